@@ -167,9 +167,13 @@ class OpponentPlayer:
         Args:
             data: Dictionary from parsed GAME_STATE message
         """
-        self.hand_size = int(data.get('opponent_hand', 0))
-        self.reserves_count = int(data.get('opponent_reserves', 0))
-        self.is_current_player = data.get('current_player') == self.name
+        # TURN_UPDATE only carries the fields that changed, keep the rest
+        if 'opponent_hand' in data:
+            self.hand_size = int(data.get('opponent_hand', 0))
+        if 'opponent_reserves' in data:
+            self.reserves_count = int(data.get('opponent_reserves', 0))
+        if 'current_player' in data:
+            self.is_current_player = data.get('current_player') == self.name
         # Note: is_connected is updated separately via PLAYER_DISCONNECTED messages
     
     def has_won(self) -> bool:
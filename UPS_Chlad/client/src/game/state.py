@@ -35,6 +35,10 @@ class GameState:
         self.deck_size: int = 0
         self.discard_pile_size: int = 0
         
+        # Sequence number of the last GAME_STATE / TURN_UPDATE applied
+        self.last_seq: int = 0
+        self.resync_pending: bool = False
+        
         # Meta state
         self.last_update: Optional[datetime] = None
         self.connection_state: str = constants.STATE_DISCONNECTED
@@ -50,6 +54,27 @@ class GameState:
         self.player_name = name
         self.player = Player(name)
     
+    def apply_turn_update(self, data: Dict[str, str]) -> bool:
+        """
+        Apply TURN_UPDATE (113) delta if it directly follows the last applied message.
+        
+        Args:
+            data: Parsed message data dictionary
+            
+        Returns:
+            False if an update was missed - the delta is dropped and full state must be requested
+        """
+        if self.resync_pending:
+            return True  # Waiting for GAME_STATE, later deltas are useless until then
+        
+        seq = int(data.get('seq', 0))
+        if seq and seq != self.last_seq + 1:
+            self.resync_pending = True
+            return False
+        
+        self.update_from_game_state_message(data)
+        return True
+    
     def update_from_game_state_message(self, data: Dict[str, str]):
         """
         Update state from GAME_STATE (106) or TURN_UPDATE (113) message.
@@ -62,11 +87,23 @@ class GameState:
         if not self.player:
             self.initialize_player(data.get('player_id', 'Unknown'))
 
+        # Full state sets sequence baseline for following deltas
+        if 'seq' in data:
+            self.last_seq = int(data.get('seq', 0))
+        if 'current_player' in data:
+            self.resync_pending = False
+
         # Update player's hand (if present)
         if 'hand' in data:
             hand_str = data.get('hand', '')
             self.player.set_hand_from_string(hand_str)
 
+        # Delta hand changes (TURN_UPDATE)
+        if data.get('hand_add'):
+            self.player.add_cards_to_hand(Card.parse_card_list(data['hand_add']))
+        if data.get('hand_remove'):
+            self.player.remove_cards_from_hand(Card.parse_card_list(data['hand_remove']))
+
         # Update reserves (if present)
         if 'reserves' in data:
             self.player.reserves_count = int(data.get('reserves', 0))
@@ -121,9 +158,14 @@ class GameState:
             if not self.opponent or self.opponent.name != opponent_name:
                 self.opponent = OpponentPlayer(opponent_name)
             self.opponent.update_from_game_state(data)
+        elif self.opponent and ('opponent_hand' in data or 'opponent_reserves' in data):
+            # Delta update names no opponent, counts belong to the known one
+            self.opponent.update_from_game_state(data)
+
+        if self.opponent:
             # Update opponent's turn state
             if 'current_player' in data:
-                self.opponent.is_current_player = (self.current_player_name == opponent_name)
+                self.opponent.is_current_player = (self.current_player_name == self.opponent.name)
             elif 'your_turn' in data:
                 your_turn = data.get('your_turn', '0')
                 self.opponent.is_current_player = (your_turn == '0' or your_turn.lower() == 'false')
@@ -163,6 +205,8 @@ class GameState:
         self.current_player_name = ""
         self.deck_size = 0
         self.discard_pile_size = 0
+        self.last_seq = 0
+        self.resync_pending = False
         self.in_game = False
         self.room_id = ""
     
@@ -422,7 +422,10 @@ class MainWindow(QMainWindow):
         elif msg_type == ServerMessageType.TURN_UPDATE:
             # Update game state (delta update - used during normal gameplay)
             # TURN_UPDATE has the same structure as GAME_STATE, just fewer fields
-            self.game_state.update_from_game_state_message(message.get('data', {}))
+            if not self.game_state.apply_turn_update(message.get('data', {})):
+                # Missed an update, deltas can't be applied until full state arrives
+                self.connection_manager.send_resync()
+                return
 
             # Update game widget if visible
             if self.game_widget and self.current_screen == "game":
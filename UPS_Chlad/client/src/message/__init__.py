@@ -8,6 +8,7 @@ from .message_types import ClientMessageType, ServerMessageType
 from .message_buffer import MessageBuffer
 from .protocol_message import ProtocolMessage
 from .message_protocol import MessageProtocol
+from .binary_codec import BinaryEncoder, BinaryDecoder, BinaryFrameError
 from .validator import MessageValidator, ValidationError
 
 __all__ = [
@@ -16,6 +17,9 @@ __all__ = [
     'MessageBuffer',
     'ProtocolMessage',
     'MessageProtocol',
+    'BinaryEncoder',
+    'BinaryDecoder',
+    'BinaryFrameError',
     'MessageValidator',
     'ValidationError',
 ]
@@ -0,0 +1,284 @@
+from typing import Optional
+
+from .protocol_message import ProtocolMessage
+from .message_protocol import MessageProtocol
+
+
+# Wire layout (must match server include/protocol/BinaryCodec.h):
+#   frame:   varint payload length, payload
+#   payload: varint type, name player_id, name room_id,
+#            varint field count, per field key + kind byte + value,
+#            varint flag count, per flag key, then one bit per flag (LSB first)
+#   key:     varint field table index + 1, or 0 followed by text key
+#   name:    0 = empty, 1 = text, 2 = text appended to intern table, n >= 3 = table entry n - 3
+#   text:    varint length, UTF-8 bytes
+
+MAX_FRAME_SIZE = 8192
+MAX_INTERNED = 1024
+
+KIND_TEXT = 0
+KIND_NUMBER = 1
+KIND_CARDS = 2
+KIND_CODE = 3
+KIND_NAME = 4
+
+# Field table index is the position in MessageProtocol.FIELD_CODE_MAP (same order as server FieldCodes::TABLE)
+FIELD_TABLE = list(MessageProtocol.FIELD_CODE_MAP.keys())
+FIELD_INDEX = {name: index for index, name in enumerate(FIELD_TABLE)}
+
+NAME_FIELDS = {
+    "name", "current_player", "opponent_name", "joined_player",
+    "winner", "reconnected_player", "disconnected_player"
+}
+
+# Card id = rank index * 4 + suit, 0 is 2H and 51 is AS
+CARD_RANKS = ["2", "3", "4", "5", "6", "7", "8", "9", "10", "J", "Q", "K", "A"]
+CARD_SUITS = "HDCS"
+CARD_NAMES = [rank + suit for rank in CARD_RANKS for suit in CARD_SUITS]
+CARD_IDS = {name: card_id for card_id, name in enumerate(CARD_NAMES)}
+
+
+class BinaryFrameError(ValueError):
+    """Malformed binary frame - connection can't be trusted any more"""
+
+
+def _append_varint(out: bytearray, value: int):
+    while value >= 0x80:
+        out.append((value & 0x7F) | 0x80)
+        value >>= 7
+    out.append(value)
+
+
+def _append_text(out: bytearray, text: str):
+    raw = text.encode('utf-8')
+    _append_varint(out, len(raw))
+    out += raw
+
+
+def _append_key(out: bytearray, key: str):
+    index = FIELD_INDEX.get(key)
+    if index is not None:
+        _append_varint(out, index + 1)
+    else:
+        _append_varint(out, 0)
+        _append_text(out, key)
+
+
+def _is_number(value: str) -> bool:
+    return value.isdigit() and value.isascii() and len(value) <= 9 and (value == "0" or value[0] != "0")
+
+
+def _is_card_list(value: str) -> bool:
+    return bool(value) and all(token in CARD_IDS for token in value.split(','))
+
+
+class BinaryEncoder:
+    """
+    Encodes messages sent on one connection, keeps the intern table of names already sent.
+    """
+
+    def __init__(self):
+        self._interned = {}
+
+    def _append_name(self, out: bytearray, name: str):
+        if not name:
+            _append_varint(out, 0)
+            return
+        index = self._interned.get(name)
+        if index is not None:
+            _append_varint(out, index + 3)
+            return
+        if len(self._interned) < MAX_INTERNED:
+            self._interned[name] = len(self._interned)
+            _append_varint(out, 2)
+        else:
+            _append_varint(out, 1)
+        _append_text(out, name)
+
+    def encode(self, msg_type: int, player_id: str = "", room_id: str = "", data: Optional[dict] = None) -> bytes:
+        """
+        Build one frame. data holds full field names and values, like ProtocolMessage.data.
+        """
+        payload = bytearray()
+        _append_varint(payload, msg_type)
+        self._append_name(payload, player_id)
+        self._append_name(payload, room_id)
+
+        items = [(key, str(value)) for key, value in (data or {}).items()]
+        fields = [(key, value) for key, value in items if value not in ("true", "false")]
+        flags = [(key, value) for key, value in items if value in ("true", "false")]
+
+        _append_varint(payload, len(fields))
+        for key, value in fields:
+            _append_key(payload, key)
+            if key in NAME_FIELDS and value:
+                payload.append(KIND_NAME)
+                self._append_name(payload, value)
+            elif _is_number(value):
+                payload.append(KIND_NUMBER)
+                _append_varint(payload, int(value))
+            elif _is_card_list(value):
+                payload.append(KIND_CARDS)
+                tokens = value.split(',')
+                payload.append(len(tokens))
+                payload += bytes(CARD_IDS[token] for token in tokens)
+            elif value in FIELD_INDEX:
+                payload.append(KIND_CODE)
+                _append_varint(payload, FIELD_INDEX[value])
+            else:
+                payload.append(KIND_TEXT)
+                _append_text(payload, value)
+
+        _append_varint(payload, len(flags))
+        for key, _ in flags:
+            _append_key(payload, key)
+        for start in range(0, len(flags), 8):
+            bits = 0
+            for bit, (_, value) in enumerate(flags[start:start + 8]):
+                if value == "true":
+                    bits |= 1 << bit
+            payload.append(bits)
+
+        frame = bytearray()
+        _append_varint(frame, len(payload))
+        return bytes(frame + payload)
+
+
+class _Reader:
+    """Bounds checked reader over one payload"""
+
+    def __init__(self, data: bytes):
+        self.data = data
+        self.pos = 0
+
+    def byte(self) -> int:
+        if self.pos >= len(self.data):
+            raise BinaryFrameError("Truncated binary frame")
+        value = self.data[self.pos]
+        self.pos += 1
+        return value
+
+    def varint(self) -> int:
+        value = 0
+        for shift in range(0, 35, 7):
+            b = self.byte()
+            value |= (b & 0x7F) << shift
+            if not b & 0x80:
+                return value
+        raise BinaryFrameError("Varint too long")
+
+    def text(self) -> str:
+        length = self.varint()
+        if length > len(self.data) - self.pos:
+            raise BinaryFrameError("Truncated text")
+        raw = self.data[self.pos:self.pos + length]
+        self.pos += length
+        return raw.decode('utf-8')
+
+
+class BinaryDecoder:
+    """
+    Splits received bytes into frames and decodes them, keeps the intern table of names received.
+    """
+
+    def __init__(self):
+        self._buffer = bytearray()
+        self._interned = []
+
+    def feed(self, data: bytes) -> list[ProtocolMessage]:
+        """
+        Add received bytes and return every message completed by them.
+
+        Raises:
+            BinaryFrameError: If a frame is malformed
+        """
+        self._buffer += data
+        messages = []
+        while True:
+            length, length_size = self._frame_length()
+            if length_size == 0:
+                break
+            if length == 0 or length > MAX_FRAME_SIZE:
+                raise BinaryFrameError(f"Invalid binary frame length {length}")
+            if len(self._buffer) - length_size < length:
+                break
+            payload = bytes(self._buffer[length_size:length_size + length])
+            del self._buffer[:length_size + length]
+            messages.append(self._decode(payload))
+        return messages
+
+    def _frame_length(self):
+        value = 0
+        for i in range(min(len(self._buffer), 5)):
+            b = self._buffer[i]
+            value |= (b & 0x7F) << (7 * i)
+            if not b & 0x80:
+                return value, i + 1
+        if len(self._buffer) >= 5:
+            raise BinaryFrameError("Invalid binary frame length prefix")
+        return 0, 0
+
+    def _read_name(self, reader: _Reader) -> str:
+        tag = reader.varint()
+        if tag == 0:
+            return ""
+        if tag in (1, 2):
+            name = reader.text()
+            if tag == 2:
+                if len(self._interned) >= MAX_INTERNED:
+                    raise BinaryFrameError("Intern table full")
+                self._interned.append(name)
+            return name
+        if tag - 3 >= len(self._interned):
+            raise BinaryFrameError("Unknown interned name")
+        return self._interned[tag - 3]
+
+    @staticmethod
+    def _read_key(reader: _Reader) -> str:
+        key = reader.varint()
+        if key == 0:
+            return reader.text()
+        if key - 1 >= len(FIELD_TABLE):
+            raise BinaryFrameError("Unknown field index")
+        return FIELD_TABLE[key - 1]
+
+    def _decode(self, payload: bytes) -> ProtocolMessage:
+        reader = _Reader(payload)
+        msg_type = reader.varint()
+        player_id = self._read_name(reader)
+        room_id = self._read_name(reader)
+
+        data = {}
+        for _ in range(reader.varint()):
+            key = self._read_key(reader)
+            kind = reader.byte()
+            if kind == KIND_TEXT:
+                value = reader.text()
+            elif kind == KIND_NUMBER:
+                value = str(reader.varint())
+            elif kind == KIND_CARDS:
+                ids = [reader.byte() for _ in range(reader.byte())]
+                if any(card_id >= len(CARD_NAMES) for card_id in ids):
+                    raise BinaryFrameError("Invalid card id")
+                value = ",".join(CARD_NAMES[card_id] for card_id in ids)
+            elif kind == KIND_CODE:
+                index = reader.varint()
+                if index >= len(FIELD_TABLE):
+                    raise BinaryFrameError("Unknown value index")
+                value = FIELD_TABLE[index]
+            elif kind == KIND_NAME:
+                value = self._read_name(reader)
+            else:
+                raise BinaryFrameError(f"Unknown field kind {kind}")
+            data[key] = value
+
+        flag_keys = [self._read_key(reader) for _ in range(reader.varint())]
+        for start in range(0, len(flag_keys), 8):
+            bits = reader.byte()
+            for bit, key in enumerate(flag_keys[start:start + 8]):
+                data[key] = "true" if (bits >> bit) & 1 else "false"
+
+        if reader.pos != len(payload):
+            raise BinaryFrameError("Trailing bytes in binary frame")
+
+        return ProtocolMessage(msg_type, player_id, room_id, data)
@@ -36,6 +36,10 @@ class MessageProtocol:
         "disconnect": "disc",
         "message": "msg",
         "reason": "rsn",
+        "seq": "sq",
+        "hand_add": "ha",
+        "hand_remove": "hr",
+        "binary": "bin",
 
         # Status values
         "temporarily_disconnected": "temp",
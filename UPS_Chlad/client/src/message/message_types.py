@@ -9,6 +9,7 @@ class ClientMessageType(IntEnum):
     RECONNECT = 6
     PLAY_CARDS = 7
     PICKUP_PILE = 8
+    RESYNC = 9
 
 class ServerMessageType(IntEnum):
     """Messages received from server"""
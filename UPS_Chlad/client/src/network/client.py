@@ -9,7 +9,7 @@ import socket
 from typing import Optional
 from PyQt5.QtCore import QThread, pyqtSignal
 
-from message import MessageBuffer, MessageProtocol
+from message import MessageBuffer, MessageProtocol, BinaryEncoder, BinaryDecoder, BinaryFrameError, ServerMessageType
 from utils import (
     get_logger,
     log_message_sent,
@@ -72,6 +72,12 @@ class NetworkClient(QThread):
         # Message buffer for handling partial TCP messages
         self.buffer = MessageBuffer()
         
+        # Binary protocol - requested in CONNECT / RECONNECT, active once CONNECTED acknowledged it
+        self.binary_requested = False
+        self.handshake_buffer = b""     # Raw bytes until CONNECTED tells how the rest is framed
+        self.encoder: Optional[BinaryEncoder] = None
+        self.decoder: Optional[BinaryDecoder] = None
+        
         self.logger = get_logger()
         self.logger.info(f"NetworkClient initialized for {host}:{port}")
     
@@ -157,6 +163,13 @@ class NetworkClient(QThread):
         log_connection_event("DISCONNECTED")
         self.disconnected.emit()
     
+    def request_binary(self):
+        """
+        Ask for binary protocol with the next CONNECT / RECONNECT.
+        Server replies to it in text, incoming bytes are split by hand until that reply arrives.
+        """
+        self.binary_requested = True
+    
     def send_message(self, message: str):
         """
         Send message to server.
@@ -174,8 +187,13 @@ class NetworkClient(QThread):
             if not message.endswith('\n'):
                 message += '\n'
             
-            # Send
-            self.socket.send(message.encode('utf-8'))
+            # Send (transcoded once binary protocol is active)
+            if self.encoder:
+                parsed = MessageProtocol.parse(message.rstrip('\n'))
+                frame = self.encoder.encode(parsed.type, parsed.player_id, parsed.room_id, parsed.data)
+                self.socket.sendall(frame)
+            else:
+                self.socket.send(message.encode('utf-8'))
             log_message_sent(message)
             
         except socket.error as e:
@@ -213,6 +231,15 @@ class NetworkClient(QThread):
                     self._handle_connection_lost()
                     continue
                 
+                if self.decoder:
+                    for parsed in self.decoder.feed(data):
+                        self._emit_message(parsed, "")
+                    continue
+                
+                if self.binary_requested:
+                    self._process_handshake_data(data)
+                    continue
+                
                 # Decode and add to buffer
                 decoded = data.decode('utf-8')
                 complete_messages = self.buffer.add_data(decoded)
@@ -222,6 +249,12 @@ class NetworkClient(QThread):
                     log_message_received(raw_message)
                     self._process_message(raw_message)
                 
+            except BinaryFrameError as e:
+                error_msg = f"Invalid binary frame: {e}"
+                log_error(error_msg)
+                self._handle_connection_lost()
+                break
+                
             except socket.timeout:
                 # Timeout is normal - just means no data received
                 continue
@@ -252,24 +285,77 @@ class NetworkClient(QThread):
         try:
             # Parse message
             parsed = MessageProtocol.parse(raw_message)
-            
-            # Convert to dict for signal
-            message_dict = {
-                'type': parsed.type,
-                'player': parsed.player_id,  # Fixed: use player_id not player
-                'room': parsed.room_id,      # Fixed: use room_id not room
-                'data': parsed.data,
-                'raw': raw_message
-            }
-            
-            # Emit signal
-            self.message_received.emit(message_dict)
+            self._emit_message(parsed, raw_message)
             
         except ValueError as e:
             error_msg = f"Invalid message format: {e}"
             log_error(error_msg)
             self.error_occurred.emit(error_msg)
     
+    def _emit_message(self, parsed, raw_message: str):
+        """
+        Emit parsed message.
+        
+        Args:
+            parsed: ProtocolMessage (from text or binary frame)
+            raw_message: Raw text message, empty for binary frames
+        """
+        # Convert to dict for signal
+        message_dict = {
+            'type': parsed.type,
+            'player': parsed.player_id,  # Fixed: use player_id not player
+            'room': parsed.room_id,      # Fixed: use room_id not room
+            'data': parsed.data,
+            'raw': raw_message
+        }
+        
+        # Emit signal
+        self.message_received.emit(message_dict)
+    
+    def _process_handshake_data(self, data: bytes):
+        """
+        Split text replies until CONNECTED / ERROR answers the binary request.
+        Everything behind an acknowledging CONNECTED is binary frames.
+        
+        Args:
+            data: Raw bytes received from socket
+        """
+        self.handshake_buffer += data
+        while self.binary_requested and b'\n' in self.handshake_buffer:
+            line, self.handshake_buffer = self.handshake_buffer.split(b'\n', 1)
+            raw_message = line.decode('utf-8')
+            if not raw_message:
+                continue
+            log_message_received(raw_message)
+            
+            try:
+                parsed = MessageProtocol.parse(raw_message)
+            except ValueError as e:
+                error_msg = f"Invalid message format: {e}"
+                log_error(error_msg)
+                self.error_occurred.emit(error_msg)
+                continue
+            
+            if parsed.type in (ServerMessageType.CONNECTED, ServerMessageType.ERROR):
+                self.binary_requested = False
+                if parsed.type == ServerMessageType.CONNECTED and parsed.data.get('binary') == 'true':
+                    # Encoder first - CONNECTED handler starts heartbeat right away
+                    self.encoder = BinaryEncoder()
+                    self.decoder = BinaryDecoder()
+                    self.logger.info("Server acknowledged binary protocol")
+            
+            self._emit_message(parsed, raw_message)
+        
+        if not self.binary_requested:
+            rest, self.handshake_buffer = self.handshake_buffer, b""
+            if self.decoder:
+                for parsed in self.decoder.feed(rest):
+                    self._emit_message(parsed, "")
+            elif rest:
+                for raw_message in self.buffer.add_data(rest.decode('utf-8')):
+                    log_message_received(raw_message)
+                    self._process_message(raw_message)
+    
     def _handle_connection_lost(self):
         """Handle unexpected connection loss"""
         if self.connected_flag:
@@ -16,6 +16,7 @@ from utils import (
     log_state_change,
     log_connection_event,
     log_error,
+    Config,
     constants
 )
 
@@ -70,6 +71,11 @@ class ConnectionManager(QObject):
         self.reconnect_attempts = 0
         self.intentional_disconnect = False
         
+        # Binary wire protocol is requested in CONNECT / RECONNECT, server answers in CONNECTED
+        config = Config()
+        config.load()
+        self.binary_protocol = config.get_binary_protocol()
+        
         # Reconnection timer
         self.reconnect_timer = QTimer()
         self.reconnect_timer.timeout.connect(self._attempt_reconnect)
@@ -190,6 +196,10 @@ class ConnectionManager(QObject):
             return
         
         self.network_client.send_message(message)
+        
+        # Every message counts as heartbeat, PING is only needed when nothing else goes out
+        if self.heartbeat:
+            self.heartbeat.on_message_sent()
     
     # ========================================================================
     # CONVENIENCE METHODS - Protocol Messages
@@ -197,8 +207,7 @@ class ConnectionManager(QObject):
     
     def send_connect(self, player_name: str):
         """Send CONNECT message"""
-        msg = MessageProtocol.build(ClientMessageType.CONNECT, name=player_name)
-        self.send_message(msg)
+        self.send_message(self._build_handshake(ClientMessageType.CONNECT, player_name))
     
     def send_join_room(self):
         """Send JOIN_ROOM message"""
@@ -225,10 +234,22 @@ class ConnectionManager(QObject):
         msg = MessageProtocol.build(ClientMessageType.PICKUP_PILE)
         self.send_message(msg)
     
+    def send_resync(self):
+        """Send RESYNC message (request full GAME_STATE after a missed TURN_UPDATE)"""
+        msg = MessageProtocol.build(ClientMessageType.RESYNC)
+        self.send_message(msg)
+    
     def send_reconnect(self, player_name: str):
         """Send RECONNECT message"""
-        msg = MessageProtocol.build(ClientMessageType.RECONNECT, name=player_name)
-        self.send_message(msg)
+        self.send_message(self._build_handshake(ClientMessageType.RECONNECT, player_name))
+    
+    def _build_handshake(self, msg_type: int, player_name: str) -> str:
+        """Build CONNECT / RECONNECT, asking for binary protocol when enabled in config"""
+        if not self.binary_protocol or not self.network_client:
+            return MessageProtocol.build(msg_type, name=player_name)
+        
+        self.network_client.request_binary()
+        return MessageProtocol.build(msg_type, name=player_name, binary="true")
     
     # ========================================================================
     # STATE MANAGEMENT
@@ -411,6 +432,10 @@ class ConnectionManager(QObject):
         """
         msg_type = message_dict.get('type')
 
+        # Any message shows the server is alive
+        if self.heartbeat:
+            self.heartbeat.on_message_received()
+
         # Handle protocol messages that affect connection state
         if msg_type == ServerMessageType.ERROR:
             # Handle ERROR during connection phase
@@ -429,23 +454,28 @@ class ConnectionManager(QObject):
             self._on_pong_message()
         elif msg_type == ServerMessageType.ROOM_JOINED:
             self._change_state(constants.STATE_IN_ROOM)
+            self._set_heartbeat_phase(HeartbeatManager.PHASE_ROOM)
         elif msg_type == ServerMessageType.ROOM_LEFT:
             # Player left room - back to connected state
             self.logger.info("Left room - changing to CONNECTED state")
             self._change_state(constants.STATE_CONNECTED)
+            self._set_heartbeat_phase(HeartbeatManager.PHASE_LOBBY)
         elif msg_type == ServerMessageType.GAME_STARTED:
             self._change_state(constants.STATE_IN_GAME)
+            self._set_heartbeat_phase(HeartbeatManager.PHASE_ROOM)
         elif msg_type == ServerMessageType.GAME_STATE:
             # GAME_STATE indicates we're in an active game (e.g., after reconnection)
             if self.state != constants.STATE_IN_GAME:
                 self.logger.info("Received GAME_STATE - changing to IN_GAME state")
                 self._change_state(constants.STATE_IN_GAME)
+            self._track_turn(message_dict.get('data', {}))
         elif msg_type == ServerMessageType.TURN_UPDATE:
             # TURN_UPDATE is only sent during active gameplay
             # State should already be IN_GAME, but ensure it
             if self.state != constants.STATE_IN_GAME:
                 self.logger.warning("Received TURN_UPDATE while not IN_GAME - fixing state")
                 self._change_state(constants.STATE_IN_GAME)
+            self._track_turn(message_dict.get('data', {}))
         elif msg_type == ServerMessageType.GAME_OVER:
             # Don't change state here - let ROOM_LEFT handle it
             # This prevents auto-joining before server sends ROOM_LEFT
@@ -464,16 +494,34 @@ class ConnectionManager(QObject):
             self.logger.info("Connection successful")
             self._change_state(constants.STATE_CONNECTED)
             
-            # Start heartbeat
+            # Start heartbeat with the intervals the server asks for
             if not self.heartbeat:
                 self.heartbeat = HeartbeatManager()
                 self._connect_heartbeat_signals()
+            self.heartbeat.set_schedule(message_dict.get('data', {}))
+            self.heartbeat.set_phase(HeartbeatManager.PHASE_LOBBY)
             self.heartbeat.start(self.network_client.send_message)
             
             # Check if this was a reconnection
             if self.reconnect_attempts > 0:
                 self._on_reconnect_success()
     
+    def _set_heartbeat_phase(self, phase: str):
+        """Switch heartbeat interval when the player enters the lobby, a room or its turn"""
+        if self.heartbeat:
+            self.heartbeat.set_phase(phase)
+    
+    def _track_turn(self, data: dict):
+        """
+        Tighter heartbeat while the game waits for us.
+        TURN_UPDATE carries your_turn only when it changed, full GAME_STATE always does.
+        """
+        your_turn = str(data.get('your_turn', ''))
+        if not your_turn:
+            return
+        on_turn = your_turn == '1' or your_turn.lower() == 'true'
+        self._set_heartbeat_phase(HeartbeatManager.PHASE_TURN if on_turn else HeartbeatManager.PHASE_ROOM)
+    
     def _on_pong_message(self):
         """Handle PONG message from server"""
         if self.heartbeat:
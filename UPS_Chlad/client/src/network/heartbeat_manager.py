@@ -1,6 +1,6 @@
 """
 Heartbeat manager for keeping connection alive.
-Sends PING every 30 seconds and detects timeouts.
+Sends PING only when nothing else was sent for one heartbeat interval and detects timeouts.
 """
 
 from PyQt5.QtCore import QObject, QTimer, pyqtSignal
@@ -13,10 +13,16 @@ from utils import get_logger, log_connection_event, constants
 class HeartbeatManager(QObject):
     """
     Manages PING/PONG heartbeat to keep connection alive.
-    
-    The server disconnects clients that don't send anything for 60 seconds.
-    We send PING every 30 seconds to stay alive.
-    We also track PONG responses to detect if server stopped responding.
+
+    The server counts every message as a sign of life and disconnects clients
+    that stay silent for a few heartbeat intervals. The interval is advertised
+    in CONNECTED and depends on what the player is doing:
+    - lobby: idle, longer only if the server allows a longer lobby timeout
+    - room:  in a room or game, waiting for the opponent
+    - turn:  the game waits for us, short interval
+    A PING is sent only after a whole interval without any other message.
+    We also track PONG responses to detect if server stopped responding,
+    any message from the server counts as an answer.
     
     Signals:
     - timeout_detected: Emitted when server doesn't respond to PING
@@ -26,9 +32,15 @@ class HeartbeatManager(QObject):
     Usage:
         heartbeat = HeartbeatManager()
         heartbeat.timeout_detected.connect(on_timeout)
+        heartbeat.set_schedule(connected_message_data)
         heartbeat.start(send_message_func)
     """
     
+    # Heartbeat phases
+    PHASE_LOBBY = "lobby"
+    PHASE_ROOM = "room"
+    PHASE_TURN = "turn"
+    
     # Signals
     timeout_detected = pyqtSignal()  # Server not responding
     ping_sent = pyqtSignal()  # PING sent
@@ -40,22 +52,63 @@ class HeartbeatManager(QObject):
         
         self.logger = get_logger()
         
-        # Timer for sending PING
+        # Timer for sending PING, restarted by every sent message
         self.ping_timer = QTimer()
+        self.ping_timer.setSingleShot(True)
         self.ping_timer.timeout.connect(self._send_ping)
         
         # Timer for detecting PONG timeout
         self.pong_timer = QTimer()
         self.pong_timer.timeout.connect(self._check_pong_timeout)
         
+        # Interval per phase in milliseconds, until the server advertises its own
+        self.intervals = {
+            self.PHASE_LOBBY: constants.PING_INTERVAL * 1000,
+            self.PHASE_ROOM: constants.PING_INTERVAL * 1000,
+            self.PHASE_TURN: constants.PING_INTERVAL * 1000,
+        }
+        self.phase = self.PHASE_LOBBY
+        
         # State
         self.running = False
         self.send_message_callback = None
         self.last_ping_time: datetime = None
+        self.last_sent_time: datetime = None
         self.waiting_for_pong = False
         
         self.logger.info("HeartbeatManager initialized")
     
+    def set_schedule(self, data: dict):
+        """
+        Take over heartbeat intervals advertised in CONNECTED.
+        
+        Args:
+            data: CONNECTED message data (heartbeat_lobby_ms, heartbeat_room_ms, heartbeat_turn_ms)
+        """
+        for phase in (self.PHASE_LOBBY, self.PHASE_ROOM, self.PHASE_TURN):
+            try:
+                interval = int(data.get(f'heartbeat_{phase}_ms', 0))
+            except (TypeError, ValueError):
+                continue
+            if interval > 0:
+                self.intervals[phase] = interval
+        
+        self.logger.info(f"Heartbeat intervals (ms): {self.intervals}")
+        if self.running:
+            self._reschedule()
+    
+    def set_phase(self, phase: str):
+        """
+        Switch heartbeat interval to the given phase (PHASE_LOBBY, PHASE_ROOM, PHASE_TURN).
+        """
+        if phase == self.phase or phase not in self.intervals:
+            return
+        
+        self.logger.debug(f"Heartbeat phase {self.phase} -> {phase} ({self.intervals[phase]} ms)")
+        self.phase = phase
+        if self.running:
+            self._reschedule()
+    
     def start(self, send_message_callback):
         """
         Start heartbeat.
@@ -70,13 +123,10 @@ class HeartbeatManager(QObject):
         self.send_message_callback = send_message_callback
         self.running = True
         
-        # Start PING timer (send every 30 seconds)
-        self.ping_timer.start(constants.PING_INTERVAL * 1000)  # Convert to milliseconds
-        
-        # Send first PING immediately
+        # Send first PING immediately, it also starts the PING timer
         self._send_ping()
         
-        self.logger.info(f"Heartbeat started (PING every {constants.PING_INTERVAL}s)")
+        self.logger.info(f"Heartbeat started (PING after {self.intervals[self.phase]} ms without traffic)")
         log_connection_event("HEARTBEAT_STARTED")
     
     def stop(self):
@@ -92,14 +142,26 @@ class HeartbeatManager(QObject):
         self.logger.info("Heartbeat stopped")
         log_connection_event("HEARTBEAT_STOPPED")
     
+    def on_message_sent(self):
+        """
+        Call this after any message was sent to the server, it counts as heartbeat.
+        """
+        self.last_sent_time = datetime.now()
+        if self.running:
+            self.ping_timer.start(self.intervals[self.phase])
+    
+    def on_message_received(self):
+        """
+        Call this for any message from the server, it shows the server is alive.
+        """
+        if self.waiting_for_pong:
+            self.waiting_for_pong = False
+            self.pong_timer.stop()
+    
     def on_pong_received(self):
         """
         Call this when PONG message is received from server.
         """
-        if not self.waiting_for_pong:
-            self.logger.warning("Received PONG but wasn't waiting for one")
-            return
-        
         # Calculate round-trip time
         if self.last_ping_time:
             rtt = (datetime.now() - self.last_ping_time).total_seconds()
@@ -109,6 +171,19 @@ class HeartbeatManager(QObject):
         self.pong_timer.stop()
         self.pong_received.emit()
     
+    def _reschedule(self):
+        """Restart PING timer for the current interval, counted from the last sent message"""
+        interval = self.intervals[self.phase]
+        if self.last_sent_time is None:
+            self._send_ping()
+            return
+        
+        elapsed = (datetime.now() - self.last_sent_time) / timedelta(milliseconds=1)
+        if elapsed >= interval:
+            self._send_ping()
+        else:
+            self.ping_timer.start(int(interval - elapsed))
+    
     def _send_ping(self):
         """Send PING message to server"""
         if not self.running or not self.send_message_callback:
@@ -119,13 +194,14 @@ class HeartbeatManager(QObject):
         
         # Send
         self.send_message_callback(ping_message)
+        self.on_message_sent()
         
         # Track state
         self.last_ping_time = datetime.now()
-        self.waiting_for_pong = True
-        
-        # Start timeout timer (expect PONG within PONG_TIMEOUT seconds)
-        self.pong_timer.start(constants.PONG_TIMEOUT * 1000)
+        if not self.waiting_for_pong:
+            self.waiting_for_pong = True
+            # Start timeout timer (expect an answer within PONG_TIMEOUT seconds)
+            self.pong_timer.start(constants.PONG_TIMEOUT * 1000)
         
         self.logger.debug("PING sent")
         self.ping_sent.emit()
@@ -124,6 +124,14 @@ class Config:
         """Set auto-reconnect setting"""
         self.config.set(CONFIG_SECTION_CONNECTION, "auto_reconnect", str(enabled).lower())
     
+    def get_binary_protocol(self) -> bool:
+        """Get whether to negotiate the binary wire protocol at CONNECT"""
+        return self.config.getboolean(CONFIG_SECTION_CONNECTION, "binary_protocol", fallback=False)
+    
+    def set_binary_protocol(self, enabled: bool):
+        """Set binary wire protocol setting"""
+        self.config.set(CONFIG_SECTION_CONNECTION, "binary_protocol", str(enabled).lower())
+    
     # ========================================================================
     # PLAYER SETTINGS
     # ========================================================================
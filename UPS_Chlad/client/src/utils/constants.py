@@ -11,9 +11,9 @@ DEFAULT_HOST = "127.0.0.1"
 DEFAULT_PORT = 8080
 
 # Timeouts (in seconds)
-PING_INTERVAL = 2  # Send PING every 2 seconds
+PING_INTERVAL = 2  # Send PING after 2 seconds without traffic, until CONNECTED advertises the server's intervals
 PONG_TIMEOUT = 2   # Expect PONG within 2 seconds of PING
-SERVER_TIMEOUT = 6  # Server disconnects after 6s without heartbeat (3 missed pings)
+SERVER_TIMEOUT = 6  # Server disconnects after 6s without any message in every phase, advertised intervals fit 3 missed pings into it
 RECONNECT_WINDOW = 120  # Server keeps player for 120s after disconnect
 
 # Connection retry settings
@@ -122,7 +122,8 @@ DEFAULT_CONFIG = {
     CONFIG_SECTION_CONNECTION: {
         "host": DEFAULT_HOST,
         "port": str(DEFAULT_PORT),
-        "auto_reconnect": "true"
+        "auto_reconnect": "true",
+        "binary_protocol": "false"
     },
     CONFIG_SECTION_PLAYER: {
         "last_name": "",
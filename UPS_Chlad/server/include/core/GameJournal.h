@@ -0,0 +1,141 @@
+// GameJournal.h - Append-only per-room game journal
+// KIV/UPS Network Programming Project
+
+#ifndef GAMEJOURNAL_H
+#define GAMEJOURNAL_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <ostream>
+#include <cstdint>
+#include <cstddef>
+#include "../game/CardSet.h"
+
+class Logger;
+class RoomManager;
+class PlayerManager;
+struct Room;
+
+/*
+* Append-only journal of every room, one file per room in the journal directory.
+* Game threads only append a few bytes to a shared queue under the room lock (so a room's events are queued
+* in the order they happened), one writer thread takes the queue every flush interval and commits it as a group -
+* one write() and at most one fdatasync() per touched file.
+*
+* A room writes "<room_id>.journal" while it exists. When it closes the file becomes "<room_id>-<unix ms>.replay",
+* a finished game that can be printed move by move (--replay). Journals still open at startup belong to rooms
+* a crashed (or stopped) process left behind, recover() rebuilds them and their players get the usual
+* reconnect window.
+*
+* File: "GJRN" + version byte, then records
+*   event (1 byte), player name length (1 byte), player name, and for GAME_START / PLAY_CARDS a little-endian
+*   64-bit value (shuffle seed / card mask).
+* A crash can only cut off the tail, replay stops at the first incomplete record.
+*/
+class GameJournal {
+public:
+    enum class Event : uint8_t {
+        JOIN = 1,
+        LEAVE,
+        GAME_START,         // value = shuffle seed
+        PLAY_CARDS,         // value = CardSet mask
+        PLAY_RESERVE,
+        PICKUP_PILE,
+        GAME_RESET,         // Game ended without a winner (opponent timed out), seats stay
+        CLOSE               // Room removed, nothing follows
+    };
+
+    struct Entry {
+        Event event = Event::CLOSE;
+        std::string_view player;    // Points into the journal data
+        uint64_t value = 0;
+    };
+
+    static constexpr int DEFAULT_FLUSH_INTERVAL_MS = 5;
+
+    GameJournal(Logger* lg, const std::string& dir, int flush_interval_ms, bool sync, bool keep_finished);
+    ~GameJournal();
+    GameJournal(const GameJournal&) = delete;
+    GameJournal& operator=(const GameJournal&) = delete;
+
+    /*
+    * Creates the directory if needed and starts the writer thread.
+    * @param error - reason on failure
+    */
+    bool start(std::string& error);
+    /*
+    * Commits everything queued and stops the writer. Open journals stay, the next start recovers them.
+    */
+    void stop();
+
+    // Called under the room's lock, right after the change succeeded
+    void recordJoin(const std::string& room_id, const std::string& player);
+    void recordLeave(const std::string& room_id, const std::string& player);
+    void recordGameStart(const std::string& room_id, uint64_t seed);
+    void recordPlayCards(const std::string& room_id, const std::string& player, CardSet cards);
+    void recordPlayFromReserve(const std::string& room_id, const std::string& player);
+    void recordPickupPile(const std::string& room_id, const std::string& player);
+    void recordGameReset(const std::string& room_id);
+    void recordClose(const std::string& room_id);
+
+    /*
+    * Rebuilds the rooms of journals left open by the previous process, before the server accepts clients.
+    * Rooms get new ids (their journals are renamed along), players come back as temporarily disconnected.
+    * @return number of rooms restored
+    */
+    size_t recover(RoomManager* roomManager, PlayerManager* playerManager);
+
+    /*
+    * Decodes the record at offset and advances it.
+    * @return false at the end of data or at an incomplete / unknown record
+    */
+    static bool nextEntry(std::string_view data, size_t& offset, Entry& entry);
+    /*
+    * Applies one entry to a room the same way the live server changed it.
+    * @return false if the game refused the action (journal does not match the game)
+    */
+    static bool apply(Room& room, const Entry& entry);
+    /*
+    * Prints a journal or replay file event by event with the game state after each one.
+    * @return false if the file can't be read or is not a journal
+    */
+    static bool printReplay(const std::string& path, std::ostream& out);
+
+private:
+    static constexpr std::string_view MAGIC = "GJRN";
+    static constexpr uint8_t VERSION = 1;
+    static constexpr size_t HEADER_SIZE = 5;
+
+    Logger* logger;
+    std::string directory;
+    int flush_interval_ms;
+    bool sync;
+    bool keep_finished;
+
+    // Queued records, each prefixed with room id length and room id
+    std::mutex queue_mutex;
+    std::condition_variable queue_cv;
+    std::string queue;
+    bool running;
+    std::thread writer_thread;
+
+    // Writer thread only
+    std::unordered_map<std::string, int> files;               // Open journal of every room with records
+    std::unordered_map<std::string, std::string> room_batches; // Records of the current group commit per room
+
+    void append(const std::string& room_id, Event event, std::string_view player, const uint64_t* value);
+    void writerLoop();
+    void commit(const std::string& batch);
+    // Writes room's records of this group commit, close = room is gone, journal becomes a replay
+    void writeRoom(const std::string& room_id, std::string& records, bool close);
+
+    std::string journalPath(const std::string& room_id) const;
+    static bool readFile(const std::string& path, std::string& data);
+};
+
+#endif //GAMEJOURNAL_H
@@ -3,14 +3,16 @@
 
 #include <string>
 #include <vector>
+#include <cstdint>
+#include "../game/CardSet.h"
 
 // Forward declarations
-class Card;
 class RoomManager;
+struct Room;
 
 // Data structure for game state (not ProtocolMessage)
 struct GameStateData {
-    std::vector<std::string> hand_cards;
+    CardSet hand_cards;
     int reserve_count;
     std::string current_player;
     std::string top_discard_card;
@@ -23,9 +25,32 @@ struct GameStateData {
     int deck_size;              // Cards left in draw pile
     int discard_pile_size;      // Cards in discard pile
 
+    uint32_t seq;               // Counts GAME_STATE and TURN_UPDATE messages sent to this player
+
     // Constructor to initialize defaults
     GameStateData() : reserve_count(0), must_play_seven_or_lower(false), valid(false),
-                      deck_size(0), discard_pile_size(0) {}
+                      deck_size(0), discard_pile_size(0), seq(0) {}
+};
+
+// Game state for a TURN_UPDATE together with the state the player was sent before it
+struct TurnUpdateData {
+    GameStateData current;
+    GameStateData previous;     // previous.valid is false if the player has no baseline yet
+};
+
+/*
+* Game state of a whole room read under one room lock after an action.
+* Public fields are read once and only the private hand is projected per player, so the work
+* (and lock hold time) depends on the number of players, not on the size of the discard pile.
+*/
+struct RoomSnapshot {
+    bool valid;
+    std::string error_message;
+    std::vector<std::string> players;       // Recipients in room order
+    std::vector<TurnUpdateData> views;      // views[i] belongs to players[i]
+    uint64_t game_seed;                     // Replays the deal and every reshuffle of the room's game
+
+    RoomSnapshot() : valid(false), game_seed(0) {}
 };
 
 class GameManager {
@@ -33,7 +58,11 @@ public:
     GameManager();
 
     // Game state queries - returns raw data, not ProtocolMessage
+    // Full state, also becomes the baseline later TURN_UPDATE deltas are computed against
     GameStateData getGameStateForPlayer(RoomManager* roomManager, const std::string& room_id, const std::string& player_name);
+    // Views of every player in the room under one lock, each view's baseline advances to the current state
+    // (full_state resets it like getGameStateForPlayer, otherwise previous holds what the player was sent)
+    RoomSnapshot getRoomSnapshot(RoomManager* roomManager, const std::string& room_id, bool full_state);
 
     // Game actions - takes RoomManager pointer and room_id
     bool playCards(RoomManager* roomManager, const std::string& room_id, const std::string& player_name, const std::vector<std::string>& card_strings);
@@ -49,9 +78,17 @@ public:
     std::string getWinner(RoomManager* roomManager, const std::string& room_id);
 
 private:
+    // Reads the player's view of the game, caller holds the room lock
+    GameStateData buildGameState(Room* room, const std::string& player_name);
+    // Reads fields every player sees the same, caller holds the room lock
+    bool buildSharedState(Room* room, GameStateData& result);
+    // Fills hand and reserves of one player into a view holding the shared state
+    void projectPlayer(Room* room, const std::string& player_name, GameStateData& view);
+    // Format: "playername:handsize:reservesize"
+    std::string describePlayer(Room* room, const std::string& player_name);
+
     // Helper methods for protocol conversion
-    Card parseCardFromString(const std::string& cardStr);
-    std::vector<std::string> convertCardsToStrings(const std::vector<Card>& cards);
+    bool parseCards(const std::vector<std::string>& card_strings, CardSet& out);
 };
 
 #endif // GAMEMANAGER_H
\ No newline at end of file
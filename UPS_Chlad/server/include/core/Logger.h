@@ -4,6 +4,13 @@
 #include <string>
 #include <fstream>
 #include <mutex>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+#include <memory>
+#include <ctime>
+#include <cstddef>
+#include <cstdint>
 
 enum class LogLevel {
     DEBUG = 0,
@@ -12,30 +19,107 @@ enum class LogLevel {
     ERROR = 3
 };
 
+/*
+* Builds the message only when DEBUG is enabled, so disabled debug logging costs one atomic load.
+* Usage: LOG_DEBUG(logger, "Received " + message);
+*/
+#define LOG_DEBUG(logger, message)                                  \
+    do {                                                            \
+        if ((logger)->isEnabled(LogLevel::DEBUG)) {                 \
+            (logger)->debug(message);                               \
+        }                                                           \
+    } while (0)
+
+/*
+* Asynchronous logger. Callers only copy the message into a fixed-size record of a lock-free
+* multi-producer ring, one background thread formats records and writes them in batches
+* every flush interval (or sooner when the ring fills up). When the ring is full records are dropped
+* and counted instead of blocking the caller.
+*/
 class Logger {
 private:
+    static constexpr size_t RING_CAPACITY = 8192;         // Records, power of two
+    static constexpr size_t MAX_RECORD_TEXT = 480;        // Longer messages are truncated
+
+    struct LogRecord {
+        LogLevel level;
+        uint16_t length;
+        std::time_t time;
+        char text[MAX_RECORD_TEXT];
+    };
+
+    // Slot of bounded MPSC ring, sequence tells producers / consumer whose turn it is
+    struct Slot {
+        std::atomic<size_t> sequence;
+        LogRecord record;
+    };
+
     std::string filePath;
     std::ofstream logFileStream;
-    std::mutex logMutex;
-    LogLevel logLevelMinimum;
-    bool logToFile;
-    bool logToConsole;
+    std::mutex logMutex;                         // Guards file stream reopening and writer wakeup
+    std::condition_variable writerCv;
+    std::atomic<LogLevel> logLevelMinimum;
+    std::atomic<bool> logToFile;
+    std::atomic<bool> logToConsole;
+    std::atomic<int> flushIntervalMs;
+
+    std::unique_ptr<Slot[]> ring;
+    alignas(64) std::atomic<size_t> enqueuePos;
+    alignas(64) size_t dequeuePos;               // Writer thread only
+    std::atomic<size_t> droppedRecords;
+
+    std::atomic<bool> running;
+    std::thread writerThread;
+
+    // Writer thread only - formatted timestamp reused for all records of the same second
+    std::time_t cachedSecond;
+    char cachedTimestamp[24];
 
 public:
     Logger(const std::string& filePath = "gamba_server.log");
     ~Logger();
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
     void setLogLevel(LogLevel logLevelMinumum);
     void setLogToFile(bool logToFile);
     void setLogToConsole(bool logToConsole);
+    /*
+    * How often the writer thread writes queued records out (milliseconds)
+    */
+    void setFlushInterval(int intervalMs);
+    /*
+    * @return true if messages of given level are written - check before building expensive messages
+    */
+    bool isEnabled(LogLevel logLevel) const { return logLevel >= logLevelMinimum.load(std::memory_order_relaxed); }
+
     void info(const std::string& message);
     void warning(const std::string& message);
     void error(const std::string& message);
     void debug(const std::string& message);
+    /*
+    * Lazy variant - builder is called only when DEBUG is enabled
+    */
+    template<typename MessageBuilder, typename = decltype(std::declval<MessageBuilder>()())>
+    void debug(MessageBuilder&& buildMessage) {
+        if (isEnabled(LogLevel::DEBUG)) {
+            writeToLog(LogLevel::DEBUG, buildMessage());
+        }
+    }
 
 private:
     void writeToLog(LogLevel logLevel, const std::string& message);
-    std::string getCurrentTimestamp();
-    std::string levelToString(LogLevel logLevel);
+    void writerLoop();
+    /*
+    * Formats every record currently in the ring into batch.
+    * @return number of records taken
+    */
+    size_t drainRing(std::string& batch);
+    void writeBatch(const std::string& batch);
+    void appendLine(std::string& batch, LogLevel logLevel, std::time_t time, const char* text, size_t length);
+    const char* timestampFor(std::time_t time);
+    const char* levelToString(LogLevel logLevel);
 };
 
-#endif // LOGGER_H
\ No newline at end of file
+#endif // LOGGER_H
@@ -0,0 +1,111 @@
+// Matchmaker.h - Batched JOIN_ROOM matchmaking thread
+// KIV/UPS Network Programming Project
+
+#ifndef MATCHMAKER_H
+#define MATCHMAKER_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <unordered_set>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include "ProtocolMessage.h"
+
+class RoomManager;
+class PlayerManager;
+class Logger;
+
+/*
+* Matchmaking stage behind JOIN_ROOM. Handlers only push the player onto a lock-free queue, the matcher thread
+* takes the whole queue every tick and places the batch at once: rooms waiting for a second player are filled first,
+* the rest are paired into fresh rooms from the room pool. ROOM_JOINED of every player placed in a tick goes out
+* in one delivery - the last player placed into a room gets the plain response, the others the room notification.
+* A player left without a partner gets a room of its own right away, the next batch fills it as a waiting room.
+*/
+class Matchmaker {
+public:
+    // Sends the messages of one tick, each is addressed to its player_id
+    using Delivery = std::function<void(const std::vector<ProtocolMessage>&)>;
+
+    Matchmaker(RoomManager* rm, PlayerManager* pm, Logger* lg, int tick_ms);
+    ~Matchmaker();
+
+    Matchmaker(const Matchmaker&) = delete;
+    Matchmaker& operator=(const Matchmaker&) = delete;
+
+    void start(Delivery deliver);
+    /*
+    * Joins the matcher thread, then places every player still queued or waiting for a partner (paired if possible,
+    * alone otherwise) and delivers their messages on the calling thread. Nothing is left behind for a snapshot.
+    */
+    void stop();
+
+    // Queues a JOIN_ROOM, safe from any thread, never blocks
+    void enqueue(const std::string& player_name);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // Node of the lock-free queue, a Treiber stack taken whole by the matcher and reversed into arrival order
+    struct Request {
+        std::string player;
+        Clock::time_point queued;
+        Request* next;
+    };
+
+    struct Waiting {
+        std::string player;
+        Clock::time_point queued;
+    };
+
+    // What the matcher may do with a queued player right now
+    enum class Eligibility {
+        READY,
+        HOLD,       // Temporarily disconnected, stays queued until it reconnects or is cleaned up
+        DROP        // Gone or already in a room
+    };
+
+    RoomManager* roomManager;
+    PlayerManager* playerManager;
+    Logger* logger;
+    std::chrono::milliseconds tick;
+
+    std::atomic<Request*> head{nullptr};
+
+    // Matcher thread only (the stopping thread once it is joined)
+    std::deque<Waiting> pending;
+    std::unordered_set<std::string> pending_names;     // A JOIN_ROOM sent twice is queued once
+    Delivery delivery;
+
+    std::thread matcher;
+    std::atomic<bool> running{false};
+    std::mutex wake_mutex;
+    std::condition_variable wake;
+
+    void run();
+    /*
+    * One batch: moves the queue into pending and places whoever can be placed.
+    * @param flush - nothing stays pending, disconnected players are dropped instead of held
+    */
+    void matchBatch(bool flush);
+    // Appends queued requests to pending in arrival order, skipping players already pending
+    void takeQueued();
+    Eligibility eligibility(const std::string& player_name);
+    /*
+    * Records player as member of room if it is still connected and in the lobby, otherwise takes it out of the room
+    * again and holds it for the next batch (disconnected) or drops it.
+    * @return true if seated
+    */
+    bool seat(const std::string& room_id, Waiting& player, std::deque<Waiting>& held, bool flush);
+    void holdOrDrop(Waiting& player, std::deque<Waiting>& held, bool flush);
+    // Adds ROOM_JOINED for everyone in room, joiner gets the plain response and the others the room notification
+    void announce(const std::string& room_id, const std::string& joiner, std::vector<ProtocolMessage>& messages);
+    void refuse(const Waiting& player, std::vector<ProtocolMessage>& messages);
+};
+
+#endif //MATCHMAKER_H
@@ -0,0 +1,169 @@
+// Metrics.h - Latency histograms and server counters
+// KIV/UPS Network Programming Project
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <string>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include "MessageType.h"
+
+/*
+* In-process metrics registry. Every thread records into its own shard (plain relaxed stores of atomics it alone
+* writes), so recording never takes a lock or bounces a cache line between threads. A scrape sums all shards.
+* Shards of finished threads are kept and reused by new ones, so totals never go backwards.
+*/
+namespace Metrics {
+    enum class Counter : size_t {
+        BYTES_IN,               // Bytes received from clients
+        BYTES_OUT,              // Bytes the kernel accepted for sending
+        MESSAGES_IN,            // Complete client messages processed
+        SEND_FAILURES,          // Messages that could not be written or queued
+        PARTIAL_WRITES,         // Writes where the kernel accepted only part of the offered bytes
+        SLOW_DISCONNECTS,       // Clients dropped for staying above the outbound high-water mark
+        REJECTED_CONNECTIONS,   // Connections closed at accept (max_clients or per-IP accept rate)
+        RATE_LIMITED_MESSAGES,  // Messages dropped by the per-connection rate limit
+        WRITE_CALLS,            // send() / sendmsg() calls on client sockets
+        HANDOFFS_SENT,          // Client connections passed to another node
+        HANDOFFS_RECEIVED,      // Client connections adopted from another node
+        COUNT
+    };
+
+    enum class Timer : size_t {
+        ROOM_LOCK_WAIT,         // Waiting for a room mutex in RoomManager::withRoom
+        ROOM_LOCK_HOLD,         // Holding a room mutex in RoomManager::withRoom
+        HEARTBEAT_SCAN,         // One pass of the heartbeat monitor
+        MATCHMAKING_WAIT,       // JOIN_ROOM queued until the player was placed into a room
+        MATCHMAKING_BATCH,      // One matchmaker batch placing the queued players
+        COUNT
+    };
+
+    // Client -> server types are 0..9, processing time is kept per type
+    constexpr size_t MESSAGE_TYPES = static_cast<size_t>(MessageType::RESYNC) + 1;
+
+    /*
+    * Log-linear (HDR-style) histogram of nanosecond values: every power of two is split into SUB_BUCKETS
+    * equal buckets, so any recorded value is known within 1 / SUB_BUCKETS of itself. Values above 2^MAX_EXPONENT
+    * land in the last bucket. Single writer (shard owner), any number of readers.
+    */
+    class LatencyHistogram {
+    public:
+        static constexpr int SUB_BUCKET_BITS = 3;
+        static constexpr uint64_t SUB_BUCKETS = uint64_t{1} << SUB_BUCKET_BITS;
+        static constexpr int MAX_EXPONENT = 35;                                     // ~34 s
+        static constexpr size_t BUCKETS = (MAX_EXPONENT - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+        static constexpr size_t bucketIndex(uint64_t value) {
+            if (value < SUB_BUCKETS) {
+                return static_cast<size_t>(value);
+            }
+            int exponent = 63 - __builtin_clzll(value);
+            if (exponent >= MAX_EXPONENT) {
+                return BUCKETS - 1;
+            }
+            uint64_t sub_bucket = (value >> (exponent - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1);
+            return static_cast<size_t>(exponent - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + sub_bucket;
+        }
+
+        // Largest value counted in bucket (inclusive)
+        static constexpr uint64_t bucketUpperBound(size_t index) {
+            if (index < SUB_BUCKETS) {
+                return index;
+            }
+            int exponent = static_cast<int>(index / SUB_BUCKETS) + SUB_BUCKET_BITS - 1;
+            uint64_t width = uint64_t{1} << (exponent - SUB_BUCKET_BITS);
+            return ((SUB_BUCKETS + index % SUB_BUCKETS) << (exponent - SUB_BUCKET_BITS)) + width - 1;
+        }
+
+        void record(uint64_t value) {
+            std::atomic<uint64_t>& bucket = buckets[bucketIndex(value)];
+            bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            sum.store(sum.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        }
+
+        // Adds all values of other, caller must be the only writer of this histogram
+        void merge(const LatencyHistogram& other) {
+            for (size_t i = 0; i < BUCKETS; ++i) {
+                buckets[i].store(buckets[i].load(std::memory_order_relaxed)
+                                 + other.buckets[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+            }
+            sum.store(sum.load(std::memory_order_relaxed) + other.sum.load(std::memory_order_relaxed),
+                      std::memory_order_relaxed);
+        }
+
+        uint64_t count() const {
+            uint64_t total = 0;
+            for (const auto& bucket : buckets) {
+                total += bucket.load(std::memory_order_relaxed);
+            }
+            return total;
+        }
+
+        // @return upper bound of the bucket holding the q-th value (0 <= q <= 1), 0 when empty
+        uint64_t quantile(double q) const {
+            uint64_t total = count();
+            if (total == 0) {
+                return 0;
+            }
+            uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(total));
+            if (rank >= total) {
+                rank = total - 1;
+            }
+            uint64_t seen = 0;
+            for (size_t i = 0; i < BUCKETS; ++i) {
+                seen += buckets[i].load(std::memory_order_relaxed);
+                if (seen > rank) {
+                    return bucketUpperBound(i);
+                }
+            }
+            return bucketUpperBound(BUCKETS - 1);
+        }
+
+        std::atomic<uint64_t> buckets[BUCKETS] = {};
+        std::atomic<uint64_t> sum{0};
+    };
+
+    void add(Counter counter, uint64_t value = 1);
+    void record(Timer timer, uint64_t nanoseconds);
+    /*
+    * Records processing time of one client message, types outside 0..MESSAGE_TYPES-1 are ignored
+    */
+    void recordMessage(MessageType type, uint64_t nanoseconds);
+    /*
+    * @return static name of a client message type ("JOIN_ROOM"), "OTHER" outside 0..MESSAGE_TYPES-1
+    */
+    const char* messageTypeName(MessageType type);
+    /*
+    * @return counter summed over all threads
+    */
+    uint64_t total(Counter counter);
+    /*
+    * Appends all counters and histograms in Prometheus text exposition format (version 0.0.4).
+    * Histograms are exported with power-of-two buckets plus p50/p90/p99/p999 gauges taken at full resolution.
+    */
+    void renderPrometheus(std::string& out);
+
+    inline uint64_t elapsedNanoseconds(std::chrono::steady_clock::time_point since) {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - since).count());
+    }
+
+    // Records time from construction to destruction
+    class ScopedTimer {
+    private:
+        Timer timer;
+        std::chrono::steady_clock::time_point start;
+
+    public:
+        explicit ScopedTimer(Timer t) : timer(t), start(std::chrono::steady_clock::now()) {}
+        ~ScopedTimer() { record(timer, elapsedNanoseconds(start)); }
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+    };
+}
+
+#endif //METRICS_H
@@ -3,33 +3,110 @@
 
 #include <string>
 #include <map>
+#include <unordered_map>
 #include <vector>
 #include <mutex>
 #include <chrono>
 #include <cstddef>  // for size_t
 #include <optional>
+#include <queue>
+#include <functional>
 #include "Player.h"
+#include "SlotMap.h"
+
+class SessionDirectory;
+class SnapshotWriter;
+class SnapshotReader;
+
+/*
+* Heartbeat interval clients are told in CONNECTED, by what the player is doing. Any valid frame counts as a sign
+* of life, a client sends PING only after an interval with nothing else to send. A player times out after
+* missed_intervals of its current interval without a frame, but never later than the timeout of its phase.
+*/
+struct HeartbeatSchedule {
+    int lobby_ms = 2000;        // Idle in the lobby
+    int room_ms = 2000;         // In a room, waiting for the game or for the opponent's move
+    int turn_ms = 1000;         // The game waits for this player
+    double missed_intervals = 3.0;
+    int timeout_ms = 6000;          // Longest silence in a room or on turn
+    int lobby_timeout_ms = 6000;    // Longest silence in the lobby
+};
+
+enum class HeartbeatPhase : uint8_t {
+    LOBBY,
+    ROOM,
+    TURN
+};
 
 class PlayerManager {
 private:
+    /*
+    * Scheduled timeout check, ordered by the ping deadline / disconnection start it was scheduled for.
+    * Entries are never updated in place - a newer deadline or disconnect just pushes another entry and
+    * the old one is discarded when it reaches the top and no longer matches the player's state.
+    */
+    struct TimeoutEntry {
+        std::chrono::steady_clock::time_point stamp;
+        PlayerHandle player;
+
+        bool operator>(const TimeoutEntry& other) const { return stamp > other.stamp; }
+    };
+    using TimeoutQueue = std::priority_queue<TimeoutEntry, std::vector<TimeoutEntry>, std::greater<TimeoutEntry>>;
+
+    /*
+    * Names are interned into handles at CONNECT, everything behind the lookup works on handles.
+    * Handles of removed players stop resolving, so stale timeout entries and socket slots are harmless.
+    */
     std::mutex players_mutex;
-    std::map<std::string, Player> players;
-    std::map<int, std::string> socket_to_player;
+    SlotMap<Player> players;
+    std::unordered_map<std::string, PlayerHandle> player_handles;     // Name -> handle
+    std::vector<PlayerHandle> socket_to_player;                         // Indexed by fd, INVALID when unmapped
+    // room_id -> players assigned to it ("" = lobby), kept in sync with Player::room_id under players_mutex
+    std::unordered_map<std::string, std::vector<PlayerHandle>> room_members;
+    TimeoutQueue socket_close_deadlines;    // Socket closed, waiting for player timeout (guarded by players_mutex)
+    TimeoutQueue reconnect_deadlines;       // Temporarily disconnected, waiting for reconnect window (guarded by players_mutex)
 
-    // Heartbeat tracking
-    std::map<std::string, std::chrono::steady_clock::time_point> player_last_ping;
+    // Heartbeat tracking, vectors indexed by handle slot
+    std::vector<std::chrono::steady_clock::time_point> player_last_ping;   // Last valid frame of any type
+    std::vector<HeartbeatPhase> heartbeat_phases;
+    std::vector<std::chrono::steady_clock::time_point> ping_scheduled;     // Deadline of the live ping_deadlines entry, {} if none
     std::mutex heartbeat_mutex;  // Separate mutex for heartbeat operations
+    /*
+    * Connected players by ping deadline (guarded by heartbeat_mutex). A frame only moves player_last_ping,
+    * the entry is pushed back to the new deadline when it comes due, so frames cost no heap operation.
+    */
+    TimeoutQueue ping_deadlines;
+    HeartbeatSchedule heartbeat_schedule;   // Set before any player connects
+
+    // Shared with the other nodes, mirrors which sessions this node owns (nullptr = single process)
+    SessionDirectory* directory = nullptr;
 
 public:
+    /*
+    * Names become unique across all nodes of the directory, sessions and their rooms are published to it.
+    * Call before any player connects.
+    */
+    void setSessionDirectory(SessionDirectory* session_directory) { directory = session_directory; }
+    /*
+    * Call before any player connects. Intervals whose missed_intervals would outlast their phase's timeout are
+    * shortened, so a client pinging on time is never dropped and a dead one is found within the timeout.
+    */
+    void setHeartbeatSchedule(const HeartbeatSchedule& schedule);
+    const HeartbeatSchedule& getHeartbeatSchedule() const { return heartbeat_schedule; }
+
     // Player lifecycle
     std::string connectPlayer(const std::string& player_name, int client_socket);
     void removePlayer(const std::string& player_name);
     void markPlayerTemporarilyDisconnected(const std::string& player_name);
     void removeSocketMapping(int client_socket);
     bool reconnectPlayer(const std::string& player_name, int new_socket);
+    // Player of a room recovered from the game journal, temporarily disconnected with a fresh reconnect window
+    bool restoreDisconnectedPlayer(const std::string& player_name, const std::string& room_id);
 
     // Player lookup
     std::string getPlayerIdFromSocket(int client_socket);
+    // Handle of socket's player, Handles::INVALID if socket has none (no name is copied)
+    PlayerHandle getPlayerHandleFromSocket(int client_socket);
     std::optional<Player> getPlayer(const std::string& player_name);
     bool playerExists(const std::string& player_name);
     std::vector<std::pair<std::string, bool>> getPlayersForHeartbeatCheck();
@@ -42,26 +119,72 @@ public:
 
     // Room management
     void setPlayerRoom(const std::string& player_name, const std::string& room_id);
+    // setPlayerRoom for a connected player still in the lobby, checked under the player lock. False changes nothing.
+    bool seatLobbyPlayer(const std::string& player_name, const std::string& room_id);
     std::string getPlayerRoom(const std::string& player_name);
     void clearPlayerRoom(const std::string& player_name);
 
-    // Heartbeat management (from current server)
+    // Heartbeat management (from current server), any valid frame of the player counts as a ping
     void updateLastPing(const std::string& player_name);
+    void updateLastPing(PlayerHandle player);
+    /*
+    * Moves the room's players to the TURN (player_name) and ROOM (everyone else) heartbeat phase,
+    * empty player_name puts all of them to ROOM
+    */
+    void setTurnPlayer(const std::string& room_id, const std::string& player_name);
     std::chrono::steady_clock::time_point getLastPing(const std::string& player_name);
     void markPlayerDisconnected(const std::string& player_name);
     void markReconnected(const std::string& player_name);
 
-    // Timeout checking
+    /*
+    * Connected players past their ping deadline (heartbeat phase timeout) and players whose socket closed
+    * more than timeout_seconds ago
+    */
     std::vector<std::string> getTimedOutPlayers(int timeout_seconds);
     void cleanupTimedOutPlayers(int timeout_seconds);
 
     // Utility
     std::vector<std::string> getAllPlayers();
     std::vector<std::string> getPlayersInRoom(const std::string& room_id);
+    // Socket of every given player under one lock, -1 for unknown or disconnected players (same order as input)
+    std::vector<int> resolvePlayerSockets(const std::vector<std::string>& player_names);
     size_t getPlayerCount();
 
     // Cleanup
     void cleanup();  // For server shutdown
+
+    /*
+    * Hot restart. Writes every player with its socket, room and how long ago it pinged / disconnected.
+    * The server is paused, nothing changes the players meanwhile.
+    */
+    void saveSnapshot(SnapshotWriter& out);
+    /*
+    * Rebuilds the players of saveSnapshot into an empty manager, timeouts keep counting from where they were.
+    * @param sockets - old socket number -> socket in this process, a connected player whose socket did not
+    *                  come along is treated as if its socket just closed
+    * @return false if the snapshot is malformed
+    */
+    bool loadSnapshot(SnapshotReader& in, const std::unordered_map<int, int>& sockets);
+
+private:
+    // Caller holds players_mutex, records disconnection start and schedules matching timeout check
+    void startDisconnection(PlayerHandle handle, Player& player);
+
+    // Caller holds heartbeat_mutex
+    void ensureHeartbeatSlot(uint32_t slot);
+    std::chrono::milliseconds pingTimeout(HeartbeatPhase phase) const;
+    void schedulePingDeadline(PlayerHandle player, std::chrono::steady_clock::time_point deadline);
+    // Shorter timeout of the new phase brings the deadline forward right away, a longer one applies when it comes due
+    void setHeartbeatPhase(PlayerHandle player, HeartbeatPhase phase);
+
+    // Caller holds players_mutex
+    PlayerHandle findHandle(const std::string& player_name) const;
+    Player* findPlayer(const std::string& player_name, PlayerHandle* handle = nullptr);
+    void mapSocket(int client_socket, PlayerHandle handle);
+    void unmapSocket(int client_socket, PlayerHandle handle);
+    PlayerHandle socketHandle(int client_socket) const;
+    void addToRoomIndex(PlayerHandle handle, const std::string& room_id);
+    void removeFromRoomIndex(PlayerHandle handle, const std::string& room_id);
 };
 
 #endif //PLAYERMANAGER_H
\ No newline at end of file
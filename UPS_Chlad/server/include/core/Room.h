@@ -9,37 +9,38 @@
 #include <vector>
 #include <memory>
 #include <algorithm>
+#include <mutex>
+#include <unordered_map>
 #include "../game/GameLogic.h"
+#include "GameManager.h"
 
 struct Room {
     std::string id;
     std::vector<std::string> players;
     bool active;
     std::unique_ptr<GameLogic> gameLogic;
+    std::unordered_map<std::string, GameStateData> sent_state;  // Last game view sent to each player, base for TURN_UPDATE deltas
 
-    // Add constructor
-    Room() : id(""), active(false), gameLogic(std::make_unique<GameLogic>()) {}
-    Room(const std::string& room_id) : id(room_id), active(false), gameLogic(std::make_unique<GameLogic>()) {}
-
-    // Copy constructor and assignment operator for proper unique_ptr handling
-    Room(const Room& other)
-        : id(other.id), players(other.players), active(other.active),
-          gameLogic(std::make_unique<GameLogic>(*other.gameLogic)) {}
+    // Per-room lock, RoomManager::withRoom holds it for the duration of one operation
+    std::mutex mutex;
+    bool removed;   // Set under mutex once room was dropped from RoomManager index
 
-    Room& operator=(const Room& other) {
-        if (this != &other) {
-            id = other.id;
-            players = other.players;
-            active = other.active;
-            gameLogic = std::make_unique<GameLogic>(*other.gameLogic);
-        }
-        return *this;
+    // Add constructor
+    Room() : Room("") {}
+    Room(const std::string& room_id) : id(room_id), active(false), gameLogic(std::make_unique<GameLogic>()), removed(false) {
+        players.reserve(2);
+        sent_state.reserve(2);
     }
 
+    // Rooms are recycled by RoomPool, never copied (copying would deep-copy the whole game)
+    Room(const Room& other) = delete;
+    Room& operator=(const Room& other) = delete;
+
     // Move constructor and assignment operator
     Room(Room&& other) noexcept
         : id(std::move(other.id)), players(std::move(other.players)),
-          active(other.active), gameLogic(std::move(other.gameLogic)) {}
+          active(other.active), gameLogic(std::move(other.gameLogic)), sent_state(std::move(other.sent_state)),
+          removed(other.removed) {}
 
     Room& operator=(Room&& other) noexcept {
         if (this != &other) {
@@ -47,6 +48,8 @@ struct Room {
             players = std::move(other.players);
             active = other.active;
             gameLogic = std::move(other.gameLogic);
+            sent_state = std::move(other.sent_state);
+            removed = other.removed;
         }
         return *this;
     }
@@ -75,12 +78,18 @@ struct Room {
     }
 
     bool startGame() {
+        return startGame(Random::newSeed());
+    }
+
+    // Same deal for the same seed, journal replay starts the recorded game with it
+    bool startGame(uint64_t seed) {
         if (players.size() < 2) {
             return false;
         }
 
         try {
-            gameLogic->startGame();
+            gameLogic->startGame(seed);
+            sent_state.clear();
             active = true;
             return true;
         } catch (const std::exception&) {
@@ -90,9 +99,18 @@ struct Room {
 
     void resetGame() {
         gameLogic->resetGame();
+        sent_state.clear();
         active = false;
     }
 
+    // Makes a released room new again under another id, keeps every buffer it has grown
+    void recycle(const std::string& room_id) {
+        id = room_id;
+        players.clear();
+        resetGame();
+        removed = false;
+    }
+
     bool isGameActive() const {
         return active && gameLogic->getGameState() == GameState::GAME_STARTED;
     }
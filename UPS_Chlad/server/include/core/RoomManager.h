@@ -6,24 +6,60 @@
 #define ROOMMANAGER_H
 
 #include <string>
-#include <map>
 #include <vector>
+#include <deque>
+#include <memory>
 #include <mutex>
+#include <shared_mutex>
+#include <functional>
 #include <cstddef>  // for size_t
 #include "Room.h"
+#include "RoomPool.h"
+#include "SlotMap.h"
+#include "Metrics.h"
+#include "Tracing.h"
 #include "../game/CardDeck.h"
 
+class SessionDirectory;
+class GameJournal;
+class SnapshotWriter;
+class SnapshotReader;
+
+/*
+* Room index is guarded by a reader-writer lock and only held while looking a room up / inserting / erasing it.
+* Room state itself is guarded by Room::mutex, so operations on different rooms never contend.
+* Lock order: never take index_mutex or waiting_mutex while holding a Room::mutex.
+*
+* Rooms live in a slot map and the protocol room id is "ROOM_<handle>", so resolving an id parses
+* the number and indexes the table instead of hashing the string.
+* Room objects come from a RoomPool holding max_rooms of them, creating a room fails once all are in use.
+* With a session directory, waiting rooms are advertised there so other nodes send their JOIN_ROOMs here.
+* With a game journal, every change of a room's players or game is recorded under the room lock.
+*/
 class RoomManager {
 private:
-    std::mutex rooms_mutex;
-    std::map<std::string, Room> rooms;
-    int next_room_id = 1;          // Add missing member variable
+    RoomPool pool;
+    std::shared_mutex index_mutex;
+    SlotMap<std::shared_ptr<Room>> rooms;
+
+    // Rooms waiting for a second player, entries are validated lazily when popped
+    std::mutex waiting_mutex;
+    std::deque<RoomHandle> waiting_rooms;
+
+    SessionDirectory* directory = nullptr;
+    GameJournal* journal = nullptr;
 
 public:
-    // Constructor to inject PlayerManager dependency
-    RoomManager() {}
+    static constexpr size_t DEFAULT_MAX_ROOMS = 10;
 
-    std::string createRoom();                                    // Returns new room ID
+    explicit RoomManager(size_t max_rooms = DEFAULT_MAX_ROOMS) : pool(max_rooms) {}
+
+    // Set before the server starts, nullptr (default) for a single node
+    void setSessionDirectory(SessionDirectory* session_directory) { directory = session_directory; }
+    void setGameJournal(GameJournal* game_journal) { journal = game_journal; }
+    GameJournal* getGameJournal() const { return journal; }
+
+    std::string createRoom();                                    // Returns new room ID, "" if max_rooms are in use
     bool deleteRoom(const std::string& room_id);
     bool joinRoom(const std::string& player_name, const std::string& room_id);
     bool leaveRoom(const std::string& player_id, const std::string& room_id);
@@ -33,25 +69,73 @@ public:
     bool isRoomFull(const std::string& room_id);               // True if 2 players
     std::vector<std::string> getRoomPlayers(const std::string& room_id);
     size_t getRoomCount();
+    size_t getRoomCapacity() const { return pool.getCapacity(); }
     std::string joinAnyAvailableRoom(const std::string& player_name);  // Fix declaration
+    // Seats player in a room waiting for a second player, "" if no room is waiting (nothing is created)
+    std::string joinWaitingRoom(const std::string& player_name);
+    // New room holding all of player_names, "" if every room is in use
+    std::string createRoomFor(const std::vector<std::string>& player_names);
     bool startGame(const std::string& room_id);
+    /*
+    * Takes a room from the pool, lets rebuild fill it (journal replay) and indexes it if rebuild returns true.
+    * Nothing is recorded in the journal. A room left with one player waits for a second one.
+    * @return new room id, "" if rebuild failed or every room is in use
+    */
+    std::string restoreRoom(const std::function<bool(Room&)>& rebuild);
+
+    /*
+    * Hot restart. Writes every room with its game and the views last sent to its players, plus the waiting queue.
+    * The server is paused, nothing changes the rooms meanwhile.
+    */
+    void saveSnapshot(SnapshotWriter& out);
+    /*
+    * Rebuilds the rooms of saveSnapshot under their old ids, into a manager that has no rooms yet.
+    * @return false if the snapshot is malformed or holds more rooms than max_rooms
+    */
+    bool loadSnapshot(SnapshotReader& in);
 
     // Player timeout handling
     void handlePlayerTimeout(const std::string& player_name, const std::string& room_id);
 
-    // Add this template method for safe room access
+    // Protocol room id of a handle and back, Handles::INVALID for ids that were not issued by createRoom
+    static std::string roomName(RoomHandle handle);
+    static RoomHandle parseRoomId(const std::string& room_id);
+
+    // Add this template method for safe room access, locks only the room touched
     template<typename GameOperation>
     auto withRoom(const std::string& room_id, GameOperation operation) {
-        std::lock_guard<std::mutex> lock(rooms_mutex);
-        auto room_it = rooms.find(room_id);
-        if (room_it == rooms.end()) {
+        return withRoom(parseRoomId(room_id), operation);
+    }
+
+    template<typename GameOperation>
+    auto withRoom(RoomHandle room_handle, GameOperation operation) {
+        std::shared_ptr<Room> room = findRoom(room_handle);
+        if (!room) {
             return operation(nullptr);  // Pass nullptr for invalid room
         }
-        return operation(&room_it->second);  // Pass room reference safely
+        auto wait_start = std::chrono::steady_clock::now();
+        {
+            Tracing::Span wait_span("RoomManager::withRoom lock wait");
+            room->mutex.lock();
+        }
+        std::lock_guard<std::mutex> lock(room->mutex, std::adopt_lock);
+        Metrics::record(Metrics::Timer::ROOM_LOCK_WAIT, Metrics::elapsedNanoseconds(wait_start));
+        Metrics::ScopedTimer hold_timer(Metrics::Timer::ROOM_LOCK_HOLD);    // Destroyed right before unlock
+        if (room->removed) {
+            return operation(nullptr);  // Deleted while we were waiting for the lock
+        }
+        return operation(room.get());  // Pass room reference safely
     }
 
 private:
+    std::shared_ptr<Room> findRoom(const std::string& room_id);
+    std::shared_ptr<Room> findRoom(RoomHandle room_handle);
+    // Drops room from index if it is still the one registered under its id
+    void eraseRoom(const std::shared_ptr<Room>& room);
+    void pushWaitingRoom(RoomHandle room_handle);
+    // Caller holds room.mutex
+    bool joinRoomLocked(Room& room, const std::string& player_id);
 };
 
 
-#endif //ROOMMANAGER_H
\ No newline at end of file
+#endif //ROOMMANAGER_H
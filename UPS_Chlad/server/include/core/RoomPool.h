@@ -0,0 +1,49 @@
+// RoomPool.h - Preallocated pool of game rooms
+// KIV/UPS Network Programming Project
+
+#ifndef ROOMPOOL_H
+#define ROOMPOOL_H
+
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <cstddef>
+#include "Room.h"
+
+/*
+* Fixed set of Room objects (with their GameLogic) allocated once and recycled, sized from max_rooms.
+* A released room may still be referenced by an operation that looked it up before it was dropped from the index,
+* so it waits in draining until the pool holds its only reference and is reset only then.
+*/
+class RoomPool {
+private:
+    std::mutex mutex;
+    size_t capacity;
+    std::vector<std::shared_ptr<Room>> free_rooms;      // Reset, ready to hand out
+    std::vector<std::shared_ptr<Room>> draining;        // Released, possibly still referenced
+    size_t in_use;
+
+    // Moves draining rooms nobody else references to free_rooms, caller holds mutex
+    void collectDrained();
+
+public:
+    /*
+    * Allocates all max_rooms rooms up front, so creating a room during a surge never allocates.
+    */
+    explicit RoomPool(size_t max_rooms);
+
+    /*
+    * Hands out a reset room with given id.
+    * @return nullptr if all max_rooms rooms are in use
+    */
+    std::shared_ptr<Room> acquire(const std::string& room_id);
+    /*
+    * Returns room dropped from the room index, it is reused once the last outside reference is gone.
+    */
+    void release(std::shared_ptr<Room> room);
+
+    size_t getCapacity() const { return capacity; }
+    size_t getInUse();
+};
+
+#endif //ROOMPOOL_H
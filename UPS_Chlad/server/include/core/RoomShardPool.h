@@ -0,0 +1,73 @@
+// RoomShardPool.h - Worker threads running game logic per room shard
+// KIV/UPS Network Programming Project
+
+#ifndef ROOMSHARDPOOL_H
+#define ROOMSHARDPOOL_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstddef>
+
+/*
+* Fixed pool of worker threads, rooms are hashed onto them.
+* Every task posted for the same room (shard) runs on the same thread in posting order, so one room's
+* game actions execute serially like an actor, while different rooms run in parallel on different cores.
+* Lobby work (players without a room, room_id "") has its own shard as well.
+*/
+class RoomShardPool {
+public:
+    using Task = std::function<void()>;
+
+    /*
+    * @param shard_count - number of worker threads (at least 1)
+    */
+    explicit RoomShardPool(size_t shard_count);
+    ~RoomShardPool();
+
+    RoomShardPool(const RoomShardPool&) = delete;
+    RoomShardPool& operator=(const RoomShardPool&) = delete;
+
+    void start();
+    /*
+    * Finishes all already posted tasks and joins worker threads. Tasks posted afterwards are dropped.
+    */
+    void stop();
+
+    /*
+    * @return shard index owning the room
+    */
+    size_t shardFor(const std::string& room_id) const;
+    /*
+    * Queues task on given shard.
+    * @return false if pool is not running (task dropped)
+    */
+    bool post(size_t shard, Task task);
+    /*
+    * @return number of tasks waiting in shard queue
+    */
+    size_t queueDepth(size_t shard);
+
+    size_t shardCount() const { return shards.size(); }
+
+private:
+    struct Shard {
+        std::mutex queue_mutex;
+        std::condition_variable queue_cv;
+        std::deque<Task> tasks;
+        std::thread worker;
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards;
+    std::atomic<bool> running;
+
+    void workerLoop(Shard* shard);
+};
+
+#endif //ROOMSHARDPOOL_H
@@ -0,0 +1,109 @@
+// SessionDirectory.h - Shared-memory session directory of the nodes on one host
+// KIV/UPS Network Programming Project
+
+#ifndef SESSIONDIRECTORY_H
+#define SESSIONDIRECTORY_H
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include "SlotMap.h"
+
+/*
+* Session directory shared by all server processes (nodes) of one host, kept in POSIX shared memory.
+* Records which node owns each player session (and the room it sits in there) and which nodes have a room
+* waiting for a second player, so a node that receives RECONNECT or JOIN_ROOM for someone else's session
+* or seat knows where to hand the connection (NodeChannel).
+*
+* Fixed-size open addressing table behind one process-shared robust mutex - a node that dies while holding it
+* does not block the others. A node counts as alive while its process exists, sessions and seats of dead
+* nodes are ignored and get overwritten or purged when the node id is started again.
+*/
+class SessionDirectory {
+public:
+    static constexpr int MAX_NODES = 64;
+    static constexpr int NO_NODE = -1;
+    static constexpr size_t MAX_NAME_LENGTH = 32;       // Same limit as handleConnect
+    static constexpr size_t MAX_ROOM_ID_LENGTH = 23;
+    static constexpr size_t MAX_OPEN_SEATS = 256;
+    static constexpr size_t DEFAULT_CAPACITY = 65536;   // Sessions over all nodes, ~3 MB of shared memory
+
+    SessionDirectory();
+    ~SessionDirectory();
+    SessionDirectory(const SessionDirectory&) = delete;
+    SessionDirectory& operator=(const SessionDirectory&) = delete;
+
+    /*
+    * Maps (creating on first use) the directory and registers this process as node_id.
+    * Sessions and seats a previous process with the same node id left behind are dropped.
+    * @param name - shared memory object name, "/gamba_sessions" style
+    * @param error - reason on failure (bad name, node id taken by a running process, ...)
+    */
+    bool open(const std::string& name, int node_id, std::string& error, size_t capacity = DEFAULT_CAPACITY);
+    /*
+    * Drops this node's sessions and seats and unmaps the directory, the object itself stays for the other nodes.
+    */
+    void close();
+    bool isOpen() const { return header != nullptr; }
+    int getNodeId() const { return node_id; }
+    const std::string& getName() const { return name; }
+
+    /*
+    * Makes this node the owner of player's session.
+    * @return false if another live node owns it or the directory is full
+    */
+    bool claim(const std::string& player_name);
+    /*
+    * Forgets player's session if this node owns it.
+    */
+    void release(const std::string& player_name);
+    /*
+    * Moves session from from_node to to_node.
+    * @return false if the session is not owned by from_node
+    */
+    bool transfer(const std::string& player_name, int from_node, int to_node);
+    /*
+    * @return live node owning player's session, NO_NODE if none does
+    */
+    int findOwner(const std::string& player_name);
+    /*
+    * Records room the player sits in on its node ("" = lobby), only for sessions this node owns.
+    */
+    void setRoom(const std::string& player_name, const std::string& room_id);
+
+    /*
+    * Advertises / withdraws this node's room waiting for a second player.
+    */
+    void offerSeat(RoomHandle room);
+    void withdrawSeat(RoomHandle room);
+    /*
+    * Where a lobby player's JOIN_ROOM should be served - this node if it offers a seat itself,
+    * otherwise a live node that does.
+    * @return node id, NO_NODE if no node has a waiting room
+    */
+    int findSeatNode();
+
+    size_t getCapacity() const;
+
+private:
+    struct Header;
+    struct Entry;
+
+    std::string name;
+    int node_id;
+    Header* header;
+    Entry* entries;
+    size_t mapped_size;
+
+    // Lock / unlock the shared mutex, recovering it if its previous holder died
+    void lock();
+    void unlock();
+
+    // Caller holds the lock
+    bool isNodeAlive(int node) const;
+    size_t findSlot(const std::string& player_name) const;     // Slot holding the name, capacity if absent
+    void eraseSlot(size_t slot);
+    void purgeNode(int node);
+};
+
+#endif //SESSIONDIRECTORY_H
@@ -0,0 +1,146 @@
+// SlotMap.h - Generational slot map with stable handles
+// KIV/UPS Network Programming Project
+
+#ifndef SLOTMAP_H
+#define SLOTMAP_H
+
+#include <vector>
+#include <optional>
+#include <cstdint>
+#include <cstddef>
+#include <stdexcept>
+#include <algorithm>
+
+/*
+* Dense 32-bit handle of a slot map entry: low INDEX_BITS are the slot index, the rest is the slot's generation.
+* Index 0 is never handed out, so 0 is always invalid. A slot's generation changes when its entry is erased,
+* so a handle kept after erase never resolves to the entry that later reuses the slot.
+*/
+using Handle = uint32_t;
+using PlayerHandle = Handle;
+using RoomHandle = Handle;
+
+namespace Handles {
+    constexpr Handle INVALID = 0;
+    constexpr int INDEX_BITS = 20;
+    constexpr uint32_t INDEX_MASK = (uint32_t{1} << INDEX_BITS) - 1;
+    constexpr uint32_t GENERATION_MASK = (uint32_t{1} << (32 - INDEX_BITS)) - 1;
+
+    constexpr uint32_t index(Handle handle) { return handle & INDEX_MASK; }
+    constexpr uint32_t generation(Handle handle) { return handle >> INDEX_BITS; }
+    constexpr Handle make(uint32_t index, uint32_t generation) {
+        return (generation << INDEX_BITS) | index;
+    }
+}
+
+/*
+* Entries stored by value in one vector and addressed by Handle, lookups are an index and a generation compare.
+* Erased slots are reused (LIFO) so the table stays as large as the peak number of live entries.
+* Not thread safe, owners guard it with their own lock.
+*/
+template <typename T>
+class SlotMap {
+private:
+    struct Slot {
+        std::optional<T> value;
+        uint32_t generation = 0;
+    };
+
+    std::vector<Slot> slots = std::vector<Slot>(1);    // Slot 0 stays empty, handle 0 is invalid
+    std::vector<uint32_t> free_slots;
+    size_t count = 0;
+
+public:
+    Handle insert(T value) {
+        uint32_t index;
+        if (!free_slots.empty()) {
+            index = free_slots.back();
+            free_slots.pop_back();
+        } else {
+            if (slots.size() > Handles::INDEX_MASK) {
+                throw std::runtime_error("Slot map is full");
+            }
+            index = static_cast<uint32_t>(slots.size());
+            slots.emplace_back();
+        }
+        slots[index].value.emplace(std::move(value));
+        count++;
+        return Handles::make(index, slots[index].generation);
+    }
+
+    /*
+    * Puts value under a handle issued earlier (possibly by another process, hot restart keeps room ids).
+    * @return false if the slot is taken or the index is out of range
+    */
+    bool insertAt(Handle handle, T value) {
+        uint32_t index = Handles::index(handle);
+        if (index == 0 || index > Handles::INDEX_MASK) {
+            return false;
+        }
+        while (slots.size() <= index) {
+            free_slots.push_back(static_cast<uint32_t>(slots.size()));
+            slots.emplace_back();
+        }
+        Slot& slot = slots[index];
+        if (slot.value) {
+            return false;
+        }
+        free_slots.erase(std::find(free_slots.begin(), free_slots.end(), index));
+        slot.generation = Handles::generation(handle);
+        slot.value.emplace(std::move(value));
+        count++;
+        return true;
+    }
+
+    T* get(Handle handle) {
+        uint32_t index = Handles::index(handle);
+        if (index == 0 || index >= slots.size()) {
+            return nullptr;
+        }
+        Slot& slot = slots[index];
+        if (!slot.value || slot.generation != Handles::generation(handle)) {
+            return nullptr;
+        }
+        return &*slot.value;
+    }
+
+    const T* get(Handle handle) const {
+        return const_cast<SlotMap*>(this)->get(handle);
+    }
+
+    bool erase(Handle handle) {
+        if (!get(handle)) {
+            return false;
+        }
+        uint32_t index = Handles::index(handle);
+        Slot& slot = slots[index];
+        slot.value.reset();
+        slot.generation = (slot.generation + 1) & Handles::GENERATION_MASK;
+        free_slots.push_back(index);
+        count--;
+        return true;
+    }
+
+    void clear() {
+        for (size_t index = 1; index < slots.size(); ++index) {
+            if (slots[index].value) {
+                erase(Handles::make(static_cast<uint32_t>(index), slots[index].generation));
+            }
+        }
+    }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    // Calls fn(Handle, T&) for every live entry in slot order
+    template <typename Fn>
+    void forEach(Fn&& fn) {
+        for (size_t index = 1; index < slots.size(); ++index) {
+            if (slots[index].value) {
+                fn(Handles::make(static_cast<uint32_t>(index), slots[index].generation), *slots[index].value);
+            }
+        }
+    }
+};
+
+#endif //SLOTMAP_H
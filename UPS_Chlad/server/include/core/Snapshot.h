@@ -0,0 +1,93 @@
+// Snapshot.h - Server state encoding for hot restart
+// KIV/UPS Network Programming Project
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <cstddef>
+
+/*
+* Little-endian encoding of the server state a hot restart hands to the new process.
+* Only both ends of one restart read it (same build or the next one), so there is a version byte but no schema.
+*/
+class SnapshotWriter {
+private:
+    std::string& out;
+
+public:
+    explicit SnapshotWriter(std::string& buffer) : out(buffer) {}
+
+    void u8(uint8_t value) { out.push_back(static_cast<char>(value)); }
+    void u32(uint32_t value) { appendLittleEndian(value, 4); }
+    void u64(uint64_t value) { appendLittleEndian(value, 8); }
+    void i64(int64_t value) { u64(static_cast<uint64_t>(value)); }
+    void boolean(bool value) { u8(value ? 1 : 0); }
+    // 32-bit length, then the bytes
+    void text(std::string_view value) {
+        u32(static_cast<uint32_t>(value.size()));
+        out.append(value.data(), value.size());
+    }
+
+private:
+    void appendLittleEndian(uint64_t value, int bytes) {
+        for (int i = 0; i < bytes; ++i) {
+            out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+        }
+    }
+};
+
+/*
+* Reads what SnapshotWriter wrote. Reading past the end returns zeros and clears ok(), so a caller decodes a whole
+* section and checks ok() once.
+*/
+class SnapshotReader {
+private:
+    std::string_view data;
+    size_t offset;
+    bool valid;
+
+public:
+    explicit SnapshotReader(std::string_view input) : data(input), offset(0), valid(true) {}
+
+    uint8_t u8() { return static_cast<uint8_t>(readLittleEndian(1)); }
+    uint32_t u32() { return static_cast<uint32_t>(readLittleEndian(4)); }
+    uint64_t u64() { return readLittleEndian(8); }
+    int64_t i64() { return static_cast<int64_t>(u64()); }
+    bool boolean() { return u8() != 0; }
+    std::string text() {
+        uint32_t length = u32();
+        if (!valid || length > data.size() - offset) {
+            valid = false;
+            return std::string();
+        }
+        std::string value(data.substr(offset, length));
+        offset += length;
+        return value;
+    }
+
+    bool ok() const { return valid; }
+    bool atEnd() const { return offset == data.size(); }
+    /*
+    * Marks the data invalid, for values that decoded fine but make no sense
+    */
+    void fail() { valid = false; }
+
+private:
+    uint64_t readLittleEndian(int bytes) {
+        if (!valid || data.size() - offset < static_cast<size_t>(bytes)) {
+            valid = false;
+            return 0;
+        }
+        uint64_t value = 0;
+        for (int i = 0; i < bytes; ++i) {
+            value |= static_cast<uint64_t>(static_cast<unsigned char>(data[offset + i])) << (8 * i);
+        }
+        offset += static_cast<size_t>(bytes);
+        return value;
+    }
+};
+
+#endif //SNAPSHOT_H
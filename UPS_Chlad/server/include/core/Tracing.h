@@ -0,0 +1,172 @@
+// Tracing.h - Sampled request tracing
+// KIV/UPS Network Programming Project
+
+#ifndef TRACING_H
+#define TRACING_H
+
+#include <string>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+
+/*
+* Sampled request tracing. A Trace at the top of a unit of work (one read of a client, one shard task, one log flush)
+* decides whether that unit is sampled, every Trace and Span below it on the same thread records only if it is.
+* Spans go into a fixed ring per thread (oldest overwritten), a dump renders all rings as Chrome trace-event JSON
+* (chrome://tracing, Perfetto). With the sample rate at 0 a Trace is one relaxed load and a Span one thread-local read.
+*
+* Names and details must be string literals (or other static strings), only the pointer is kept.
+*/
+namespace Tracing {
+    namespace detail {
+        enum class State : uint8_t {
+            NONE,       // No trace running on this thread
+            SKIPPED,    // Trace running, not sampled
+            SAMPLED
+        };
+
+        inline std::atomic<uint64_t> sample_threshold{0};     // Sampled if a random 64-bit value is below, 0 = off
+        inline thread_local State state = State::NONE;
+        inline thread_local uint64_t trace_id = 0;
+
+        bool shouldSample();
+        uint64_t newTraceId();
+        void record(const char* name, const char* detail, uint64_t start_ns, uint64_t end_ns);
+
+        inline uint64_t now() {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+    }
+
+    /*
+    * @param sample_rate - fraction of traces recorded, 0 turns tracing off, 1 records everything
+    * @param buffer_spans - ring size per thread, applies to threads recording their first span afterwards
+    */
+    void configure(double sample_rate, size_t buffer_spans);
+    inline bool enabled() { return detail::sample_threshold.load(std::memory_order_relaxed) != 0; }
+
+    // Names the calling thread in dumps ("reactor", "shard 2")
+    void nameThread(const std::string& name);
+
+    /*
+    * Id of the sampled trace running on this thread, 0 if none. Work handed to another thread passes it on
+    * so the other thread continues the same trace.
+    */
+    inline uint64_t currentTrace() {
+        return detail::state == detail::State::SAMPLED ? detail::trace_id : 0;
+    }
+
+    // Timestamp to hand to spanSince later, 0 when the thread is not inside a sampled trace
+    inline uint64_t sampledNow() {
+        return detail::state == detail::State::SAMPLED ? detail::now() : 0;
+    }
+
+    /*
+    * Records a span from start_ns (sampledNow() taken earlier, possibly on another thread) until now, e.g. the time
+    * a task waited in a queue. Nothing is recorded for start_ns 0 or outside a sampled trace.
+    */
+    inline void spanSince(const char* name, uint64_t start_ns) {
+        if (start_ns != 0 && detail::state == detail::State::SAMPLED) {
+            detail::record(name, nullptr, start_ns, detail::now());
+        }
+    }
+
+    // Span recorded when the thread is inside a sampled trace
+    class Span {
+    private:
+        const char* name;
+        const char* detail_text;
+        uint64_t start;
+
+    public:
+        explicit Span(const char* span_name, const char* span_detail = nullptr)
+            : name(nullptr), detail_text(span_detail), start(0) {
+            if (detail::state == detail::State::SAMPLED) {
+                name = span_name;
+                start = detail::now();
+            }
+        }
+        ~Span() {
+            if (name) {
+                detail::record(name, detail_text, start, detail::now());
+            }
+        }
+
+        // Detail shown with the span, e.g. the message type once it is parsed
+        void setDetail(const char* span_detail) { detail_text = span_detail; }
+
+        Span(const Span&) = delete;
+        Span& operator=(const Span&) = delete;
+    };
+
+    /*
+    * Starts a trace (sampling decision) or, inside one, acts as a Span. The trace ends with the outermost Trace.
+    */
+    class Trace {
+    private:
+        const char* name;
+        const char* detail_text;
+        uint64_t start;
+        bool root;
+
+        void open(const char* span_name) {
+            if (detail::state == detail::State::SAMPLED) {
+                name = span_name;
+                start = detail::now();
+            }
+        }
+
+    public:
+        explicit Trace(const char* span_name, const char* span_detail = nullptr)
+            : name(nullptr), detail_text(span_detail), start(0), root(false) {
+            if (detail::state == detail::State::NONE && enabled()) {
+                root = true;
+                bool sampled = detail::shouldSample();
+                detail::state = sampled ? detail::State::SAMPLED : detail::State::SKIPPED;
+                detail::trace_id = sampled ? detail::newTraceId() : 0;
+            }
+            open(span_name);
+        }
+
+        /*
+        * Continues a trace started on another thread (currentTrace() there), 0 continues an unsampled one.
+        */
+        Trace(const char* span_name, uint64_t continued_trace)
+            : name(nullptr), detail_text(nullptr), start(0), root(false) {
+            if (detail::state == detail::State::NONE && enabled()) {
+                root = true;
+                detail::state = continued_trace != 0 ? detail::State::SAMPLED : detail::State::SKIPPED;
+                detail::trace_id = continued_trace;
+            }
+            open(span_name);
+        }
+
+        ~Trace() {
+            if (name) {
+                detail::record(name, detail_text, start, detail::now());
+            }
+            if (root) {
+                detail::state = detail::State::NONE;
+            }
+        }
+
+        void setDetail(const char* span_detail) { detail_text = span_detail; }
+
+        Trace(const Trace&) = delete;
+        Trace& operator=(const Trace&) = delete;
+    };
+
+    /*
+    * Appends every buffered span of every thread as a Chrome trace-event JSON object.
+    */
+    void renderChromeTrace(std::string& out);
+    /*
+    * Writes renderChromeTrace to path.
+    * @param error - reason on failure
+    */
+    bool writeChromeTrace(const std::string& path, std::string& error);
+}
+
+#endif //TRACING_H
@@ -17,10 +17,74 @@ struct ServerConfig {
     int invalid_message_limit = 3;
     std::string log_file = "logs/gamba_server.log";
     bool enable_file_logging = true;
+    int log_flush_interval_ms = 100;      // How often the log writer thread writes queued records out
 
     // Heartbeat timeout settings
     int player_timeout_seconds = 6;        // How long before player is considered disconnected
     int heartbeat_check_interval = 2;      // How often to check for timeouts (in seconds)
+    int reconnect_window_seconds = 120;    // How long a timed out player may reconnect before being removed
+    // Ping interval advertised in CONNECTED, any frame counts as a ping. Players in a room use heartbeat_interval_ms
+    // and time out after player_timeout_seconds, idle lobby players and the player on turn use their own interval
+    // and time out after the same number of missed intervals - never later than player_timeout_seconds
+    // (lobby_timeout_seconds in the lobby, 0 = the same). Longer intervals are shortened to fit.
+    int heartbeat_interval_ms = 2000;
+    int heartbeat_lobby_interval_ms = 2000;
+    int heartbeat_turn_interval_ms = 1000;
+    int lobby_timeout_seconds = 0;
+
+    // Network I/O model: "epoll" (single reactor thread), "io_uring" (reactor on io_uring, epoll on kernels
+    // older than 6.0) or "threaded" (one thread per client)
+    std::string io_mode = "epoll";
+    int worker_threads = 4;                // Room shard worker threads in epoll mode (0 = run game logic on reactor thread)
+
+    // JOIN_ROOMs are queued and paired by the matchmaker thread every tick (0 = join right away in the handler).
+    // A player without a partner gets a room of its own right away and the next tick fills it.
+    int matchmaking_tick_ms = 5;
+
+    // Outbound backpressure: clients whose send queue stays above the mark longer than grace period are dropped
+    int outbound_high_water_bytes = 262144;
+    int slow_client_grace_ms = 5000;
+    bool tcp_nodelay = true;               // Disable Nagle on client sockets, responses are coalesced per socket already
+
+    // Admission control: new connections per second from one IP and messages per second per connection (0 = unlimited).
+    // The burst is taken at once before the rate applies (NAT, reconnect storms). Rejected messages are answered
+    // with ERROR, rate_limit_strikes rejections in a row disconnect the client.
+    int accept_rate_per_ip = 0;
+    int accept_burst_per_ip = 50;
+    int client_message_rate = 0;
+    int client_message_burst = 100;
+    int rate_limit_strikes = 5;
+
+    // Admin endpoint serving Prometheus metrics at http://admin_ip:admin_port/metrics (0 = disabled),
+    // admin_port + node_id for nodes of a session directory
+    std::string admin_ip = "127.0.0.1";
+    int admin_port = 0;
+
+    // Several server processes (nodes) on one port: SO_REUSEPORT spreads accepted connections over them, the
+    // shared memory session directory tells each node where a session or a waiting room lives ("" = single process)
+    bool reuse_port = false;
+    std::string session_directory = "";
+    int node_id = 0;                       // Unique per process sharing the directory, 0-63
+
+    // Per-room game journal for crash recovery and replays ("" = disabled). Records are group-committed every
+    // journal_flush_ms, journal_sync adds one fdatasync per touched file to each commit.
+    std::string journal_dir = "";
+    int journal_flush_ms = 5;
+    bool journal_sync = true;
+    bool journal_keep_finished = true;     // Keep journals of closed rooms as <room>-<ms>.replay
+    std::string replay_file = "";          // --replay FILE: print the game in FILE and exit
+
+    // Hot restart (io_mode=epoll, single process): the server listens on this abstract Unix socket name, a new
+    // binary started with --takeover connects, gets the listening socket, every client socket and the game state,
+    // and continues without clients noticing ("" = disabled)
+    std::string hot_restart_socket = "";
+    bool takeover = false;                 // --takeover: take the server over from the process on hot_restart_socket
+
+    // Sampled request tracing: fraction of client reads / shard tasks traced (0 = off), ring of spans kept per thread,
+    // file SIGUSR2 writes the Chrome trace-event JSON to (the admin endpoint serves it at /trace)
+    double trace_sample_rate = 0.0;
+    int trace_buffer_spans = 65536;
+    std::string trace_file = "gamba_trace.json";
 
     bool loadFromFile(const std::string& filename);
     void parseCommandLine(int argc, char* argv[]);
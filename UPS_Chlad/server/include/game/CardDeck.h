@@ -7,6 +7,8 @@
 
 #include <vector>
 #include <string>
+#include "CardSet.h"
+#include "Random.h"
 
 enum class Suit {
     HEARTS, DIAMONDS, CLUBS, SPADES
@@ -22,6 +24,10 @@ struct Card {
     Rank rank;
 
     Card(Suit s, Rank r) : suit(s), rank(r) {}
+    explicit Card(CardId id) : suit(static_cast<Suit>(cardSuit(id))), rank(static_cast<Rank>(cardRank(id))) {}
+
+    // Get compact card id
+    CardId id() const { return makeCardId(static_cast<int>(suit), static_cast<int>(rank)); }
 
     // Get rank value for comparison
     int getValue() const;
@@ -35,19 +41,19 @@ struct Card {
 
 class CardDeck {
 private:
-    std::vector<Card> cards;
+    CardStack<DECK_SIZE> cards;
 
 public:
-    CardDeck();
+    CardDeck();     // Empty, startGame fills it with initializeStandardDeck
 
     // Initialize with standard 52-card deck
     void initializeStandardDeck();
 
-    // Shuffle the deck
-    void shuffle();
+    // Shuffle the deck, same generator state gives the same order
+    void shuffle(Xoshiro256& generator);
 
     // Deal a card (removes from deck)
-    Card dealCard();
+    CardId dealCard();
 
     // Check if deck is empty
     bool isEmpty() const;
@@ -59,7 +65,10 @@ public:
     void clear();
 
     // Add cards back to deck (for recycling discard pile)
-    void addCards(const std::vector<Card>& cardsToAdd);
+    void addCards(const CardId* first, const CardId* last);
+
+    // Remaining cards, the next card dealt is the last one
+    const CardStack<DECK_SIZE>& getCards() const { return cards; }
 };
 
 #endif //CARDDECK_H
\ No newline at end of file
@@ -0,0 +1,243 @@
+// CardSet.h - One-byte cards and card bitsets
+// KIV/UPS Network Programming Project
+
+#ifndef CARDSET_H
+#define CARDSET_H
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <stdexcept>
+
+/*
+* One byte card identifier: id = (rank - 2) * 4 + suit, so 0 is 2H and 51 is AS.
+* Cards of one rank occupy four consecutive ids, which makes rank checks a mask test
+* and keeps a CardSet iterated in ascending rank order.
+*/
+using CardId = uint8_t;
+
+constexpr int DECK_SIZE = 52;
+constexpr int SUIT_COUNT = 4;
+constexpr int LOWEST_RANK = 2;
+constexpr int HIGHEST_RANK = 14;
+
+constexpr CardId makeCardId(int suit, int rank) {
+    return static_cast<CardId>((rank - LOWEST_RANK) * SUIT_COUNT + suit);
+}
+
+constexpr int cardSuit(CardId id) {
+    return id % SUIT_COUNT;
+}
+
+constexpr int cardRank(CardId id) {
+    return id / SUIT_COUNT + LOWEST_RANK;
+}
+
+namespace CardNames {
+    inline constexpr char RANK_CHARS[] = "23456789TJQKA";
+    inline constexpr char SUIT_CHARS[] = "HDCS";
+
+    struct Name {
+        char text[4];
+        uint8_t length;
+    };
+
+    constexpr std::array<Name, DECK_SIZE> buildNames() {
+        std::array<Name, DECK_SIZE> names{};
+        for (int id = 0; id < DECK_SIZE; ++id) {
+            Name& name = names[id];
+            int rank = cardRank(static_cast<CardId>(id));
+            if (rank == 10) {
+                name.text[0] = '1';
+                name.text[1] = '0';
+                name.length = 2;
+            } else {
+                name.text[0] = RANK_CHARS[rank - LOWEST_RANK];
+                name.length = 1;
+            }
+            name.text[name.length++] = SUIT_CHARS[cardSuit(static_cast<CardId>(id))];
+            name.text[name.length] = '\0';
+        }
+        return names;
+    }
+
+    inline constexpr std::array<Name, DECK_SIZE> NAMES = buildNames();
+}
+
+/*
+* @return protocol name of the card ("10H", "AS"), points into a static table
+*/
+constexpr std::string_view cardName(CardId id) {
+    return std::string_view(CardNames::NAMES[id].text, CardNames::NAMES[id].length);
+}
+
+/*
+* Parses a protocol card name ("7D", "10S", "QH")
+* @return false if the text is not a card of the standard deck
+*/
+constexpr bool parseCardId(std::string_view text, CardId& out) {
+    if (text.size() < 2 || text.size() > 3) {
+        return false;
+    }
+
+    int suit = -1;
+    for (int s = 0; s < SUIT_COUNT; ++s) {
+        if (CardNames::SUIT_CHARS[s] == text.back()) {
+            suit = s;
+        }
+    }
+    if (suit < 0) {
+        return false;
+    }
+
+    int rank = -1;
+    if (text.size() == 3) {
+        if (text[0] == '1' && text[1] == '0') {
+            rank = 10;
+        }
+    } else {
+        for (int r = LOWEST_RANK; r <= HIGHEST_RANK; ++r) {
+            if (r != 10 && CardNames::RANK_CHARS[r - LOWEST_RANK] == text[0]) {
+                rank = r;
+            }
+        }
+    }
+    if (rank < 0) {
+        return false;
+    }
+
+    out = makeCardId(suit, rank);
+    return true;
+}
+
+/*
+* Set of cards stored as a 64-bit mask, bit n set means card id n is present.
+* Membership, insertion and removal are single bit operations, and because a deck holds
+* every card exactly once a hand never needs duplicates.
+*/
+class CardSet {
+private:
+    uint64_t bits;
+
+public:
+    constexpr CardSet() : bits(0) {}
+    constexpr explicit CardSet(uint64_t mask) : bits(mask) {}
+
+    static constexpr CardSet of(CardId id) {
+        return CardSet(uint64_t{1} << id);
+    }
+
+    // All four cards of a rank
+    static constexpr CardSet ofRank(int rank) {
+        return CardSet(uint64_t{0xF} << ((rank - LOWEST_RANK) * SUIT_COUNT));
+    }
+
+    // All cards of value at most rank (2 up to rank)
+    static constexpr CardSet upToRank(int rank) {
+        return CardSet((uint64_t{1} << ((rank - LOWEST_RANK + 1) * SUIT_COUNT)) - 1);
+    }
+
+    constexpr uint64_t mask() const { return bits; }
+    constexpr bool empty() const { return bits == 0; }
+    constexpr size_t size() const { return static_cast<size_t>(__builtin_popcountll(bits)); }
+
+    constexpr bool contains(CardId id) const { return (bits >> id) & 1; }
+    constexpr bool containsAll(CardSet other) const { return (bits & other.bits) == other.bits; }
+    constexpr bool intersects(CardSet other) const { return (bits & other.bits) != 0; }
+
+    constexpr void insert(CardId id) { bits |= uint64_t{1} << id; }
+    constexpr void erase(CardId id) { bits &= ~(uint64_t{1} << id); }
+    constexpr void insertAll(CardSet other) { bits |= other.bits; }
+    constexpr void eraseAll(CardSet other) { bits &= ~other.bits; }
+    constexpr void clear() { bits = 0; }
+
+    // Lowest card id in the set, set must not be empty
+    constexpr CardId lowest() const { return static_cast<CardId>(__builtin_ctzll(bits)); }
+
+    // true if every card in the set has the same rank (vacuously true when empty)
+    constexpr bool sameRank() const {
+        return empty() || ofRank(cardRank(lowest())).containsAll(*this);
+    }
+
+    constexpr CardSet operator&(CardSet other) const { return CardSet(bits & other.bits); }
+    constexpr CardSet operator|(CardSet other) const { return CardSet(bits | other.bits); }
+    constexpr bool operator==(CardSet other) const { return bits == other.bits; }
+    constexpr bool operator!=(CardSet other) const { return bits != other.bits; }
+
+    // Calls fn(CardId) for every card in ascending id order
+    template <typename Fn>
+    void forEach(Fn&& fn) const {
+        for (uint64_t rest = bits; rest != 0; rest &= rest - 1) {
+            fn(static_cast<CardId>(__builtin_ctzll(rest)));
+        }
+    }
+
+    // Appends comma separated card names ("2H,7D,10S")
+    void appendNames(std::string& out) const {
+        bool first = true;
+        forEach([&](CardId id) {
+            if (!first) out += ',';
+            out += cardName(id);
+            first = false;
+        });
+    }
+};
+
+/*
+* Fixed-capacity stack of cards (deck, discard pile, reserves).
+* Lives inline in its owner, pushing and popping never touches the heap.
+*/
+template <size_t Capacity>
+class CardStack {
+private:
+    std::array<CardId, Capacity> cards;
+    size_t count;
+
+public:
+    CardStack() : cards{}, count(0) {}
+
+    bool empty() const { return count == 0; }
+    size_t size() const { return count; }
+    static constexpr size_t capacity() { return Capacity; }
+
+    void push(CardId id) {
+        if (count == Capacity) {
+            throw std::runtime_error("Card stack is full");
+        }
+        cards[count++] = id;
+    }
+
+    CardId pop() {
+        if (count == 0) {
+            throw std::runtime_error("Card stack is empty");
+        }
+        return cards[--count];
+    }
+
+    CardId back() const {
+        if (count == 0) {
+            throw std::runtime_error("Card stack is empty");
+        }
+        return cards[count - 1];
+    }
+
+    void clear() { count = 0; }
+
+    CardId* begin() { return cards.data(); }
+    CardId* end() { return cards.data() + count; }
+    const CardId* begin() const { return cards.data(); }
+    const CardId* end() const { return cards.data() + count; }
+
+    // Cards of the stack as a set (order is lost)
+    CardSet toSet() const {
+        CardSet set;
+        for (CardId id : *this) {
+            set.insert(id);
+        }
+        return set;
+    }
+};
+
+#endif //CARDSET_H
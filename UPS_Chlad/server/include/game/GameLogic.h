@@ -6,9 +6,12 @@
 #define GAMELOGIC_H
 
 #include "CardDeck.h"
+#include "CardSet.h"
+#include "Random.h"
 #include <vector>
 #include <string>
-#include <map>
+#include <array>
+#include <cstdint>
 
 enum class GameState {
     WAITING_FOR_PLAYERS,
@@ -16,35 +19,69 @@ enum class GameState {
     GAME_FINISHED
 };
 
+constexpr size_t RESERVE_COUNT = 3;
+constexpr size_t MAX_SEATS = 6;        // 6 seats x 6 cards + the first pile card still fit one deck
+constexpr size_t NO_SEAT = SIZE_MAX;
+
 struct PlayerHand {
-    std::vector<Card> hand;           // Cards in hand (up to 3)
-    std::vector<Card> reserves;       // Face-down reserve cards (up to 3)
+    CardSet hand;                           // Cards in hand (3, or more after picking up the pile)
+    CardStack<RESERVE_COUNT> reserves;      // Face-down reserve cards (up to 3)
     std::string playerId;
 
+    PlayerHand() = default;
     PlayerHand(const std::string& id) : playerId(id) {}
 };
 
+/*
+* Complete state of one game. Restoring it continues the game exactly where it was saved, including
+* every future shuffle (hot restart hands running games to the new process this way).
+*/
+struct GameSnapshot {
+    struct Seat {
+        std::string playerId;
+        CardSet hand;
+        std::vector<CardId> reserves;   // Bottom first
+    };
+
+    std::vector<CardId> deck;           // Bottom first, the last card is dealt next
+    std::vector<CardId> discardPile;    // Bottom first
+    std::vector<Seat> seats;
+    size_t currentPlayerIndex = 0;
+    GameState gameState = GameState::WAITING_FOR_PLAYERS;
+    bool clockwise = true;
+    bool mustPlaySevenOrLower = false;
+    uint64_t seed = 0;
+    std::array<uint64_t, 4> generator{};
+};
+
 class GameLogic {
 private:
     CardDeck deck;
-    std::vector<Card> discardPile;
-    std::vector<PlayerHand> players;
-    std::map<std::string, size_t> playerIndexMap;
+    CardStack<DECK_SIZE> discardPile;
+    std::array<PlayerHand, MAX_SEATS> players;  // Seat order, inline so copying a game never allocates
+    size_t playerCount;                         // Seats in use, a room seats two players so lookups scan them
 
     size_t currentPlayerIndex;
     GameState gameState;
     bool clockwise;                   // Direction of play
     bool mustPlaySevenOrLower;        // Special state after 7 is played
+    uint64_t seed;                    // Seed of the current game, replaying it with the same moves gives the same game
+    Xoshiro256 generator;             // Seeded from seed at start, drives every shuffle of the game
 
 public:
     GameLogic();
 
     // Game setup
-    bool addPlayer(const std::string& playerId);
+    bool addPlayer(const std::string& playerId);    // false if already seated or all MAX_SEATS are taken
     bool removePlayer(const std::string& playerId);
-    void startGame();
+    void startGame();                       // New random seed
+    void startGame(uint64_t gameSeed);      // Deals exactly the game gameSeed stands for, also a cheap reset of a copy
     void resetGame();
 
+    GameSnapshot saveSnapshot() const;
+    // @return false (game left unchanged) if snapshot is not a consistent game - duplicate cards, bad seat index
+    bool restoreSnapshot(const GameSnapshot& snapshot);
+
     // Game state queries
     GameState getGameState() const;
     std::string getCurrentPlayer() const;
@@ -56,10 +93,13 @@ public:
     void drawCardsToHand(const std::string& playerId);
 
     // Game actions
-    bool playCards(const std::string& playerId, const std::vector<Card>& cardsToPlay);
+    bool playCards(const std::string& playerId, CardSet cardsToPlay);
     bool playFromReserve(const std::string& playerId);  // NEW: Play blind from reserve cards
     bool pickupDiscardPile(const std::string& playerId);
 
+    // Cards the player could play right now (empty when it is not their turn or they must play from reserves)
+    CardSet legalMoves(const std::string& playerId) const;
+
     // Turn management
     void nextTurn();
     bool isPlayerTurn(const std::string& playerId) const;
@@ -68,21 +108,40 @@ public:
     bool hasPlayerWon(const std::string& playerId) const;
     std::string getWinner() const;
 
+    /*
+    * Seat-indexed versions of the actions and queries above, same rules without the name lookups.
+    * For callers that track seats themselves (simulation). Seats are numbered in the order players were added.
+    */
+    size_t getCurrentSeat() const;      // NO_SEAT unless a game is running
+    size_t getWinnerSeat() const;       // NO_SEAT unless the game is finished
+    bool playCardsAt(size_t seat, CardSet cardsToPlay);
+    bool playFromReserveAt(size_t seat);
+    bool pickupDiscardPileAt(size_t seat);
+    CardSet legalMovesAt(size_t seat) const;
+    CardSet getHandAt(size_t seat) const;
+    size_t getReserveSizeAt(size_t seat) const;
+    bool isClockwise() const;
+
     // Game state access
-    std::vector<Card> getPlayerHand(const std::string& playerId) const;
-    std::vector<Card> getPlayerReserves(const std::string& playerId) const;
+    CardSet getPlayerHand(const std::string& playerId) const;
+    CardSet getPlayerReserves(const std::string& playerId) const;
     size_t getPlayerHandSize(const std::string& playerId) const;
     size_t getPlayerReserveSize(const std::string& playerId) const;
-    std::vector<Card> getDiscardPile() const;
-    Card getTopDiscardCard() const;
+    const CardStack<DECK_SIZE>& getDiscardPile() const;
+    size_t getDiscardPileSize() const;
+    CardId getTopDiscardCard() const;
     size_t getDeckSize() const;
     bool getMustPlaySevenOrLower() const;
+    uint64_t getSeed() const;
 
     // Utility methods
     void shuffleDiscardPileIntoDeck();
 
 private:
     size_t getPlayerIndex(const std::string& playerId) const;
+    bool isSeatTurn(size_t seat) const;
+    bool hasSeatWon(size_t seat) const;
+    void drawCardsToSeat(size_t seat);
     void recycleDiscardPile();
     void moveToNextValidPlayer();
 };
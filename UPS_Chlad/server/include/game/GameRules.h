@@ -6,38 +6,107 @@
 #define GAMERULES_H
 
 #include "CardDeck.h"
-#include <vector>
+#include "CardSet.h"
+#include <array>
+
+namespace LegalityTable {
+    constexpr int RANK_COUNT = HIGHEST_RANK - LOWEST_RANK + 1;
+
+    /*
+    * The play rule for one rank on another, evaluated only while building the table:
+    * 2 goes on anything and anything goes on a 2, after a 7 only 7 or lower may follow,
+    * otherwise a 10 or any card of higher or equal rank may be played.
+    */
+    constexpr bool rankPlaysOn(int candidate, int top, bool mustPlaySevenOrLower) {
+        if (candidate == static_cast<int>(Rank::TWO) || top == static_cast<int>(Rank::TWO)) {
+            return true;
+        }
+        if (mustPlaySevenOrLower) {
+            return candidate <= static_cast<int>(Rank::SEVEN);
+        }
+        return candidate == static_cast<int>(Rank::TEN) || candidate >= top;
+    }
+
+    // LEGAL[top rank][must play low] = mask of every card that may be played on it
+    constexpr std::array<std::array<uint64_t, 2>, RANK_COUNT> buildTable() {
+        std::array<std::array<uint64_t, 2>, RANK_COUNT> table{};
+        for (int top = LOWEST_RANK; top <= HIGHEST_RANK; ++top) {
+            for (int low = 0; low < 2; ++low) {
+                uint64_t mask = 0;
+                for (int candidate = LOWEST_RANK; candidate <= HIGHEST_RANK; ++candidate) {
+                    if (rankPlaysOn(candidate, top, low != 0)) {
+                        mask |= CardSet::ofRank(candidate).mask();
+                    }
+                }
+                table[top - LOWEST_RANK][low] = mask;
+            }
+        }
+        return table;
+    }
+
+    inline constexpr std::array<std::array<uint64_t, 2>, RANK_COUNT> LEGAL = buildTable();
+}
 
 class GameRules {
 public:
+    // Every card that may be played on topCard, AND it with a hand to get the playable cards
+    static constexpr CardSet legalCards(CardId topCard, bool mustPlaySevenOrLower) {
+        return CardSet(LegalityTable::LEGAL[cardRank(topCard) - LOWEST_RANK][mustPlaySevenOrLower ? 1 : 0]);
+    }
+
+    // Any card may be played on an empty discard pile
+    static constexpr CardSet legalCardsOnEmptyPile() {
+        return CardSet::upToRank(HIGHEST_RANK);
+    }
+
     // Core game rule validation
-    static bool isValidPlay(const std::vector<Card>& cardsToPlay, const Card& topCard, bool mustPlaySevenOrLower);
+    static bool isValidPlay(CardSet cardsToPlay, CardId topCard, bool mustPlaySevenOrLower);
 
     // Check if cards can be played together (same rank)
-    static bool canPlayTogether(const std::vector<Card>& cards);
+    static bool canPlayTogether(CardSet cards);
 
     // Check if a single card can be played on top of another
-    static bool canPlayOn(const Card& cardToPlay, const Card& topCard, bool mustPlaySevenOrLower);
+    static bool canPlayOn(CardId cardToPlay, CardId topCard, bool mustPlaySevenOrLower);
 
     // Check if card is higher or equal value
-    static bool isHigherOrEqual(const Card& cardToPlay, const Card& topCard);
+    static bool isHigherOrEqual(CardId cardToPlay, CardId topCard);
 
     // Special card handling
-    static bool isWildCard(const Card& card);        // 2 - Wild Card
-    static bool isReverseCard(const Card& card);     // 7 - Reverse Direction
-    static bool isBurnCard(const Card& card);        // 10 - Burn Card
+    static bool isWildCard(CardId card);        // 2 - Wild Card
+    static bool isReverseCard(CardId card);     // 7 - Reverse Direction
+    static bool isBurnCard(CardId card);        // 10 - Burn Card
 
     // Apply special card effects
-    static void applySpecialCardEffects(const std::vector<Card>& cardsPlayed,
-                                      std::vector<Card>& discardPile,
+    template <size_t Capacity>
+    static void applySpecialCardEffects(CardSet cardsPlayed,
+                                      CardStack<Capacity>& discardPile,
                                       bool& clockwise,
                                       bool& mustPlaySevenOrLower);
 
     // Check if multiple cards are valid (all same rank)
-    static bool areMultipleCardsValid(const std::vector<Card>& cards);
+    static bool areMultipleCardsValid(CardSet cards);
 
     // Get the effective value of a card (considering special rules)
-    static int getEffectiveValue(const Card& card);
+    static int getEffectiveValue(CardId card);
 };
 
+template <size_t Capacity>
+void GameRules::applySpecialCardEffects(CardSet cardsPlayed,
+                                      CardStack<Capacity>& discardPile,
+                                      bool& /* clockwise */,
+                                      bool& mustPlaySevenOrLower) {
+    // 7 - Reverse Direction: Next player must play 7 or lower
+    mustPlaySevenOrLower = cardsPlayed.intersects(CardSet::ofRank(static_cast<int>(Rank::SEVEN)));
+
+    if (cardsPlayed.intersects(CardSet::ofRank(static_cast<int>(Rank::TEN)))) {
+        // 10 - Burn Card: Remove entire discard pile from game
+        discardPile.clear();
+        // Note: The current played cards are added to discard pile after this function
+        // so the 10 will be the only card in the discard pile
+    }
+
+    // Note: Wild cards (2s) don't have special effects beyond being playable on anything
+    // Direction reversal could be implemented here if needed for the game variant
+}
+
 #endif //GAMERULES_H
\ No newline at end of file
@@ -0,0 +1,105 @@
+// Random.h - xoshiro256** random generator
+// KIV/UPS Network Programming Project
+
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+#include <array>
+
+/*
+* xoshiro256** generator - 32 bytes of state, a handful of instructions per number.
+* Seeded from one 64-bit value through splitmix64, so a game seed fully determines every shuffle of the game.
+* Satisfies UniformRandomBitGenerator, but deck shuffles use shuffle() below, whose output does not depend
+* on the standard library implementation.
+*/
+class Xoshiro256 {
+private:
+    uint64_t state[4];
+
+    static constexpr uint64_t rotl(uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+public:
+    using result_type = uint64_t;
+
+    explicit Xoshiro256(uint64_t seed = 0) { reseed(seed); }
+
+    void reseed(uint64_t seed) {
+        // splitmix64 spreads any seed (even 0) over the whole state
+        for (uint64_t& word : state) {
+            seed += 0x9E3779B97F4A7C15ULL;
+            uint64_t z = seed;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            word = z ^ (z >> 31);
+        }
+    }
+
+    uint64_t operator()() {
+        uint64_t result = rotl(state[1] * 5, 7) * 9;
+        uint64_t t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+        return result;
+    }
+
+    // Uniform value in [0, bound) without modulo bias (Lemire's multiply and reject)
+    uint64_t below(uint64_t bound) {
+        unsigned __int128 product = static_cast<unsigned __int128>((*this)()) * bound;
+        uint64_t low = static_cast<uint64_t>(product);
+        if (low < bound) {
+            uint64_t threshold = (0 - bound) % bound;
+            while (low < threshold) {
+                product = static_cast<unsigned __int128>((*this)()) * bound;
+                low = static_cast<uint64_t>(product);
+            }
+        }
+        return static_cast<uint64_t>(product >> 64);
+    }
+
+    // Raw state, a generator set to a saved state continues the exact same sequence
+    std::array<uint64_t, 4> getState() const { return {state[0], state[1], state[2], state[3]}; }
+    void setState(const std::array<uint64_t, 4>& saved) {
+        for (size_t i = 0; i < 4; ++i) {
+            state[i] = saved[i];
+        }
+    }
+
+    static constexpr uint64_t min() { return 0; }
+    static constexpr uint64_t max() { return std::numeric_limits<uint64_t>::max(); }
+};
+
+namespace Random {
+    /*
+    * Generator of the calling thread, seeded once from std::random_device when the thread first uses it.
+    */
+    Xoshiro256& threadGenerator();
+
+    /*
+    * Fresh seed for a new game, drawn from the calling thread's generator.
+    */
+    inline uint64_t newSeed() {
+        return threadGenerator()();
+    }
+
+    // Fisher-Yates over [first, first + count), identical for the same generator state on every platform
+    template<typename T>
+    void shuffle(T* first, size_t count, Xoshiro256& generator) {
+        for (size_t i = count; i > 1; --i) {
+            size_t j = static_cast<size_t>(generator.below(i));
+            T swapped = first[i - 1];
+            first[i - 1] = first[j];
+            first[j] = swapped;
+        }
+    }
+}
+
+#endif //RANDOM_H
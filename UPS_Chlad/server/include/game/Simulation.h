@@ -0,0 +1,119 @@
+// Simulation.h - Headless game simulation
+// KIV/UPS Network Programming Project
+
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include "GameLogic.h"
+#include "Random.h"
+#include <array>
+#include <vector>
+#include <string>
+#include <memory>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+
+// What a bot does with its turn
+struct BotAction {
+    enum class Kind : uint8_t {
+        PLAY_CARDS,     // cards from the hand, all of one rank
+        PLAY_RESERVE,   // blind reserve card, hand must be empty
+        PICKUP          // take the discard pile
+    };
+
+    Kind kind;
+    CardSet cards;
+
+    static BotAction play(CardSet cards) { return {Kind::PLAY_CARDS, cards}; }
+    static BotAction reserve() { return {Kind::PLAY_RESERVE, {}}; }
+    static BotAction pickup() { return {Kind::PICKUP, {}}; }
+};
+
+/*
+* Decides the moves of one seat. Every simulation thread creates its own policies through a PolicyFactory, so a
+* policy may keep state between calls without locking. Randomized choices must come from random, otherwise the
+* same seed would not replay the same game.
+*/
+class BotPolicy {
+public:
+    virtual ~BotPolicy() = default;
+
+    /*
+    * Called only when it is seat's turn. A move GameLogic rejects is replaced by a pickup (or a reserve card
+    * when the pile is empty) and counted in SimulationStats::rejected_moves.
+    */
+    virtual BotAction chooseAction(const GameLogic& game, size_t seat, Xoshiro256& random) = 0;
+};
+
+using PolicyFactory = std::function<std::unique_ptr<BotPolicy>()>;
+
+namespace BotPolicies {
+    /*
+    * Built-in policies:
+    *   random  - random legal rank, all cards of it
+    *   lowest  - lowest legal rank, all cards of it, picks up only when nothing is legal
+    *   saver   - like lowest, but holds 2s and 10s back while another rank is legal
+    * @return nullptr for an unknown name
+    */
+    PolicyFactory byName(const std::string& name);
+    std::vector<std::string> names();
+}
+
+struct SimulationConfig {
+    uint64_t games = 1000000;
+    uint64_t seed = 1;                      // Game i is dealt from gameSeed(seed, i) whatever the thread count
+    size_t threads = 0;                     // 0 = every core
+    size_t max_turns = 2000;                // Games still running after this many turns count as stalled
+    std::vector<PolicyFactory> seats;       // One policy per seat, 2 to MAX_SEATS of them
+};
+
+struct SimulationStats {
+    static constexpr size_t LENGTH_BUCKET_TURNS = 5;
+    static constexpr size_t LENGTH_BUCKETS = 100;       // Last bucket also counts every longer game
+
+    uint64_t games = 0;
+    uint64_t finished = 0;              // Ended with a winner
+    uint64_t stalled = 0;               // Hit max_turns
+    uint64_t turns = 0;                 // Over finished games
+    uint64_t shortest_game = UINT64_MAX;
+    uint64_t longest_game = 0;
+    std::array<uint64_t, LENGTH_BUCKETS> length_histogram{};   // Finished games by turns / LENGTH_BUCKET_TURNS
+
+    uint64_t pickups = 0;               // Discard pile taken, by choice or after a losing reserve card
+    uint64_t reserve_plays = 0;
+    uint64_t failed_reserve_plays = 0;  // Reserve card did not fit and the pile was picked up with it
+    uint64_t rejected_moves = 0;        // Policy chose an illegal move
+    uint64_t deck_ran_dry = 0;          // Games where the draw pile ran out before the end
+    uint64_t turns_after_dry = 0;       // Turns played with an empty draw pile, over those games
+    std::array<uint64_t, MAX_SEATS> wins_by_seat{};
+
+    double seconds = 0.0;               // Wall time of Simulation::run
+
+    void merge(const SimulationStats& other);
+    // Turns of the game at the given fraction (0.5 = median) of finished games, bucket resolution
+    uint64_t lengthPercentile(double fraction) const;
+};
+
+namespace Simulation {
+    // Deterministic seed of game index, independent of how the games were split between threads
+    uint64_t gameSeed(uint64_t seed, uint64_t index);
+
+    /*
+    * Plays one complete game of the seated players in game (reset with startGame, so the same GameLogic is
+    * reused across games without allocating) and adds it to stats.
+    * @param policies - one per seated player
+    */
+    void playGame(GameLogic& game, BotPolicy* const* policies, uint64_t game_seed, size_t max_turns,
+                  SimulationStats& stats);
+
+    /*
+    * Plays config.games games on config.threads threads. Games are cut into chunks that start evenly spread
+    * over per-thread deques, an idle thread steals chunks from the others, so slow chunks do not hold up the end.
+    * Totals depend only on config, not on scheduling.
+    * @throws std::invalid_argument for a bad seat count
+    */
+    SimulationStats run(const SimulationConfig& config);
+}
+
+#endif //SIMULATION_H
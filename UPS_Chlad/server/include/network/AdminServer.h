@@ -0,0 +1,57 @@
+// AdminServer.h - Admin HTTP endpoint for metrics and traces
+// KIV/UPS Network Programming Project
+
+#ifndef ADMINSERVER_H
+#define ADMINSERVER_H
+
+#include <string>
+#include <thread>
+#include <atomic>
+
+class PlayerManager;
+class RoomManager;
+class NetworkManager;
+class Logger;
+
+/*
+* Minimal HTTP endpoint on a separate admin port. GET /metrics answers with the Metrics registry and
+* current gauges (players, rooms, connections, outbound queue depth) in Prometheus text format,
+* GET /trace with the sampled spans as Chrome trace-event JSON, anything else gets 404. Serves one request per connection on its own thread, away from game traffic.
+*/
+class AdminServer {
+private:
+    PlayerManager* playerManager;
+    RoomManager* roomManager;
+    NetworkManager* networkManager;
+    Logger* logger;
+    std::string admin_ip;
+    int admin_port;
+    bool share_port;
+
+    int listen_socket;
+    std::atomic<bool> running;
+    std::thread server_thread;
+
+    /*
+    * Accept loop, wakes up periodically to notice stop()
+    */
+    void serveLoop();
+    /*
+    * Reads one request from client socket, writes the response and closes the socket.
+    */
+    void handleRequest(int client_socket);
+    /*
+    * @return metrics page - gauges followed by all registry counters and histograms
+    */
+    std::string renderMetrics();
+
+public:
+    AdminServer(PlayerManager* pm, RoomManager* rm, NetworkManager* nm, Logger* lg,
+                const std::string& ip, int port, bool reuse_port = false);
+    ~AdminServer();
+
+    bool start();       // Bind admin socket and start serving thread
+    void stop();        // Stop serving thread and close socket
+};
+
+#endif //ADMINSERVER_H
@@ -0,0 +1,63 @@
+// Connection.h - Per-client connection state
+// KIV/UPS Network Programming Project
+
+#ifndef CONNECTION_H
+#define CONNECTION_H
+
+#include <string>
+#include <mutex>
+#include <chrono>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "OutboundQueue.h"
+#include "BinaryCodec.h"
+#include "TokenBucket.h"
+#include "ReceiveBuffer.h"
+
+/*
+* State of one client socket owned by the network layer.
+* Only the thread serving the socket (reactor or client thread) reads read_buffer, while outbound
+* may be appended to from any thread (broadcasts, heartbeat monitor) under write_mutex.
+*/
+struct Connection {
+    int fd;
+    ReceiveBuffer read_buffer;  // Bytes received but not yet split into complete messages
+    OutboundQueue outbound;     // Frames accepted for sending but not yet written to the socket
+    std::mutex write_mutex;     // Guards outbound, closed and the high-water state
+    bool closed;                // Set once the socket was closed, no more writes allowed
+
+    // Backpressure - when outbound grew above high-water mark and since when
+    bool over_high_water;
+    std::chrono::steady_clock::time_point over_high_water_since;
+
+    // Room sharding (epoll mode with worker_threads > 0)
+    std::atomic<int> in_flight;                 // Messages posted to a shard and not yet processed
+    size_t pinned_shard;                        // Shard of in-flight messages, reactor thread only
+    std::atomic<bool> disconnect_requested;     // Disconnect handled or pending, skip everything still queued
+    std::atomic<bool> dropped;                  // Dropped as slow client, queued messages are not worth answering
+    bool closing;                               // Close was scheduled, reactor ignores further events
+    uint32_t ring_generation;                   // io_uring reactor only, tells completions for a reused fd apart
+
+    // Binary wire format, negotiated in CONNECT / RECONNECT and switched on when CONNECTED is sent
+    std::atomic<bool> binary_input;             // Incoming bytes are binary frames instead of text lines
+    bool binary_output;                         // Outgoing messages are encoded by encoder, guarded by write_mutex
+    BinaryEncoder encoder;                      // Guarded by write_mutex
+    BinaryDecoder decoder;                      // Reading thread only
+
+    // Threaded mode, guarded by write_mutex: eventfd the client thread polls next to its socket, signalled when
+    // another thread leaves bytes queued while the client thread does not wait for POLLOUT yet
+    int wakeup_fd;
+    bool polling_writable;
+
+    // Inbound rate limit, reading thread only
+    TokenBucket message_bucket;
+    int rate_strikes;                           // Messages rejected since the last admitted one
+
+    explicit Connection(int socket_fd)
+        : fd(socket_fd), closed(false), over_high_water(false),
+          in_flight(0), pinned_shard(0), disconnect_requested(false), dropped(false), closing(false), ring_generation(0),
+          binary_input(false), binary_output(false), wakeup_fd(-1), polling_writable(false), rate_strikes(0) {}
+};
+
+#endif //CONNECTION_H
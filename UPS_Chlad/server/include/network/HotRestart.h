@@ -0,0 +1,95 @@
+// HotRestart.h - Server handover to a new process
+// KIV/UPS Network Programming Project
+
+#ifndef HOTRESTART_H
+#define HOTRESTART_H
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <cstddef>
+
+class Logger;
+
+/*
+* Unix domain (SOCK_SEQPACKET, abstract namespace) socket a running server listens on for its successor.
+* A new process started with --takeover connects and asks for the server. The old one pauses, passes its listening
+* socket and every client socket with SCM_RIGHTS together with a snapshot of the player and room state, and exits
+* once the successor confirmed it serves them. Clients keep their TCP connections and never notice.
+*
+* Datagrams:
+*   successor -> server    'T'                      take over
+*   server -> successor    'F' + fds attached       up to MAX_FDS_PER_MESSAGE sockets, the first one is the listener
+*                          'S' + bytes              next piece of the snapshot
+*                          'E' + u32 socket count, u64 snapshot size
+*   successor -> server    'A'                      state restored, the successor serves the clients now
+*/
+class HotRestart {
+public:
+    static constexpr size_t MAX_FDS_PER_MESSAGE = 250;      // Kernel limit is 253 (SCM_MAX_FD)
+    static constexpr size_t SNAPSHOT_CHUNK_SIZE = 60000;    // Fits the default socket send buffer
+
+    using TakeoverCallback = std::function<void(int channel_socket)>;
+
+    // What the successor received, it owns every socket in it
+    struct State {
+        int channel_socket = -1;
+        int listen_socket = -1;
+        std::vector<int> client_sockets;    // Same order as the connections in the snapshot
+        std::string snapshot;
+    };
+
+    explicit HotRestart(Logger* lg);
+    ~HotRestart();
+    HotRestart(const HotRestart&) = delete;
+    HotRestart& operator=(const HotRestart&) = delete;
+
+    /*
+    * Listens on name and starts the listening thread. The first successor that asks stops the listening (so the
+    * successor can bind the name itself later) and on_takeover gets the channel to it, on the listening thread.
+    * Call again to listen for the next successor if that takeover failed.
+    */
+    bool listen(const std::string& name, TakeoverCallback on_takeover);
+    void stop();
+
+    // Old process side
+    /*
+    * Sends listen_socket, the client sockets and the snapshot. The sockets stay open here, the kernel holds its
+    * own references for the successor.
+    */
+    static bool sendState(int channel_socket, int listen_socket, const std::vector<int>& client_sockets,
+                          const std::string& snapshot);
+    /*
+    * @return true if the successor confirmed within timeout_ms
+    */
+    static bool waitForAcknowledge(int channel_socket, int timeout_ms);
+
+    // Successor side
+    /*
+    * Asks the server on name to hand over and receives everything sendState sent.
+    * @param error - reason on failure, every socket received so far is closed again
+    */
+    static bool requestTakeover(const std::string& name, State& state, std::string& error);
+    /*
+    * Tells the old process to exit, closes the channel.
+    */
+    static bool acknowledge(State& state);
+    /*
+    * Closes every socket of a takeover that is abandoned, the old process keeps serving.
+    */
+    static void discard(State& state);
+
+private:
+    Logger* logger;
+    std::string socket_name;
+    int listen_socket;
+    std::atomic<bool> running;
+    std::thread listen_thread;
+    TakeoverCallback callback;
+
+    void listenLoop();
+};
+
+#endif //HOTRESTART_H
@@ -0,0 +1,92 @@
+// IoUring.h - Minimal io_uring wrapper
+// KIV/UPS Network Programming Project
+
+#ifndef IOURING_H
+#define IOURING_H
+
+#include <linux/io_uring.h>
+#include <memory>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+/*
+* Minimal io_uring wrapper over the raw syscalls (no liburing): one submission / completion ring pair
+* and one provided-buffer ring that multishot recv picks its buffers from.
+* Needs Linux 6.0 (multishot accept and recv, buffer rings). Not thread safe, owned by the reactor thread.
+*/
+class IoUring {
+private:
+    int ring_fd;
+
+    // Shared rings mapped from the kernel
+    void* ring_memory;
+    size_t ring_memory_size;
+    io_uring_sqe* sqes;
+    size_t sqes_size;
+    unsigned* sq_head;
+    unsigned* sq_tail;
+    unsigned sq_mask;
+    unsigned sq_entries;
+    unsigned* cq_head;
+    unsigned* cq_tail;
+    unsigned cq_mask;
+    io_uring_cqe* cqes;
+    unsigned sqe_tail;          // Local tail, published to the kernel on submit
+    unsigned unsubmitted;       // Entries prepared since the last io_uring_enter()
+
+    // Provided buffers
+    io_uring_buf_ring* buffer_ring;
+    size_t buffer_ring_size;
+    std::unique_ptr<char[]> buffer_memory;
+    unsigned buffer_count;
+    unsigned buffer_size;
+    uint16_t buffer_tail;       // Local tail, published by publishBuffers()
+
+    // At least major.minor according to uname()
+    static bool kernelAtLeast(int major, int minor);
+
+public:
+    IoUring();
+    ~IoUring();
+    IoUring(const IoUring&) = delete;
+    IoUring& operator=(const IoUring&) = delete;
+
+    /*
+    * Creates the rings and registers count provided buffers of buffer_size bytes as buffer group.
+    * @param entries - submission queue size (completion queue is twice as large)
+    * @param count - number of provided buffers, power of two
+    * @param error - reason when io_uring is not usable
+    * @return false if the kernel lacks anything needed, caller falls back to epoll
+    */
+    bool setup(unsigned entries, uint16_t group, unsigned count, unsigned size, std::string& error);
+    void close();
+    bool isOpen() const { return ring_fd >= 0; }
+
+    // Preparing requests - false if the submission queue stayed full even after submitting
+    bool prepareMultishotAccept(int listen_fd, uint64_t user_data);
+    bool prepareMultishotRecv(int fd, uint16_t group, uint64_t user_data);
+    bool prepareMultishotPoll(int fd, unsigned events, uint64_t user_data);
+    bool prepareCancel(uint64_t target_user_data, uint64_t user_data);
+
+    /*
+    * Submits prepared requests and waits until at least min_complete completions are available.
+    * @return number of submitted requests or -errno
+    */
+    int submitAndWait(unsigned min_complete);
+
+    // Oldest completion not consumed yet or nullptr
+    io_uring_cqe* peekCompletion();
+    void consumeCompletion();
+
+    // Provided buffer the kernel filled, handed back with recycleBuffer() once its bytes were copied
+    const char* bufferData(uint16_t buffer_id) const { return buffer_memory.get() + static_cast<size_t>(buffer_id) * buffer_size; }
+    void recycleBuffer(uint16_t buffer_id);
+    // Makes recycled buffers visible to the kernel, once per batch of completions
+    void publishBuffers();
+
+private:
+    io_uring_sqe* nextSqe();
+};
+
+#endif //IOURING_H
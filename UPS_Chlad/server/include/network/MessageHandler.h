@@ -7,7 +7,9 @@
 
 #include "ProtocolMessage.h"
 #include "ProtocolHelper.h"
+#include "SlotMap.h"
 #include <vector>
+#include <string_view>
 
 // Forward declarations
 class PlayerManager;
@@ -15,6 +17,8 @@ class RoomManager;
 class GameManager;
 class MessageValidator;
 class Logger;
+class Matchmaker;
+struct RoomSnapshot;
 
 class MessageHandler {
 private:
@@ -23,9 +27,13 @@ private:
     GameManager* gameManager;
     MessageValidator* validator;
     Logger* logger;
+    Matchmaker* matchmaker = nullptr;
 
 public:
     MessageHandler(PlayerManager* pm, RoomManager* rm, MessageValidator* mv, Logger* lg, GameManager* gm);
+
+    // Set before the server starts, JOIN_ROOM is then answered by the matchmaker. nullptr (default) joins right away.
+    void setMatchmaker(Matchmaker* room_matchmaker) { matchmaker = room_matchmaker; }
     
     // Main entry point
     /*
@@ -33,7 +41,15 @@ public:
     * Handles invalid messages (kick player).
     * @return vector of response messages (used when broadcasting is required).
     */
-    std::vector<ProtocolMessage> processMessage(const std::string& raw_message, int client_socket);
+    std::vector<ProtocolMessage> processMessage(std::string_view raw_message, int client_socket);
+    /*
+    * Same as above, but fills caller-owned vector (cleared first) so its capacity can be reused between messages.
+    */
+    void processMessage(std::string_view raw_message, int client_socket, std::vector<ProtocolMessage>& responses);
+    /*
+    * Same as above for a message decoded from a binary frame.
+    */
+    void processMessage(const ProtocolMessage& msg, int client_socket, std::vector<ProtocolMessage>& responses);
 
     /*
     * Handles request for connection with validation for lenght, invalid characters and returns response with result
@@ -91,6 +107,44 @@ public:
     * @return vector of response messages
     */
     std::vector<ProtocolMessage> handlePickupPile(const std::string& player_name);
+    /*
+    * Handles request for full game state from a client that detected a gap in TURN_UPDATE sequence numbers
+    * @param player_name requesting player
+    * @return GAME_STATE response, or error if the player is not in an active game
+    */
+    std::vector<ProtocolMessage> handleResync(const std::string& player_name);
+
+private:
+    /*
+    * Resolves requesting player and routes parsed message to its handler.
+    * @return vector of response messages
+    */
+    std::vector<ProtocolMessage> routeMessage(const ProtocolMessage& msg, int client_socket);
+    /*
+    * Every valid frame refreshes the heartbeat of the socket's player.
+    * @return the player, Handles::INVALID before CONNECT
+    */
+    PlayerHandle markAlive(int client_socket);
+    /*
+    * Appends PONG (error if socket has no player)
+    */
+    void answerPing(PlayerHandle player, std::vector<ProtocolMessage>& responses);
+    /*
+    * Echoes binary=true from CONNECT / RECONNECT into CONNECTED, which turns on the binary protocol
+    */
+    void acknowledgeBinary(const ProtocolMessage& request, ProtocolMessage& connected);
+    /*
+    * Tells the client in CONNECTED how often to show a sign of life in the lobby, in a room and on turn
+    */
+    void advertiseHeartbeat(ProtocolMessage& connected);
+    /*
+    * Appends TURN_UPDATE for every player in the room, built from one room snapshot
+    */
+    void appendTurnUpdates(const std::string& room_id, std::vector<ProtocolMessage>& responses);
+    /*
+    * Puts the player on turn in the snapshot to the tighter turn heartbeat, the rest of the room back to the room one
+    */
+    void trackTurn(const std::string& room_id, const RoomSnapshot& snapshot);
 };
 
 #endif //MESSAGEHANDLER_H
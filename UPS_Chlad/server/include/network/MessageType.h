@@ -15,6 +15,7 @@ enum class MessageType {
     RECONNECT = 6,      // Client requesting reconnetion
     PLAY_CARDS = 7,     // Client plays cards
     PICKUP_PILE = 8,    // Client picks up discard pile
+    RESYNC = 9,         // Client missed a TURN_UPDATE and requests full game state
 
     // Server -> gamba-client
     CONNECTED = 100, 			// Server notifies about connection
@@ -32,4 +33,39 @@ enum class MessageType {
     GAME_OVER = 112,        // Server announces game completion
     TURN_UPDATE = 113       // Server sends delta update after turn (compact protocol)
 };
+
+/*
+* @return true if type_code corresponds to an existing MessageType
+*/
+constexpr bool isKnownMessageType(int type_code) {
+    switch (static_cast<MessageType>(type_code)) {
+        case MessageType::CONNECT:
+        case MessageType::DISCONNECT:
+        case MessageType::JOIN_ROOM:
+        case MessageType::LEAVE_ROOM:
+        case MessageType::PING:
+        case MessageType::START_GAME:
+        case MessageType::RECONNECT:
+        case MessageType::PLAY_CARDS:
+        case MessageType::PICKUP_PILE:
+        case MessageType::RESYNC:
+        case MessageType::CONNECTED:
+        case MessageType::ROOM_JOINED:
+        case MessageType::ROOM_LEFT:
+        case MessageType::ERROR_MSG:
+        case MessageType::PONG:
+        case MessageType::GAME_STARTED:
+        case MessageType::GAME_STATE:
+        case MessageType::TURN_UPDATE:
+        case MessageType::PLAYER_DISCONNECTED:
+        case MessageType::GAME_PAUSED:
+        case MessageType::PLAYER_RECONNECTED:
+        case MessageType::GAME_RESUMED:
+        case MessageType::TURN_RESULT:
+        case MessageType::GAME_OVER:
+            return true;
+        default:
+            return false;
+    }
+}
 #endif //MESSAGETYPE_H
\ No newline at end of file
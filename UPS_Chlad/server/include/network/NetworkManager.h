@@ -12,8 +12,19 @@
 #include <thread>
 #include <atomic>
 #include <string>
+#include <string_view>
 #include <condition_variable>
 #include <mutex>
+#include <memory>
+#include <unordered_map>
+#include <map>
+#include <vector>
+#include <cstdint>
+#include "Connection.h"
+#include "EncodedFrame.h"
+#include "TokenBucket.h"
+#include "NodeChannel.h"
+#include "HotRestart.h"
 
 // Forward declarations
 class ProtocolMessage;
@@ -23,9 +34,32 @@ class MessageHandler;
 class MessageValidator;
 class Logger;
 struct ServerConfig;
+class RoomShardPool;
+class IoUring;
+class SessionDirectory;
+class Matchmaker;
+
+// Snapshot of outbound queue state across all connections (queue depth metric)
+struct OutboundStats {
+    size_t connections = 0;           // Live connections
+    size_t queued_bytes = 0;          // Unwritten bytes over all outbound queues
+    size_t max_queued_bytes = 0;      // Deepest single outbound queue
+    uint64_t partial_writes = 0;      // Flushes where kernel accepted only part of the data (total)
+    uint64_t slow_disconnects = 0;    // Clients dropped for staying above high-water mark (total)
+};
+
+// Message a shared text frame was serialized from, binary connections encode it themselves
+struct FrameSource {
+    const ProtocolMessage& message;
+    const std::string& header_player_id;                       // Player id in the frame header
+    const std::map<std::string, std::string>* extra_data;      // Merged into message data, may be nullptr
+};
 
 class NetworkManager {
 private:
+    static constexpr size_t RECEIVE_CHUNK_SIZE = 4096;     // Free space offered to every recv()
+    static constexpr size_t MAX_MESSAGE_SIZE = 8192;       // Longest text line or pending partial frame
+
     int server_socket;
     std::atomic<bool> running;
     std::string server_ip;
@@ -45,6 +79,67 @@ private:
     std::condition_variable heartbeat_cv;
     std::mutex heartbeat_mutex;
 
+    // Live client connections (both I/O modes register here)
+    std::unordered_map<int, std::shared_ptr<Connection>> connections;
+    std::mutex connections_mutex;
+
+    // Epoll reactor state (io_mode=epoll). The io_uring backend is a reactor too and shares everything but the event loop.
+    bool use_epoll;
+    int epoll_fd;
+    int wakeup_fd;       // eventfd used to break epoll_wait() / the ring wait on stop()
+
+    // io_uring reactor state (io_mode=io_uring, falls back to epoll when the kernel lacks it)
+    bool use_uring;
+    std::unique_ptr<IoUring> uring;
+    uint32_t next_ring_generation;     // Tags requests of one connection, completions for a reused fd are told apart
+
+    // Room-sharded worker pool (epoll mode, worker_threads > 0), nullptr = process on reactor thread
+    std::unique_ptr<RoomShardPool> shard_pool;
+    // Connections whose shard finished with them, closed by the reactor on its next wakeup (it owns the fds)
+    std::mutex pending_close_mutex;
+    std::vector<std::shared_ptr<Connection>> pending_closes;
+
+    // Other server processes on the same port (session_directory set), nullptr = single node
+    SessionDirectory* directory;
+    std::unique_ptr<NodeChannel> node_channel;
+
+    // Pairs queued JOIN_ROOMs (matchmaking_tick_ms > 0), runs while the server does, nullptr = joins in the handler
+    Matchmaker* matchmaker;
+    // Connections handed over by other nodes, adopted by the reactor on its next wakeup
+    std::mutex adopted_mutex;
+    std::vector<std::pair<int, Handoff>> adopted;
+
+    // Hot restart (hot_restart_socket set), the process hands itself over to a successor
+    std::unique_ptr<HotRestart> hot_restart;
+    std::atomic<int> takeover_channel;      // Successor waiting for the reactor to hand over, -1 = none
+    std::atomic<bool> handed_over;          // Successor serves everything now, this process only exits
+
+    // Accept rate per client IPv4 address, used by the accepting thread only
+    std::unordered_map<uint32_t, TokenBucket> accept_buckets;
+
+    // Outcome of the per-connection message rate limit
+    enum class Admission {
+        ACCEPT,
+        REJECT,         // Dropped and answered with ERROR
+        DISCONNECT      // Rejected rate_limit_strikes times in a row
+    };
+
+    /*
+    * Response coalescing. While a batch is open on a thread, frames sent by that thread are only queued,
+    * and every connection they went to gets one gathered write when the outermost batch closes.
+    * Opened around all messages of one read and around each processed message.
+    */
+    class WriteBatch {
+    private:
+        NetworkManager& manager;
+
+    public:
+        explicit WriteBatch(NetworkManager& owner);
+        ~WriteBatch();
+        WriteBatch(const WriteBatch&) = delete;
+        WriteBatch& operator=(const WriteBatch&) = delete;
+    };
+
 public:
 	NetworkManager(PlayerManager* pm, RoomManager* rm, MessageHandler* mh,
                MessageValidator* mv, Logger* lg, const ServerConfig* cfg,
@@ -52,9 +147,21 @@ public:
 
     ~NetworkManager();
 
-    bool start();        // Create and bind socket
+    // Set before start(), nullptr (default) for a single node
+    void setSessionDirectory(SessionDirectory* session_directory) { directory = session_directory; }
+    void setMatchmaker(Matchmaker* room_matchmaker) { matchmaker = room_matchmaker; }
+
+    bool start();        // Create and bind socket (or take it over from the previous process, --takeover)
     void run();          // Main accept loop
     void stop();         // Stop server gracefully
+    // True once a hot restart successor took over, run() has returned and there is nothing left to stop
+    bool wasHandedOver() const { return handed_over.load(); }
+    /*
+    * Hand over and takeover need the epoll reactor of a single node - threaded mode has no point where every
+    * client thread is paused, io_uring may hold received bytes in the ring, and nodes of a session directory
+    * own their node id until they exit.
+    */
+    bool supportsHotRestart() const;
     /**
     * Broadcasting to all players in the room. Retrieves all room players and tries to send message to all of them except the requester.
     * Validates the count of sent messages against number of players in the room - 1
@@ -63,13 +170,256 @@ public:
     * @param excluded_player - requester that wont receive broadcasted message
     */
     void broadcastToRoom(const std::string& room_id, const ProtocolMessage& message, const std::string& exclude_player = "");
+    /*
+    * Same as broadcastToRoom for an already encoded text frame, enqueued by reference to every text recipient.
+    * Binary recipients encode message (with extra_data merged, may be nullptr) themselves.
+    */
+    void broadcastFrame(const std::string& room_id, const ProtocolMessage& message,
+                        const std::map<std::string, std::string>* extra_data,
+                        const EncodedFrame& frame, const std::string& exclude_player = "");
+    /*
+    * Collects outbound queue depth over all live connections.
+    * @return current outbound statistics
+    */
+    OutboundStats getOutboundStats();
 
 private:
 
     bool setupSocket();                    // Create, bind, listen
-    void handleClient(int client_socket);  // Process one client
+    void handleClient(int client_socket);  // Process one client (threaded mode)
     void cleanup();                        // Clean shutdown
 
+    // Epoll reactor (io_mode=epoll, io_uring backend shares everything from readEpollClient on)
+    /*
+    * Creates epoll instance and wakeup eventfd, registers listening socket in edge-triggered mode.
+    * @return true on success
+    */
+    bool setupEpoll();
+    /*
+    * Single-threaded reactor loop. Accepts connections, reads all available data, drives MessageHandler
+    * and flushes pending writes when sockets become writable.
+    */
+    void runEpollLoop();
+    /*
+    * Accepts all pending connections (edge-triggered listener) and registers them with epoll.
+    */
+    void acceptEpollClients();
+    /*
+    * Reads socket until EAGAIN and processes (or dispatches to shards) every complete message.
+    * @return false if connection should be closed (see finishEpollClient)
+    */
+    bool readEpollClient(const std::shared_ptr<Connection>& conn);
+    /*
+    * Processes (or dispatches to shards) every complete message in connection's receive buffer.
+    * @return false if connection should be closed (see finishEpollClient)
+    */
+    bool processReceived(const std::shared_ptr<Connection>& conn);
+    /*
+    * Hands one complete message (text line or decoded binary frame) to its room's shard (or processes it inline
+    * without shard pool). Messages of one connection stay ordered - while some are in flight they go to the same shard.
+    * @return false if connection should be closed (inline processing only)
+    */
+    template <typename Message>
+    bool dispatchClientMessage(const std::shared_ptr<Connection>& conn, Message complete_message);
+    /*
+    * @return shard for connection's next message - its room's shard, or the shard of messages still in flight
+    */
+    size_t selectShard(const std::shared_ptr<Connection>& conn);
+    /*
+    * Runs disconnect handling and closes the connection. With shard pool this happens on connection's shard
+    * after all its queued messages, so nothing races with an fd that is being closed.
+    */
+    void finishEpollClient(const std::shared_ptr<Connection>& conn);
+    /*
+    * Writes as much of connection's outbound queue as the socket accepts without blocking and applies
+    * the high-water backpressure policy. Caller must hold conn->write_mutex.
+    * @return false on fatal socket error or when client was dropped for being too slow
+    */
+    bool flushConnection(Connection& conn);
+    /*
+    * Applies the high-water backpressure policy after a write attempt. Caller must hold conn->write_mutex.
+    * @return false on fatal socket error or when client was dropped for being too slow
+    */
+    bool handleFlushResult(Connection& conn, OutboundQueue::FlushResult result, bool partial_write);
+    /*
+    * Shuts the socket down so its owner thread / reactor notices and runs the normal disconnect path.
+    * Caller must hold conn->write_mutex.
+    */
+    void dropSlowClient(Connection& conn);
+    /*
+    * Drops clients that stayed above the outbound high-water mark longer than the grace period.
+    */
+    void checkSlowClients();
+    /*
+    * Removes connection from epoll and connection table and closes the socket. Reactor thread only - it may be
+    * reading the fd, and a number closed elsewhere could meanwhile belong to another socket.
+    */
+    void closeEpollClient(const std::shared_ptr<Connection>& conn);
+    /*
+    * Shard side of a close, queues the connection for the reactor and wakes it up.
+    */
+    void requestClose(const std::shared_ptr<Connection>& conn);
+    /*
+    * Reactor side of requestClose, closes every queued connection.
+    */
+    void closePendingClients();
+
+    // io_uring reactor (io_mode=io_uring)
+    /*
+    * Creates the ring with its provided receive buffers and wakeup eventfd, arms multishot accept.
+    * @return false if io_uring is not usable here, caller falls back to epoll
+    */
+    bool setupUring();
+    /*
+    * Reactor loop on io_uring - one io_uring_enter() submits every re-armed request and collects all completions.
+    * Reads arrive through multishot recv into provided buffers, writes stay direct sendmsg() calls and only
+    * the wait for writability goes through the ring.
+    */
+    void runUringLoop();
+    /*
+    * Handles one completion, user_data carries request kind, connection generation and fd.
+    */
+    void handleUringCompletion(uint64_t user_data, int32_t result, uint32_t flags);
+    /*
+    * Admits and registers a socket from multishot accept and arms its recv and writable poll.
+    */
+    void acceptUringClient(int client_socket);
+    /*
+    * Arms multishot recv and writable poll of a registered connection under a fresh generation.
+    * @return false if the ring had no room, caller closes the connection
+    */
+    bool armUringClient(const std::shared_ptr<Connection>& conn);
+
+    // Connection handoff between nodes (session_directory set)
+    /*
+    * Passes the connection to the node that should serve line - the owner of a RECONNECTing session, or the node
+    * with a waiting room for a lobby player's JOIN_ROOM. Called by the reading thread before the line is processed.
+    * Only text connections with nothing in flight move (io_uring nodes only receive, multishot recv may hold bytes).
+    * @return true if the connection now belongs to another node, its socket here is already closed
+    */
+    bool handOffConnection(const std::shared_ptr<Connection>& conn, std::string_view line);
+    bool handOffConnection(const std::shared_ptr<Connection>&, const ProtocolMessage&) { return false; }
+    /*
+    * NodeChannel callback. Threaded mode adopts the socket right away, reactors queue it and get woken up.
+    */
+    void receiveHandoff(int client_socket, Handoff&& handoff);
+    /*
+    * Registers an adopted socket with its unprocessed bytes, JOIN_ROOM handoffs also get their lobby player back.
+    * @return registered connection, nullptr if it was refused (socket closed)
+    */
+    std::shared_ptr<Connection> adoptConnection(int client_socket, Handoff& handoff);
+    /*
+    * Reactor side of receiveHandoff - registers queued sockets with epoll / the ring and processes their bytes.
+    */
+    void adoptHandoffs();
+
+    // Hot restart (hot_restart_socket set)
+    /*
+    * Listens for the next successor, takeover requests are passed to the reactor through the wakeup eventfd.
+    */
+    void listenForSuccessor();
+    /*
+    * Reactor thread. Pauses the server (stops accepting, drains room shards, stops the heartbeat monitor and the
+    * game journal), sends the listening socket, every connection with its buffered bytes and the player and room
+    * snapshot, and stops the reactor once the successor confirmed. Resumes serving if the successor fails.
+    */
+    void handOverServer(int channel_socket);
+    /*
+    * Successor side of start(), after the reactor is set up on the inherited listening socket. Rebuilds players,
+    * rooms and connections from the snapshot and confirms, so the old process exits.
+    * @return false if the state could not be restored, the old process then keeps serving
+    */
+    bool restoreInheritedState(HotRestart::State& state);
+
+    // Shared by both I/O modes
+    /*
+    * Admission stage of the accept path, runs before any per-client state or thread exists.
+    * Refuses the socket (short ERROR, then close) when max_clients connections are live or the client IP
+    * used up accept_burst_per_ip and exceeds accept_rate_per_ip.
+    * @return true if the connection may be registered
+    */
+    bool admitConnection(int client_socket, const sockaddr_in& client_addr);
+    /*
+    * Per-connection token bucket in front of message processing, called by the connection's reading thread.
+    */
+    Admission admitMessage(Connection& conn);
+    /*
+    * Registers socket in connection table.
+    */
+    std::shared_ptr<Connection> registerConnection(int client_socket);
+    /*
+    * @return connection for socket or nullptr if not registered (already closed)
+    */
+    std::shared_ptr<Connection> findConnection(int client_socket);
+    /*
+    * One recv() straight into the connection's receive buffer, after making room for RECEIVE_CHUNK_SIZE bytes.
+    * @param bytes_received - result of recv()
+    * @return true if any bytes were received
+    */
+    bool receiveInto(Connection& conn, ssize_t& bytes_received);
+    /*
+    * Splits complete messages off the front of connection's receive buffer - text lines, or binary frames once
+    * the connection switched - and calls dispatch(std::string_view) / dispatch(ProtocolMessage) for each until it
+    * returns false. Line views point into the receive buffer and are valid only during the dispatch call.
+    * @return false if dispatch failed, a binary frame was malformed or a frame exceeds MAX_MESSAGE_SIZE
+    */
+    template <typename Dispatch>
+    bool extractMessages(Connection& conn, Dispatch&& dispatch);
+    /*
+    * Writes serialized frame(s) right away without blocking, straight from data when nothing is queued.
+    * Whatever the socket does not accept is queued and written once socket becomes writable.
+    * Inside a WriteBatch the data is only queued. Caller must hold conn->write_mutex.
+    * @return false if the data could not be queued (error, slow client dropped)
+    */
+    bool writeToConnection(const std::shared_ptr<Connection>& conn, std::string_view data);
+    /*
+    * Adds connection to the calling thread's open WriteBatch. Caller must hold conn->write_mutex.
+    * @return false if no batch is open, frame has to be written right away
+    */
+    bool joinWriteBatch(const std::shared_ptr<Connection>& conn);
+    /*
+    * Flushes every connection of the calling thread's batch once, called when the outermost batch closes.
+    */
+    void flushWriteBatch();
+    /*
+    * Serializes message into a reused per-thread buffer (constant messages use their pre-rendered frame,
+    * binary connections the connection's encoder) and writes it. Sending CONNECTED with binary=true
+    * switches the connection to binary frames right behind it.
+    */
+    bool sendMessage(int client_socket, const ProtocolMessage& message);
+    /*
+    * Sends small per-socket head followed by shared body frame, body is queued by reference if the socket is busy.
+    * Binary connections get source encoded instead.
+    */
+    bool sendFrame(int client_socket, std::string_view head, const EncodedFrame& body, const FrameSource& source);
+    /*
+    * Serializes message body once and sends it to every player in message.recipients with their own header.
+    */
+    void sendToRecipients(const ProtocolMessage& message);
+    /*
+    * Parses one complete message, routes it through MessageHandler and delivers all responses.
+    * @return false if client should be disconnected (invalid message)
+    */
+    bool processClientMessage(int client_socket, std::string_view complete_message);
+    /*
+    * Same as above for a message decoded from a binary frame.
+    */
+    bool processClientMessage(int client_socket, const ProtocolMessage& message);
+    /*
+    * Sends MessageHandler responses to the requester, targeted players, recipients or the room.
+    * @return false if client should be disconnected (invalid message)
+    */
+    bool deliverResponses(int client_socket, const std::vector<ProtocolMessage>& responses);
+    /*
+    * Matchmaker delivery, sends one batch of messages to their player_ids with one write per connection.
+    */
+    void deliverMatches(const std::vector<ProtocolMessage>& messages);
+    /*
+    * Marks socket's player as disconnected, notifies room and removes socket mapping.
+    * @param status - reason sent in PLAYER_DISCONNECTED broadcast (socket_closed, invalid_message)
+    */
+    void handleClientDisconnect(int client_socket, const std::string& status);
+
     // Heartbeat monitoring
     /*
     * Inicializes heartbeat for u Player
@@ -81,7 +431,7 @@ private:
     void stopHeartbeatMonitor();           // Stop heartbeat monitoring thread
     /*
     * Loop that takes care of players heartbeat, if server didnt receive ping for a 60s, marks player as afk (short-term).
-    * After 120s removes player from game and server (long-term).
+    * After reconnect_window_seconds removes player from game and server (long-term).
     */
     void heartbeatMonitorLoop();           // Main heartbeat monitoring loop
 };
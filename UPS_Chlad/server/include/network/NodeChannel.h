@@ -0,0 +1,70 @@
+// NodeChannel.h - Unix socket passing clients between nodes
+// KIV/UPS Network Programming Project
+
+#ifndef NODECHANNEL_H
+#define NODECHANNEL_H
+
+#include <string>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+
+class Logger;
+
+// Live client connection passed from one node to another
+struct Handoff {
+    enum class Kind : uint8_t {
+        RECONNECT = 1,      // Session is owned by the receiving node
+        JOIN_ROOM = 2       // Lobby player moves to the node with a waiting room, session already transferred
+    };
+
+    Kind kind = Kind::RECONNECT;
+    std::string player_name;
+    std::string pending;    // Received bytes not processed yet, starting with the message that caused the handoff
+};
+
+/*
+* Unix domain (SOCK_SEQPACKET, abstract namespace) socket between the nodes of one session directory.
+* A node passes a client socket with SCM_RIGHTS together with the bytes it already read from it, so the
+* receiving node continues the TCP connection where the sender stopped and the client never notices.
+* One handoff per channel connection, received on the channel's own thread.
+*/
+class NodeChannel {
+public:
+    static constexpr size_t MAX_PENDING = 65536;
+
+    using HandoffCallback = std::function<void(int client_socket, Handoff&& handoff)>;
+
+    explicit NodeChannel(Logger* lg);
+    ~NodeChannel();
+    NodeChannel(const NodeChannel&) = delete;
+    NodeChannel& operator=(const NodeChannel&) = delete;
+
+    /*
+    * Listens as node_id of the directory and starts the receiving thread.
+    * @param on_handoff - called on the receiving thread, owns the socket from then on
+    */
+    bool start(const std::string& directory_name, int node_id, HandoffCallback on_handoff);
+    void stop();
+
+    /*
+    * Passes client_socket to node. The caller still owns its descriptor and closes it once this succeeded.
+    * @return false if the node does not listen or the handoff could not be sent
+    */
+    bool send(int node_id, int client_socket, const Handoff& handoff);
+
+private:
+    Logger* logger;
+    std::string directory_name;
+    int listen_socket;
+    std::atomic<bool> running;
+    std::thread receive_thread;
+    HandoffCallback callback;
+
+    void receiveLoop();
+    void receiveHandoff(int channel_socket);
+};
+
+#endif //NODECHANNEL_H
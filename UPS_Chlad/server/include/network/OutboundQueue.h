@@ -0,0 +1,78 @@
+// OutboundQueue.h - Per-client outbound message queue
+// KIV/UPS Network Programming Project
+
+#ifndef OUTBOUNDQUEUE_H
+#define OUTBOUNDQUEUE_H
+
+#include <string>
+#include <string_view>
+#include <deque>
+#include <cstddef>
+#include "EncodedFrame.h"
+
+/*
+* Queue of serialized frames waiting to be written to one socket.
+* Frames are written with a single gathered sendmsg() (writev semantics + MSG_NOSIGNAL), and the offset
+* into a partially written front frame is kept so no byte is ever dropped.
+* Frames are held by reference, so one broadcast frame queued on many sockets exists only once.
+* Not thread-safe, owner (Connection) guards it with its write mutex.
+*/
+class OutboundQueue {
+public:
+    enum class FlushResult {
+        DRAINED,    // Everything written
+        PENDING,    // Socket would block, data left in queue
+        FAILED      // Fatal socket error, queue cleared
+    };
+
+    OutboundQueue();
+
+    /*
+    * Appends frame to queue (frame must already contain "\n" terminator)
+    */
+    void push(std::string frame);
+    /*
+    * Appends shared frame by reference
+    */
+    void push(EncodedFrame frame);
+    /*
+    * Sends frame straight from caller's buffer when nothing is queued and queues only the part the socket
+    * did not accept; with data already queued the frame is appended and the queue flushed (keeps ordering).
+    * @param fd - socket to write to
+    * @param frame - complete frame(s) including "\n"
+    * @param partial_write - set to true if the kernel accepted only part of the offered bytes
+    * @return result as for flush()
+    */
+    FlushResult write(int fd, std::string_view frame, bool& partial_write);
+    /*
+    * Like write(), for a small per-socket head (may be empty) followed by a shared body, sent in one sendmsg().
+    * Unsent part of the body is queued by reference, not copied.
+    */
+    FlushResult write(int fd, std::string_view head, const EncodedFrame& body, bool& partial_write);
+    /*
+    * Writes as much as socket accepts without blocking (socket must be non-blocking).
+    * @param fd - socket to write to
+    * @param partial_write - set to true if the kernel accepted only part of the offered bytes
+    * @return result of the flush
+    */
+    FlushResult flush(int fd, bool& partial_write);
+    /*
+    * Drops all queued data
+    */
+    void clear();
+    /*
+    * Copies every unwritten byte in order (hot restart hands them to the new process)
+    */
+    std::string pendingData() const;
+
+    bool empty() const { return frames.empty(); }
+    size_t pendingBytes() const { return pending_bytes; }
+    size_t pendingFrames() const { return frames.size(); }
+
+private:
+    std::deque<EncodedFrame> frames;
+    size_t front_offset;     // Bytes of frames.front() already written
+    size_t pending_bytes;    // Total unwritten bytes in queue
+};
+
+#endif //OUTBOUNDQUEUE_H
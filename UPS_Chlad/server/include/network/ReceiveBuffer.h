@@ -0,0 +1,52 @@
+// ReceiveBuffer.h - Per-client receive buffer and line framing
+// KIV/UPS Network Programming Project
+
+#ifndef RECEIVEBUFFER_H
+#define RECEIVEBUFFER_H
+
+#include <memory>
+#include <string_view>
+#include <cstddef>
+
+/*
+* Contiguous receive buffer of one connection, recv() writes straight into it and complete messages are
+* handed out as views into the same bytes, so a line is never copied between the socket and the parser.
+* Unread bytes are moved to the front only when the free tail is too small for the next recv(), and the
+* buffer grows only when a single pending frame does not fit. Reading thread only.
+*/
+class ReceiveBuffer {
+private:
+    std::unique_ptr<char[]> storage;
+    size_t capacity;
+    size_t read_pos;    // First unread byte
+    size_t write_pos;   // End of received bytes
+    size_t scan_pos;    // Bytes before this were already searched for '\n'
+
+public:
+    explicit ReceiveBuffer(size_t initial_capacity = 4096);
+
+    /*
+    * Makes room for at least min_free bytes behind the received data.
+    * @return pointer to recv() into, followed by writableSize() free bytes
+    */
+    char* prepareWrite(size_t min_free);
+    size_t writableSize() const { return capacity - write_pos; }
+    /*
+    * Marks count bytes written at prepareWrite() pointer as received.
+    */
+    void commit(size_t count) { write_pos += count; }
+
+    // Received bytes not split off yet, valid until the next prepareWrite()
+    std::string_view unread() const { return std::string_view(storage.get() + read_pos, write_pos - read_pos); }
+    void consume(size_t count);
+    /*
+    * Splits next complete line (without '\n') off the front, scanning only bytes not searched before.
+    * @return false if unread data contains no complete line yet
+    */
+    bool nextLine(std::string_view& line);
+
+    size_t size() const { return write_pos - read_pos; }
+    bool empty() const { return read_pos == write_pos; }
+};
+
+#endif //RECEIVEBUFFER_H
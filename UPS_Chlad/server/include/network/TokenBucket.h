@@ -0,0 +1,57 @@
+// TokenBucket.h - Token bucket rate limiter
+// KIV/UPS Network Programming Project
+
+#ifndef TOKENBUCKET_H
+#define TOKENBUCKET_H
+
+#include <chrono>
+#include <algorithm>
+
+/*
+* Rate limiter allowing burst events at once and rate events per second on average.
+* A rate of 0 disables the limit. Not thread safe, every bucket belongs to one thread.
+*/
+class TokenBucket {
+private:
+    double rate;
+    double burst;
+    double tokens;
+    std::chrono::steady_clock::time_point last;
+
+    void refill(std::chrono::steady_clock::time_point now) {
+        tokens = std::min(burst, tokens + std::chrono::duration<double>(now - last).count() * rate);
+        last = now;
+    }
+
+public:
+    TokenBucket() : TokenBucket(0.0, 0.0) {}
+    TokenBucket(double per_second, double max_burst)
+        : rate(per_second), burst(std::max(1.0, max_burst)), tokens(burst), last(std::chrono::steady_clock::now()) {}
+
+    /*
+    * Takes one token.
+    * @return false if the bucket is empty and the event should be rejected
+    */
+    bool take(std::chrono::steady_clock::time_point now) {
+        if (rate <= 0.0) {
+            return true;
+        }
+        refill(now);
+        if (tokens < 1.0) {
+            return false;
+        }
+        tokens -= 1.0;
+        return true;
+    }
+
+    // True once the bucket refilled completely, i.e. it would behave exactly like a new one
+    bool isFull(std::chrono::steady_clock::time_point now) {
+        if (rate <= 0.0) {
+            return true;
+        }
+        refill(now);
+        return tokens >= burst;
+    }
+};
+
+#endif //TOKENBUCKET_H
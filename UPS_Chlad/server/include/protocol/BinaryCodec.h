@@ -0,0 +1,91 @@
+// BinaryCodec.h - Optional length-prefixed binary wire format
+// KIV/UPS Network Programming Project
+
+#ifndef BINARY_CODEC_H
+#define BINARY_CODEC_H
+
+#include <string>
+#include <string_view>
+#include <map>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+#include "ProtocolMessage.h"
+
+/*
+* Binary encoding of ProtocolMessage, used on a connection once the client asked for it with binary=true
+* in CONNECT / RECONNECT and the server acknowledged it in CONNECTED (the last text frame of that connection).
+*
+* frame:   varint payload length, payload
+* payload: varint type, name player_id, name room_id,
+*          varint field count, per field key + kind byte + value,
+*          varint flag count, per flag key, then one bit per flag (LSB first) for "true" / "false" values
+* key:     varint FieldCodes index + 1, or 0 followed by text key
+* name:    varint 0 = empty, 1 = text, 2 = text appended to intern table, n >= 3 = intern table entry n - 3
+* text:    varint length, bytes
+*
+* Each direction of a connection keeps its own intern table, so player and room names cross the wire once.
+*/
+namespace BinaryProtocol {
+    constexpr size_t MAX_FRAME_SIZE = 8192;     // Same limit as one text message
+    constexpr size_t MAX_INTERNED = 1024;       // Names beyond this are sent as plain text
+
+    enum class Kind : uint8_t {
+        TEXT = 0,       // text
+        NUMBER = 1,     // varint, for decimal values without leading zeros
+        CARDS = 2,      // varint count, one CardId byte per card of a comma separated list
+        CODE = 3,       // varint FieldCodes index of a mapped value
+        NAME = 4        // name
+    };
+}
+
+/*
+* Writes frames for one connection. Not thread safe, the network layer uses it under the connection's write_mutex.
+*/
+class BinaryEncoder {
+private:
+    std::unordered_map<std::string, uint32_t> interned;
+
+    void appendName(std::string& out, const std::string& name);
+
+public:
+    /*
+    * Appends one frame for message to out. Header carries header_player_id instead of message.player_id,
+    * extra_data (may be nullptr) is encoded as if merged into data, same as ProtocolMessage::serializeTo.
+    */
+    void encode(const ProtocolMessage& message, const std::string& header_player_id,
+                const std::map<std::string, std::string>* extra_data, std::string& out);
+
+    // Intern table in index order, hot restart carries it to the encoder of the new process
+    std::vector<std::string> internedNames() const;
+    void restoreInterned(const std::vector<std::string>& names);
+};
+
+/*
+* Reads frames of one connection, only the thread reading the socket uses it.
+*/
+class BinaryDecoder {
+private:
+    std::vector<std::string> interned;
+
+public:
+    enum class Status {
+        OK,             // One frame decoded into out, consumed holds its size
+        INCOMPLETE,     // Input ends inside the frame, nothing consumed
+        INVALID         // Malformed or oversized frame, connection must be closed
+    };
+
+    /*
+    * Decodes the frame at the start of input.
+    * @param consumed - bytes of input taken by the frame (OK only)
+    * @param out - decoded message with full field names and values (OK only)
+    */
+    Status decode(std::string_view input, size_t& consumed, ProtocolMessage& out);
+
+    // Intern table in index order, hot restart carries it to the decoder of the new process
+    const std::vector<std::string>& internedNames() const { return interned; }
+    void restoreInterned(const std::vector<std::string>& names) { interned = names; }
+};
+
+#endif // BINARY_CODEC_H
@@ -0,0 +1,20 @@
+// EncodedFrame.h - Immutable serialized frame shared between outbound queues
+// KIV/UPS Network Programming Project
+
+#ifndef ENCODED_FRAME_H
+#define ENCODED_FRAME_H
+
+#include <string>
+#include <memory>
+
+/*
+* Message serialized once for many recipients. Every outbound queue it is enqueued to holds a reference,
+* the bytes are never copied per socket and never modified after creation.
+*/
+using EncodedFrame = std::shared_ptr<const std::string>;
+
+inline EncodedFrame makeEncodedFrame(std::string bytes) {
+    return std::make_shared<const std::string>(std::move(bytes));
+}
+
+#endif // ENCODED_FRAME_H
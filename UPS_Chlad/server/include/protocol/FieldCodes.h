@@ -0,0 +1,171 @@
+// FieldCodes.h - Compact protocol field codes resolved at compile time
+// KIV/UPS Network Programming Project
+
+#ifndef FIELD_CODES_H
+#define FIELD_CODES_H
+
+#include <string_view>
+#include <array>
+#include <cstdint>
+#include <cstddef>
+
+/*
+* Verbose field names (and common values) and the compact codes sent on the wire.
+* Both directions are looked up through collision-free hash tables built by the compiler,
+* so translating a token costs one hash and one comparison and never allocates.
+*/
+namespace FieldCodes {
+
+struct Entry {
+    std::string_view full;
+    std::string_view code;
+};
+
+inline constexpr Entry TABLE[] = {
+    // Field names
+    {"hand", "h"},
+    {"reserves", "r"},
+    {"opponent_hand", "oh"},
+    {"opponent_reserves", "or"},
+    {"opponent_name", "on"},
+    {"top_card", "tc"},
+    {"discard_pile_size", "dp"},
+    {"deck_size", "dk"},
+    {"must_play_low", "ml"},
+    {"your_turn", "yt"},
+    {"current_player", "cp"},
+    {"status", "st"},
+    {"name", "nm"},
+    {"error", "er"},
+    {"result", "rs"},
+    {"cards", "cd"},
+    {"winner", "wn"},
+    {"reconnected_player", "rp"},
+    {"disconnected_player", "dc"},
+    {"broadcast_type", "bt"},
+    {"joined_player", "jp"},
+    {"players", "pl"},
+    {"player_count", "pc"},
+    {"room_full", "rf"},
+    {"disconnect", "disc"},
+    {"message", "msg"},
+    {"reason", "rsn"},
+    {"seq", "sq"},
+    {"hand_add", "ha"},
+    {"hand_remove", "hr"},
+    {"binary", "bin"},
+
+    // Status values
+    {"temporarily_disconnected", "temp"},
+    {"reconnected", "recon"},
+    {"success", "ok"},
+    {"game_over", "end"},
+    {"started", "start"},
+    {"left", "lft"},
+    {"timed_out", "tout"},
+    {"invalid_message", "inv"},
+
+    // Result values
+    {"play_success", "pok"},
+    {"pickup_success", "uok"},
+    {"opponent_disconnect", "opdc"},
+
+    // Other common values
+    {"room_notification", "rnotif"}
+};
+
+inline constexpr size_t COUNT = sizeof(TABLE) / sizeof(TABLE[0]);
+inline constexpr size_t SLOTS = 256;
+inline constexpr uint8_t EMPTY_SLOT = 0xFF;
+inline constexpr uint32_t NO_SEED = UINT32_MAX;
+
+static_assert(COUNT < EMPTY_SLOT, "Field code table does not fit into slot index type");
+
+// FNV-1a mixed with a seed, seed is searched at compile time until no two keys share a slot.
+// The final shifts fold high bits down, FNV alone leaves the low (slot) bits dependent on the low seed bits only.
+constexpr uint32_t hash(std::string_view key, uint32_t seed) {
+    uint32_t h = 2166136261u ^ (seed * 0x9E3779B9u);
+    for (char c : key) {
+        h ^= static_cast<unsigned char>(c);
+        h *= 16777619u;
+    }
+    h ^= h >> 16;
+    h *= 0x45D9F3Bu;
+    h ^= h >> 16;
+    return h;
+}
+
+struct PerfectHash {
+    uint32_t seed;
+    std::array<uint8_t, SLOTS> slots;
+};
+
+constexpr PerfectHash buildPerfectHash(bool by_code) {
+    for (uint32_t seed = 0; seed < 4096; ++seed) {
+        PerfectHash table{seed, {}};
+        for (size_t slot = 0; slot < SLOTS; ++slot) {
+            table.slots[slot] = EMPTY_SLOT;
+        }
+
+        bool collision = false;
+        for (size_t i = 0; i < COUNT && !collision; ++i) {
+            std::string_view key = by_code ? TABLE[i].code : TABLE[i].full;
+            size_t slot = hash(key, seed) % SLOTS;
+            if (table.slots[slot] != EMPTY_SLOT) {
+                collision = true;
+            } else {
+                table.slots[slot] = static_cast<uint8_t>(i);
+            }
+        }
+        if (!collision) {
+            return table;
+        }
+    }
+    return PerfectHash{NO_SEED, {}};
+}
+
+inline constexpr PerfectHash BY_CODE = buildPerfectHash(true);
+inline constexpr PerfectHash BY_FULL = buildPerfectHash(false);
+
+static_assert(BY_CODE.seed != NO_SEED, "No collision-free seed for compact field codes");
+static_assert(BY_FULL.seed != NO_SEED, "No collision-free seed for full field names");
+
+/*
+* @return verbose name for compact code, or the code itself if it has no mapping
+*/
+constexpr std::string_view expand(std::string_view code) {
+    uint8_t index = BY_CODE.slots[hash(code, BY_CODE.seed) % SLOTS];
+    if (index != EMPTY_SLOT && TABLE[index].code == code) {
+        return TABLE[index].full;
+    }
+    return code;
+}
+
+/*
+* @return compact code for verbose name, or the name itself if it has no mapping
+*/
+constexpr std::string_view compact(std::string_view full) {
+    uint8_t index = BY_FULL.slots[hash(full, BY_FULL.seed) % SLOTS];
+    if (index != EMPTY_SLOT && TABLE[index].full == full) {
+        return TABLE[index].code;
+    }
+    return full;
+}
+
+/*
+* @return position of verbose name in TABLE (binary protocol sends it instead of the text), or -1 if it has no mapping
+*/
+constexpr int indexOf(std::string_view full) {
+    uint8_t index = BY_FULL.slots[hash(full, BY_FULL.seed) % SLOTS];
+    if (index != EMPTY_SLOT && TABLE[index].full == full) {
+        return index;
+    }
+    return -1;
+}
+
+static_assert(expand("nm") == "name" && compact("name") == "nm", "Field code lookup broken");
+static_assert(expand("unknown") == "unknown", "Unmapped codes must pass through");
+
+} // namespace FieldCodes
+
+#endif // FIELD_CODES_H
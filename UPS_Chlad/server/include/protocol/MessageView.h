@@ -0,0 +1,53 @@
+// MessageView.h - Non-owning parsed view of one received protocol message
+// KIV/UPS Network Programming Project
+
+#ifndef MESSAGE_VIEW_H
+#define MESSAGE_VIEW_H
+
+#include <string_view>
+#include <array>
+#include <cstddef>
+#include "MessageType.h"
+
+/*
+* Result of tokenizing raw message TYPE|PLAYER_ID|ROOM_ID|KEY1=VALUE1|... in place.
+* player_id, room_id and unmapped keys/values point into the raw message, so the view is only valid
+* while the buffer it was parsed from is alive and unchanged. Mapped keys/values point to static field names.
+*/
+struct MessageView {
+    static constexpr size_t MAX_FIELDS = 16;   // Client requests carry at most a couple of fields
+
+    struct Field {
+        std::string_view key;       // Full field name (compact code already expanded)
+        std::string_view value;     // Full value for non-numeric mapped values, raw otherwise
+    };
+
+    enum class ParseStatus {
+        OK,
+        INVALID_FORMAT,     // Empty, no '|' after type, type not a number in 0-200 or more than MAX_FIELDS fields
+        INVALID_TYPE        // Well-formed, but type is not an existing MessageType
+    };
+
+    int type_code = 0;
+    std::string_view player_id;
+    std::string_view room_id;
+    std::array<Field, MAX_FIELDS> fields;
+    size_t field_count = 0;
+
+    /*
+    * Tokenizes and validates raw message in a single pass without allocating.
+    * @param raw - one message without trailing newline
+    * @param out - view to fill, only meaningful when OK is returned
+    * @return OK or reason the message is rejected
+    */
+    static ParseStatus parse(std::string_view raw, MessageView& out);
+
+    MessageType type() const { return static_cast<MessageType>(type_code); }
+    /*
+    * @return value of field with given full name, or default_value if message does not contain it
+    */
+    std::string_view get(std::string_view key, std::string_view default_value = {}) const;
+    bool has(std::string_view key) const;
+};
+
+#endif // MESSAGE_VIEW_H
@@ -5,6 +5,7 @@
 #ifndef PROTOCOLHELPER_H
 #define PROTOCOLHELPER_H
 #include <string>
+#include <string_view>
 #include <vector>
 #include "MessageType.h"
 #include "ProtocolMessage.h"
@@ -57,6 +58,11 @@ public:
     * @return ProtocolMessage that will be sent to User after success
     */
     static ProtocolMessage createPongResponse();
+    /*
+    * Constant messages are rendered once at startup, sending them needs no serialization.
+    * @return complete frame (with "\n") if message is one of the constant messages, else empty view
+    */
+    static std::string_view prerenderedFrame(const ProtocolMessage& message);
     
     /*
     * takes param values as strings and build ProtocolMessage response when game state is required.
@@ -79,16 +85,19 @@ public:
 
     /*
     * Creates a compact delta update message (TURN_UPDATE) for game state changes.
-    * Only includes fields that have changed since last update.
+    * Only includes fields that have changed since previous, the hand as added and removed cards.
+    * Every update carries seq, a client that sees a gap asks for full state with RESYNC.
     * @param player_name - player id (recipient)
     * @param room_id - room id (usually empty since client knows)
     * @param game_data - current game state data
+    * @param previous - state the recipient was sent last, everything is sent if it is not valid
     * @return ProtocolMessage with only delta fields (much smaller than full state)
     */
     static ProtocolMessage createTurnUpdateResponse(
         const std::string& player_name,
         const std::string& room_id,
-        const GameStateData& game_data
+        const GameStateData& game_data,
+        const GameStateData& previous
     );
 
     // Validation utilities
@@ -6,7 +6,9 @@
 
 #include <string>
 #include <map>
+#include <vector>
 #include "MessageType.h"
+#include "MessageView.h"
 
 struct ProtocolMessage {
     MessageType type;
@@ -14,12 +16,10 @@ struct ProtocolMessage {
     std::string room_id;
     std::map<std::string, std::string> data;
     bool should_broadcast_to_room = false;
+    // Same message for several players - body is serialized once, only "TYPE|PLAYER|ROOM" header differs per player
+    std::vector<std::string> recipients;
 
-    // Field code mappings (old verbose names → new compact codes)
-    static const std::map<std::string, std::string> FIELD_CODE_MAP;
-    static const std::map<std::string, std::string> REVERSE_FIELD_CODE_MAP;
-
-    // Helper to get compact code for a field name
+    // Helper to get compact code for a field name (mappings live in FieldCodes.h)
     static std::string getCompactCode(const std::string& field_name);
     static std::string getFullFieldName(const std::string& compact_code);
 
@@ -32,10 +32,33 @@ struct ProtocolMessage {
     */
     std::string serialize() const;
     /*
+    * Appends serialized message including "\n" terminator to out, keys and values are translated to compact
+    * codes without allocating, so a reused buffer costs nothing once it has grown.
+    */
+    void serializeTo(std::string& out) const;
+    /*
+    * Same as serializeTo, but extra_data is serialized as if it was merged into data (extra wins on equal key).
+    * Lets a variant of the message (e.g. room notification) be encoded without copying the message.
+    */
+    void serializeTo(std::string& out, const std::map<std::string, std::string>& extra_data) const;
+    /*
+    * Appends "TYPE|PLAYER_ID|ROOM_ID" with given player id (used for per-recipient headers)
+    */
+    void serializeHeaderTo(std::string& out, const std::string& header_player_id) const;
+    /*
+    * Appends "|KEY1=VALUE1|...\n" - everything after the header
+    */
+    void serializeBodyTo(std::string& out) const;
+    /*
     * Parses string message in this format type|player|room|key_value1|key_value2|..|..|key_valuen
+    * Thin wrapper over MessageView::parse, rejected messages come back as ERROR_MSG.
     * @return ProtocolMessage format
     */
     static ProtocolMessage parse(const std::string& message);
+    /*
+    * Copies already parsed view into owning message
+    */
+    static ProtocolMessage fromView(const MessageView& view);
 
     // Helper methods
     /*
@@ -0,0 +1,467 @@
+// GameJournal.cpp - Append-only per-room game journal
+// KIV/UPS Network Programming Project
+
+#include "GameJournal.h"
+#include "Logger.h"
+#include "Room.h"
+#include "RoomManager.h"
+#include "PlayerManager.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+namespace {
+    constexpr size_t MAX_QUEUED_BYTES = 256 * 1024;    // Writer is woken before the interval ends past this
+    constexpr std::string_view JOURNAL_SUFFIX = ".journal";
+    constexpr std::string_view RECOVERING_SUFFIX = ".recovering";
+
+    bool hasValue(GameJournal::Event event) {
+        return event == GameJournal::Event::GAME_START || event == GameJournal::Event::PLAY_CARDS;
+    }
+
+    const char* eventName(GameJournal::Event event) {
+        switch (event) {
+            case GameJournal::Event::JOIN:          return "JOIN";
+            case GameJournal::Event::LEAVE:         return "LEAVE";
+            case GameJournal::Event::GAME_START:    return "GAME_START";
+            case GameJournal::Event::PLAY_CARDS:    return "PLAY_CARDS";
+            case GameJournal::Event::PLAY_RESERVE:  return "PLAY_RESERVE";
+            case GameJournal::Event::PICKUP_PILE:   return "PICKUP_PILE";
+            case GameJournal::Event::GAME_RESET:    return "GAME_RESET";
+            case GameJournal::Event::CLOSE:         return "CLOSE";
+        }
+        return "UNKNOWN";
+    }
+
+    bool endsWith(std::string_view text, std::string_view suffix) {
+        return text.size() >= suffix.size() && text.substr(text.size() - suffix.size()) == suffix;
+    }
+}
+
+GameJournal::GameJournal(Logger* lg, const std::string& dir, int interval_ms, bool sync_writes, bool keep)
+    : logger(lg), directory(dir), flush_interval_ms(interval_ms), sync(sync_writes), keep_finished(keep), running(false) {}
+
+GameJournal::~GameJournal() {
+    stop();
+}
+
+bool GameJournal::start(std::string& error) {
+    if (mkdir(directory.c_str(), 0755) < 0 && errno != EEXIST) {
+        error = "cannot create " + directory + ": " + std::string(strerror(errno));
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        running = true;
+    }
+    writer_thread = std::thread(&GameJournal::writerLoop, this);
+    logger->info("Game journal writing to " + directory + " (group commit every " + std::to_string(flush_interval_ms)
+                 + " ms" + (sync ? ", fdatasync" : "") + ")");
+    return true;
+}
+
+void GameJournal::stop() {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        if (!running) {
+            return;
+        }
+        running = false;
+        queue_cv.notify_one();
+    }
+    if (writer_thread.joinable()) {
+        writer_thread.join();
+    }
+
+    for (const auto& file : files) {
+        close(file.second);
+    }
+    files.clear();
+}
+
+void GameJournal::recordJoin(const std::string& room_id, const std::string& player) {
+    append(room_id, Event::JOIN, player, nullptr);
+}
+
+void GameJournal::recordLeave(const std::string& room_id, const std::string& player) {
+    append(room_id, Event::LEAVE, player, nullptr);
+}
+
+void GameJournal::recordGameStart(const std::string& room_id, uint64_t seed) {
+    append(room_id, Event::GAME_START, {}, &seed);
+}
+
+void GameJournal::recordPlayCards(const std::string& room_id, const std::string& player, CardSet cards) {
+    uint64_t mask = cards.mask();
+    append(room_id, Event::PLAY_CARDS, player, &mask);
+}
+
+void GameJournal::recordPlayFromReserve(const std::string& room_id, const std::string& player) {
+    append(room_id, Event::PLAY_RESERVE, player, nullptr);
+}
+
+void GameJournal::recordPickupPile(const std::string& room_id, const std::string& player) {
+    append(room_id, Event::PICKUP_PILE, player, nullptr);
+}
+
+void GameJournal::recordGameReset(const std::string& room_id) {
+    append(room_id, Event::GAME_RESET, {}, nullptr);
+}
+
+void GameJournal::recordClose(const std::string& room_id) {
+    append(room_id, Event::CLOSE, {}, nullptr);
+}
+
+void GameJournal::append(const std::string& room_id, Event event, std::string_view player, const uint64_t* value) {
+    size_t name_length = std::min(player.size(), size_t{255});
+
+    std::lock_guard<std::mutex> lock(queue_mutex);
+    queue.push_back(static_cast<char>(room_id.size()));
+    queue += room_id;
+    queue.push_back(static_cast<char>(event));
+    queue.push_back(static_cast<char>(name_length));
+    queue.append(player.data(), name_length);
+    if (value) {
+        for (int shift = 0; shift < 64; shift += 8) {
+            queue.push_back(static_cast<char>(*value >> shift));
+        }
+    }
+    if (queue.size() >= MAX_QUEUED_BYTES) {
+        queue_cv.notify_one();
+    }
+}
+
+void GameJournal::writerLoop() {
+    std::string batch;
+    while (true) {
+        bool still_running;
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex);
+            queue_cv.wait_for(lock, std::chrono::milliseconds(flush_interval_ms),
+                              [this] { return !running || queue.size() >= MAX_QUEUED_BYTES; });
+            still_running = running;
+            batch.swap(queue);  // Queue continues in the buffer the previous batch left behind
+        }
+
+        if (!batch.empty()) {
+            commit(batch);
+            batch.clear();
+        }
+
+        if (!still_running) {
+            return;  // Queue was committed after stop was requested
+        }
+    }
+}
+
+void GameJournal::commit(const std::string& batch) {
+    // Group records by room, a closing room is written out right away so its file can be retired
+    size_t offset = 0;
+    while (offset < batch.size()) {
+        size_t id_length = static_cast<unsigned char>(batch[offset++]);
+        std::string room_id(batch, offset, id_length);
+        offset += id_length;
+
+        size_t record_start = offset;
+        Entry entry;
+        if (!nextEntry(batch, offset, entry)) {
+            logger->error("Game journal queue is corrupted, dropping " + std::to_string(batch.size() - record_start) + " bytes");
+            break;
+        }
+
+        std::string& records = room_batches[room_id];
+        records.append(batch, record_start, offset - record_start);
+        if (entry.event == Event::CLOSE) {
+            writeRoom(room_id, records, true);
+            room_batches.erase(room_id);
+        }
+    }
+
+    for (auto& pending : room_batches) {
+        if (!pending.second.empty()) {
+            writeRoom(pending.first, pending.second, false);
+        }
+    }
+}
+
+void GameJournal::writeRoom(const std::string& room_id, std::string& records, bool room_closed) {
+    std::string path = journalPath(room_id);
+    auto file = files.find(room_id);
+    if (file == files.end()) {
+        int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            logger->error("Failed to open game journal " + path + ": " + std::string(strerror(errno)));
+            records.clear();
+            return;
+        }
+        struct stat info;
+        if (fstat(fd, &info) == 0 && info.st_size == 0) {
+            std::string header(MAGIC);
+            header.push_back(static_cast<char>(VERSION));
+            records.insert(0, header);
+        }
+        file = files.emplace(room_id, fd).first;
+    }
+
+    int fd = file->second;
+    const char* data = records.data();
+    size_t left = records.size();
+    while (left > 0) {
+        ssize_t written = write(fd, data, left);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            logger->error("Failed to write game journal " + path + ": " + std::string(strerror(errno)));
+            break;
+        }
+        data += written;
+        left -= static_cast<size_t>(written);
+    }
+    if (sync && fdatasync(fd) < 0) {
+        logger->warning("fdatasync failed for game journal " + path + ": " + std::string(strerror(errno)));
+    }
+    records.clear();
+
+    if (room_closed) {
+        close(fd);
+        files.erase(file);
+        if (!keep_finished) {
+            unlink(path.c_str());
+            return;
+        }
+        auto now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        std::string replay_path = directory + "/" + room_id + "-" + std::to_string(now_ms) + ".replay";
+        if (rename(path.c_str(), replay_path.c_str()) < 0) {
+            logger->warning("Failed to retire game journal " + path + ": " + std::string(strerror(errno)));
+        }
+    }
+}
+
+std::string GameJournal::journalPath(const std::string& room_id) const {
+    return directory + "/" + room_id + std::string(JOURNAL_SUFFIX);
+}
+
+size_t GameJournal::recover(RoomManager* roomManager, PlayerManager* playerManager) {
+    // Moved aside first, a restored room may get the id some other leftover journal is named after
+    std::vector<std::string> leftovers;
+    DIR* dir = opendir(directory.c_str());
+    if (!dir) {
+        return 0;
+    }
+    while (struct dirent* item = readdir(dir)) {
+        std::string name = item->d_name;
+        if (!endsWith(name, JOURNAL_SUFFIX)) {
+            continue;
+        }
+        std::string path = directory + "/" + name;
+        std::string aside = path + std::string(RECOVERING_SUFFIX);
+        if (rename(path.c_str(), aside.c_str()) == 0) {
+            leftovers.push_back(aside);
+        }
+    }
+    closedir(dir);
+    std::sort(leftovers.begin(), leftovers.end());
+
+    size_t restored = 0;
+    for (const std::string& path : leftovers) {
+        std::string old_name = path.substr(directory.size() + 1);
+        old_name.resize(old_name.size() - JOURNAL_SUFFIX.size() - RECOVERING_SUFFIX.size());
+
+        std::string data;
+        if (!readFile(path, data) || data.size() < HEADER_SIZE || std::string_view(data).substr(0, MAGIC.size()) != MAGIC) {
+            logger->warning("Game journal " + path + " is not readable, left as it is");
+            continue;
+        }
+
+        size_t valid_end = HEADER_SIZE;
+        bool closed = false;
+        bool consistent = true;
+        std::string room_id = roomManager->restoreRoom([&](Room& room) {
+            size_t offset = HEADER_SIZE;
+            Entry entry;
+            while (nextEntry(data, offset, entry)) {
+                if (entry.event == Event::CLOSE) {
+                    closed = true;
+                    break;
+                }
+                if (!apply(room, entry)) {
+                    consistent = false;
+                    break;
+                }
+                valid_end = offset;
+            }
+            return consistent && !closed && !room.players.empty();
+        });
+
+        if (room_id.empty()) {
+            // Finished before its journal was retired, emptied, or not replayable - kept as a replay
+            if (!consistent) {
+                logger->warning("Game journal of " + old_name + " does not replay past offset " + std::to_string(valid_end));
+            }
+            std::string replay_path = directory + "/" + old_name + "-recovered.replay";
+            if (!keep_finished) {
+                unlink(path.c_str());
+            } else if (rename(path.c_str(), replay_path.c_str()) < 0) {
+                logger->warning("Failed to retire game journal " + path + ": " + std::string(strerror(errno)));
+            }
+            continue;
+        }
+
+        // Torn tail goes before the restored room appends to the file under its new name
+        if (valid_end < data.size() && truncate(path.c_str(), static_cast<off_t>(valid_end)) < 0) {
+            logger->warning("Failed to cut torn tail of " + path + ": " + std::string(strerror(errno)));
+        }
+        if (rename(path.c_str(), journalPath(room_id).c_str()) < 0) {
+            logger->warning("Failed to rename game journal " + path + ": " + std::string(strerror(errno)));
+        }
+
+        std::vector<std::string> players = roomManager->getRoomPlayers(room_id);
+        for (const std::string& player : players) {
+            if (!playerManager->restoreDisconnectedPlayer(player, room_id)) {
+                logger->warning("Player '" + player + "' of recovered room " + room_id + " already exists, removing the seat");
+                roomManager->handlePlayerTimeout(player, room_id);
+            }
+        }
+        logger->info("Recovered room " + old_name + " as " + room_id + " with " + std::to_string(players.size()) + " player(s)");
+        restored++;
+    }
+    return restored;
+}
+
+bool GameJournal::nextEntry(std::string_view data, size_t& offset, Entry& entry) {
+    if (offset + 2 > data.size()) {
+        return false;
+    }
+    uint8_t code = static_cast<uint8_t>(data[offset]);
+    if (code < static_cast<uint8_t>(Event::JOIN) || code > static_cast<uint8_t>(Event::CLOSE)) {
+        return false;
+    }
+    Event event = static_cast<Event>(code);
+    size_t name_length = static_cast<unsigned char>(data[offset + 1]);
+    size_t end = offset + 2 + name_length + (hasValue(event) ? 8 : 0);
+    if (end > data.size()) {
+        return false;
+    }
+
+    entry.event = event;
+    entry.player = data.substr(offset + 2, name_length);
+    entry.value = 0;
+    if (hasValue(event)) {
+        for (int i = 7; i >= 0; --i) {
+            entry.value = (entry.value << 8) | static_cast<unsigned char>(data[offset + 2 + name_length + i]);
+        }
+    }
+    offset = end;
+    return true;
+}
+
+bool GameJournal::apply(Room& room, const Entry& entry) {
+    std::string player(entry.player);
+    switch (entry.event) {
+        case Event::JOIN:
+            return room.addPlayerToGame(player);
+        case Event::LEAVE: {
+            auto it = std::find(room.players.begin(), room.players.end(), player);
+            if (it == room.players.end()) {
+                return false;
+            }
+            room.players.erase(it);
+            room.gameLogic->removePlayer(player);
+            return true;
+        }
+        case Event::GAME_START:
+            return room.startGame(entry.value);
+        case Event::PLAY_CARDS:
+            return room.isGameActive() && room.gameLogic->playCards(player, CardSet(entry.value));
+        case Event::PLAY_RESERVE:
+            return room.isGameActive() && room.gameLogic->playFromReserve(player);
+        case Event::PICKUP_PILE:
+            return room.isGameActive() && room.gameLogic->pickupDiscardPile(player);
+        case Event::GAME_RESET:
+            room.resetGame();
+            return true;
+        case Event::CLOSE:
+            return true;
+    }
+    return false;
+}
+
+bool GameJournal::printReplay(const std::string& path, std::ostream& out) {
+    std::string data;
+    if (!readFile(path, data) || data.size() < HEADER_SIZE || std::string_view(data).substr(0, MAGIC.size()) != MAGIC) {
+        out << "Not a game journal: " << path << std::endl;
+        return false;
+    }
+
+    Room room("replay");
+    size_t offset = HEADER_SIZE;
+    size_t number = 0;
+    Entry entry;
+    while (nextEntry(data, offset, entry)) {
+        bool applied = apply(room, entry);
+
+        out << "#" << ++number << " " << eventName(entry.event);
+        if (!entry.player.empty()) {
+            out << " " << entry.player;
+        }
+        if (entry.event == Event::GAME_START) {
+            out << " seed=" << entry.value;
+        } else if (entry.event == Event::PLAY_CARDS) {
+            std::string cards;
+            CardSet(entry.value).appendNames(cards);
+            out << " " << cards;
+        }
+        if (!applied) {
+            out << " REJECTED (journal does not match the game)";
+        }
+        out << "\n";
+
+        const GameLogic& game = *room.gameLogic;
+        if (room.isGameActive() || room.isGameFinished()) {
+            out << "    turn=" << game.getCurrentPlayer() << " deck=" << game.getDeckSize()
+                << " pile=" << game.getDiscardPileSize();
+            if (game.getDiscardPileSize() > 0) {
+                out << " top=" << cardName(game.getTopDiscardCard());
+            }
+            for (const std::string& player : room.players) {
+                std::string hand;
+                game.getPlayerHand(player).appendNames(hand);
+                out << " | " << player << " [" << hand << "] reserves=" << game.getPlayerReserveSize(player);
+            }
+            out << "\n";
+        }
+
+        if (entry.event == Event::CLOSE) {
+            break;
+        }
+    }
+
+    if (offset < data.size() && entry.event != Event::CLOSE) {
+        out << "Journal ends with " << (data.size() - offset) << " bytes of an incomplete record" << std::endl;
+    }
+    if (room.isGameFinished()) {
+        out << "Winner: " << room.gameLogic->getWinner() << std::endl;
+    }
+    return true;
+}
+
+bool GameJournal::readFile(const std::string& path, std::string& data) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    std::ostringstream content;
+    content << file.rdbuf();
+    data = content.str();
+    return true;
+}
@@ -1,6 +1,8 @@
 #include "GameManager.h"
 #include "RoomManager.h"
 #include "Room.h"
+#include "GameJournal.h"
+#include "Tracing.h"
 #include "../game/CardDeck.h"
 #include "../game/GameLogic.h"
 #include <stdexcept>
@@ -11,42 +13,57 @@ GameManager::GameManager() {
 
 bool GameManager::playCards(RoomManager* roomManager, const std::string& room_id, 
                            const std::string& player_name, const std::vector<std::string>& card_strings) {
-    
+    Tracing::Span span("GameManager::playCards");
     return roomManager->withRoom(room_id, [&](Room* room) -> bool {
         if (!room || !room->isGameActive()) return false;
         
         // Check if player is trying to play from reserves
         if (card_strings.size() == 1 && card_strings[0] == "RESERVE") {
             // Player wants to play from reserves
-            return room->gameLogic->playFromReserve(player_name);
+            if (!room->gameLogic->playFromReserve(player_name)) {
+                return false;
+            }
+            if (GameJournal* journal = roomManager->getGameJournal()) {
+                journal->recordPlayFromReserve(room->id, player_name);
+            }
+            return true;
         }
         
-        // Normal card play - convert protocol strings to domain objects
-        std::vector<Card> cardObjects;
-        for (const std::string& cardStr : card_strings) {
-            Card card = parseCardFromString(cardStr);
-            if (card.rank == Rank::ACE && card.suit == Suit::HEARTS && cardStr != "AH") {
-                return false; // Invalid card string
-            }
-            cardObjects.push_back(card);
+        // Normal card play - convert protocol strings to card ids
+        CardSet cards;
+        if (!parseCards(card_strings, cards)) {
+            return false; // Invalid card string
         }
         
         // Execute game logic safely within lock
-        return room->gameLogic->playCards(player_name, cardObjects);
+        if (!room->gameLogic->playCards(player_name, cards)) {
+            return false;
+        }
+        if (GameJournal* journal = roomManager->getGameJournal()) {
+            journal->recordPlayCards(room->id, player_name, cards);
+        }
+        return true;
     });
 }
 
 bool GameManager::pickupPile(RoomManager* roomManager, const std::string& room_id, 
                             const std::string& player_name) {
-    
+    Tracing::Span span("GameManager::pickupPile");
     return roomManager->withRoom(room_id, [&](Room* room) -> bool {
         if (!room || !room->isGameActive()) return false;
         
-        return room->gameLogic->pickupDiscardPile(player_name);
+        if (!room->gameLogic->pickupDiscardPile(player_name)) {
+            return false;
+        }
+        if (GameJournal* journal = roomManager->getGameJournal()) {
+            journal->recordPickupPile(room->id, player_name);
+        }
+        return true;
     });
 }
 
 bool GameManager::startGame(RoomManager* roomManager, const std::string& room_id) {
+    Tracing::Span span("GameManager::startGame");
     return roomManager->withRoom(room_id, [&](Room* room) -> bool {
         if (!room){
             return false;
@@ -56,69 +73,144 @@ bool GameManager::startGame(RoomManager* roomManager, const std::string& room_id
             return false; // Need at least 2 players
         }
 
-        return room->startGame();
+        if (!room->startGame()) {
+            return false;
+        }
+        if (GameJournal* journal = roomManager->getGameJournal()) {
+            journal->recordGameStart(room->id, room->gameLogic->getSeed());
+        }
+        return true;
     });
 }
 
 GameStateData GameManager::getGameStateForPlayer(RoomManager* roomManager, const std::string& room_id, 
                                                  const std::string& player_name) {
-    
+    Tracing::Span span("GameManager::getGameStateForPlayer");
     return roomManager->withRoom(room_id, [&](Room* room) -> GameStateData {
-        GameStateData result;
-        result.valid = false;
-        
-        if (!room) {
-            result.error_message = "Room not found";
-            return result;
+        GameStateData result = buildGameState(room, player_name);
+        if (result.valid) {
+            // Full state resets the baseline for deltas
+            GameStateData& sent = room->sent_state[player_name];
+            result.seq = sent.seq + 1;
+            sent = result;
         }
-        
-        if (!room->isGameActive()) {
-            result.error_message = "Game not active";
-            return result;
+        return result;
+    });
+}
+
+RoomSnapshot GameManager::getRoomSnapshot(RoomManager* roomManager, const std::string& room_id, bool full_state) {
+    Tracing::Span span("GameManager::getRoomSnapshot");
+    return roomManager->withRoom(room_id, [&](Room* room) -> RoomSnapshot {
+        RoomSnapshot snapshot;
+
+        GameStateData shared;
+        if (!buildSharedState(room, shared)) {
+            snapshot.error_message = shared.error_message;
+            return snapshot;
         }
-        
-        // Get player's hand cards
-        std::vector<Card> hand_cards = room->gameLogic->getPlayerHand(player_name);
-        result.hand_cards = convertCardsToStrings(hand_cards);
-        
-        // Get reserve count (not actual cards)
-        result.reserve_count = room->gameLogic->getPlayerReserveSize(player_name);
-        
-        // Get current player
-        result.current_player = room->gameLogic->getCurrentPlayer();
-        
-        // Get top discard card
-        if (!room->gameLogic->getDiscardPile().empty()) {
-            result.top_discard_card = room->gameLogic->getTopDiscardCard().toString();
-        } else {
-            // Empty pile - use placeholder card (1S)
-            result.top_discard_card = "1S";  // Placeholder: any card can be played
+
+        // Each player's public counts are described once and reused for every other recipient
+        std::vector<std::string> descriptions;
+        descriptions.reserve(room->players.size());
+        for (const std::string& player : room->players) {
+            descriptions.push_back(describePlayer(room, player));
         }
-        
-        // Get other players' info
-        for (const std::string& other_player : room->players) {
-            if (other_player != player_name) {
-                int hand_size = room->gameLogic->getPlayerHandSize(other_player);
-                int reserve_size = room->gameLogic->getPlayerReserveSize(other_player);
-                result.other_players_info.push_back(other_player + ":" + 
-                                                   std::to_string(hand_size) + ":" + 
-                                                   std::to_string(reserve_size));
+
+        snapshot.players = room->players;
+        snapshot.game_seed = room->gameLogic->getSeed();
+        snapshot.views.resize(room->players.size());
+        for (size_t i = 0; i < room->players.size(); ++i) {
+            const std::string& player = room->players[i];
+            TurnUpdateData& view = snapshot.views[i];
+
+            view.current = shared;
+            projectPlayer(room, player, view.current);
+            for (size_t j = 0; j < descriptions.size(); ++j) {
+                if (j != i) {
+                    view.current.other_players_info.push_back(descriptions[j]);
+                }
             }
+
+            GameStateData& sent = room->sent_state[player];
+            view.current.seq = sent.seq + 1;
+            if (!full_state) {
+                view.previous = std::move(sent);
+            }
+            sent = view.current;
         }
-        
-        // Get special game state
-        result.must_play_seven_or_lower = room->gameLogic->getMustPlaySevenOrLower();
-        
-        // NEW: Get deck and discard pile sizes
-        result.deck_size = room->gameLogic->getDeckSize();
-        result.discard_pile_size = room->gameLogic->getDiscardPile().size();
-        
-        result.valid = true;
-        
-        return result;
+
+        snapshot.valid = true;
+        return snapshot;
     });
 }
 
+GameStateData GameManager::buildGameState(Room* room, const std::string& player_name) {
+    GameStateData result;
+    if (!buildSharedState(room, result)) {
+        return result;
+    }
+
+    projectPlayer(room, player_name, result);
+
+    // Get other players' info
+    for (const std::string& other_player : room->players) {
+        if (other_player != player_name) {
+            result.other_players_info.push_back(describePlayer(room, other_player));
+        }
+    }
+
+    return result;
+}
+
+bool GameManager::buildSharedState(Room* room, GameStateData& result) {
+    result.valid = false;
+
+    if (!room) {
+        result.error_message = "Room not found";
+        return false;
+    }
+
+    if (!room->isGameActive()) {
+        result.error_message = "Game not active";
+        return false;
+    }
+
+    // Get current player
+    result.current_player = room->gameLogic->getCurrentPlayer();
+    
+    // Get top discard card
+    if (room->gameLogic->getDiscardPileSize() > 0) {
+        result.top_discard_card = cardName(room->gameLogic->getTopDiscardCard());
+    } else {
+        // Empty pile - use placeholder card (1S)
+        result.top_discard_card = "1S";  // Placeholder: any card can be played
+    }
+    
+    // Get special game state
+    result.must_play_seven_or_lower = room->gameLogic->getMustPlaySevenOrLower();
+    
+    // NEW: Get deck and discard pile sizes
+    result.deck_size = room->gameLogic->getDeckSize();
+    result.discard_pile_size = room->gameLogic->getDiscardPileSize();
+    
+    result.valid = true;
+    return true;
+}
+
+void GameManager::projectPlayer(Room* room, const std::string& player_name, GameStateData& view) {
+    // Get player's hand cards
+    view.hand_cards = room->gameLogic->getPlayerHand(player_name);
+    
+    // Get reserve count (not actual cards)
+    view.reserve_count = room->gameLogic->getPlayerReserveSize(player_name);
+}
+
+std::string GameManager::describePlayer(Room* room, const std::string& player_name) {
+    return player_name + ":" +
+           std::to_string(room->gameLogic->getPlayerHandSize(player_name)) + ":" +
+           std::to_string(room->gameLogic->getPlayerReserveSize(player_name));
+}
+
 bool GameManager::isGameActive(RoomManager* roomManager, const std::string& room_id) {
     return roomManager->withRoom(room_id, [](Room* room) -> bool {
         return room && room->isGameActive();
@@ -169,55 +261,14 @@ std::string GameManager::getWinner(RoomManager* roomManager, const std::string&
 }
 
 // Helper methods implementation
-Card GameManager::parseCardFromString(const std::string& cardStr) {
-    if (cardStr.length() < 2) {
-        throw std::invalid_argument("Invalid card string: " + cardStr);
-    }
-
-    // Parse suit (last character)
-    char suitChar = cardStr[cardStr.length() - 1];
-    Suit suit;
-    switch (suitChar) {
-        case 'H': suit = Suit::HEARTS; break;
-        case 'D': suit = Suit::DIAMONDS; break;
-        case 'C': suit = Suit::CLUBS; break;
-        case 'S': suit = Suit::SPADES; break;
-        default: throw std::invalid_argument("Invalid suit: " + std::string(1, suitChar));
-    }
-
-    // Parse rank (everything except last character)
-    std::string rankStr = cardStr.substr(0, cardStr.length() - 1);
-    Rank rank;
-    
-    if (rankStr == "A") {
-        rank = Rank::ACE;
-    } else if (rankStr == "J") {
-        rank = Rank::JACK;
-    } else if (rankStr == "Q") {
-        rank = Rank::QUEEN;
-    } else if (rankStr == "K") {
-        rank = Rank::KING;
-    } else {
-        // Numeric rank (2-10)
-        try {
-            int rankValue = std::stoi(rankStr);
-            if (rankValue < 1 || rankValue > 13) {
-                throw std::invalid_argument("Rank out of range: " + rankStr);
-            }
-            rank = static_cast<Rank>(rankValue);
-        } catch (const std::exception&) {
-            throw std::invalid_argument("Invalid rank: " + rankStr);
+bool GameManager::parseCards(const std::vector<std::string>& card_strings, CardSet& out) {
+    out.clear();
+    for (const std::string& cardStr : card_strings) {
+        CardId card;
+        if (!parseCardId(cardStr, card) || out.contains(card)) {
+            return false; // Unknown card or the same card listed twice
         }
+        out.insert(card);
     }
-
-    Card result(suit, rank);
-    return result;
-}
-
-std::vector<std::string> GameManager::convertCardsToStrings(const std::vector<Card>& cards) {
-    std::vector<std::string> result;
-    for (const Card& card : cards) {
-        result.push_back(card.toString());
-    }
-    return result;
+    return !out.empty();
 }
\ No newline at end of file
@@ -3,74 +3,192 @@
 //
 
 #include "Logger.h"
+#include "Tracing.h"
 #include <iostream>
 #include <chrono>
-#include <sstream>
-#include <iomanip>
+#include <cstring>
 
-Logger::Logger(const std::string& filePath) {
+Logger::Logger(const std::string& filePath)
+    : logLevelMinimum(LogLevel::INFO), flushIntervalMs(100),
+      ring(new Slot[RING_CAPACITY]), enqueuePos(0), dequeuePos(0), droppedRecords(0),
+      running(true), cachedSecond(-1) {
     this->filePath = filePath;
     this->logToFile = true;           // Initialize first!
     this->logToConsole = false;        // Initialize first!
-    this->logLevelMinimum = LogLevel::INFO;  // Initialize first!
+    cachedTimestamp[0] = '\0';
+
+    for (size_t i = 0; i < RING_CAPACITY; ++i) {
+        ring[i].sequence.store(i, std::memory_order_relaxed);
+    }
 
     if (logToFile) {
         logFileStream.open(filePath, std::ios::app);
     }
+
+    writerThread = std::thread(&Logger::writerLoop, this);
 }
 
 Logger::~Logger() {
+    // Writer drains everything still queued before exiting
+    {
+        std::lock_guard<std::mutex> lock(logMutex);
+        running.store(false);
+        writerCv.notify_one();
+    }
+    if (writerThread.joinable()) {
+        writerThread.join();
+    }
+
     if (logFileStream.is_open()) {
         logFileStream.close();
     }
 }
 
 void Logger::info(const std::string& message) {
-    if (LogLevel::INFO < logLevelMinimum) {return;}
+    if (!isEnabled(LogLevel::INFO)) {return;}
     writeToLog(LogLevel::INFO, message);
 }
 
 void Logger::debug(const std::string& message) {
-    if (LogLevel::DEBUG < logLevelMinimum) {return;}
+    if (!isEnabled(LogLevel::DEBUG)) {return;}
     writeToLog(LogLevel::DEBUG, message);
 }
 
 void Logger::error(const std::string& message) {
-    if (LogLevel::ERROR < logLevelMinimum) {return;}
+    if (!isEnabled(LogLevel::ERROR)) {return;}
     writeToLog(LogLevel::ERROR, message);
 }
 
 void Logger::warning(const std::string& message) {
-    if (LogLevel::WARNING < logLevelMinimum) {return;}
+    if (!isEnabled(LogLevel::WARNING)) {return;}
     writeToLog(LogLevel::WARNING, message);
 }
 
 void Logger::writeToLog(LogLevel logLevel, const std::string& message) {
-    // CRITICAL: Lock the mutex first!
-    std::string timestamp = getCurrentTimestamp();
-    std::string level = levelToString(logLevel);
-    std::string fullMessage = "[" + timestamp + "] " + level + ": " + message;
-    std::lock_guard<std::mutex> lock(logMutex);
-    if (logToConsole) {
-        std::cout << fullMessage << std::endl;
+    // Claim a slot - fails only when the writer is a full ring behind
+    size_t pos = enqueuePos.load(std::memory_order_relaxed);
+    Slot* slot = nullptr;
+    while (true) {
+        slot = &ring[pos & (RING_CAPACITY - 1)];
+        size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+        if (diff == 0) {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            droppedRecords.fetch_add(1, std::memory_order_relaxed);
+            return;  // Ring full
+        } else {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
     }
-    if (logToFile) {
-        logFileStream << fullMessage << std::endl;
-        logFileStream.flush();  // Ensure it's written
+
+    LogRecord& record = slot->record;
+    record.level = logLevel;
+    record.time = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    size_t length = message.size();
+    if (length > MAX_RECORD_TEXT) {
+        length = MAX_RECORD_TEXT;
+        memcpy(record.text, message.data(), length - 3);
+        memcpy(record.text + length - 3, "...", 3);
+    } else {
+        memcpy(record.text, message.data(), length);
+    }
+    record.length = static_cast<uint16_t>(length);
+
+    slot->sequence.store(pos + 1, std::memory_order_release);
+
+    // Wake writer early every half ring instead of waiting for the flush interval
+    if ((pos & (RING_CAPACITY / 2 - 1)) == 0) {
+        writerCv.notify_one();
+    }
+}
+
+void Logger::writerLoop() {
+    Tracing::nameThread("logger");
+    std::string batch;
+    batch.reserve(64 * 1024);
+
+    while (true) {
+        bool still_running = running.load();
+
+        batch.clear();
+        drainRing(batch);
+
+        size_t dropped = droppedRecords.exchange(0, std::memory_order_relaxed);
+        if (dropped > 0) {
+            std::string note = std::to_string(dropped) + " log records dropped (queue full)";
+            std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+            appendLine(batch, LogLevel::WARNING, now, note.data(), note.size());
+        }
+
+        if (!batch.empty()) {
+            Tracing::Trace trace("Logger::writeBatch");
+            writeBatch(batch);
+        }
+
+        if (!still_running) {
+            return;  // Ring was drained after stop was requested
+        }
+
+        std::unique_lock<std::mutex> lock(logMutex);
+        writerCv.wait_for(lock, std::chrono::milliseconds(flushIntervalMs.load()),
+                          [this] { return !running.load(); });
     }
 }
 
-std::string Logger::getCurrentTimestamp() {
-    auto now = std::chrono::system_clock::now();
-    auto time_t = std::chrono::system_clock::to_time_t(now);
-    auto tm = *std::localtime(&time_t);
+size_t Logger::drainRing(std::string& batch) {
+    size_t taken = 0;
+    while (true) {
+        Slot& slot = ring[dequeuePos & (RING_CAPACITY - 1)];
+        size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence != dequeuePos + 1) {
+            return taken;  // Empty (or producer still filling this slot)
+        }
 
-    std::stringstream ss;
-    ss << std::put_time(&tm, "%Y-%m-%d %H:%M:%S");
-    return ss.str();
+        const LogRecord& record = slot.record;
+        appendLine(batch, record.level, record.time, record.text, record.length);
+
+        // Hand slot back to producers for the next lap
+        slot.sequence.store(dequeuePos + RING_CAPACITY, std::memory_order_release);
+        dequeuePos++;
+        taken++;
+    }
+}
+
+void Logger::writeBatch(const std::string& batch) {
+    if (logToConsole.load()) {
+        std::cout.write(batch.data(), static_cast<std::streamsize>(batch.size()));
+        std::cout.flush();
+    }
+    if (logToFile.load()) {
+        logFileStream.write(batch.data(), static_cast<std::streamsize>(batch.size()));
+        logFileStream.flush();  // One flush per batch, not per line
+    }
 }
 
-std::string Logger::levelToString(LogLevel logLevel) {
+void Logger::appendLine(std::string& batch, LogLevel logLevel, std::time_t time, const char* text, size_t length) {
+    batch += '[';
+    batch += timestampFor(time);
+    batch += "] ";
+    batch += levelToString(logLevel);
+    batch += ": ";
+    batch.append(text, length);
+    batch += '\n';
+}
+
+const char* Logger::timestampFor(std::time_t time) {
+    if (time != cachedSecond) {
+        std::tm tm;
+        localtime_r(&time, &tm);
+        strftime(cachedTimestamp, sizeof(cachedTimestamp), "%Y-%m-%d %H:%M:%S", &tm);
+        cachedSecond = time;
+    }
+    return cachedTimestamp;
+}
+
+const char* Logger::levelToString(LogLevel logLevel) {
     switch (logLevel) {
         case LogLevel::DEBUG:   return "DEBUG";
         case LogLevel::INFO:    return "INFO";
@@ -81,16 +199,17 @@ std::string Logger::levelToString(LogLevel logLevel) {
 }
 
 void Logger::setLogLevel(LogLevel level) {
-    std::lock_guard<std::mutex> lock(logMutex);
-    logLevelMinimum = level;
+    logLevelMinimum.store(level);
 }
 
 void Logger::setLogToFile(bool enabled) {
-    std::lock_guard<std::mutex> lock(logMutex);
-    logToFile = enabled;
+    logToFile.store(enabled);
 }
 
 void Logger::setLogToConsole(bool enabled) {
-    std::lock_guard<std::mutex> lock(logMutex);
-    logToConsole = enabled;
-}
\ No newline at end of file
+    logToConsole.store(enabled);
+}
+
+void Logger::setFlushInterval(int intervalMs) {
+    flushIntervalMs.store(intervalMs > 0 ? intervalMs : 1);
+}
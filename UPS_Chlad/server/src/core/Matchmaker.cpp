@@ -0,0 +1,233 @@
+// Matchmaker.cpp - Batched JOIN_ROOM matchmaking thread
+// KIV/UPS Network Programming Project
+
+#include "Matchmaker.h"
+#include "RoomManager.h"
+#include "PlayerManager.h"
+#include "Logger.h"
+#include "Metrics.h"
+#include "Tracing.h"
+#include "ProtocolHelper.h"
+
+Matchmaker::Matchmaker(RoomManager* rm, PlayerManager* pm, Logger* lg, int tick_ms)
+    : roomManager(rm), playerManager(pm), logger(lg), tick(tick_ms) {}
+
+Matchmaker::~Matchmaker() {
+    stop();
+    Request* request = head.exchange(nullptr);
+    while (request) {
+        Request* next = request->next;
+        delete request;
+        request = next;
+    }
+}
+
+void Matchmaker::start(Delivery deliver) {
+    if (running.load()) {
+        return;
+    }
+    delivery = std::move(deliver);
+    running.store(true);
+    matcher = std::thread(&Matchmaker::run, this);
+    logger->info("Matchmaker started with " + std::to_string(tick.count()) + " ms tick");
+}
+
+void Matchmaker::stop() {
+    if (!running.load()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex);
+        running.store(false);
+    }
+    wake.notify_one();
+    if (matcher.joinable()) {
+        matcher.join();
+    }
+    matchBatch(true);
+    logger->info("Matchmaker stopped");
+}
+
+void Matchmaker::enqueue(const std::string& player_name) {
+    Request* request = new Request{player_name, Clock::now(), head.load(std::memory_order_relaxed)};
+    while (!head.compare_exchange_weak(request->next, request, std::memory_order_release, std::memory_order_relaxed)) {
+    }
+}
+
+void Matchmaker::run() {
+    Tracing::nameThread("matchmaker");
+    while (running.load()) {
+        {
+            std::unique_lock<std::mutex> lock(wake_mutex);
+            wake.wait_for(lock, tick, [this] { return !running.load(); });
+        }
+        if (!running.load()) {
+            break;      // stop() places the rest
+        }
+        try {
+            matchBatch(false);
+        } catch (const std::exception& e) {
+            logger->error("Matchmaker batch failed: " + std::string(e.what()));
+        }
+    }
+}
+
+void Matchmaker::takeQueued() {
+    // Whole stack at once, producers keep pushing onto an empty head meanwhile
+    Request* request = head.exchange(nullptr, std::memory_order_acquire);
+    Request* ordered = nullptr;
+    while (request) {
+        Request* next = request->next;
+        request->next = ordered;
+        ordered = request;
+        request = next;
+    }
+    while (ordered) {
+        Request* next = ordered->next;
+        if (pending_names.insert(ordered->player).second) {
+            pending.push_back({std::move(ordered->player), ordered->queued});
+        }
+        delete ordered;
+        ordered = next;
+    }
+}
+
+Matchmaker::Eligibility Matchmaker::eligibility(const std::string& player_name) {
+    std::optional<Player> player = playerManager->getPlayer(player_name);
+    if (!player.has_value() || !player->room_id.empty()) {
+        return Eligibility::DROP;
+    }
+    return player->connected ? Eligibility::READY : Eligibility::HOLD;
+}
+
+bool Matchmaker::seat(const std::string& room_id, Waiting& player, std::deque<Waiting>& held, bool flush) {
+    // Eligibility was checked earlier in the batch, the player may have disconnected since
+    if (!playerManager->seatLobbyPlayer(player.player, room_id)) {
+        roomManager->leaveRoom(player.player, room_id);
+        holdOrDrop(player, held, flush);
+        return false;
+    }
+    pending_names.erase(player.player);
+    Metrics::record(Metrics::Timer::MATCHMAKING_WAIT, Metrics::elapsedNanoseconds(player.queued));
+    return true;
+}
+
+void Matchmaker::holdOrDrop(Waiting& player, std::deque<Waiting>& held, bool flush) {
+    if (!flush && eligibility(player.player) == Eligibility::HOLD) {
+        held.push_back(std::move(player));
+        return;
+    }
+    pending_names.erase(player.player);     // Joins again after reconnecting
+}
+
+void Matchmaker::announce(const std::string& room_id, const std::string& joiner,
+                          std::vector<ProtocolMessage>& messages) {
+    std::vector<std::string> room_players = roomManager->getRoomPlayers(room_id);
+    std::string players_list;
+    for (size_t i = 0; i < room_players.size(); ++i) {
+        if (i > 0) players_list += ",";
+        players_list += room_players[i];
+    }
+
+    for (const std::string& player : room_players) {
+        ProtocolMessage joined = ProtocolHelper::createRoomJoinedResponse(player, room_id);
+        if (player != joiner) {
+            joined.setData("broadcast_type", "room_notification");
+            joined.setData("joined_player", joiner);
+        }
+        joined.setData("players", players_list);
+        joined.setData("player_count", std::to_string(room_players.size()));
+        joined.setData("room_full", (room_players.size() >= 2) ? "true" : "false");
+        messages.push_back(std::move(joined));
+    }
+
+    logger->info("Player '" + joiner + "' joined room '" + room_id + "' with " + std::to_string(room_players.size()) + " players");
+}
+
+void Matchmaker::refuse(const Waiting& player, std::vector<ProtocolMessage>& messages) {
+    pending_names.erase(player.player);
+    ProtocolMessage error = ProtocolHelper::createErrorResponse("No free room, server is full");
+    error.player_id = player.player;
+    messages.push_back(std::move(error));
+}
+
+void Matchmaker::matchBatch(bool flush) {
+    takeQueued();
+    if (pending.empty()) {
+        return;
+    }
+
+    Metrics::ScopedTimer batch_timer(Metrics::Timer::MATCHMAKING_BATCH);
+    Tracing::Trace trace("Matchmaker::matchBatch");
+
+    std::vector<Waiting> ready;
+    std::deque<Waiting> held;
+    for (Waiting& waiting : pending) {
+        switch (eligibility(waiting.player)) {
+            case Eligibility::READY:
+                ready.push_back(std::move(waiting));
+                break;
+            case Eligibility::HOLD:
+                holdOrDrop(waiting, held, flush);
+                break;
+            case Eligibility::DROP:
+                pending_names.erase(waiting.player);
+                break;
+        }
+    }
+    pending.clear();
+
+    std::vector<ProtocolMessage> messages;
+    size_t next = 0;
+
+    // Rooms waiting for a second player first, someone has been sitting in them already
+    for (; next < ready.size(); ++next) {
+        std::string room_id = roomManager->joinWaitingRoom(ready[next].player);
+        if (room_id.empty()) {
+            break;
+        }
+        if (seat(room_id, ready[next], held, flush)) {
+            announce(room_id, ready[next].player, messages);
+        }
+    }
+
+    // Then pairs in arrival order, each into a fresh room
+    for (; next + 1 < ready.size(); next += 2) {
+        Waiting& first = ready[next];
+        Waiting& second = ready[next + 1];
+        std::string room_id = roomManager->createRoomFor({first.player, second.player});
+        if (room_id.empty()) {
+            refuse(first, messages);
+            refuse(second, messages);
+            continue;
+        }
+        std::string first_name = first.player;
+        std::string second_name = second.player;
+        bool first_seated = seat(room_id, first, held, flush);
+        bool second_seated = seat(room_id, second, held, flush);
+        if (second_seated) {
+            announce(room_id, second_name, messages);
+        } else if (first_seated) {
+            announce(room_id, first_name, messages);    // Alone, the room waits for the next batch
+        }
+    }
+
+    // Odd one out gets a room of its own right away, the next batch fills it through the waiting rooms
+    if (next < ready.size()) {
+        Waiting& last = ready[next];
+        std::string room_id = roomManager->joinAnyAvailableRoom(last.player);
+        if (room_id.empty()) {
+            refuse(last, messages);
+        } else {
+            std::string last_name = last.player;
+            if (seat(room_id, last, held, flush)) {
+                announce(room_id, last_name, messages);
+            }
+        }
+    }
+    pending.swap(held);
+
+    if (!messages.empty() && delivery) {
+        delivery(messages);
+    }
+}
@@ -0,0 +1,250 @@
+// Metrics.cpp - Latency histograms and server counters
+// KIV/UPS Network Programming Project
+
+#include "Metrics.h"
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <cstdio>
+
+namespace {
+    using Metrics::Counter;
+    using Metrics::Timer;
+    using Metrics::LatencyHistogram;
+
+    constexpr size_t COUNTERS = static_cast<size_t>(Counter::COUNT);
+    constexpr size_t TIMERS = static_cast<size_t>(Timer::COUNT);
+
+    // Exported Prometheus buckets are powers of two from ~1 us to ~17 s
+    constexpr int FIRST_EXPORTED_EXPONENT = 10;
+    constexpr int LAST_EXPORTED_EXPONENT = 34;
+
+    constexpr double QUANTILES[] = {0.5, 0.9, 0.99, 0.999};
+
+    struct CounterInfo {
+        const char* name;
+        const char* help;
+    };
+
+    constexpr CounterInfo COUNTER_INFO[COUNTERS] = {
+        {"gamba_bytes_received_total", "Bytes received from clients"},
+        {"gamba_bytes_sent_total", "Bytes accepted by the kernel for sending"},
+        {"gamba_messages_received_total", "Complete client messages processed"},
+        {"gamba_send_failures_total", "Messages that could not be written or queued"},
+        {"gamba_partial_writes_total", "Writes where the kernel accepted only part of the data"},
+        {"gamba_slow_client_disconnects_total", "Clients dropped for staying above the outbound high-water mark"},
+        {"gamba_rejected_connections_total", "Connections refused at accept by max_clients or the per-IP accept rate"},
+        {"gamba_rate_limited_messages_total", "Messages dropped by the per-connection rate limit"},
+        {"gamba_write_calls_total", "send() and sendmsg() calls on client sockets"},
+        {"gamba_handoffs_sent_total", "Client connections passed to another node"},
+        {"gamba_handoffs_received_total", "Client connections adopted from another node"}
+    };
+
+    constexpr CounterInfo TIMER_INFO[TIMERS] = {
+        {"gamba_room_lock_wait_seconds", "Time spent waiting for a room lock"},
+        {"gamba_room_lock_hold_seconds", "Time a room lock was held"},
+        {"gamba_heartbeat_scan_seconds", "Duration of one heartbeat monitor pass"},
+        {"gamba_matchmaking_wait_seconds", "Time a JOIN_ROOM waited in the matchmaking queue"},
+        {"gamba_matchmaking_batch_seconds", "Duration of one matchmaker batch"}
+    };
+
+    constexpr const char* MESSAGE_TYPE_NAMES[Metrics::MESSAGE_TYPES] = {
+        "CONNECT", "DISCONNECT", "JOIN_ROOM", "LEAVE_ROOM", "PING",
+        "START_GAME", "RECONNECT", "PLAY_CARDS", "PICKUP_PILE", "RESYNC"
+    };
+
+    // Everything one thread records, only the owning thread writes it
+    struct alignas(64) Shard {
+        std::atomic<uint64_t> counters[COUNTERS] = {};
+        LatencyHistogram timers[TIMERS];
+        LatencyHistogram messages[Metrics::MESSAGE_TYPES];
+    };
+
+    struct Registry {
+        std::mutex mutex;                               // Guards shard lists, taken per thread start / exit and scrape
+        std::vector<std::unique_ptr<Shard>> shards;     // Every shard ever created, scrape sums all of them
+        std::vector<Shard*> free_shards;                // Shards of finished threads, reused by new ones
+    };
+
+    Registry& registry() {
+        // Never destroyed, threads detached at shutdown may still record
+        static Registry* instance = new Registry();
+        return *instance;
+    }
+
+    // Lends a shard to the current thread for its whole lifetime
+    class ShardLease {
+    public:
+        Shard* shard;
+
+        ShardLease() {
+            Registry& reg = registry();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            if (!reg.free_shards.empty()) {
+                shard = reg.free_shards.back();
+                reg.free_shards.pop_back();
+            } else {
+                reg.shards.push_back(std::make_unique<Shard>());
+                shard = reg.shards.back().get();
+            }
+        }
+
+        ~ShardLease() {
+            Registry& reg = registry();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            reg.free_shards.push_back(shard);
+        }
+    };
+
+    Shard& localShard() {
+        thread_local ShardLease lease;
+        return *lease.shard;
+    }
+
+    // Single writer, a plain load + store is enough and avoids a locked instruction
+    void bump(std::atomic<uint64_t>& value, uint64_t amount) {
+        value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    // Everything summed over all shards, written only by the scraping thread
+    struct Snapshot {
+        uint64_t counters[COUNTERS] = {};
+        LatencyHistogram timers[TIMERS];
+        LatencyHistogram messages[Metrics::MESSAGE_TYPES];
+    };
+
+    void appendNumber(std::string& out, double value) {
+        char buffer[32];
+        int length = std::snprintf(buffer, sizeof(buffer), "%.9g", value);
+        out.append(buffer, static_cast<size_t>(length));
+    }
+
+    void appendSeconds(std::string& out, uint64_t nanoseconds) {
+        appendNumber(out, static_cast<double>(nanoseconds) * 1e-9);
+    }
+
+    // "x_seconds" -> "x_quantile_seconds", unit stays the last part of the name
+    std::string quantileName(const std::string& name) {
+        const std::string unit = "_seconds";
+        return name.substr(0, name.size() - unit.size()) + "_quantile" + unit;
+    }
+
+    void appendFamilyHeader(std::string& out, const std::string& name, const char* help, const char* type) {
+        out += "# HELP " + name + " " + help + "\n";
+        out += "# TYPE " + name + " " + type + "\n";
+    }
+
+    // labels is either empty or "key=\"value\"" without braces
+    void appendHistogram(std::string& out, const std::string& name, const std::string& labels, const LatencyHistogram& total) {
+        std::string prefix = labels.empty() ? "" : labels + ",";
+        uint64_t count = total.count();
+        uint64_t cumulative = 0;
+        size_t bucket = 0;
+        for (int exponent = FIRST_EXPORTED_EXPONENT; exponent <= LAST_EXPORTED_EXPONENT; ++exponent) {
+            // Buckets below index (exponent - SUB_BUCKET_BITS + 1) * SUB_BUCKETS hold values under 2^exponent
+            size_t end = static_cast<size_t>(exponent - LatencyHistogram::SUB_BUCKET_BITS + 1) * LatencyHistogram::SUB_BUCKETS;
+            for (; bucket < end; ++bucket) {
+                cumulative += total.buckets[bucket].load(std::memory_order_relaxed);
+            }
+            out += name + "_bucket{" + prefix + "le=\"";
+            appendSeconds(out, uint64_t{1} << exponent);
+            out += "\"} " + std::to_string(cumulative) + "\n";
+        }
+        out += name + "_bucket{" + prefix + "le=\"+Inf\"} " + std::to_string(count) + "\n";
+
+        std::string braces = labels.empty() ? "" : "{" + labels + "}";
+        out += name + "_sum" + braces + " ";
+        appendSeconds(out, total.sum.load(std::memory_order_relaxed));
+        out += "\n" + name + "_count" + braces + " " + std::to_string(count) + "\n";
+    }
+
+    void appendQuantiles(std::string& out, const std::string& name, const std::string& labels, const LatencyHistogram& total) {
+        std::string prefix = labels.empty() ? "" : labels + ",";
+        for (double q : QUANTILES) {
+            out += name + "{" + prefix + "quantile=\"";
+            appendNumber(out, q);
+            out += "\"} ";
+            appendSeconds(out, total.quantile(q));
+            out += "\n";
+        }
+    }
+}
+
+void Metrics::add(Counter counter, uint64_t value) {
+    bump(localShard().counters[static_cast<size_t>(counter)], value);
+}
+
+void Metrics::record(Timer timer, uint64_t nanoseconds) {
+    localShard().timers[static_cast<size_t>(timer)].record(nanoseconds);
+}
+
+void Metrics::recordMessage(MessageType type, uint64_t nanoseconds) {
+    size_t index = static_cast<size_t>(type);
+    if (index < MESSAGE_TYPES) {
+        localShard().messages[index].record(nanoseconds);
+    }
+}
+
+const char* Metrics::messageTypeName(MessageType type) {
+    size_t index = static_cast<size_t>(type);
+    return index < MESSAGE_TYPES ? MESSAGE_TYPE_NAMES[index] : "OTHER";
+}
+
+uint64_t Metrics::total(Counter counter) {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    uint64_t sum = 0;
+    for (const auto& shard : reg.shards) {
+        sum += shard->counters[static_cast<size_t>(counter)].load(std::memory_order_relaxed);
+    }
+    return sum;
+}
+
+void Metrics::renderPrometheus(std::string& out) {
+    // Large (per type histograms), built on the heap once per scrape
+    auto snapshot = std::make_unique<Snapshot>();
+    {
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        for (const auto& shard : reg.shards) {
+            for (size_t i = 0; i < COUNTERS; ++i) {
+                snapshot->counters[i] += shard->counters[i].load(std::memory_order_relaxed);
+            }
+            for (size_t i = 0; i < TIMERS; ++i) {
+                snapshot->timers[i].merge(shard->timers[i]);
+            }
+            for (size_t i = 0; i < MESSAGE_TYPES; ++i) {
+                snapshot->messages[i].merge(shard->messages[i]);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < COUNTERS; ++i) {
+        appendFamilyHeader(out, COUNTER_INFO[i].name, COUNTER_INFO[i].help, "counter");
+        out += std::string(COUNTER_INFO[i].name) + " " + std::to_string(snapshot->counters[i]) + "\n";
+    }
+
+    const std::string message_family = "gamba_message_processing_seconds";
+    appendFamilyHeader(out, message_family, "MessageHandler processing time per client message type", "histogram");
+    for (size_t i = 0; i < MESSAGE_TYPES; ++i) {
+        if (snapshot->messages[i].count() > 0) {
+            appendHistogram(out, message_family, std::string("type=\"") + MESSAGE_TYPE_NAMES[i] + "\"", snapshot->messages[i]);
+        }
+    }
+    appendFamilyHeader(out, quantileName(message_family), "Processing time quantiles per client message type", "gauge");
+    for (size_t i = 0; i < MESSAGE_TYPES; ++i) {
+        if (snapshot->messages[i].count() > 0) {
+            appendQuantiles(out, quantileName(message_family), std::string("type=\"") + MESSAGE_TYPE_NAMES[i] + "\"", snapshot->messages[i]);
+        }
+    }
+
+    for (size_t i = 0; i < TIMERS; ++i) {
+        std::string name = TIMER_INFO[i].name;
+        appendFamilyHeader(out, name, TIMER_INFO[i].help, "histogram");
+        appendHistogram(out, name, "", snapshot->timers[i]);
+        if (snapshot->timers[i].count() > 0) {
+            appendFamilyHeader(out, quantileName(name), TIMER_INFO[i].help, "gauge");
+            appendQuantiles(out, quantileName(name), "", snapshot->timers[i]);
+        }
+    }
+}
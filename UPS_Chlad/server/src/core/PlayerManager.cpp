@@ -3,79 +3,231 @@
 //
 
 #include "PlayerManager.h"
+#include "SessionDirectory.h"
+#include "Snapshot.h"
+#include <algorithm>
 
 Player::Player(const std::string& player_name, int socket)
     : name(player_name), room_id(""), connected(true), socket_fd(socket),
       temporarily_disconnected(false) {
 }
 
+PlayerHandle PlayerManager::findHandle(const std::string& player_name) const {
+    auto it = player_handles.find(player_name);
+    return (it != player_handles.end()) ? it->second : Handles::INVALID;
+}
+
+Player* PlayerManager::findPlayer(const std::string& player_name, PlayerHandle* handle) {
+    PlayerHandle found = findHandle(player_name);
+    if (handle) {
+        *handle = found;
+    }
+    return players.get(found);
+}
+
+void PlayerManager::mapSocket(int client_socket, PlayerHandle handle) {
+    if (client_socket < 0) {
+        return;
+    }
+    if (static_cast<size_t>(client_socket) >= socket_to_player.size()) {
+        socket_to_player.resize(static_cast<size_t>(client_socket) + 1, Handles::INVALID);
+    }
+    socket_to_player[client_socket] = handle;
+}
+
+void PlayerManager::unmapSocket(int client_socket, PlayerHandle handle) {
+    // Only clears the slot if it still belongs to the player, fd may have been reused already
+    if (client_socket >= 0 && static_cast<size_t>(client_socket) < socket_to_player.size() &&
+        socket_to_player[client_socket] == handle) {
+        socket_to_player[client_socket] = Handles::INVALID;
+    }
+}
+
+PlayerHandle PlayerManager::socketHandle(int client_socket) const {
+    if (client_socket < 0 || static_cast<size_t>(client_socket) >= socket_to_player.size()) {
+        return Handles::INVALID;
+    }
+    return socket_to_player[client_socket];
+}
+
 std::string PlayerManager::connectPlayer(const std::string& player_name, int client_socket) {
-    auto it = players.find(player_name);
+    std::lock_guard<std::mutex> lock(players_mutex);
 
-    if (it != players.end()) {
+    if (findHandle(player_name) != Handles::INVALID) {
         // Player already exists - reject connection
         // They must use RECONNECT message instead
         return "";
-    } else {
-        // Add new player
-        players.emplace(player_name, Player(player_name, client_socket));
-        socket_to_player[client_socket] = player_name;
-        updateLastPing(player_name);
-        return player_name;
     }
+
+    // Same rule across nodes - the name may be in use on another server process
+    if (directory && !directory->claim(player_name)) {
+        return "";
+    }
+
+    // Add new player
+    PlayerHandle handle = players.insert(Player(player_name, client_socket));
+    player_handles.emplace(player_name, handle);
+    mapSocket(client_socket, handle);
+    addToRoomIndex(handle, "");
+    updateLastPing(handle);
+    return player_name;
 }
 
 std::string PlayerManager::getPlayerIdFromSocket(int client_socket) {
     std::lock_guard<std::mutex> lock(players_mutex);
 
-    auto it = socket_to_player.find(client_socket);
-    if (it != socket_to_player.end()) {
-        return it->second;  // Return player name
+    const Player* player = players.get(socketHandle(client_socket));
+    if (player) {
+        return player->name;  // Return player name
     }
     return "";  // Socket not found
 }
 
+PlayerHandle PlayerManager::getPlayerHandleFromSocket(int client_socket) {
+    std::lock_guard<std::mutex> lock(players_mutex);
+
+    PlayerHandle handle = socketHandle(client_socket);
+    return players.get(handle) ? handle : Handles::INVALID;
+}
+
 /**
 * Complete delete from the server
 **/
 void PlayerManager::removePlayer(const std::string& player_name) {
     std::lock_guard<std::mutex> lock(players_mutex);
 
-    auto it = players.find(player_name);
-    if (it != players.end()) {
-        // Get socket before removing player
-        int socket_fd = it->second.socket_fd;
-
+    PlayerHandle handle;
+    Player* player = findPlayer(player_name, &handle);
+    if (player) {
         // Remove from socket mapping (if socket is valid)
-        if (socket_fd != -1) {
-            socket_to_player.erase(socket_fd);
+        if (player->socket_fd != -1) {
+            unmapSocket(player->socket_fd, handle);
         }
 
-        // Remove player completely
-        players.erase(it);
+        // Remove player completely, handle stops resolving so queued timeout entries are dropped
+        removeFromRoomIndex(handle, player->room_id);
+        players.erase(handle);
+        player_handles.erase(player_name);
+        if (directory) {
+            directory->release(player_name);   // No-op once the session moved to another node
+        }
 
         // Clean up heartbeat data
         {
             std::lock_guard<std::mutex> hb_lock(heartbeat_mutex);
-            player_last_ping.erase(player_name);
+            uint32_t slot = Handles::index(handle);
+            if (slot < player_last_ping.size()) {
+                player_last_ping[slot] = std::chrono::steady_clock::time_point{};
+                heartbeat_phases[slot] = HeartbeatPhase::LOBBY;
+                ping_scheduled[slot] = std::chrono::steady_clock::time_point{};
+            }
         }
     }
 }
 
 void PlayerManager::updateLastPing(const std::string& player_name) {
-    // Update ping
+    PlayerHandle handle;
     {
-        std::lock_guard<std::mutex> lock(heartbeat_mutex);
-        player_last_ping[player_name] = std::chrono::steady_clock::now();
+        std::lock_guard<std::mutex> lock(players_mutex);
+        handle = findHandle(player_name);
+    }
+    if (handle != Handles::INVALID) {
+        updateLastPing(handle);
+    }
+}
+
+void PlayerManager::updateLastPing(PlayerHandle player) {
+    // Queued deadline is moved when it comes due, only a player without one gets an entry here
+    std::lock_guard<std::mutex> lock(heartbeat_mutex);
+    auto now = std::chrono::steady_clock::now();
+    uint32_t slot = Handles::index(player);
+    ensureHeartbeatSlot(slot);
+    player_last_ping[slot] = now;
+    if (ping_scheduled[slot] == std::chrono::steady_clock::time_point{}) {
+        schedulePingDeadline(player, now + pingTimeout(heartbeat_phases[slot]));
+    }
+}
+
+void PlayerManager::setTurnPlayer(const std::string& room_id, const std::string& player_name) {
+    std::lock_guard<std::mutex> lock(players_mutex);
+    auto room_it = room_members.find(room_id);
+    if (room_id.empty() || room_it == room_members.end()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> hb_lock(heartbeat_mutex);
+    for (PlayerHandle handle : room_it->second) {
+        bool on_turn = players.get(handle)->name == player_name;
+        setHeartbeatPhase(handle, on_turn ? HeartbeatPhase::TURN : HeartbeatPhase::ROOM);
+    }
+}
+
+void PlayerManager::ensureHeartbeatSlot(uint32_t slot) {
+    if (slot >= player_last_ping.size()) {
+        player_last_ping.resize(slot + 1);
+        heartbeat_phases.resize(slot + 1, HeartbeatPhase::LOBBY);
+        ping_scheduled.resize(slot + 1);
+    }
+}
+
+void PlayerManager::setHeartbeatSchedule(const HeartbeatSchedule& schedule) {
+    heartbeat_schedule = schedule;
+    auto fit = [this](int& interval_ms, int timeout_ms) {
+        int longest = static_cast<int>(timeout_ms / heartbeat_schedule.missed_intervals);
+        interval_ms = std::max(1, std::min(interval_ms, longest));
+    };
+    fit(heartbeat_schedule.lobby_ms, heartbeat_schedule.lobby_timeout_ms);
+    fit(heartbeat_schedule.room_ms, heartbeat_schedule.timeout_ms);
+    fit(heartbeat_schedule.turn_ms, heartbeat_schedule.timeout_ms);
+}
+
+std::chrono::milliseconds PlayerManager::pingTimeout(HeartbeatPhase phase) const {
+    int interval_ms = heartbeat_schedule.room_ms;
+    int timeout_ms = heartbeat_schedule.timeout_ms;
+    if (phase == HeartbeatPhase::LOBBY) {
+        interval_ms = heartbeat_schedule.lobby_ms;
+        timeout_ms = heartbeat_schedule.lobby_timeout_ms;
+    } else if (phase == HeartbeatPhase::TURN) {
+        interval_ms = heartbeat_schedule.turn_ms;
+    }
+    auto missed = static_cast<int64_t>(interval_ms * heartbeat_schedule.missed_intervals);
+    return std::chrono::milliseconds(std::min<int64_t>(missed, timeout_ms));
+}
+
+void PlayerManager::schedulePingDeadline(PlayerHandle player, std::chrono::steady_clock::time_point deadline) {
+    // Any entry queued before becomes stale, its deadline no longer matches
+    ping_scheduled[Handles::index(player)] = deadline;
+    ping_deadlines.push(TimeoutEntry{deadline, player});
+}
+
+void PlayerManager::setHeartbeatPhase(PlayerHandle player, HeartbeatPhase phase) {
+    uint32_t slot = Handles::index(player);
+    ensureHeartbeatSlot(slot);
+    heartbeat_phases[slot] = phase;
+    if (ping_scheduled[slot] == std::chrono::steady_clock::time_point{}) {
+        return;     // Not connected, the next frame schedules with the new phase
+    }
+    auto deadline = player_last_ping[slot] + pingTimeout(phase);
+    if (deadline < ping_scheduled[slot]) {
+        schedulePingDeadline(player, deadline);
+    }
+}
+
+void PlayerManager::startDisconnection(PlayerHandle handle, Player& player) {
+    player.disconnection_start = std::chrono::steady_clock::now();
+    if (player.temporarily_disconnected) {
+        reconnect_deadlines.push(TimeoutEntry{player.disconnection_start, handle});
+    } else {
+        socket_close_deadlines.push(TimeoutEntry{player.disconnection_start, handle});
     }
 }
 
 std::optional<Player> PlayerManager::getPlayer(const std::string& player_name) {
     std::lock_guard<std::mutex> lock(players_mutex);
 
-    auto it = players.find(player_name);
-    if (it != players.end()) {
-        return it->second;  // Return copy
+    const Player* player = findPlayer(player_name);
+    if (player) {
+        return *player;  // Return copy
     }
     return std::nullopt;  // Not found
 }
@@ -83,20 +235,21 @@ std::optional<Player> PlayerManager::getPlayer(const std::string& player_name) {
 void PlayerManager::markPlayerDisconnected(const std::string& player_name) {
     std::lock_guard<std::mutex> lock(players_mutex);
 
-    auto it = players.find(player_name);
-    if (it != players.end()) {
+    PlayerHandle handle;
+    Player* player = findPlayer(player_name, &handle);
+    if (player) {
         // Get socket before clearing it
-        int socket_fd = it->second.socket_fd;
+        int socket_fd = player->socket_fd;
 
         // Update player state
-        it->second.connected = false;
-        it->second.socket_fd = -1;
-        it->second.temporarily_disconnected = true;
-        it->second.disconnection_start = std::chrono::steady_clock::now();
+        player->connected = false;
+        player->socket_fd = -1;
+        player->temporarily_disconnected = true;
+        startDisconnection(handle, *player);
 
         // Remove from socket mapping (if socket was valid)
         if (socket_fd != -1) {
-            socket_to_player.erase(socket_fd);
+            unmapSocket(socket_fd, handle);
         }
     }
 }
@@ -106,18 +259,45 @@ void PlayerManager::markPlayerDisconnected(const std::string& player_name) {
 void PlayerManager::setPlayerRoom(const std::string& player_name, const std::string& room_id) {
     std::lock_guard<std::mutex> lock(players_mutex);
 
-    auto it = players.find(player_name);
-    if (it != players.end()) {
-        it->second.room_id = room_id;
+    PlayerHandle handle;
+    Player* player = findPlayer(player_name, &handle);
+    if (player) {
+        removeFromRoomIndex(handle, player->room_id);
+        player->room_id = room_id;
+        addToRoomIndex(handle, room_id);
+        if (directory) {
+            directory->setRoom(player_name, room_id);
+        }
+        std::lock_guard<std::mutex> hb_lock(heartbeat_mutex);
+        setHeartbeatPhase(handle, room_id.empty() ? HeartbeatPhase::LOBBY : HeartbeatPhase::ROOM);
     }
 }
 
+bool PlayerManager::seatLobbyPlayer(const std::string& player_name, const std::string& room_id) {
+    std::lock_guard<std::mutex> lock(players_mutex);
+
+    PlayerHandle handle;
+    Player* player = findPlayer(player_name, &handle);
+    if (!player || !player->connected || !player->room_id.empty()) {
+        return false;
+    }
+    removeFromRoomIndex(handle, player->room_id);
+    player->room_id = room_id;
+    addToRoomIndex(handle, room_id);
+    if (directory) {
+        directory->setRoom(player_name, room_id);
+    }
+    std::lock_guard<std::mutex> hb_lock(heartbeat_mutex);
+    setHeartbeatPhase(handle, HeartbeatPhase::ROOM);
+    return true;
+}
+
 std::string PlayerManager::getPlayerRoom(const std::string& player_name) {
     std::lock_guard<std::mutex> lock(players_mutex);
 
-    auto it = players.find(player_name);
-    if (it != players.end()) {
-        return it->second.room_id;
+    const Player* player = findPlayer(player_name);
+    if (player) {
+        return player->room_id;
     }
     return "";  // Player not found
 }
@@ -125,15 +305,23 @@ std::string PlayerManager::getPlayerRoom(const std::string& player_name) {
 void PlayerManager::clearPlayerRoom(const std::string& player_name) {
     std::lock_guard<std::mutex> lock(players_mutex);
 
-    auto it = players.find(player_name);
-    if (it != players.end()) {
-        it->second.room_id = "";  // Empty string = lobby
+    PlayerHandle handle;
+    Player* player = findPlayer(player_name, &handle);
+    if (player) {
+        removeFromRoomIndex(handle, player->room_id);
+        player->room_id = "";  // Empty string = lobby
+        addToRoomIndex(handle, "");
+        if (directory) {
+            directory->setRoom(player_name, "");
+        }
+        std::lock_guard<std::mutex> hb_lock(heartbeat_mutex);
+        setHeartbeatPhase(handle, HeartbeatPhase::LOBBY);
     }
 }
 
 bool PlayerManager::playerExists(const std::string& player_name) {
     std::lock_guard<std::mutex> lock(players_mutex);
-    return players.find(player_name) != players.end();
+    return findHandle(player_name) != Handles::INVALID;
 }
 
 std::size_t PlayerManager::getPlayerCount(){
@@ -141,18 +329,57 @@ std::size_t PlayerManager::getPlayerCount(){
     return players.size();
 }
 
+void PlayerManager::addToRoomIndex(PlayerHandle handle, const std::string& room_id) {
+    room_members[room_id].push_back(handle);
+}
+
+void PlayerManager::removeFromRoomIndex(PlayerHandle handle, const std::string& room_id) {
+    auto room_it = room_members.find(room_id);
+    if (room_it == room_members.end()) {
+        return;
+    }
+    std::vector<PlayerHandle>& members = room_it->second;
+    auto member_it = std::find(members.begin(), members.end(), handle);
+    if (member_it != members.end()) {
+        // Order within a room is not kept, swap with last instead of shifting
+        *member_it = members.back();
+        members.pop_back();
+    }
+    if (members.empty()) {
+        room_members.erase(room_it);
+    }
+}
+
 /**
-*
+*    Returns names of players assigned to the room, served from room index in O(room size).
 */
 std::vector<std::string> PlayerManager::getPlayersInRoom(const std::string& room_id) {
     std::lock_guard<std::mutex> lock(players_mutex);
-    std::vector<std::string> roomPlayers;
-    for (const auto& pair : players) {
-        if (pair.second.room_id == room_id) {
-            roomPlayers.push_back(pair.first);
+    std::vector<std::string> names;
+    auto room_it = room_members.find(room_id);
+    if (room_it == room_members.end()) {
+        return names;
+    }
+    names.reserve(room_it->second.size());
+    for (PlayerHandle handle : room_it->second) {
+        names.push_back(players.get(handle)->name);
+    }
+    return names;
+}
+
+std::vector<int> PlayerManager::resolvePlayerSockets(const std::vector<std::string>& player_names) {
+    std::lock_guard<std::mutex> lock(players_mutex);
+    std::vector<int> sockets;
+    sockets.reserve(player_names.size());
+    for (const std::string& player_name : player_names) {
+        const Player* player = findPlayer(player_name);
+        if (player && player->connected) {
+            sockets.push_back(player->socket_fd);
+        } else {
+            sockets.push_back(-1);
         }
     }
-    return roomPlayers;
+    return sockets;
 }
 
 /**
@@ -161,18 +388,24 @@ std::vector<std::string> PlayerManager::getPlayersInRoom(const std::string& room
 std::vector<std::string> PlayerManager::getAllPlayers() {
     std::lock_guard<std::mutex> lock(players_mutex);
     std::vector<std::string> playerNames;
-    for (const auto& pair : players) {
-        playerNames.push_back(pair.first);
-    }
+    playerNames.reserve(players.size());
+    players.forEach([&](PlayerHandle, const Player& player) {
+        playerNames.push_back(player.name);
+    });
     return playerNames;
 }
 
 std::chrono::steady_clock::time_point PlayerManager::getLastPing(const std::string& player_name) {
-    std::lock_guard<std::mutex> lock(heartbeat_mutex);
+    PlayerHandle handle;
+    {
+        std::lock_guard<std::mutex> lock(players_mutex);
+        handle = findHandle(player_name);
+    }
 
-    auto it = player_last_ping.find(player_name);
-    if (it != player_last_ping.end()) {
-        return it->second;
+    std::lock_guard<std::mutex> lock(heartbeat_mutex);
+    uint32_t slot = Handles::index(handle);
+    if (handle != Handles::INVALID && slot < player_last_ping.size()) {
+        return player_last_ping[slot];
     }
     return std::chrono::steady_clock::time_point{}; // Return default-constructed time_point if not found
 }
@@ -180,10 +413,10 @@ std::chrono::steady_clock::time_point PlayerManager::getLastPing(const std::stri
 void PlayerManager::markReconnected(const std::string& player_name) {
     std::lock_guard<std::mutex> lock(players_mutex);
 
-    auto it = players.find(player_name);
-    if (it != players.end()) {
-        it->second.connected = true;
-        it->second.temporarily_disconnected = false;
+    Player* player = findPlayer(player_name);
+    if (player) {
+        player->connected = true;
+        player->temporarily_disconnected = false;
         // Note: socket_fd should be set externally when reconnecting
     }
 }
@@ -191,33 +424,47 @@ void PlayerManager::markReconnected(const std::string& player_name) {
 std::vector<std::string> PlayerManager::getTimedOutPlayers(int timeout_seconds) {
     std::vector<std::string> timed_out_players;
     auto now = std::chrono::steady_clock::now();
-    auto timeout_duration = std::chrono::seconds(timeout_seconds);
+    auto deadline = now - std::chrono::seconds(timeout_seconds);
 
     {
         std::lock_guard<std::mutex> players_lock(players_mutex);
-        std::lock_guard<std::mutex> heartbeat_lock(heartbeat_mutex);
-
-        for (const auto& pair : players) {
-            const std::string& player_name = pair.first;
-            const Player& player = pair.second;
-
-            // Check connected players for PING timeout
-            if (player.connected) {
-                auto ping_it = player_last_ping.find(player_name);
-                if (ping_it != player_last_ping.end()) {
-                    auto time_since_last_ping = now - ping_it->second;
-                    if (time_since_last_ping > timeout_duration) {
-                        timed_out_players.push_back(player_name);
-                    }
+
+        // Check connected players for PING timeout, only entries whose deadline already passed are touched
+        {
+            std::lock_guard<std::mutex> heartbeat_lock(heartbeat_mutex);
+            while (!ping_deadlines.empty() && ping_deadlines.top().stamp < now) {
+                TimeoutEntry entry = ping_deadlines.top();
+                ping_deadlines.pop();
+
+                uint32_t slot = Handles::index(entry.player);
+                if (slot >= ping_scheduled.size() || ping_scheduled[slot] != entry.stamp) {
+                    continue;   // Replaced by an earlier deadline or left over from a removed player
                 }
-            }
-            // Check disconnected (but not yet temporarily_disconnected) players for socket close timeout
-            else if (!player.connected && !player.temporarily_disconnected) {
-                // Socket closed but 6-second timeout hasn't been applied yet
-                auto time_since_disconnect = now - player.disconnection_start;
-                if (time_since_disconnect > timeout_duration) {
-                    timed_out_players.push_back(player_name);
+                ping_scheduled[slot] = std::chrono::steady_clock::time_point{};
+
+                const Player* player = players.get(entry.player);
+                if (!player || !player->connected) {
+                    continue;   // Next frame after a reconnect schedules again
                 }
+                // Frames since the entry was queued moved the real deadline
+                auto ping_deadline = player_last_ping[slot] + pingTimeout(heartbeat_phases[slot]);
+                if (ping_deadline >= now) {
+                    schedulePingDeadline(entry.player, ping_deadline);
+                } else {
+                    timed_out_players.push_back(player->name);
+                }
+            }
+        }
+
+        // Check disconnected (but not yet temporarily_disconnected) players for socket close timeout
+        while (!socket_close_deadlines.empty() && socket_close_deadlines.top().stamp < deadline) {
+            TimeoutEntry entry = socket_close_deadlines.top();
+            socket_close_deadlines.pop();
+
+            const Player* player = players.get(entry.player);
+            if (player && !player->connected && !player->temporarily_disconnected &&
+                player->disconnection_start == entry.stamp) {
+                timed_out_players.push_back(player->name);
             }
         }
     }
@@ -236,19 +483,20 @@ void PlayerManager::cleanupTimedOutPlayers(int timeout_seconds) {
 void PlayerManager::markPlayerTemporarilyDisconnected(const std::string& player_name) {
     std::lock_guard<std::mutex> lock(players_mutex);
 
-    auto it = players.find(player_name);
-    if (it != players.end()) {
-        int socket_fd = it->second.socket_fd;
+    PlayerHandle handle;
+    Player* player = findPlayer(player_name, &handle);
+    if (player) {
+        int socket_fd = player->socket_fd;
 
         // Update player state for temporary disconnection
-        it->second.connected = false;
-        it->second.socket_fd = -1;
-        it->second.temporarily_disconnected = true;
-        it->second.disconnection_start = std::chrono::steady_clock::now();
+        player->connected = false;
+        player->socket_fd = -1;
+        player->temporarily_disconnected = true;
+        startDisconnection(handle, *player);
 
         // Remove from socket mapping
         if (socket_fd != -1) {
-            socket_to_player.erase(socket_fd);
+            unmapSocket(socket_fd, handle);
         }
     }
 }
@@ -256,54 +504,152 @@ void PlayerManager::markPlayerTemporarilyDisconnected(const std::string& player_
 void PlayerManager::removeSocketMapping(int client_socket) {
     std::lock_guard<std::mutex> lock(players_mutex);
 
-    auto it = socket_to_player.find(client_socket);
-    if (it != socket_to_player.end()) {
-        socket_to_player.erase(it);
+    if (client_socket >= 0 && static_cast<size_t>(client_socket) < socket_to_player.size()) {
+        socket_to_player[client_socket] = Handles::INVALID;
     }
 }
 
 bool PlayerManager::reconnectPlayer(const std::string& player_name, int new_socket) {
     std::lock_guard<std::mutex> lock(players_mutex);
 
-    auto it = players.find(player_name);
-    if (it != players.end() && it->second.temporarily_disconnected) {
+    PlayerHandle handle;
+    Player* player = findPlayer(player_name, &handle);
+    if (player && player->temporarily_disconnected) {
         // Restore connection
-        it->second.connected = true;
-        it->second.socket_fd = new_socket;
-        it->second.temporarily_disconnected = false;
-        socket_to_player[new_socket] = player_name;
+        player->connected = true;
+        player->socket_fd = new_socket;
+        player->temporarily_disconnected = false;
+        mapSocket(new_socket, handle);
 
         // Update heartbeat
-        updateLastPing(player_name);
+        updateLastPing(handle);
         return true;
     }
 
     return false; // Player not found or not in reconnection state
 }
 
+bool PlayerManager::restoreDisconnectedPlayer(const std::string& player_name, const std::string& room_id) {
+    std::lock_guard<std::mutex> lock(players_mutex);
+
+    if (findHandle(player_name) != Handles::INVALID) {
+        return false;
+    }
+    if (directory && !directory->claim(player_name)) {
+        return false;
+    }
+
+    PlayerHandle handle = players.insert(Player(player_name, -1));
+    player_handles.emplace(player_name, handle);
+    Player& player = *players.get(handle);
+    player.connected = false;
+    player.temporarily_disconnected = true;
+    player.room_id = room_id;
+    addToRoomIndex(handle, room_id);
+    if (directory) {
+        directory->setRoom(player_name, room_id);
+    }
+    startDisconnection(handle, player);
+    std::lock_guard<std::mutex> hb_lock(heartbeat_mutex);
+    setHeartbeatPhase(handle, HeartbeatPhase::ROOM);
+    return true;
+}
+
+void PlayerManager::saveSnapshot(SnapshotWriter& out) {
+    std::lock_guard<std::mutex> lock(players_mutex);
+    std::lock_guard<std::mutex> hb_lock(heartbeat_mutex);
+    auto now = std::chrono::steady_clock::now();
+    auto age = [now](std::chrono::steady_clock::time_point stamp) {
+        return static_cast<int64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(now - stamp).count());
+    };
+
+    out.u32(static_cast<uint32_t>(players.size()));
+    players.forEach([&](PlayerHandle handle, const Player& player) {
+        uint32_t slot = Handles::index(handle);
+        auto last_ping = slot < player_last_ping.size() ? player_last_ping[slot] : now;
+        out.text(player.name);
+        out.text(player.room_id);
+        out.boolean(player.connected);
+        out.i64(player.socket_fd);
+        out.boolean(player.temporarily_disconnected);
+        out.i64(age(last_ping));
+        out.i64(age(player.disconnection_start));
+    });
+}
+
+bool PlayerManager::loadSnapshot(SnapshotReader& in, const std::unordered_map<int, int>& sockets) {
+    std::lock_guard<std::mutex> lock(players_mutex);
+    std::lock_guard<std::mutex> hb_lock(heartbeat_mutex);
+    auto now = std::chrono::steady_clock::now();
+
+    uint32_t count = in.u32();
+    for (uint32_t i = 0; i < count && in.ok(); ++i) {
+        std::string name = in.text();
+        std::string room_id = in.text();
+        bool connected = in.boolean();
+        int64_t old_socket = in.i64();
+        bool temporarily_disconnected = in.boolean();
+        auto last_ping = now - std::chrono::milliseconds(in.i64());
+        auto disconnection_start = now - std::chrono::milliseconds(in.i64());
+        if (!in.ok() || findHandle(name) != Handles::INVALID) {
+            return false;
+        }
+
+        PlayerHandle handle = players.insert(Player(name, -1));
+        player_handles.emplace(name, handle);
+        Player& player = *players.get(handle);
+        player.room_id = room_id;
+        player.temporarily_disconnected = temporarily_disconnected;
+        player.disconnection_start = disconnection_start;
+        addToRoomIndex(handle, room_id);
+
+        uint32_t slot = Handles::index(handle);
+        ensureHeartbeatSlot(slot);
+        player_last_ping[slot] = last_ping;
+        heartbeat_phases[slot] = room_id.empty() ? HeartbeatPhase::LOBBY : HeartbeatPhase::ROOM;
+
+        auto socket = connected ? sockets.find(static_cast<int>(old_socket)) : sockets.end();
+        if (socket != sockets.end()) {
+            player.socket_fd = socket->second;
+            mapSocket(player.socket_fd, handle);
+            schedulePingDeadline(handle, last_ping + pingTimeout(heartbeat_phases[slot]));
+        } else {
+            player.connected = false;
+            if (connected) {
+                startDisconnection(handle, player);
+            } else if (temporarily_disconnected) {
+                reconnect_deadlines.push(TimeoutEntry{disconnection_start, handle});
+            } else {
+                socket_close_deadlines.push(TimeoutEntry{disconnection_start, handle});
+            }
+        }
+    }
+    return in.ok();
+}
+
 std::vector<std::pair<std::string, bool>> PlayerManager::getPlayersForHeartbeatCheck() {
     std::lock_guard<std::mutex> lock(players_mutex);
     std::vector<std::pair<std::string, bool>> result;
 
-    for (const auto& pair : players) {
-        result.emplace_back(pair.first, pair.second.connected);
-    }
+    players.forEach([&](PlayerHandle, const Player& player) {
+        result.emplace_back(player.name, player.connected);
+    });
     return result;
 }
 
 std::vector<std::string> PlayerManager::getDisconnectedPlayersForCleanup(int cleanup_seconds) {
     std::lock_guard<std::mutex> lock(players_mutex);
     std::vector<std::string> cleanup_players;
-    auto now = std::chrono::steady_clock::now();
-    auto cleanup_timeout = std::chrono::seconds(cleanup_seconds);
-
-    for (const auto& pair : players) {
-        const Player& player = pair.second;
-        if (player.temporarily_disconnected) {
-            auto time_since_disconnect = now - player.disconnection_start;
-            if (time_since_disconnect > cleanup_timeout) {
-                cleanup_players.push_back(pair.first);
-            }
+    auto deadline = std::chrono::steady_clock::now() - std::chrono::seconds(cleanup_seconds);
+
+    while (!reconnect_deadlines.empty() && reconnect_deadlines.top().stamp < deadline) {
+        TimeoutEntry entry = reconnect_deadlines.top();
+        reconnect_deadlines.pop();
+
+        const Player* player = players.get(entry.player);
+        if (player && player->temporarily_disconnected &&
+            player->disconnection_start == entry.stamp) {
+            cleanup_players.push_back(player->name);
         }
     }
     return cleanup_players;
@@ -312,19 +658,20 @@ std::vector<std::string> PlayerManager::getDisconnectedPlayersForCleanup(int cle
 void PlayerManager::markSocketDisconnected(const std::string& player_name) {
     std::lock_guard<std::mutex> lock(players_mutex);
 
-    auto it = players.find(player_name);
-    if (it != players.end()) {
-        int socket_fd = it->second.socket_fd;
+    PlayerHandle handle;
+    Player* player = findPlayer(player_name, &handle);
+    if (player) {
+        int socket_fd = player->socket_fd;
 
         // Mark as disconnected but don't mark as temporarily_disconnected yet
         // The heartbeat monitor will detect the timeout after 6 seconds
-        it->second.connected = false;
-        it->second.socket_fd = -1;
-        it->second.disconnection_start = std::chrono::steady_clock::now();
+        player->connected = false;
+        player->socket_fd = -1;
+        startDisconnection(handle, *player);
 
         // Remove from socket mapping
         if (socket_fd != -1) {
-            socket_to_player.erase(socket_fd);
+            unmapSocket(socket_fd, handle);
         }
     }
-}
\ No newline at end of file
+}
@@ -3,45 +3,226 @@
 //
 
 #include "RoomManager.h"
+#include "SessionDirectory.h"
+#include "GameJournal.h"
+#include "Snapshot.h"
 #include <mutex>
 #include <algorithm>  // for std::find, std::remove
 #include <vector>
 #include <string>
 #include <iostream>
+#include <charconv>
+
+namespace {
+    constexpr std::string_view ROOM_PREFIX = "ROOM_";
+
+    void writeCards(SnapshotWriter& out, const std::vector<CardId>& cards) {
+        out.u32(static_cast<uint32_t>(cards.size()));
+        for (CardId id : cards) {
+            out.u8(id);
+        }
+    }
+
+    std::vector<CardId> readCards(SnapshotReader& in) {
+        uint32_t count = in.u32();
+        std::vector<CardId> cards;
+        if (count > static_cast<uint32_t>(DECK_SIZE)) {
+            in.fail();
+            return cards;
+        }
+        for (uint32_t i = 0; i < count; ++i) {
+            cards.push_back(in.u8());
+        }
+        return cards;
+    }
+
+    void writeGame(SnapshotWriter& out, const GameSnapshot& game) {
+        writeCards(out, game.deck);
+        writeCards(out, game.discardPile);
+        out.u32(static_cast<uint32_t>(game.seats.size()));
+        for (const GameSnapshot::Seat& seat : game.seats) {
+            out.text(seat.playerId);
+            out.u64(seat.hand.mask());
+            writeCards(out, seat.reserves);
+        }
+        out.u32(static_cast<uint32_t>(game.currentPlayerIndex));
+        out.u8(static_cast<uint8_t>(game.gameState));
+        out.boolean(game.clockwise);
+        out.boolean(game.mustPlaySevenOrLower);
+        out.u64(game.seed);
+        for (uint64_t word : game.generator) {
+            out.u64(word);
+        }
+    }
+
+    GameSnapshot readGame(SnapshotReader& in) {
+        GameSnapshot game;
+        game.deck = readCards(in);
+        game.discardPile = readCards(in);
+        uint32_t seats = in.u32();
+        for (uint32_t i = 0; i < seats && in.ok(); ++i) {
+            GameSnapshot::Seat seat;
+            seat.playerId = in.text();
+            seat.hand = CardSet(in.u64());
+            seat.reserves = readCards(in);
+            game.seats.push_back(std::move(seat));
+        }
+        game.currentPlayerIndex = in.u32();
+        uint8_t state = in.u8();
+        if (state > static_cast<uint8_t>(GameState::GAME_FINISHED)) {
+            in.fail();
+        }
+        game.gameState = static_cast<GameState>(state);
+        game.clockwise = in.boolean();
+        game.mustPlaySevenOrLower = in.boolean();
+        game.seed = in.u64();
+        for (uint64_t& word : game.generator) {
+            word = in.u64();
+        }
+        return game;
+    }
+
+    // Baseline of the next TURN_UPDATE delta, carried so clients keep their seq and get deltas right away
+    void writeView(SnapshotWriter& out, const GameStateData& view) {
+        out.u64(view.hand_cards.mask());
+        out.u32(static_cast<uint32_t>(view.reserve_count));
+        out.text(view.current_player);
+        out.text(view.top_discard_card);
+        out.u32(static_cast<uint32_t>(view.other_players_info.size()));
+        for (const std::string& info : view.other_players_info) {
+            out.text(info);
+        }
+        out.boolean(view.must_play_seven_or_lower);
+        out.boolean(view.valid);
+        out.text(view.error_message);
+        out.u32(static_cast<uint32_t>(view.deck_size));
+        out.u32(static_cast<uint32_t>(view.discard_pile_size));
+        out.u32(view.seq);
+    }
+
+    GameStateData readView(SnapshotReader& in) {
+        GameStateData view;
+        view.hand_cards = CardSet(in.u64());
+        view.reserve_count = static_cast<int>(in.u32());
+        view.current_player = in.text();
+        view.top_discard_card = in.text();
+        uint32_t others = in.u32();
+        for (uint32_t i = 0; i < others && in.ok(); ++i) {
+            view.other_players_info.push_back(in.text());
+        }
+        view.must_play_seven_or_lower = in.boolean();
+        view.valid = in.boolean();
+        view.error_message = in.text();
+        view.deck_size = static_cast<int>(in.u32());
+        view.discard_pile_size = static_cast<int>(in.u32());
+        view.seq = in.u32();
+        return view;
+    }
+}
+
+std::string RoomManager::roomName(RoomHandle handle) {
+    return std::string(ROOM_PREFIX) + std::to_string(handle);
+}
+
+RoomHandle RoomManager::parseRoomId(const std::string& room_id) {
+    std::string_view id(room_id);
+    if (id.size() <= ROOM_PREFIX.size() || id.substr(0, ROOM_PREFIX.size()) != ROOM_PREFIX) {
+        return Handles::INVALID;
+    }
+    id.remove_prefix(ROOM_PREFIX.size());
+    RoomHandle handle = Handles::INVALID;
+    auto result = std::from_chars(id.data(), id.data() + id.size(), handle);
+    if (result.ec != std::errc() || result.ptr != id.data() + id.size()) {
+        return Handles::INVALID;
+    }
+    return handle;
+}
+
+std::shared_ptr<Room> RoomManager::findRoom(const std::string& room_id) {
+    return findRoom(parseRoomId(room_id));
+}
+
+std::shared_ptr<Room> RoomManager::findRoom(RoomHandle room_handle) {
+    std::shared_lock<std::shared_mutex> lock(index_mutex);
+    const std::shared_ptr<Room>* room = rooms.get(room_handle);
+    return room ? *room : nullptr;
+}
+
+void RoomManager::eraseRoom(const std::shared_ptr<Room>& room) {
+    RoomHandle handle = parseRoomId(room->id);
+    std::shared_ptr<Room> erased;
+    {
+        std::unique_lock<std::shared_mutex> lock(index_mutex);
+        std::shared_ptr<Room>* registered = rooms.get(handle);
+        if (registered && *registered == room) {
+            erased = std::move(*registered);
+            rooms.erase(handle);
+        }
+    }
+    if (erased && directory) {
+        directory->withdrawSeat(handle);
+    }
+    pool.release(std::move(erased));
+}
+
+void RoomManager::pushWaitingRoom(RoomHandle room_handle) {
+    {
+        std::lock_guard<std::mutex> lock(waiting_mutex);
+        waiting_rooms.push_back(room_handle);
+    }
+    if (directory) {
+        directory->offerSeat(room_handle);
+    }
+}
 
 std::string RoomManager::createRoom() {
-    std::string room_name = "ROOM_" + std::to_string(next_room_id);
-    rooms[room_name] = Room(room_name);
-    next_room_id++;
+    std::shared_ptr<Room> room = pool.acquire("");
+    if (!room) {
+        return "";  // Every room of the pool is in use
+    }
+
+    // Id depends on the handle, the room is not reachable by anyone else until it is in the index
+    std::unique_lock<std::shared_mutex> lock(index_mutex);
+    RoomHandle handle = rooms.insert(nullptr);
+    std::string room_name = roomName(handle);
+    room->id = room_name;
+    *rooms.get(handle) = std::move(room);
     return room_name;
 }
 
 bool RoomManager::deleteRoom(const std::string& room_id) {
-    std::lock_guard<std::mutex> lock(rooms_mutex);
-    
-    auto room_it = rooms.find(room_id);
-    if (room_it == rooms.end()) {
-        return false;  // Room doesn't exist
-    }
-    
-    rooms.erase(room_it);
+    RoomHandle handle = parseRoomId(room_id);
+    std::shared_ptr<Room> room;
+    {
+        std::unique_lock<std::shared_mutex> lock(index_mutex);
+        std::shared_ptr<Room>* registered = rooms.get(handle);
+        if (!registered) {
+            return false;  // Room doesn't exist
+        }
+        room = std::move(*registered);
+        rooms.erase(handle);
+    }
+    if (directory) {
+        directory->withdrawSeat(handle);
+    }
+
+    // Operations that already hold the pointer see the room as gone
+    {
+        std::lock_guard<std::mutex> room_lock(room->mutex);
+        room->removed = true;
+        if (journal) {
+            journal->recordClose(room->id);
+        }
+    }
+    pool.release(std::move(room));
     return true;
 }
 
 bool RoomManager::roomExists(const std::string& room_id) {
-    std::lock_guard<std::mutex> lock(rooms_mutex);
-    return rooms.find(room_id) != rooms.end();
+    return findRoom(room_id) != nullptr;
 }
 
-bool RoomManager::joinRoom(const std::string& player_id, const std::string& room_id) {
-
-    auto room_it = rooms.find(room_id);
-    if (room_it == rooms.end()) {
-        return false;  // Room doesn't exist
-    }
-
-    Room& room = room_it->second;
-
+bool RoomManager::joinRoomLocked(Room& room, const std::string& player_id) {
     // Check if room is full
     if (room.players.size() >= 2) {  // FIX: was calling isRoomFull incorrectly
         return false;
@@ -54,123 +235,346 @@ bool RoomManager::joinRoom(const std::string& player_id, const std::string& room
 
     // ADD THE MISSING PART:
     if (room.addPlayerToGame(player_id)) {
+        if (journal) {
+            journal->recordJoin(room.id, player_id);
+        }
         return true;
     }
 
     return false;
 }
 
-bool RoomManager::isRoomFull(const std::string& room_id) {
-
-    auto room_it = rooms.find(room_id);
-    if (room_it == rooms.end()) {
-        return false;  // Room doesn't exist, so not full
-    }
+bool RoomManager::joinRoom(const std::string& player_id, const std::string& room_id) {
+    return withRoom(room_id, [&](Room* room) -> bool {
+        if (!room) {
+            return false;  // Room doesn't exist
+        }
+        return joinRoomLocked(*room, player_id);
+    });
+}
 
-    return room_it->second.players.size() >= 2;  // True if exactly 2 players
+bool RoomManager::isRoomFull(const std::string& room_id) {
+    return withRoom(room_id, [](Room* room) -> bool {
+        if (!room) {
+            return false;  // Room doesn't exist, so not full
+        }
+        return room->players.size() >= 2;  // True if exactly 2 players
+    });
 }
 
 bool RoomManager::leaveRoom(const std::string& player_id, const std::string& room_id) {
-    std::lock_guard<std::mutex> lock(rooms_mutex);
-
     if (room_id.empty()) {
         return false;  // Player not in any room
     }
 
-    auto room_it = rooms.find(room_id);
-    if (room_it != rooms.end()) {
+    std::shared_ptr<Room> room = findRoom(room_id);
+    if (!room) {
+        return false;
+    }
+
+    bool now_empty = false;
+    bool now_waiting = false;
+    {
+        std::lock_guard<std::mutex> room_lock(room->mutex);
+        if (room->removed) {
+            return false;
+        }
+
         // Remove player from room's player list
-        auto& players_vec = room_it->second.players;
+        auto& players_vec = room->players;
         players_vec.erase(std::remove(players_vec.begin(), players_vec.end(), player_id), players_vec.end());
+        // Free the seat too, or the next joiner of this room would start a game with a ghost player
+        // (refused while a game runs, resetGame drops the seats then)
+        room->gameLogic->removePlayer(player_id);
+        if (journal) {
+            journal->recordLeave(room->id, player_id);
+        }
 
         // Delete room if empty
-        if (room_it->second.players.empty()) {
-            rooms.erase(room_it);
+        if (players_vec.empty()) {
+            room->removed = true;
+            now_empty = true;
+            if (journal) {
+                journal->recordClose(room->id);
+            }
+        } else if (players_vec.size() == 1) {
+            now_waiting = true;
         }
-        return true;
     }
-    return false;
+
+    if (now_empty) {
+        eraseRoom(room);
+    } else if (now_waiting) {
+        pushWaitingRoom(parseRoomId(room_id));
+    }
+    return true;
 }
 
 std::vector<std::string> RoomManager::getRoomPlayers(const std::string& room_id) {
-    std::lock_guard<std::mutex> lock(rooms_mutex);
-    auto room_it = rooms.find(room_id);
-    if (room_it == rooms.end()) {
-        return std::vector<std::string>();
-    }
-    return room_it->second.players;
+    return withRoom(room_id, [](Room* room) -> std::vector<std::string> {
+        if (!room) {
+            return std::vector<std::string>();
+        }
+        return room->players;
+    });
 }
 
-std::string RoomManager::joinAnyAvailableRoom(const std::string& player_name) {
-    std::lock_guard<std::mutex> lock(rooms_mutex);
+size_t RoomManager::getRoomCount() {
+    std::shared_lock<std::shared_mutex> lock(index_mutex);
+    return rooms.size();
+}
 
-    // Look for rooms with exactly 1 player (available for second player)
-    for (auto& pair : rooms) {
+std::string RoomManager::joinWaitingRoom(const std::string& player_name) {
+    // Take rooms waiting for a second player, skipping stale entries (filled, emptied or deleted meanwhile)
+    while (true) {
+        RoomHandle candidate;
+        {
+            std::lock_guard<std::mutex> lock(waiting_mutex);
+            if (waiting_rooms.empty()) {
+                break;
+            }
+            candidate = waiting_rooms.front();
+            waiting_rooms.pop_front();
+        }
+        if (directory) {
+            directory->withdrawSeat(candidate);  // Filled or stale either way, re-offered if it waits again
+        }
 
-        if (pair.second.players.size() == 1) {
-            // Found room with 1 player - join it
-            if (joinRoom(player_name, pair.first)) {
-                return pair.first;  // Return room_id
-            } else {
+        bool joined = withRoom(candidate, [&](Room* room) -> bool {
+            if (!room || room->players.size() != 1) {
+                return false;
             }
+            return joinRoomLocked(*room, player_name);
+        });
+        if (joined) {
+            return roomName(candidate);  // Return room_id
         }
     }
+    return "";
+}
+
+std::string RoomManager::joinAnyAvailableRoom(const std::string& player_name) {
+    std::string waiting_room = joinWaitingRoom(player_name);
+    if (!waiting_room.empty()) {
+        return waiting_room;
+    }
 
     // No available rooms - create new empty room
     std::string new_room = createRoom();
+    if (new_room.empty()) {
+        return "";  // max_rooms reached
+    }
     if (joinRoom(player_name, new_room)) {
+        pushWaitingRoom(parseRoomId(new_room));
         return new_room;
     }
     return "";  // Failed to join any room
 }
 
+std::string RoomManager::createRoomFor(const std::vector<std::string>& player_names) {
+    std::string new_room = createRoom();
+    if (new_room.empty()) {
+        return "";  // max_rooms reached
+    }
+    bool seated = withRoom(new_room, [&](Room* room) -> bool {
+        if (!room) {
+            return false;
+        }
+        for (const std::string& player_name : player_names) {
+            if (!joinRoomLocked(*room, player_name)) {
+                return false;
+            }
+        }
+        return true;
+    });
+    if (!seated) {
+        deleteRoom(new_room);
+        return "";
+    }
+    if (player_names.size() == 1) {
+        pushWaitingRoom(parseRoomId(new_room));
+    }
+    return new_room;
+}
+
 bool RoomManager::startGame(const std::string& room_id) {
-    std::lock_guard<std::mutex> lock(rooms_mutex);
+    return withRoom(room_id, [this](Room* room) -> bool {
+        if (!room) {
+            return false;  // Room not found
+        }
+
+        // Check if can start game
+        if (room->players.size() < 2) {
+            return false;  // Need at least 2 players
+        }
+
+        // Use the Room's integrated game logic
+        if (!room->startGame()) {
+            return false;
+        }
+        if (journal) {
+            journal->recordGameStart(room->id, room->gameLogic->getSeed());
+        }
+        return true;
+    });
+}
 
-    auto room_it = rooms.find(room_id);
-    if (room_it == rooms.end()) {
-        return false;  // Room not found
+std::string RoomManager::restoreRoom(const std::function<bool(Room&)>& rebuild) {
+    std::shared_ptr<Room> room = pool.acquire("");
+    if (!room) {
+        return "";
+    }
+    // Not indexed yet, nobody else can reach the room while it is rebuilt
+    if (!rebuild(*room)) {
+        pool.release(std::move(room));
+        return "";
+    }
+
+    bool waiting = room->players.size() == 1;
+    std::string room_name;
+    {
+        std::unique_lock<std::shared_mutex> lock(index_mutex);
+        RoomHandle handle = rooms.insert(nullptr);
+        room_name = roomName(handle);
+        room->id = room_name;
+        *rooms.get(handle) = std::move(room);
+    }
+    if (waiting) {
+        pushWaitingRoom(parseRoomId(room_name));
+    }
+    return room_name;
+}
+
+void RoomManager::saveSnapshot(SnapshotWriter& out) {
+    std::vector<std::pair<RoomHandle, std::shared_ptr<Room>>> live;
+    {
+        std::shared_lock<std::shared_mutex> lock(index_mutex);
+        rooms.forEach([&live](RoomHandle handle, const std::shared_ptr<Room>& room) {
+            live.emplace_back(handle, room);
+        });
+    }
+
+    out.u32(static_cast<uint32_t>(live.size()));
+    for (const auto& [handle, room] : live) {
+        std::lock_guard<std::mutex> lock(room->mutex);
+        out.u32(handle);
+        out.u32(static_cast<uint32_t>(room->players.size()));
+        for (const std::string& player : room->players) {
+            out.text(player);
+        }
+        out.boolean(room->active);
+        writeGame(out, room->gameLogic->saveSnapshot());
+        out.u32(static_cast<uint32_t>(room->sent_state.size()));
+        for (const auto& [player, view] : room->sent_state) {
+            out.text(player);
+            writeView(out, view);
+        }
     }
 
-    Room& room = room_it->second;
+    std::lock_guard<std::mutex> lock(waiting_mutex);
+    out.u32(static_cast<uint32_t>(waiting_rooms.size()));
+    for (RoomHandle handle : waiting_rooms) {
+        out.u32(handle);
+    }
+}
+
+bool RoomManager::loadSnapshot(SnapshotReader& in) {
+    uint32_t room_count = in.u32();
+    for (uint32_t i = 0; i < room_count && in.ok(); ++i) {
+        RoomHandle handle = in.u32();
+        std::shared_ptr<Room> room = pool.acquire(roomName(handle));
+        if (!room) {
+            return false;   // New max_rooms is smaller than what is in use
+        }
+
+        uint32_t player_count = in.u32();
+        for (uint32_t p = 0; p < player_count && in.ok(); ++p) {
+            room->players.push_back(in.text());
+        }
+        room->active = in.boolean();
+        GameSnapshot game = readGame(in);
+        uint32_t view_count = in.u32();
+        for (uint32_t v = 0; v < view_count && in.ok(); ++v) {
+            std::string player = in.text();
+            room->sent_state[player] = readView(in);
+        }
 
-    // Check if can start game
-    if (room.players.size() < 2) {
-        return false;  // Need at least 2 players
+        bool indexed = false;
+        if (in.ok() && room->gameLogic->restoreSnapshot(game)) {
+            std::unique_lock<std::shared_mutex> lock(index_mutex);
+            indexed = rooms.insertAt(handle, room);
+        }
+        if (!indexed) {
+            pool.release(std::move(room));
+            return false;
+        }
     }
 
-    // Use the Room's integrated game logic
-    return room.startGame();
+    uint32_t waiting_count = in.u32();
+    std::lock_guard<std::mutex> lock(waiting_mutex);
+    for (uint32_t i = 0; i < waiting_count && in.ok(); ++i) {
+        waiting_rooms.push_back(in.u32());
+    }
+    return in.ok();
 }
 
 void RoomManager::handlePlayerTimeout(const std::string& player_name, const std::string& room_id) {
     // If player was in a room, handle the timeout in that room
-    if (!room_id.empty() && room_id != "lobby") {
-        std::lock_guard<std::mutex> lock(rooms_mutex);
-        auto room_it = rooms.find(room_id);
-
-        if (room_it != rooms.end()) {
-            Room& room = room_it->second;
-
-            // Check if game was active before removing player
-            bool game_was_active = room.isGameActive();
-
-            // Remove player from room
-            auto it = std::find(room.players.begin(), room.players.end(), player_name);
-            if (it != room.players.end()) {
-                room.players.erase(it);
-
-                // If room becomes empty, delete it
-                if (room.players.empty()) {
-                    rooms.erase(room_it);
-                } else if (game_was_active && room.players.size() == 1) {
-                    // Game was active and only one player remains
-                    // The game must end (can't continue with 1 player)
-                    // Note: Notification is handled by NetworkManager
-                    room.resetGame();
-                    // Room will be deleted after notification
-                }
+    if (room_id.empty() || room_id == "lobby") {
+        return;
+    }
+
+    std::shared_ptr<Room> room = findRoom(room_id);
+    if (!room) {
+        return;
+    }
+
+    bool now_empty = false;
+    bool now_waiting = false;
+    {
+        std::lock_guard<std::mutex> room_lock(room->mutex);
+        if (room->removed) {
+            return;
+        }
+
+        // Check if game was active before removing player
+        bool game_was_active = room->isGameActive();
+
+        // Remove player from room
+        auto it = std::find(room->players.begin(), room->players.end(), player_name);
+        if (it == room->players.end()) {
+            return;
+        }
+        room->players.erase(it);
+        room->gameLogic->removePlayer(player_name);
+        if (journal) {
+            journal->recordLeave(room->id, player_name);
+        }
+
+        // If room becomes empty, delete it
+        if (room->players.empty()) {
+            room->removed = true;
+            now_empty = true;
+            if (journal) {
+                journal->recordClose(room->id);
             }
+        } else if (game_was_active && room->players.size() == 1) {
+            // Game was active and only one player remains
+            // The game must end (can't continue with 1 player)
+            // Note: Notification is handled by NetworkManager
+            room->resetGame();
+            if (journal) {
+                journal->recordGameReset(room->id);
+            }
+            // Room will be deleted after notification
+        } else if (room->players.size() == 1) {
+            now_waiting = true;
         }
     }
-}
\ No newline at end of file
+
+    if (now_empty) {
+        eraseRoom(room);
+    } else if (now_waiting) {
+        pushWaitingRoom(parseRoomId(room_id));
+    }
+}
@@ -0,0 +1,59 @@
+// RoomPool.cpp - Preallocated pool of game rooms
+// KIV/UPS Network Programming Project
+
+#include "RoomPool.h"
+
+RoomPool::RoomPool(size_t max_rooms) : capacity(max_rooms), in_use(0) {
+    free_rooms.reserve(capacity);
+    draining.reserve(capacity);
+    for (size_t i = 0; i < capacity; ++i) {
+        free_rooms.push_back(std::make_shared<Room>());
+    }
+}
+
+void RoomPool::collectDrained() {
+    for (size_t i = 0; i < draining.size();) {
+        if (draining[i].use_count() == 1) {
+            free_rooms.push_back(std::move(draining[i]));
+            draining[i] = std::move(draining.back());
+            draining.pop_back();
+        } else {
+            ++i;
+        }
+    }
+}
+
+std::shared_ptr<Room> RoomPool::acquire(const std::string& room_id) {
+    std::shared_ptr<Room> room;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (free_rooms.empty()) {
+            collectDrained();
+            if (free_rooms.empty()) {
+                return nullptr;
+            }
+        }
+        room = std::move(free_rooms.back());
+        free_rooms.pop_back();
+        in_use++;
+    }
+
+    // Last outside user unlocked the room before dropping its reference, taking the lock makes its writes visible
+    std::lock_guard<std::mutex> room_lock(room->mutex);
+    room->recycle(room_id);
+    return room;
+}
+
+void RoomPool::release(std::shared_ptr<Room> room) {
+    if (!room) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    in_use--;
+    draining.push_back(std::move(room));
+}
+
+size_t RoomPool::getInUse() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return in_use;
+}
@@ -0,0 +1,90 @@
+// RoomShardPool.cpp - Worker threads running game logic per room shard
+// KIV/UPS Network Programming Project
+
+#include "RoomShardPool.h"
+#include "Tracing.h"
+
+RoomShardPool::RoomShardPool(size_t shard_count) : running(false) {
+    if (shard_count == 0) {
+        shard_count = 1;
+    }
+    shards.reserve(shard_count);
+    for (size_t i = 0; i < shard_count; ++i) {
+        shards.push_back(std::make_unique<Shard>());
+    }
+}
+
+RoomShardPool::~RoomShardPool() {
+    stop();
+}
+
+void RoomShardPool::start() {
+    if (running.exchange(true)) {
+        return;  // Already running
+    }
+    for (auto& shard : shards) {
+        shard->worker = std::thread(&RoomShardPool::workerLoop, this, shard.get());
+    }
+}
+
+void RoomShardPool::stop() {
+    if (!running.exchange(false)) {
+        return;
+    }
+    for (auto& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard->queue_mutex);
+        shard->queue_cv.notify_all();
+    }
+    for (auto& shard : shards) {
+        if (shard->worker.joinable()) {
+            shard->worker.join();
+        }
+    }
+}
+
+size_t RoomShardPool::shardFor(const std::string& room_id) const {
+    return std::hash<std::string>{}(room_id) % shards.size();
+}
+
+bool RoomShardPool::post(size_t shard, Task task) {
+    Shard& target = *shards[shard % shards.size()];
+    {
+        // Checked under the queue lock, a worker only exits with its queue empty under this lock after stop()
+        std::lock_guard<std::mutex> lock(target.queue_mutex);
+        if (!running.load()) {
+            return false;
+        }
+        target.tasks.push_back(std::move(task));
+    }
+    target.queue_cv.notify_one();
+    return true;
+}
+
+size_t RoomShardPool::queueDepth(size_t shard) {
+    Shard& target = *shards[shard % shards.size()];
+    std::lock_guard<std::mutex> lock(target.queue_mutex);
+    return target.tasks.size();
+}
+
+void RoomShardPool::workerLoop(Shard* shard) {
+    for (size_t i = 0; i < shards.size(); ++i) {
+        if (shards[i].get() == shard) {
+            Tracing::nameThread("shard " + std::to_string(i));
+        }
+    }
+    while (true) {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(shard->queue_mutex);
+            shard->queue_cv.wait(lock, [this, shard] { return !shard->tasks.empty() || !running.load(); });
+
+            // Drain remaining tasks before exiting so no accepted message is lost
+            if (shard->tasks.empty()) {
+                return;
+            }
+            task = std::move(shard->tasks.front());
+            shard->tasks.pop_front();
+        }
+        task();
+    }
+}
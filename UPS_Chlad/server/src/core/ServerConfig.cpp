@@ -120,6 +120,14 @@ bool ServerConfig::loadFromFile(const std::string& filename) {
                     enable_file_logging = true;
                     has_errors = true;
                 }
+            } else if (key == "log_flush_interval_ms") {
+                log_flush_interval_ms = std::stoi(value);
+                if (log_flush_interval_ms < 1 || log_flush_interval_ms > 10000) {
+                    std::cerr << "Warning: Invalid log_flush_interval_ms " << log_flush_interval_ms
+                              << " at line " << line_number << ". Using default: 100" << std::endl;
+                    log_flush_interval_ms = 100;
+                    has_errors = true;
+                }
             } else if (key == "player_timeout_seconds") {
                 player_timeout_seconds = std::stoi(value);
                 if (player_timeout_seconds < 5) {
@@ -136,6 +144,231 @@ bool ServerConfig::loadFromFile(const std::string& filename) {
                     heartbeat_check_interval = 10;
                     has_errors = true;
                 }
+            } else if (key == "reconnect_window_seconds") {
+                reconnect_window_seconds = std::stoi(value);
+                if (reconnect_window_seconds < 1) {
+                    std::cerr << "Warning: Invalid reconnect_window_seconds " << reconnect_window_seconds
+                              << " at line " << line_number << ". Using default: 120" << std::endl;
+                    reconnect_window_seconds = 120;
+                    has_errors = true;
+                }
+            } else if (key == "heartbeat_interval_ms") {
+                heartbeat_interval_ms = std::stoi(value);
+                if (heartbeat_interval_ms < 100) {
+                    std::cerr << "Warning: Invalid heartbeat_interval_ms " << heartbeat_interval_ms
+                              << " at line " << line_number << ". Using default: 2000" << std::endl;
+                    heartbeat_interval_ms = 2000;
+                    has_errors = true;
+                }
+            } else if (key == "heartbeat_lobby_interval_ms") {
+                heartbeat_lobby_interval_ms = std::stoi(value);
+                if (heartbeat_lobby_interval_ms < 100) {
+                    std::cerr << "Warning: Invalid heartbeat_lobby_interval_ms " << heartbeat_lobby_interval_ms
+                              << " at line " << line_number << ". Using default: 2000" << std::endl;
+                    heartbeat_lobby_interval_ms = 2000;
+                    has_errors = true;
+                }
+            } else if (key == "lobby_timeout_seconds") {
+                lobby_timeout_seconds = std::stoi(value);
+                if (lobby_timeout_seconds != 0 && lobby_timeout_seconds < 5) {
+                    std::cerr << "Warning: Invalid lobby_timeout_seconds " << lobby_timeout_seconds
+                              << " at line " << line_number << ". Using default: 0" << std::endl;
+                    lobby_timeout_seconds = 0;
+                    has_errors = true;
+                }
+            } else if (key == "heartbeat_turn_interval_ms") {
+                heartbeat_turn_interval_ms = std::stoi(value);
+                if (heartbeat_turn_interval_ms < 100) {
+                    std::cerr << "Warning: Invalid heartbeat_turn_interval_ms " << heartbeat_turn_interval_ms
+                              << " at line " << line_number << ". Using default: 1000" << std::endl;
+                    heartbeat_turn_interval_ms = 1000;
+                    has_errors = true;
+                }
+            } else if (key == "matchmaking_tick_ms") {
+                matchmaking_tick_ms = std::stoi(value);
+                if (matchmaking_tick_ms < 0 || matchmaking_tick_ms > 1000) {
+                    std::cerr << "Warning: Invalid matchmaking_tick_ms " << matchmaking_tick_ms
+                              << " at line " << line_number << ". Using default: 5" << std::endl;
+                    matchmaking_tick_ms = 5;
+                    has_errors = true;
+                }
+            } else if (key == "io_mode") {
+                std::string lower_value = value;
+                std::transform(lower_value.begin(), lower_value.end(), lower_value.begin(), ::tolower);
+                if (lower_value == "epoll" || lower_value == "io_uring" || lower_value == "threaded") {
+                    io_mode = lower_value;
+                } else {
+                    std::cerr << "Warning: Invalid io_mode '" << value
+                              << "' at line " << line_number << ". Using default: epoll" << std::endl;
+                    io_mode = "epoll";
+                    has_errors = true;
+                }
+            } else if (key == "worker_threads") {
+                worker_threads = std::stoi(value);
+                if (worker_threads < 0 || worker_threads > 256) {
+                    std::cerr << "Warning: Invalid worker_threads " << worker_threads
+                              << " at line " << line_number << ". Using default: 4" << std::endl;
+                    worker_threads = 4;
+                    has_errors = true;
+                }
+            } else if (key == "outbound_high_water_bytes") {
+                outbound_high_water_bytes = std::stoi(value);
+                if (outbound_high_water_bytes < 1024) {
+                    std::cerr << "Warning: Invalid outbound_high_water_bytes " << outbound_high_water_bytes
+                              << " at line " << line_number << ". Using default: 262144" << std::endl;
+                    outbound_high_water_bytes = 262144;
+                    has_errors = true;
+                }
+            } else if (key == "slow_client_grace_ms") {
+                slow_client_grace_ms = std::stoi(value);
+                if (slow_client_grace_ms < 0) {
+                    std::cerr << "Warning: Invalid slow_client_grace_ms " << slow_client_grace_ms
+                              << " at line " << line_number << ". Using default: 5000" << std::endl;
+                    slow_client_grace_ms = 5000;
+                    has_errors = true;
+                }
+            } else if (key == "tcp_nodelay") {
+                std::string lower_value = value;
+                std::transform(lower_value.begin(), lower_value.end(), lower_value.begin(), ::tolower);
+                if (lower_value == "true" || lower_value == "1" || lower_value == "yes") {
+                    tcp_nodelay = true;
+                } else if (lower_value == "false" || lower_value == "0" || lower_value == "no") {
+                    tcp_nodelay = false;
+                } else {
+                    std::cerr << "Warning: Invalid tcp_nodelay value '" << value
+                              << "' at line " << line_number << ". Using default: true" << std::endl;
+                    tcp_nodelay = true;
+                    has_errors = true;
+                }
+            } else if (key == "accept_rate_per_ip") {
+                accept_rate_per_ip = std::stoi(value);
+                if (accept_rate_per_ip < 0) {
+                    std::cerr << "Warning: Invalid accept_rate_per_ip " << accept_rate_per_ip
+                              << " at line " << line_number << ". Using default: 0" << std::endl;
+                    accept_rate_per_ip = 0;
+                    has_errors = true;
+                }
+            } else if (key == "accept_burst_per_ip") {
+                accept_burst_per_ip = std::stoi(value);
+                if (accept_burst_per_ip < 1) {
+                    std::cerr << "Warning: Invalid accept_burst_per_ip " << accept_burst_per_ip
+                              << " at line " << line_number << ". Using default: 50" << std::endl;
+                    accept_burst_per_ip = 50;
+                    has_errors = true;
+                }
+            } else if (key == "client_message_rate") {
+                client_message_rate = std::stoi(value);
+                if (client_message_rate < 0) {
+                    std::cerr << "Warning: Invalid client_message_rate " << client_message_rate
+                              << " at line " << line_number << ". Using default: 0" << std::endl;
+                    client_message_rate = 0;
+                    has_errors = true;
+                }
+            } else if (key == "client_message_burst") {
+                client_message_burst = std::stoi(value);
+                if (client_message_burst < 1) {
+                    std::cerr << "Warning: Invalid client_message_burst " << client_message_burst
+                              << " at line " << line_number << ". Using default: 100" << std::endl;
+                    client_message_burst = 100;
+                    has_errors = true;
+                }
+            } else if (key == "rate_limit_strikes") {
+                rate_limit_strikes = std::stoi(value);
+                if (rate_limit_strikes < 1) {
+                    std::cerr << "Warning: Invalid rate_limit_strikes " << rate_limit_strikes
+                              << " at line " << line_number << ". Using default: 5" << std::endl;
+                    rate_limit_strikes = 5;
+                    has_errors = true;
+                }
+            } else if (key == "admin_ip") {
+                admin_ip = value;
+            } else if (key == "admin_port") {
+                admin_port = std::stoi(value);
+                if (admin_port < 0 || admin_port > 65535) {
+                    std::cerr << "Warning: Invalid admin_port " << admin_port
+                              << " at line " << line_number << ". Using default: 0 (disabled)" << std::endl;
+                    admin_port = 0;
+                    has_errors = true;
+                }
+            } else if (key == "reuse_port") {
+                std::string lower_value = value;
+                std::transform(lower_value.begin(), lower_value.end(), lower_value.begin(), ::tolower);
+                if (lower_value == "true" || lower_value == "1" || lower_value == "yes") {
+                    reuse_port = true;
+                } else if (lower_value == "false" || lower_value == "0" || lower_value == "no") {
+                    reuse_port = false;
+                } else {
+                    std::cerr << "Warning: Invalid reuse_port value '" << value
+                              << "' at line " << line_number << ". Using default: false" << std::endl;
+                    reuse_port = false;
+                    has_errors = true;
+                }
+            } else if (key == "session_directory") {
+                session_directory = value;
+            } else if (key == "node_id") {
+                node_id = std::stoi(value);
+                if (node_id < 0 || node_id > 63) {
+                    std::cerr << "Warning: Invalid node_id " << node_id
+                              << " at line " << line_number << ". Using default: 0" << std::endl;
+                    node_id = 0;
+                    has_errors = true;
+                }
+            } else if (key == "hot_restart_socket") {
+                hot_restart_socket = value;
+            } else if (key == "trace_sample_rate") {
+                trace_sample_rate = std::stod(value);
+                if (trace_sample_rate < 0.0 || trace_sample_rate > 1.0) {
+                    std::cerr << "Warning: Invalid trace_sample_rate " << trace_sample_rate
+                              << " at line " << line_number << ". Using default: 0 (disabled)" << std::endl;
+                    trace_sample_rate = 0.0;
+                    has_errors = true;
+                }
+            } else if (key == "trace_buffer_spans") {
+                trace_buffer_spans = std::stoi(value);
+                if (trace_buffer_spans < 16) {
+                    std::cerr << "Warning: Invalid trace_buffer_spans " << trace_buffer_spans
+                              << " at line " << line_number << ". Using default: 65536" << std::endl;
+                    trace_buffer_spans = 65536;
+                    has_errors = true;
+                }
+            } else if (key == "trace_file") {
+                trace_file = value;
+            } else if (key == "journal_dir") {
+                journal_dir = value;
+            } else if (key == "journal_flush_ms") {
+                journal_flush_ms = std::stoi(value);
+                if (journal_flush_ms < 1 || journal_flush_ms > 1000) {
+                    std::cerr << "Warning: Invalid journal_flush_ms " << journal_flush_ms
+                              << " at line " << line_number << ". Using default: 5" << std::endl;
+                    journal_flush_ms = 5;
+                    has_errors = true;
+                }
+            } else if (key == "journal_sync") {
+                std::string lower_value = value;
+                std::transform(lower_value.begin(), lower_value.end(), lower_value.begin(), ::tolower);
+                if (lower_value == "true" || lower_value == "1" || lower_value == "yes") {
+                    journal_sync = true;
+                } else if (lower_value == "false" || lower_value == "0" || lower_value == "no") {
+                    journal_sync = false;
+                } else {
+                    std::cerr << "Warning: Invalid journal_sync value '" << value
+                              << "' at line " << line_number << ". Using default: true" << std::endl;
+                    journal_sync = true;
+                    has_errors = true;
+                }
+            } else if (key == "journal_keep_finished") {
+                std::string lower_value = value;
+                std::transform(lower_value.begin(), lower_value.end(), lower_value.begin(), ::tolower);
+                if (lower_value == "true" || lower_value == "1" || lower_value == "yes") {
+                    journal_keep_finished = true;
+                } else if (lower_value == "false" || lower_value == "0" || lower_value == "no") {
+                    journal_keep_finished = false;
+                } else {
+                    std::cerr << "Warning: Invalid journal_keep_finished value '" << value
+                              << "' at line " << line_number << ". Using default: true" << std::endl;
+                    journal_keep_finished = true;
+                    has_errors = true;
+                }
             } else {
                 std::cerr << "Warning: Unknown configuration key '" << key
                           << "' at line " << line_number << " in " << filename << std::endl;
@@ -206,6 +439,50 @@ void ServerConfig::parseCommandLine(int argc, char* argv[]) {
                 printUsage(argv[0]);
                 exit(1);
             }
+        } else if (arg == "--node-id") {
+            if (i + 1 < argc) {
+                try {
+                    node_id = std::stoi(argv[++i]);
+                    if (node_id < 0 || node_id > 63) {
+                        std::cerr << "Error: Node id must be between 0 and 63" << std::endl;
+                        exit(1);
+                    }
+                } catch (const std::exception& e) {
+                    std::cerr << "Error: Invalid node id" << std::endl;
+                    exit(1);
+                }
+            } else {
+                std::cerr << "Error: --node-id requires a number" << std::endl;
+                printUsage(argv[0]);
+                exit(1);
+            }
+        } else if (arg == "--replay") {
+            if (i + 1 < argc) {
+                replay_file = argv[++i];
+            } else {
+                std::cerr << "Error: --replay requires a journal file" << std::endl;
+                printUsage(argv[0]);
+                exit(1);
+            }
+        } else if (arg == "--takeover") {
+            takeover = true;
+        } else if (arg == "--trace-rate") {
+            if (i + 1 < argc) {
+                try {
+                    trace_sample_rate = std::stod(argv[++i]);
+                    if (trace_sample_rate < 0.0 || trace_sample_rate > 1.0) {
+                        std::cerr << "Error: Trace sample rate must be between 0 and 1" << std::endl;
+                        exit(1);
+                    }
+                } catch (const std::exception& e) {
+                    std::cerr << "Error: Invalid trace sample rate" << std::endl;
+                    exit(1);
+                }
+            } else {
+                std::cerr << "Error: --trace-rate requires a number" << std::endl;
+                printUsage(argv[0]);
+                exit(1);
+            }
         } else {
             std::cerr << "Error: Unknown argument: " << arg << std::endl;
             printUsage(argv[0]);
@@ -222,6 +499,10 @@ void ServerConfig::printUsage(const char* program_name) {
     std::cout << "  -c, --config FILE       Load configuration from FILE (default: server.conf)" << std::endl;
     std::cout << "  -p, --port PORT         Set server port (overrides config file)" << std::endl;
     std::cout << "  --ip IP                 Set server IP (overrides config file)" << std::endl;
+    std::cout << "  --node-id N             Set node id of this process in the session directory" << std::endl;
+    std::cout << "  --replay FILE           Print the game recorded in a journal / replay FILE and exit" << std::endl;
+    std::cout << "  --takeover              Take over clients and games of the server on hot_restart_socket" << std::endl;
+    std::cout << "  --trace-rate RATE       Trace this fraction (0-1) of requests, dump with SIGUSR2 or GET /trace" << std::endl;
     std::cout << std::endl;
     std::cout << "Default configuration file: server.conf" << std::endl;
 }
@@ -236,7 +517,54 @@ void ServerConfig::printConfig() {
     std::cout << "  Invalid Message Limit: " << invalid_message_limit << std::endl;
     std::cout << "  Log File: " << log_file << std::endl;
     std::cout << "  File Logging Enabled: " << (enable_file_logging ? "Yes" : "No") << std::endl;
-    std::cout << "  Player Timeout: " << player_timeout_seconds << " seconds" << std::endl;
+    std::cout << "  Log Flush Interval: " << log_flush_interval_ms << " ms" << std::endl;
+    std::cout << "  Player Timeout: " << player_timeout_seconds << " seconds, "
+              << (lobby_timeout_seconds > 0 ? lobby_timeout_seconds : player_timeout_seconds) << " in the lobby" << std::endl;
     std::cout << "  Heartbeat Check Interval: " << heartbeat_check_interval << " seconds" << std::endl;
+    std::cout << "  Client Heartbeat: " << heartbeat_interval_ms << " ms in a room, " << heartbeat_lobby_interval_ms
+              << " ms in the lobby, " << heartbeat_turn_interval_ms << " ms on turn" << std::endl;
+    std::cout << "  Reconnect Window: " << reconnect_window_seconds << " seconds" << std::endl;
+    std::cout << "  I/O Mode: " << io_mode << std::endl;
+    std::cout << "  Worker Threads: " << worker_threads << std::endl;
+    if (matchmaking_tick_ms > 0) {
+        std::cout << "  Matchmaking: every " << matchmaking_tick_ms << " ms" << std::endl;
+    } else {
+        std::cout << "  Matchmaking: immediate" << std::endl;
+    }
+    std::cout << "  Outbound High-Water Mark: " << outbound_high_water_bytes << " bytes" << std::endl;
+    std::cout << "  Slow Client Grace: " << slow_client_grace_ms << " ms" << std::endl;
+    std::cout << "  TCP_NODELAY: " << (tcp_nodelay ? "Yes" : "No") << std::endl;
+    std::cout << "  Accept Rate per IP: " << accept_rate_per_ip << "/s (burst " << accept_burst_per_ip << ")" << std::endl;
+    std::cout << "  Client Message Rate: " << client_message_rate << "/s (burst " << client_message_burst
+              << ", disconnect after " << rate_limit_strikes << " rejections)" << std::endl;
+    if (admin_port > 0) {
+        std::cout << "  Metrics Endpoint: " << admin_ip << ":"
+                  << admin_port + (session_directory.empty() ? 0 : node_id) << std::endl;
+    } else {
+        std::cout << "  Metrics Endpoint: disabled" << std::endl;
+    }
+    std::cout << "  SO_REUSEPORT: " << (reuse_port ? "Yes" : "No") << std::endl;
+    if (!session_directory.empty()) {
+        std::cout << "  Session Directory: " << session_directory << " (node " << node_id << ")" << std::endl;
+    } else {
+        std::cout << "  Session Directory: disabled" << std::endl;
+    }
+    if (!journal_dir.empty()) {
+        std::cout << "  Game Journal: " << journal_dir << " (commit every " << journal_flush_ms << " ms"
+                  << (journal_sync ? ", fdatasync" : "") << (journal_keep_finished ? ", keeping replays" : "") << ")" << std::endl;
+    } else {
+        std::cout << "  Game Journal: disabled" << std::endl;
+    }
+    if (!hot_restart_socket.empty()) {
+        std::cout << "  Hot Restart Socket: " << hot_restart_socket << (takeover ? " (taking over)" : "") << std::endl;
+    } else {
+        std::cout << "  Hot Restart Socket: disabled" << std::endl;
+    }
+    if (trace_sample_rate > 0.0) {
+        std::cout << "  Tracing: " << trace_sample_rate * 100.0 << "% sampled, " << trace_buffer_spans
+                  << " spans per thread, SIGUSR2 writes " << trace_file << std::endl;
+    } else {
+        std::cout << "  Tracing: disabled" << std::endl;
+    }
     std::cout << "============================" << std::endl;
 }
\ No newline at end of file
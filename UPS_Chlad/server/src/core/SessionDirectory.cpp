@@ -0,0 +1,407 @@
+// SessionDirectory.cpp - Shared-memory session directory of the nodes on one host
+// KIV/UPS Network Programming Project
+
+#include "SessionDirectory.h"
+#include <atomic>
+#include <new>
+#include <algorithm>
+#include <thread>
+#include <chrono>
+#include <cstring>
+#include <cerrno>
+#include <pthread.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace {
+    constexpr uint32_t DIRECTORY_MAGIC = 0x47534431;     // "GSD1", set last by the creating process
+    constexpr int OPEN_WAIT_MS = 2000;                   // How long to wait for another process to finish creating it
+
+    uint64_t hashName(const char* name, size_t length) {
+        // FNV-1a, names are short and the table size is a power of two
+        uint64_t hash = 0xCBF29CE484222325ULL;
+        for (size_t i = 0; i < length; ++i) {
+            hash ^= static_cast<unsigned char>(name[i]);
+            hash *= 0x100000001B3ULL;
+        }
+        return hash;
+    }
+
+    void copyBounded(char* target, const std::string& value, size_t max_length) {
+        size_t length = std::min(value.size(), max_length);
+        std::memcpy(target, value.data(), length);
+        target[length] = '\0';
+    }
+}
+
+struct SessionDirectory::Header {
+    std::atomic<uint32_t> magic;
+    uint32_t capacity;                      // Entries behind the header, power of two
+    uint32_t used;
+    pthread_mutex_t mutex;                  // Process shared, robust
+    int32_t node_pids[MAX_NODES];           // 0 = node id not registered
+    struct Seat {
+        int32_t node;                       // NO_NODE = free
+        RoomHandle room;
+    } seats[MAX_OPEN_SEATS];
+};
+
+struct SessionDirectory::Entry {
+    uint8_t used;
+    int8_t node;
+    char name[MAX_NAME_LENGTH + 1];
+    char room_id[MAX_ROOM_ID_LENGTH + 1];
+};
+
+SessionDirectory::SessionDirectory() : node_id(NO_NODE), header(nullptr), entries(nullptr), mapped_size(0) {}
+
+SessionDirectory::~SessionDirectory() {
+    close();
+}
+
+bool SessionDirectory::open(const std::string& object_name, int node, std::string& error, size_t capacity) {
+    if (node < 0 || node >= MAX_NODES) {
+        error = "node_id must be between 0 and " + std::to_string(MAX_NODES - 1);
+        return false;
+    }
+    name = (!object_name.empty() && object_name[0] == '/') ? object_name : "/" + object_name;
+    if (name.size() < 2 || name.find('/', 1) != std::string::npos) {
+        error = "invalid shared memory name '" + object_name + "'";
+        return false;
+    }
+
+    size_t table_size = 1;
+    while (table_size < capacity) {
+        table_size <<= 1;
+    }
+
+    // First process creates and initializes the object, the rest wait until its magic is set
+    int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    bool created = fd >= 0;
+    if (!created && errno == EEXIST) {
+        fd = shm_open(name.c_str(), O_RDWR, 0600);
+    }
+    if (fd < 0) {
+        error = "shm_open(" + name + ") failed: " + std::string(strerror(errno));
+        return false;
+    }
+
+    void* memory = MAP_FAILED;
+    if (created) {
+        mapped_size = sizeof(Header) + table_size * sizeof(Entry);
+        if (ftruncate(fd, static_cast<off_t>(mapped_size)) == 0) {
+            memory = mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+        if (memory != MAP_FAILED) {
+            // ftruncate zero-filled everything, entries start unused
+            Header* created_header = new (memory) Header();
+            created_header->capacity = static_cast<uint32_t>(table_size);
+            created_header->used = 0;
+            for (auto& seat : created_header->seats) {
+                seat.node = NO_NODE;
+                seat.room = Handles::INVALID;
+            }
+            pthread_mutexattr_t attributes;
+            pthread_mutexattr_init(&attributes);
+            pthread_mutexattr_setpshared(&attributes, PTHREAD_PROCESS_SHARED);
+            pthread_mutexattr_setrobust(&attributes, PTHREAD_MUTEX_ROBUST);
+            pthread_mutex_init(&created_header->mutex, &attributes);
+            pthread_mutexattr_destroy(&attributes);
+            created_header->magic.store(DIRECTORY_MAGIC, std::memory_order_release);
+        }
+    } else {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(OPEN_WAIT_MS);
+        while (memory == MAP_FAILED && std::chrono::steady_clock::now() < deadline) {
+            struct stat info;
+            if (fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) > sizeof(Header)) {
+                mapped_size = static_cast<size_t>(info.st_size);
+                memory = mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                if (memory != MAP_FAILED &&
+                    static_cast<Header*>(memory)->magic.load(std::memory_order_acquire) != DIRECTORY_MAGIC) {
+                    munmap(memory, mapped_size);
+                    memory = MAP_FAILED;
+                }
+            }
+            if (memory == MAP_FAILED) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+        }
+    }
+    int map_errno = errno;
+    ::close(fd);
+
+    if (memory == MAP_FAILED) {
+        error = created ? "mapping " + name + " failed: " + std::string(strerror(map_errno))
+                        : name + " exists but was never initialized";
+        mapped_size = 0;
+        return false;
+    }
+
+    header = static_cast<Header*>(memory);
+    entries = reinterpret_cast<Entry*>(static_cast<char*>(memory) + sizeof(Header));
+
+    lock();
+    int32_t previous = header->node_pids[node];
+    if (previous != 0 && previous != getpid() && isNodeAlive(node)) {
+        unlock();
+        error = "node id " + std::to_string(node) + " is used by running process " + std::to_string(previous);
+        munmap(header, mapped_size);
+        header = nullptr;
+        entries = nullptr;
+        mapped_size = 0;
+        return false;
+    }
+    node_id = node;
+    header->node_pids[node_id] = 0;     // Leftovers of a previous process with this id are purged with the dead nodes
+    for (int other = 0; other < MAX_NODES; ++other) {
+        if (!isNodeAlive(other)) {
+            purgeNode(other);
+        }
+    }
+    header->node_pids[node_id] = getpid();
+    unlock();
+    return true;
+}
+
+void SessionDirectory::close() {
+    if (!header) {
+        return;
+    }
+    lock();
+    purgeNode(node_id);
+    header->node_pids[node_id] = 0;
+    unlock();
+
+    munmap(header, mapped_size);
+    header = nullptr;
+    entries = nullptr;
+    mapped_size = 0;
+    node_id = NO_NODE;
+}
+
+void SessionDirectory::lock() {
+    int result = pthread_mutex_lock(&header->mutex);
+    if (result == EOWNERDEAD) {
+        // Holder died mid-update, an entry may be half written but the table stays usable
+        pthread_mutex_consistent(&header->mutex);
+    }
+}
+
+void SessionDirectory::unlock() {
+    pthread_mutex_unlock(&header->mutex);
+}
+
+bool SessionDirectory::isNodeAlive(int node) const {
+    if (node < 0 || node >= MAX_NODES) {
+        return false;
+    }
+    pid_t pid = header->node_pids[node];
+    if (pid == 0) {
+        return false;
+    }
+    return kill(pid, 0) == 0 || errno == EPERM;
+}
+
+size_t SessionDirectory::findSlot(const std::string& player_name) const {
+    size_t capacity = header->capacity;
+    size_t mask = capacity - 1;
+    size_t slot = hashName(player_name.data(), player_name.size()) & mask;
+    for (size_t probe = 0; probe < capacity; ++probe) {
+        const Entry& entry = entries[slot];
+        if (!entry.used) {
+            return capacity;
+        }
+        if (player_name == entry.name) {
+            return slot;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return capacity;
+}
+
+void SessionDirectory::eraseSlot(size_t slot) {
+    // Backward shift deletion - later entries of the probe chain move up, so lookups never need tombstones
+    size_t mask = header->capacity - 1;
+    entries[slot].used = 0;
+    header->used--;
+    size_t next = slot;
+    while (true) {
+        next = (next + 1) & mask;
+        Entry& candidate = entries[next];
+        if (!candidate.used) {
+            return;
+        }
+        size_t home = hashName(candidate.name, strlen(candidate.name)) & mask;
+        bool stays = (slot <= next) ? (slot < home && home <= next) : (slot < home || home <= next);
+        if (stays) {
+            continue;
+        }
+        entries[slot] = candidate;
+        candidate.used = 0;
+        slot = next;
+    }
+}
+
+void SessionDirectory::purgeNode(int node) {
+    for (size_t slot = 0; slot < header->capacity; ++slot) {
+        // Shifting may pull another entry of the node into this slot
+        while (entries[slot].used && entries[slot].node == node) {
+            eraseSlot(slot);
+        }
+    }
+    for (auto& seat : header->seats) {
+        if (seat.node == node) {
+            seat.node = NO_NODE;
+        }
+    }
+}
+
+bool SessionDirectory::claim(const std::string& player_name) {
+    if (!header || player_name.empty() || player_name.size() > MAX_NAME_LENGTH) {
+        return false;
+    }
+    lock();
+    bool claimed = false;
+    size_t slot = findSlot(player_name);
+    if (slot < header->capacity) {
+        Entry& entry = entries[slot];
+        if (entry.node == node_id || !isNodeAlive(entry.node)) {
+            entry.node = static_cast<int8_t>(node_id);
+            entry.room_id[0] = '\0';
+            claimed = true;
+        }
+    } else if (header->used < header->capacity / 4 * 3) {
+        // Kept at most 3/4 full so probe chains stay short
+        size_t mask = header->capacity - 1;
+        slot = hashName(player_name.data(), player_name.size()) & mask;
+        while (entries[slot].used) {
+            slot = (slot + 1) & mask;
+        }
+        Entry& entry = entries[slot];
+        entry.used = 1;
+        entry.node = static_cast<int8_t>(node_id);
+        copyBounded(entry.name, player_name, MAX_NAME_LENGTH);
+        entry.room_id[0] = '\0';
+        header->used++;
+        claimed = true;
+    }
+    unlock();
+    return claimed;
+}
+
+void SessionDirectory::release(const std::string& player_name) {
+    if (!header) {
+        return;
+    }
+    lock();
+    size_t slot = findSlot(player_name);
+    if (slot < header->capacity && entries[slot].node == node_id) {
+        eraseSlot(slot);
+    }
+    unlock();
+}
+
+bool SessionDirectory::transfer(const std::string& player_name, int from_node, int to_node) {
+    if (!header || to_node < 0 || to_node >= MAX_NODES) {
+        return false;
+    }
+    lock();
+    bool moved = false;
+    size_t slot = findSlot(player_name);
+    if (slot < header->capacity && entries[slot].node == from_node) {
+        entries[slot].node = static_cast<int8_t>(to_node);
+        moved = true;
+    }
+    unlock();
+    return moved;
+}
+
+int SessionDirectory::findOwner(const std::string& player_name) {
+    if (!header) {
+        return NO_NODE;
+    }
+    lock();
+    int owner = NO_NODE;
+    size_t slot = findSlot(player_name);
+    if (slot < header->capacity && isNodeAlive(entries[slot].node)) {
+        owner = entries[slot].node;
+    }
+    unlock();
+    return owner;
+}
+
+void SessionDirectory::setRoom(const std::string& player_name, const std::string& room_id) {
+    if (!header) {
+        return;
+    }
+    lock();
+    size_t slot = findSlot(player_name);
+    if (slot < header->capacity && entries[slot].node == node_id) {
+        copyBounded(entries[slot].room_id, room_id, MAX_ROOM_ID_LENGTH);
+    }
+    unlock();
+}
+
+void SessionDirectory::offerSeat(RoomHandle room) {
+    if (!header) {
+        return;
+    }
+    lock();
+    Header::Seat* free_seat = nullptr;
+    bool offered = false;
+    for (auto& seat : header->seats) {
+        if (seat.node == node_id && seat.room == room) {
+            offered = true;
+            break;
+        }
+        if (!free_seat && seat.node == NO_NODE) {
+            free_seat = &seat;
+        }
+    }
+    // Best effort - with every seat slot taken the room is only filled by this node's own joins
+    if (!offered && free_seat) {
+        free_seat->node = node_id;
+        free_seat->room = room;
+    }
+    unlock();
+}
+
+void SessionDirectory::withdrawSeat(RoomHandle room) {
+    if (!header) {
+        return;
+    }
+    lock();
+    for (auto& seat : header->seats) {
+        if (seat.node == node_id && seat.room == room) {
+            seat.node = NO_NODE;
+            break;
+        }
+    }
+    unlock();
+}
+
+int SessionDirectory::findSeatNode() {
+    if (!header) {
+        return NO_NODE;
+    }
+    lock();
+    int found = NO_NODE;
+    for (const auto& seat : header->seats) {
+        if (seat.node == node_id) {
+            found = node_id;
+            break;
+        }
+        if (found == NO_NODE && seat.node != NO_NODE && isNodeAlive(seat.node)) {
+            found = seat.node;
+        }
+    }
+    unlock();
+    return found;
+}
+
+size_t SessionDirectory::getCapacity() const {
+    return header ? header->capacity : 0;
+}
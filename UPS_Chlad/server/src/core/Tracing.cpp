@@ -0,0 +1,228 @@
+// Tracing.cpp - Sampled request tracing
+// KIV/UPS Network Programming Project
+
+#include "Tracing.h"
+#include "../game/Random.h"
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+namespace {
+    struct Event {
+        const char* name;
+        const char* detail;
+        uint64_t start_ns;
+        uint64_t duration_ns;
+        uint64_t trace_id;
+        int tid;
+    };
+
+    // Ring of one thread's spans. The owner locks it per sampled span only, so the lock is uncontended but for dumps.
+    struct Buffer {
+        std::mutex mutex;
+        std::vector<Event> events;
+        uint64_t recorded = 0;      // Total ever written, the next slot is recorded % size
+    };
+
+    struct Registry {
+        std::mutex mutex;                               // Guards everything below
+        std::vector<std::unique_ptr<Buffer>> buffers;   // Every buffer ever created, dumps read all of them
+        std::vector<Buffer*> free_buffers;              // Buffers of finished threads, reused by new ones
+        std::map<int, std::string> thread_names;
+        size_t buffer_spans = 65536;
+    };
+
+    Registry& registry() {
+        // Never destroyed, threads detached at shutdown may still record
+        static Registry* instance = new Registry();
+        return *instance;
+    }
+
+    std::atomic<uint64_t> next_trace_id{1};
+
+    int currentTid() {
+        return static_cast<int>(syscall(SYS_gettid));
+    }
+
+    // Lends a buffer to the current thread for its whole lifetime, created on its first sampled span
+    class BufferLease {
+    public:
+        Buffer* buffer;
+        int tid;
+
+        BufferLease() : tid(currentTid()) {
+            Registry& reg = registry();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            if (!reg.free_buffers.empty()) {
+                buffer = reg.free_buffers.back();
+                reg.free_buffers.pop_back();
+            } else {
+                reg.buffers.push_back(std::make_unique<Buffer>());
+                buffer = reg.buffers.back().get();
+                buffer->events.resize(reg.buffer_spans);
+            }
+        }
+
+        ~BufferLease() {
+            Registry& reg = registry();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            reg.free_buffers.push_back(buffer);
+        }
+    };
+
+    BufferLease& localLease() {
+        thread_local BufferLease lease;
+        return lease;
+    }
+
+    // Names are static identifiers, escaping keeps the JSON valid whatever they hold
+    void appendJsonString(std::string& out, const char* text) {
+        out += '"';
+        for (const char* c = text; *c; ++c) {
+            if (*c == '"' || *c == '\\') {
+                out += '\\';
+                out += *c;
+            } else if (static_cast<unsigned char>(*c) < 0x20) {
+                out += ' ';
+            } else {
+                out += *c;
+            }
+        }
+        out += '"';
+    }
+
+    void appendMicroseconds(std::string& out, uint64_t nanoseconds) {
+        char buffer[32];
+        int length = std::snprintf(buffer, sizeof(buffer), "%llu.%03llu",
+                                   static_cast<unsigned long long>(nanoseconds / 1000),
+                                   static_cast<unsigned long long>(nanoseconds % 1000));
+        out.append(buffer, static_cast<size_t>(length));
+    }
+}
+
+namespace Tracing {
+    namespace detail {
+        bool shouldSample() {
+            uint64_t threshold = sample_threshold.load(std::memory_order_relaxed);
+            return threshold == UINT64_MAX || Random::threadGenerator()() < threshold;
+        }
+
+        uint64_t newTraceId() {
+            return next_trace_id.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void record(const char* name, const char* detail, uint64_t start_ns, uint64_t end_ns) {
+            BufferLease& lease = localLease();
+            Buffer& buffer = *lease.buffer;
+            std::lock_guard<std::mutex> lock(buffer.mutex);
+            if (buffer.events.empty()) {
+                return;
+            }
+            Event& event = buffer.events[buffer.recorded % buffer.events.size()];
+            event.name = name;
+            event.detail = detail;
+            event.start_ns = start_ns;
+            event.duration_ns = end_ns > start_ns ? end_ns - start_ns : 0;
+            event.trace_id = trace_id;
+            event.tid = lease.tid;
+            buffer.recorded++;
+        }
+    }
+
+    void configure(double sample_rate, size_t buffer_spans) {
+        uint64_t threshold = 0;
+        if (sample_rate >= 1.0) {
+            threshold = UINT64_MAX;
+        } else if (sample_rate > 0.0) {
+            threshold = std::max<uint64_t>(1, static_cast<uint64_t>(sample_rate * 18446744073709551616.0));
+        }
+        {
+            Registry& reg = registry();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            reg.buffer_spans = buffer_spans;
+        }
+        detail::sample_threshold.store(threshold, std::memory_order_relaxed);
+    }
+
+    void nameThread(const std::string& name) {
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        reg.thread_names[currentTid()] = name;
+    }
+
+    void renderChromeTrace(std::string& out) {
+        std::vector<Event> events;
+        std::map<int, std::string> names;
+        {
+            Registry& reg = registry();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            names = reg.thread_names;
+            for (const auto& buffer : reg.buffers) {
+                std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+                size_t size = buffer->events.size();
+                size_t count = static_cast<size_t>(std::min<uint64_t>(buffer->recorded, size));
+                for (size_t i = 0; i < count; ++i) {
+                    events.push_back(buffer->events[(buffer->recorded - count + i) % size]);
+                }
+            }
+        }
+
+        std::string pid = std::to_string(getpid());
+        out += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        out += "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" + pid + ",\"args\":{\"name\":\"gamba_server\"}}";
+        for (const auto& entry : names) {
+            out += ",{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" + pid + ",\"tid\":" + std::to_string(entry.first)
+                   + ",\"args\":{\"name\":";
+            appendJsonString(out, entry.second.c_str());
+            out += "}}";
+        }
+        for (const Event& event : events) {
+            out += ",{\"name\":";
+            appendJsonString(out, event.name);
+            out += ",\"cat\":\"gamba\",\"ph\":\"X\",\"pid\":" + pid + ",\"tid\":" + std::to_string(event.tid) + ",\"ts\":";
+            appendMicroseconds(out, event.start_ns);
+            out += ",\"dur\":";
+            appendMicroseconds(out, event.duration_ns);
+            out += ",\"args\":{\"trace\":" + std::to_string(event.trace_id);
+            if (event.detail) {
+                out += ",\"detail\":";
+                appendJsonString(out, event.detail);
+            }
+            out += "}}";
+        }
+        out += "]}\n";
+    }
+
+    bool writeChromeTrace(const std::string& path, std::string& error) {
+        std::string json;
+        renderChromeTrace(json);
+
+        // Written aside and renamed, a viewer never opens half a file
+        std::string temporary = path + ".tmp";
+        {
+            std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+            if (!file) {
+                error = "cannot open " + temporary + ": " + std::strerror(errno);
+                return false;
+            }
+            file.write(json.data(), static_cast<std::streamsize>(json.size()));
+            if (!file) {
+                error = "write to " + temporary + " failed";
+                return false;
+            }
+        }
+        if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+            error = "cannot rename " + temporary + ": " + std::strerror(errno);
+            return false;
+        }
+        return true;
+    }
+}
@@ -4,7 +4,6 @@
 
 #include "CardDeck.h"
 #include <algorithm>
-#include <random>
 #include <stdexcept>
 #include <sstream>
 
@@ -14,24 +13,7 @@ int Card::getValue() const {
 }
 
 std::string Card::toString() const {
-    std::string suitStr;
-    switch (suit) {
-        case Suit::HEARTS: suitStr = "H"; break;
-        case Suit::DIAMONDS: suitStr = "D"; break;
-        case Suit::CLUBS: suitStr = "C"; break;
-        case Suit::SPADES: suitStr = "S"; break;
-    }
-
-    std::string rankStr;
-    switch (rank) {
-        case Rank::ACE: rankStr = "A"; break;
-        case Rank::JACK: rankStr = "J"; break;
-        case Rank::QUEEN: rankStr = "Q"; break;
-        case Rank::KING: rankStr = "K"; break;
-        default: rankStr = std::to_string(static_cast<int>(rank)); break;
-    }
-
-    return rankStr + suitStr;
+    return std::string(cardName(id()));
 }
 
 bool Card::isSpecial() const {
@@ -39,41 +21,35 @@ bool Card::isSpecial() const {
 }
 
 // CardDeck methods
-CardDeck::CardDeck() {
-    initializeStandardDeck();
-}
+CardDeck::CardDeck() {}
 
 void CardDeck::initializeStandardDeck() {
     cards.clear();
 
     // TESTING: Generate only 2s and Aces for quick testing
     // for (int suit = 0; suit < 4; ++suit) {
-    //     cards.emplace_back(static_cast<Suit>(suit), Rank::TWO);   // 2 of each suit
-    //     cards.emplace_back(static_cast<Suit>(suit), Rank::ACE);   // Ace of each suit
+    //     cards.push(makeCardId(suit, static_cast<int>(Rank::TWO)));   // 2 of each suit
+    //     cards.push(makeCardId(suit, static_cast<int>(Rank::ACE)));   // Ace of each suit
     // }
     
     // TODO: For full game, uncomment this:
     for (int suit = 0; suit < 4; ++suit) {
         for (int rank = 2; rank <= 13; ++rank) {
-            cards.emplace_back(static_cast<Suit>(suit), static_cast<Rank>(rank));
+            cards.push(makeCardId(suit, rank));
         }
-        cards.emplace_back(static_cast<Suit>(suit), Rank::ACE);
+        cards.push(makeCardId(suit, static_cast<int>(Rank::ACE)));
     }
 }
 
-void CardDeck::shuffle() {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::shuffle(cards.begin(), cards.end(), gen);
+void CardDeck::shuffle(Xoshiro256& generator) {
+    Random::shuffle(cards.begin(), cards.size(), generator);
 }
 
-Card CardDeck::dealCard() {
+CardId CardDeck::dealCard() {
     if (isEmpty()) {
         throw std::runtime_error("Cannot deal from empty deck");
     }
-    Card card = cards.back();
-    cards.pop_back();
-    return card;
+    return cards.pop();
 }
 
 bool CardDeck::isEmpty() const {
@@ -88,6 +64,8 @@ void CardDeck::clear() {
     cards.clear();
 }
 
-void CardDeck::addCards(const std::vector<Card>& cardsToAdd) {
-    cards.insert(cards.end(), cardsToAdd.begin(), cardsToAdd.end());
+void CardDeck::addCards(const CardId* first, const CardId* last) {
+    for (const CardId* it = first; it != last; ++it) {
+        cards.push(*it);
+    }
 }
\ No newline at end of file
@@ -10,9 +10,8 @@
 #include <iostream>
 
 GameLogic::GameLogic()
-    : currentPlayerIndex(0), gameState(GameState::WAITING_FOR_PLAYERS),
-      clockwise(true), mustPlaySevenOrLower(false) {
-}
+    : playerCount(0), currentPlayerIndex(0), gameState(GameState::WAITING_FOR_PLAYERS),
+      clockwise(true), mustPlaySevenOrLower(false), seed(0) {}
 
 bool GameLogic::addPlayer(const std::string& playerId) {
     if (gameState != GameState::WAITING_FOR_PLAYERS) {
@@ -23,8 +22,11 @@ bool GameLogic::addPlayer(const std::string& playerId) {
         return false; // Player already in game
     }
 
-    players.emplace_back(playerId);
-    playerIndexMap[playerId] = players.size() - 1;
+    if (playerCount == MAX_SEATS) {
+        return false;
+    }
+
+    players[playerCount++] = PlayerHand(playerId);
     return true;
 }
 
@@ -33,26 +35,22 @@ bool GameLogic::removePlayer(const std::string& playerId) {
         return false; // Cannot remove during active game
     }
 
-    auto it = playerIndexMap.find(playerId);
-    if (it == playerIndexMap.end()) {
+    size_t index = getPlayerIndex(playerId);
+    if (index >= playerCount) {
         return false;
     }
 
-    size_t index = it->second;
-    players.erase(players.begin() + index);
-    playerIndexMap.erase(it);
-
-    // Rebuild index map
-    playerIndexMap.clear();
-    for (size_t i = 0; i < players.size(); ++i) {
-        playerIndexMap[players[i].playerId] = i;
-    }
-
+    std::move(players.begin() + index + 1, players.begin() + playerCount, players.begin() + index);
+    players[--playerCount] = PlayerHand();
     return true;
 }
 
 void GameLogic::startGame() {
-    if (players.size() < 2) {
+    startGame(Random::newSeed());
+}
+
+void GameLogic::startGame(uint64_t gameSeed) {
+    if (playerCount < 2) {
         throw std::runtime_error("Need at least 2 players to start game");
     }
 
@@ -60,10 +58,12 @@ void GameLogic::startGame() {
     currentPlayerIndex = 0;
     clockwise = true;
     mustPlaySevenOrLower = false;
+    seed = gameSeed;
+    generator.reseed(seed);
 
     // Initialize deck and shuffle
     deck.initializeStandardDeck();
-    deck.shuffle();
+    deck.shuffle(generator);
 
     // Clear discard pile
     discardPile.clear();
@@ -73,71 +73,70 @@ void GameLogic::startGame() {
 
 void GameLogic::dealInitialCards() {
     // Deal 6 cards to each player (3 reserves + 3 hand)
-    for (auto& player : players) {
+    for (size_t seat = 0; seat < playerCount; ++seat) {
+        PlayerHand& player = players[seat];
         player.hand.clear();
         player.reserves.clear();
 
         // Deal 3 reserve cards (face down)
-        for (int i = 0; i < 3; ++i) {
+        for (size_t i = 0; i < RESERVE_COUNT; ++i) {
             if (!deck.isEmpty()) {
-                player.reserves.push_back(deck.dealCard());
+                player.reserves.push(deck.dealCard());
             }
         }
 
         // Deal 3 hand cards
         for (int i = 0; i < 3; ++i) {
             if (!deck.isEmpty()) {
-                player.hand.push_back(deck.dealCard());
+                player.hand.insert(deck.dealCard());
             }
         }
     }
 
     // Place first card on discard pile
     if (!deck.isEmpty()) {
-        discardPile.push_back(deck.dealCard());
+        discardPile.push(deck.dealCard());
     }
 }
 
 void GameLogic::drawCardsToHand(const std::string& playerId) {
-    size_t playerIndex = getPlayerIndex(playerId);
-    if (playerIndex >= players.size()) return;
+    drawCardsToSeat(getPlayerIndex(playerId));
+}
+
+void GameLogic::drawCardsToSeat(size_t seat) {
+    if (seat >= playerCount) return;
 
-    PlayerHand& player = players[playerIndex];
+    PlayerHand& player = players[seat];
 
     // Draw cards to maintain 3 in hand (if deck has cards)
     while (player.hand.size() < 3 && !deck.isEmpty()) {
-        player.hand.push_back(deck.dealCard());
+        player.hand.insert(deck.dealCard());
     }
     
     // Note: If deck is empty, player just doesn't draw
     // They continue playing with whatever cards they have
 }
 
-bool GameLogic::playCards(const std::string& playerId, const std::vector<Card>& cardsToPlay) {
-    if (!isPlayerTurn(playerId) || cardsToPlay.empty()) {
+bool GameLogic::playCards(const std::string& playerId, CardSet cardsToPlay) {
+    return playCardsAt(getPlayerIndex(playerId), cardsToPlay);
+}
+
+bool GameLogic::playCardsAt(size_t seat, CardSet cardsToPlay) {
+    if (!isSeatTurn(seat) || cardsToPlay.empty()) {
         return false;
     }
 
-    size_t playerIndex = getPlayerIndex(playerId);
-    if (playerIndex >= players.size()) return false;
-
-    PlayerHand& player = players[playerIndex];
+    PlayerHand& player = players[seat];
 
     // Validate cards are in player's hand
-    for (const Card& card : cardsToPlay) {
-        auto it = std::find_if(player.hand.begin(), player.hand.end(),
-            [&card](const Card& handCard) {
-                return handCard.suit == card.suit && handCard.rank == card.rank;
-            });
-        if (it == player.hand.end()) {
-            return false; // Card not in hand
-        }
+    if (!player.hand.containsAll(cardsToPlay)) {
+        return false; // Card not in hand
     }
 
     // Validate play using GameRules
     // IMPORTANT: If discard pile is empty (after pickup), any card is valid
     if (!discardPile.empty()) {
-        Card topCard = getTopDiscardCard();
+        CardId topCard = getTopDiscardCard();
         if (!GameRules::isValidPlay(cardsToPlay, topCard, mustPlaySevenOrLower)) {
             return false;
         }
@@ -145,28 +144,20 @@ bool GameLogic::playCards(const std::string& playerId, const std::vector<Card>&
     // If pile is empty, skip validation - any card is valid
 
     // Remove cards from hand
-    for (const Card& card : cardsToPlay) {
-        auto it = std::find_if(player.hand.begin(), player.hand.end(),
-            [&card](const Card& handCard) {
-                return handCard.suit == card.suit && handCard.rank == card.rank;
-            });
-        if (it != player.hand.end()) {
-            player.hand.erase(it);
-        }
-    }
+    player.hand.eraseAll(cardsToPlay);
     // Add cards to discard pile
-    for (const Card& card : cardsToPlay) {
-        discardPile.push_back(card);
-    }
+    cardsToPlay.forEach([this](CardId card) {
+        discardPile.push(card);
+    });
 
     // Handle special card effects
     GameRules::applySpecialCardEffects(cardsToPlay, discardPile, clockwise, mustPlaySevenOrLower);
 
     // Draw cards back to 3 (if deck has cards)
-    drawCardsToHand(playerId);
+    drawCardsToSeat(seat);
 
     // Check for win condition
-    if (hasPlayerWon(playerId)) {
+    if (hasSeatWon(seat)) {
         gameState = GameState::GAME_FINISHED;
         return true;
     }
@@ -176,17 +167,18 @@ bool GameLogic::playCards(const std::string& playerId, const std::vector<Card>&
 }
 
 bool GameLogic::pickupDiscardPile(const std::string& playerId) {
-    if (!isPlayerTurn(playerId) || discardPile.empty()) {
+    return pickupDiscardPileAt(getPlayerIndex(playerId));
+}
+
+bool GameLogic::pickupDiscardPileAt(size_t seat) {
+    if (!isSeatTurn(seat) || discardPile.empty()) {
         return false;
     }
 
-    size_t playerIndex = getPlayerIndex(playerId);
-    if (playerIndex >= players.size()) return false;
-
-    PlayerHand& player = players[playerIndex];
+    PlayerHand& player = players[seat];
 
     // Add all discard pile cards to player's hand
-    player.hand.insert(player.hand.end(), discardPile.begin(), discardPile.end());
+    player.hand.insertAll(discardPile.toSet());
     discardPile.clear();
 
     // Reset special states
@@ -196,54 +188,156 @@ bool GameLogic::pickupDiscardPile(const std::string& playerId) {
     return true;
 }
 
+CardSet GameLogic::legalMoves(const std::string& playerId) const {
+    return legalMovesAt(getPlayerIndex(playerId));
+}
+
+CardSet GameLogic::legalMovesAt(size_t seat) const {
+    if (!isSeatTurn(seat)) {
+        return {};
+    }
+
+    CardSet legal = discardPile.empty()
+        ? GameRules::legalCardsOnEmptyPile()
+        : GameRules::legalCards(getTopDiscardCard(), mustPlaySevenOrLower);
+    return players[seat].hand & legal;
+}
+
 void GameLogic::nextTurn() {
     moveToNextValidPlayer();
 }
 
 void GameLogic::moveToNextValidPlayer() {
-    if (players.empty()) return;
+    if (playerCount == 0) return;
 
     if (clockwise) {
-        currentPlayerIndex = (currentPlayerIndex + 1) % players.size();
+        currentPlayerIndex = (currentPlayerIndex + 1) % playerCount;
     } else {
-        currentPlayerIndex = (currentPlayerIndex == 0) ? players.size() - 1 : currentPlayerIndex - 1;
+        currentPlayerIndex = (currentPlayerIndex == 0) ? playerCount - 1 : currentPlayerIndex - 1;
     }
 }
 
 bool GameLogic::isPlayerTurn(const std::string& playerId) const {
     if (gameState != GameState::GAME_STARTED) return false;
-    if (currentPlayerIndex >= players.size()) return false;
+    if (currentPlayerIndex >= playerCount) return false;
     return players[currentPlayerIndex].playerId == playerId;
 }
 
+bool GameLogic::isSeatTurn(size_t seat) const {
+    return gameState == GameState::GAME_STARTED && seat < playerCount && seat == currentPlayerIndex;
+}
+
 bool GameLogic::hasPlayerWon(const std::string& playerId) const {
-    size_t playerIndex = getPlayerIndex(playerId);
-    if (playerIndex >= players.size()) return false;
+    return hasSeatWon(getPlayerIndex(playerId));
+}
+
+bool GameLogic::hasSeatWon(size_t seat) const {
+    if (seat >= playerCount) return false;
 
-    const PlayerHand& player = players[playerIndex];
+    const PlayerHand& player = players[seat];
     return player.hand.empty() && player.reserves.empty();
 }
 
 std::string GameLogic::getWinner() const {
-    if (gameState != GameState::GAME_FINISHED) return "";
+    size_t seat = getWinnerSeat();
+    return seat == NO_SEAT ? "" : players[seat].playerId;
+}
+
+size_t GameLogic::getWinnerSeat() const {
+    if (gameState != GameState::GAME_FINISHED) return NO_SEAT;
 
-    for (const auto& player : players) {
-        if (player.hand.empty() && player.reserves.empty()) {
-            return player.playerId;
+    for (size_t seat = 0; seat < playerCount; ++seat) {
+        if (hasSeatWon(seat)) {
+            return seat;
         }
     }
-    return "";
+    return NO_SEAT;
+}
+
+size_t GameLogic::getCurrentSeat() const {
+    return gameState == GameState::GAME_STARTED && currentPlayerIndex < playerCount ? currentPlayerIndex : NO_SEAT;
 }
 
 void GameLogic::resetGame() {
     gameState = GameState::WAITING_FOR_PLAYERS;
-    players.clear();
-    playerIndexMap.clear();
+    for (size_t seat = 0; seat < playerCount; ++seat) {
+        players[seat] = PlayerHand();
+    }
+    playerCount = 0;
     discardPile.clear();
     currentPlayerIndex = 0;
     clockwise = true;
     mustPlaySevenOrLower = false;
-    deck.initializeStandardDeck();
+    deck.clear();   // Refilled by startGame
+}
+
+GameSnapshot GameLogic::saveSnapshot() const {
+    GameSnapshot snapshot;
+    snapshot.deck.assign(deck.getCards().begin(), deck.getCards().end());
+    snapshot.discardPile.assign(discardPile.begin(), discardPile.end());
+    snapshot.seats.reserve(playerCount);
+    for (size_t seat = 0; seat < playerCount; ++seat) {
+        const PlayerHand& player = players[seat];
+        snapshot.seats.push_back({player.playerId, player.hand,
+                                  std::vector<CardId>(player.reserves.begin(), player.reserves.end())});
+    }
+    snapshot.currentPlayerIndex = currentPlayerIndex;
+    snapshot.gameState = gameState;
+    snapshot.clockwise = clockwise;
+    snapshot.mustPlaySevenOrLower = mustPlaySevenOrLower;
+    snapshot.seed = seed;
+    snapshot.generator = generator.getState();
+    return snapshot;
+}
+
+bool GameLogic::restoreSnapshot(const GameSnapshot& snapshot) {
+    // Every card may be in one place only, and stacks must fit
+    CardSet seen;
+    auto claim = [&seen](CardId id) {
+        if (id >= DECK_SIZE || seen.contains(id)) {
+            return false;
+        }
+        seen.insert(id);
+        return true;
+    };
+    bool valid = snapshot.deck.size() <= static_cast<size_t>(DECK_SIZE) && snapshot.seats.size() <= MAX_SEATS &&
+                 (snapshot.seats.empty() || snapshot.currentPlayerIndex < snapshot.seats.size()) &&
+                 std::all_of(snapshot.deck.begin(), snapshot.deck.end(), claim) &&
+                 std::all_of(snapshot.discardPile.begin(), snapshot.discardPile.end(), claim);
+    for (const GameSnapshot::Seat& seat : snapshot.seats) {
+        valid = valid && seat.reserves.size() <= RESERVE_COUNT && (seat.hand.mask() >> DECK_SIZE) == 0 &&
+                (seen & seat.hand).empty() && std::all_of(seat.reserves.begin(), seat.reserves.end(), claim);
+        seen.insertAll(seat.hand);
+    }
+    if (!valid) {
+        return false;
+    }
+
+    deck.clear();
+    deck.addCards(snapshot.deck.data(), snapshot.deck.data() + snapshot.deck.size());
+    discardPile.clear();
+    for (CardId id : snapshot.discardPile) {
+        discardPile.push(id);
+    }
+    for (size_t seat = 0; seat < playerCount; ++seat) {
+        players[seat] = PlayerHand();
+    }
+    playerCount = 0;
+    for (const GameSnapshot::Seat& seat : snapshot.seats) {
+        PlayerHand& player = players[playerCount++];
+        player.playerId = seat.playerId;
+        player.hand = seat.hand;
+        for (CardId id : seat.reserves) {
+            player.reserves.push(id);
+        }
+    }
+    currentPlayerIndex = snapshot.currentPlayerIndex;
+    gameState = snapshot.gameState;
+    clockwise = snapshot.clockwise;
+    mustPlaySevenOrLower = snapshot.mustPlaySevenOrLower;
+    seed = snapshot.seed;
+    generator.setState(snapshot.generator);
+    return true;
 }
 
 // Getters
@@ -252,47 +346,51 @@ GameState GameLogic::getGameState() const {
 }
 
 std::string GameLogic::getCurrentPlayer() const {
-    if (currentPlayerIndex >= players.size()) return "";
+    if (currentPlayerIndex >= playerCount) return "";
     return players[currentPlayerIndex].playerId;
 }
 
 size_t GameLogic::getPlayerCount() const {
-    return players.size();
+    return playerCount;
 }
 
 bool GameLogic::isPlayerInGame(const std::string& playerId) const {
-    return playerIndexMap.find(playerId) != playerIndexMap.end();
+    return getPlayerIndex(playerId) < playerCount;
 }
 
-std::vector<Card> GameLogic::getPlayerHand(const std::string& playerId) const {
+CardSet GameLogic::getPlayerHand(const std::string& playerId) const {
     size_t playerIndex = getPlayerIndex(playerId);
-    if (playerIndex >= players.size()) return {};
+    if (playerIndex >= playerCount) return {};
     return players[playerIndex].hand;
 }
 
-std::vector<Card> GameLogic::getPlayerReserves(const std::string& playerId) const {
+CardSet GameLogic::getPlayerReserves(const std::string& playerId) const {
     size_t playerIndex = getPlayerIndex(playerId);
-    if (playerIndex >= players.size()) return {};
-    return players[playerIndex].reserves;
+    if (playerIndex >= playerCount) return {};
+    return players[playerIndex].reserves.toSet();
 }
 
 size_t GameLogic::getPlayerHandSize(const std::string& playerId) const {
     size_t playerIndex = getPlayerIndex(playerId);
-    if (playerIndex >= players.size()) return 0;
+    if (playerIndex >= playerCount) return 0;
     return players[playerIndex].hand.size();
 }
 
 size_t GameLogic::getPlayerReserveSize(const std::string& playerId) const {
     size_t playerIndex = getPlayerIndex(playerId);
-    if (playerIndex >= players.size()) return 0;
+    if (playerIndex >= playerCount) return 0;
     return players[playerIndex].reserves.size();
 }
 
-std::vector<Card> GameLogic::getDiscardPile() const {
+const CardStack<DECK_SIZE>& GameLogic::getDiscardPile() const {
     return discardPile;
 }
 
-Card GameLogic::getTopDiscardCard() const {
+size_t GameLogic::getDiscardPileSize() const {
+    return discardPile.size();
+}
+
+CardId GameLogic::getTopDiscardCard() const {
     if (discardPile.empty()) {
         throw std::runtime_error("Discard pile is empty");
     }
@@ -303,43 +401,63 @@ size_t GameLogic::getDeckSize() const {
     return deck.size();
 }
 
+CardSet GameLogic::getHandAt(size_t seat) const {
+    return seat < playerCount ? players[seat].hand : CardSet();
+}
+
+size_t GameLogic::getReserveSizeAt(size_t seat) const {
+    return seat < playerCount ? players[seat].reserves.size() : 0;
+}
+
+bool GameLogic::isClockwise() const {
+    return clockwise;
+}
+
 bool GameLogic::getMustPlaySevenOrLower() const {
     return mustPlaySevenOrLower;
 }
 
+uint64_t GameLogic::getSeed() const {
+    return seed;
+}
+
 void GameLogic::shuffleDiscardPileIntoDeck() {
     recycleDiscardPile();
 }
 
 // Private methods
 size_t GameLogic::getPlayerIndex(const std::string& playerId) const {
-    auto it = playerIndexMap.find(playerId);
-    return (it != playerIndexMap.end()) ? it->second : SIZE_MAX;
+    for (size_t i = 0; i < playerCount; ++i) {
+        if (players[i].playerId == playerId) {
+            return i;
+        }
+    }
+    return SIZE_MAX;
 }
 
 void GameLogic::recycleDiscardPile() {
     if (discardPile.size() <= 1) return;
 
     // Keep the top card, shuffle the rest back into deck
-    Card topCard = discardPile.back();
-    discardPile.pop_back();
+    CardId topCard = discardPile.pop();
 
-    deck.addCards(discardPile);
-    deck.shuffle();
+    deck.addCards(discardPile.begin(), discardPile.end());
+    deck.shuffle(generator);
 
     discardPile.clear();
-    discardPile.push_back(topCard);
+    discardPile.push(topCard);
 }
 
 bool GameLogic::playFromReserve(const std::string& playerId) {
-    if (!isPlayerTurn(playerId)) {
+    return playFromReserveAt(getPlayerIndex(playerId));
+}
+
+bool GameLogic::playFromReserveAt(size_t seat) {
+    if (!isSeatTurn(seat)) {
         return false;
     }
 
-    size_t playerIndex = getPlayerIndex(playerId);
-    if (playerIndex >= players.size()) return false;
-
-    PlayerHand& player = players[playerIndex];
+    PlayerHand& player = players[seat];
 
     // Check if player can play from reserves
     if (!player.hand.empty()) {
@@ -351,31 +469,28 @@ bool GameLogic::playFromReserve(const std::string& playerId) {
     }
 
     // Randomly select one reserve card (take from back - "blind" selection)
-    Card reserve_card = player.reserves.back();
-    player.reserves.pop_back();
+    CardId reserve_card = player.reserves.pop();
 
     // Check if reserve card is valid
     // IMPORTANT: If discard pile is empty (after pickup), any card is valid
     bool isValid = false;
-    std::vector<Card> singleCard;
+    CardSet singleCard = CardSet::of(reserve_card);
     if (discardPile.empty()) {
-        singleCard = {reserve_card};
         isValid = true;  // Any card is valid when pile is empty
     } else {
-        Card topCard = getTopDiscardCard();
-        singleCard = {reserve_card};
+        CardId topCard = getTopDiscardCard();
         isValid = GameRules::isValidPlay(singleCard, topCard, mustPlaySevenOrLower);
     }
 
     if (isValid) {
         // Valid - play the reserve card
-        discardPile.push_back(reserve_card);
+        discardPile.push(reserve_card);
 
         // Apply special effects if it's a special card
         GameRules::applySpecialCardEffects(singleCard, discardPile, clockwise, mustPlaySevenOrLower);
 
         // Check for win condition
-        if (hasPlayerWon(playerId)) {
+        if (hasSeatWon(seat)) {
             gameState = GameState::GAME_FINISHED;
             return true;
         }
@@ -384,8 +499,8 @@ bool GameLogic::playFromReserve(const std::string& playerId) {
         return true;
     } else {
         // Invalid - player picks up entire pile + the invalid reserve card
-        player.hand.push_back(reserve_card);  // Add reserve to hand
-        player.hand.insert(player.hand.end(), discardPile.begin(), discardPile.end());  // Add pile
+        player.hand.insert(reserve_card);  // Add reserve to hand
+        player.hand.insertAll(discardPile.toSet());  // Add pile
         discardPile.clear();
         mustPlaySevenOrLower = false;  // Reset special state
 
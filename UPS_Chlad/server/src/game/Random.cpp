@@ -0,0 +1,13 @@
+// Random.cpp - xoshiro256** random generator
+// KIV/UPS Network Programming Project
+
+#include "Random.h"
+#include <random>
+
+Xoshiro256& Random::threadGenerator() {
+    thread_local Xoshiro256 generator([] {
+        std::random_device device;
+        return (static_cast<uint64_t>(device()) << 32) ^ device();
+    }());
+    return generator;
+}
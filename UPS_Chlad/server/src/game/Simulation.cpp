@@ -0,0 +1,310 @@
+// Simulation.cpp - Headless game simulation
+// KIV/UPS Network Programming Project
+
+#include "Simulation.h"
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+    constexpr uint64_t CHUNK_GAMES = 4096;                      // Unit of work a thread takes or steals
+    constexpr uint64_t POLICY_STREAM = 0xA5A5A5A55A5A5A5AULL;  // Policies draw from another stream than the deal
+
+    const CardSet SPECIAL_RANKS = CardSet::ofRank(static_cast<int>(Rank::TWO)) |
+                                  CardSet::ofRank(static_cast<int>(Rank::TEN));
+
+    // Every legal card of the rank of card
+    CardSet rankOf(CardSet legal, CardId card) {
+        return legal & CardSet::ofRank(cardRank(card));
+    }
+
+    // Nothing to choose: empty hand goes to the reserves, no legal card means the pile
+    bool forcedAction(CardSet legal, const GameLogic& game, size_t seat, BotAction& action) {
+        if (game.getHandAt(seat).empty()) {
+            action = BotAction::reserve();
+            return true;
+        }
+        if (legal.empty()) {
+            action = BotAction::pickup();
+            return true;
+        }
+        return false;
+    }
+
+    class RandomPolicy : public BotPolicy {
+    public:
+        BotAction chooseAction(const GameLogic& game, size_t seat, Xoshiro256& random) override {
+            CardSet legal = game.legalMovesAt(seat);
+            BotAction action;
+            if (forcedAction(legal, game, seat, action)) {
+                return action;
+            }
+
+            // n-th legal card, so a rank held twice is twice as likely
+            uint64_t skip = random.below(legal.size());
+            uint64_t rest = legal.mask();
+            for (; skip > 0; --skip) {
+                rest &= rest - 1;
+            }
+            return BotAction::play(rankOf(legal, static_cast<CardId>(__builtin_ctzll(rest))));
+        }
+    };
+
+    class LowestPolicy : public BotPolicy {
+    public:
+        BotAction chooseAction(const GameLogic& game, size_t seat, Xoshiro256& /* random */) override {
+            CardSet legal = game.legalMovesAt(seat);
+            BotAction action;
+            if (forcedAction(legal, game, seat, action)) {
+                return action;
+            }
+            return BotAction::play(rankOf(legal, legal.lowest()));
+        }
+    };
+
+    class SaverPolicy : public BotPolicy {
+    public:
+        BotAction chooseAction(const GameLogic& game, size_t seat, Xoshiro256& /* random */) override {
+            CardSet legal = game.legalMovesAt(seat);
+            BotAction action;
+            if (forcedAction(legal, game, seat, action)) {
+                return action;
+            }
+            CardSet ordinary(legal.mask() & ~SPECIAL_RANKS.mask());
+            CardSet from = ordinary.empty() ? legal : ordinary;
+            return BotAction::play(rankOf(from, from.lowest()));
+        }
+    };
+
+    template <typename Policy>
+    PolicyFactory factoryOf() {
+        return [] { return std::make_unique<Policy>(); };
+    }
+
+    /*
+    * Applies action for seat, counting pickups.
+    * @return false if GameLogic rejected it (the game is unchanged then)
+    */
+    bool applyAction(GameLogic& game, size_t seat, const BotAction& action, SimulationStats& stats) {
+        switch (action.kind) {
+            case BotAction::Kind::PLAY_CARDS:
+                return game.playCardsAt(seat, action.cards);
+            case BotAction::Kind::PICKUP:
+                if (!game.pickupDiscardPileAt(seat)) {
+                    return false;
+                }
+                stats.pickups++;
+                return true;
+            case BotAction::Kind::PLAY_RESERVE:
+                if (!game.playFromReserveAt(seat)) {
+                    return false;
+                }
+                stats.reserve_plays++;
+                if (!game.getHandAt(seat).empty()) {    // Card did not fit, pile went to the hand with it
+                    stats.failed_reserve_plays++;
+                    stats.pickups++;
+                }
+                return true;
+        }
+        return false;
+    }
+
+    // Always accepted: pile if there is one, else the reserves or any card (everything fits an empty pile)
+    BotAction fallbackAction(const GameLogic& game, size_t seat) {
+        if (game.getDiscardPileSize() > 0) {
+            return BotAction::pickup();
+        }
+        CardSet hand = game.getHandAt(seat);
+        return hand.empty() ? BotAction::reserve() : BotAction::play(rankOf(hand, hand.lowest()));
+    }
+
+    struct ChunkQueue {
+        std::mutex mutex;
+        std::deque<std::pair<uint64_t, uint64_t>> chunks;     // [first, last) game indexes
+    };
+
+    /*
+    * Own chunks are taken from the back, stolen ones from the front, so owner and thief rarely want the same one.
+    * No chunk is ever added, so every queue being empty means the run is over.
+    */
+    bool takeChunk(std::vector<ChunkQueue>& queues, size_t self, std::pair<uint64_t, uint64_t>& chunk) {
+        {
+            std::lock_guard<std::mutex> lock(queues[self].mutex);
+            if (!queues[self].chunks.empty()) {
+                chunk = queues[self].chunks.back();
+                queues[self].chunks.pop_back();
+                return true;
+            }
+        }
+        for (size_t offset = 1; offset < queues.size(); ++offset) {
+            ChunkQueue& victim = queues[(self + offset) % queues.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.chunks.empty()) {
+                chunk = victim.chunks.front();
+                victim.chunks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void runWorker(const SimulationConfig& config, std::vector<ChunkQueue>& queues, size_t self,
+                   SimulationStats& result) {
+        SimulationStats stats;      // Local until the end, neighbouring results share cache lines
+        std::vector<std::unique_ptr<BotPolicy>> owned;
+        std::vector<BotPolicy*> policies;
+        GameLogic game;
+        for (size_t seat = 0; seat < config.seats.size(); ++seat) {
+            owned.push_back(config.seats[seat]());
+            policies.push_back(owned.back().get());
+            game.addPlayer("seat" + std::to_string(seat));
+        }
+
+        std::pair<uint64_t, uint64_t> chunk;
+        while (takeChunk(queues, self, chunk)) {
+            for (uint64_t index = chunk.first; index < chunk.second; ++index) {
+                Simulation::playGame(game, policies.data(), Simulation::gameSeed(config.seed, index),
+                                     config.max_turns, stats);
+            }
+        }
+        result = stats;
+    }
+}
+
+namespace BotPolicies {
+    PolicyFactory byName(const std::string& name) {
+        if (name == "random") return factoryOf<RandomPolicy>();
+        if (name == "lowest") return factoryOf<LowestPolicy>();
+        if (name == "saver") return factoryOf<SaverPolicy>();
+        return nullptr;
+    }
+
+    std::vector<std::string> names() {
+        return {"random", "lowest", "saver"};
+    }
+}
+
+void SimulationStats::merge(const SimulationStats& other) {
+    games += other.games;
+    finished += other.finished;
+    stalled += other.stalled;
+    turns += other.turns;
+    shortest_game = std::min(shortest_game, other.shortest_game);
+    longest_game = std::max(longest_game, other.longest_game);
+    for (size_t i = 0; i < LENGTH_BUCKETS; ++i) {
+        length_histogram[i] += other.length_histogram[i];
+    }
+    pickups += other.pickups;
+    reserve_plays += other.reserve_plays;
+    failed_reserve_plays += other.failed_reserve_plays;
+    rejected_moves += other.rejected_moves;
+    deck_ran_dry += other.deck_ran_dry;
+    turns_after_dry += other.turns_after_dry;
+    for (size_t i = 0; i < MAX_SEATS; ++i) {
+        wins_by_seat[i] += other.wins_by_seat[i];
+    }
+}
+
+uint64_t SimulationStats::lengthPercentile(double fraction) const {
+    if (finished == 0) {
+        return 0;
+    }
+    uint64_t target = static_cast<uint64_t>(fraction * static_cast<double>(finished));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < LENGTH_BUCKETS; ++i) {
+        seen += length_histogram[i];
+        if (seen > target) {
+            return (i + 1) * LENGTH_BUCKET_TURNS - 1;   // Upper end of the bucket
+        }
+    }
+    return longest_game;
+}
+
+uint64_t Simulation::gameSeed(uint64_t seed, uint64_t index) {
+    // splitmix64 finalizer, neighbouring indexes give unrelated seeds
+    uint64_t z = seed + (index + 1) * 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+void Simulation::playGame(GameLogic& game, BotPolicy* const* policies, uint64_t game_seed, size_t max_turns,
+                          SimulationStats& stats) {
+    game.startGame(game_seed);
+    Xoshiro256 random(game_seed ^ POLICY_STREAM);
+
+    uint64_t turn = 0;
+    uint64_t dry_since = UINT64_MAX;
+    while (game.getGameState() == GameState::GAME_STARTED && turn < max_turns) {
+        size_t seat = game.getCurrentSeat();
+        BotAction action = policies[seat]->chooseAction(game, seat, random);
+        if (!applyAction(game, seat, action, stats)) {
+            stats.rejected_moves++;
+            applyAction(game, seat, fallbackAction(game, seat), stats);
+        }
+        ++turn;
+        if (dry_since == UINT64_MAX && game.getDeckSize() == 0) {
+            dry_since = turn;
+        }
+    }
+
+    stats.games++;
+    if (dry_since != UINT64_MAX) {
+        stats.deck_ran_dry++;
+        stats.turns_after_dry += turn - dry_since;
+    }
+    if (game.getGameState() != GameState::GAME_FINISHED) {
+        stats.stalled++;
+        return;
+    }
+
+    stats.finished++;
+    stats.turns += turn;
+    stats.shortest_game = std::min(stats.shortest_game, turn);
+    stats.longest_game = std::max(stats.longest_game, turn);
+    size_t bucket = std::min<size_t>(turn / SimulationStats::LENGTH_BUCKET_TURNS, SimulationStats::LENGTH_BUCKETS - 1);
+    stats.length_histogram[bucket]++;
+    size_t winner = game.getWinnerSeat();
+    if (winner < MAX_SEATS) {
+        stats.wins_by_seat[winner]++;
+    }
+}
+
+SimulationStats Simulation::run(const SimulationConfig& config) {
+    if (config.seats.size() < 2 || config.seats.size() > MAX_SEATS) {
+        throw std::invalid_argument("Simulation needs 2 to " + std::to_string(MAX_SEATS) + " seats");
+    }
+
+    auto started = std::chrono::steady_clock::now();
+    uint64_t chunk_count = (config.games + CHUNK_GAMES - 1) / CHUNK_GAMES;
+    size_t threads = config.threads > 0 ? config.threads : std::max(1u, std::thread::hardware_concurrency());
+    threads = static_cast<size_t>(std::max<uint64_t>(1, std::min<uint64_t>(threads, chunk_count)));
+
+    // Chunks are dealt round-robin, stealing evens out whatever the deal did not
+    std::vector<ChunkQueue> queues(threads);
+    for (uint64_t chunk = 0; chunk < chunk_count; ++chunk) {
+        uint64_t first = chunk * CHUNK_GAMES;
+        queues[chunk % threads].chunks.emplace_back(first, std::min(first + CHUNK_GAMES, config.games));
+    }
+
+    std::vector<SimulationStats> results(threads);
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for (size_t i = 1; i < threads; ++i) {
+        workers.emplace_back(runWorker, std::cref(config), std::ref(queues), i, std::ref(results[i]));
+    }
+    runWorker(config, queues, 0, results[0]);
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    SimulationStats total;
+    for (const SimulationStats& result : results) {
+        total.merge(result);
+    }
+    total.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    return total;
+}
@@ -12,9 +12,14 @@
 #include "core/RoomManager.h"
 #include "core/GameManager.h"
 #include "core/server_config.h"
+#include "core/SessionDirectory.h"
+#include "core/GameJournal.h"
+#include "core/Matchmaker.h"
+#include "core/Tracing.h"
 #include "network/MessageHandler.h"
 #include "network/MessageValidator.h"
 #include "network/NetworkManager.h"
+#include "network/AdminServer.h"
 #include "protocol/ProtocolMessage.h"
 #include "protocol/ProtocolHelper.h"
 #include <csignal>
@@ -28,6 +33,13 @@ void signalHandler(int signal) {
     server_running.store(false);
 }
 
+// Set by SIGUSR2, the main loop writes the trace buffers out (no file I/O in the handler)
+std::atomic<bool> trace_dump_requested(false);
+
+void traceDumpHandler(int /* signal */) {
+    trace_dump_requested.store(true);
+}
+
 int main(int argc, char* argv[]) {
     ServerConfig config;
 
@@ -48,26 +60,85 @@ int main(int argc, char* argv[]) {
     // Parse command line arguments (can override config file values or load custom config)
     config.parseCommandLine(argc, argv);
 
+    // Offline replay of one recorded game, no server is started
+    if (!config.replay_file.empty()) {
+        return GameJournal::printReplay(config.replay_file, std::cout) ? 0 : 1;
+    }
+
     config.printConfig();
 
     // Set up signal handlers for graceful shutdown
     std::signal(SIGINT, signalHandler);
     std::signal(SIGTERM, signalHandler);
+    std::signal(SIGUSR2, traceDumpHandler);
+
+    // Before any thread starts, so every one of them samples at the same rate
+    Tracing::configure(config.trace_sample_rate, static_cast<size_t>(config.trace_buffer_spans));
 
     try {
         // Initialize all components
         Logger logger(config.log_file);
         logger.setLogLevel(LogLevel::INFO);
         logger.setLogToFile(config.enable_file_logging);
+        logger.setFlushInterval(config.log_flush_interval_ms);
+        // Shared with the other processes on this port, outlives every manager using it
+        SessionDirectory sessionDirectory;
+        if (!config.session_directory.empty()) {
+            std::string error;
+            if (!sessionDirectory.open(config.session_directory, config.node_id, error)) {
+                logger.error("Failed to open session directory " + config.session_directory + ": " + error);
+                return 1;
+            }
+            logger.info("Joined session directory " + config.session_directory + " as node " + std::to_string(config.node_id));
+        }
+        SessionDirectory* directory = sessionDirectory.isOpen() ? &sessionDirectory : nullptr;
+        // Outlives the managers too, game threads record into it until the network is stopped
+        GameJournal gameJournal(&logger, config.journal_dir, config.journal_flush_ms,
+                                config.journal_sync, config.journal_keep_finished);
+
         PlayerManager playerManager;
-        RoomManager roomManager;
+        playerManager.setSessionDirectory(directory);
+        HeartbeatSchedule heartbeat;
+        heartbeat.lobby_ms = config.heartbeat_lobby_interval_ms;
+        heartbeat.room_ms = config.heartbeat_interval_ms;
+        heartbeat.turn_ms = config.heartbeat_turn_interval_ms;
+        heartbeat.missed_intervals = config.player_timeout_seconds * 1000.0 / config.heartbeat_interval_ms;
+        heartbeat.timeout_ms = config.player_timeout_seconds * 1000;
+        heartbeat.lobby_timeout_ms = (config.lobby_timeout_seconds > 0 ? config.lobby_timeout_seconds
+                                                                       : config.player_timeout_seconds) * 1000;
+        playerManager.setHeartbeatSchedule(heartbeat);
+        RoomManager roomManager(static_cast<size_t>(config.max_rooms));
+        roomManager.setSessionDirectory(directory);
         GameManager gameManager;
         MessageValidator validator;
         MessageHandler messageHandler(&playerManager, &roomManager, &validator, &logger, &gameManager);
+        Matchmaker matchmaker(&roomManager, &playerManager, &logger, config.matchmaking_tick_ms);
+        if (config.matchmaking_tick_ms > 0) {
+            messageHandler.setMatchmaker(&matchmaker);
+        }
 
         // Initialize NetworkManager with heartbeat monitoring
         NetworkManager networkManager(&playerManager, &roomManager, &messageHandler,
                                     &validator, &logger, &config, config.ip, config.port);
+        networkManager.setSessionDirectory(directory);
+        if (config.matchmaking_tick_ms > 0) {
+            networkManager.setMatchmaker(&matchmaker);
+        }
+
+        // Rooms of the previous process come back before anyone can connect, their players get to reconnect.
+        // A hot restart brings the rooms along instead, their journals simply continue.
+        if (!config.journal_dir.empty()) {
+            std::string error;
+            if (!gameJournal.start(error)) {
+                logger.error("Failed to start game journal: " + error);
+                return 1;
+            }
+            roomManager.setGameJournal(&gameJournal);
+            size_t recovered = config.takeover ? 0 : gameJournal.recover(&roomManager, &playerManager);
+            if (recovered > 0) {
+                logger.info("Recovered " + std::to_string(recovered) + " room(s) from the game journal");
+            }
+        }
 
         logger.info("=== Gamba Server Starting ===");
         logger.info("Server configuration loaded with " + std::to_string(config.player_timeout_seconds) +
@@ -78,6 +149,20 @@ int main(int argc, char* argv[]) {
             return 1;
         }
 
+        // Metrics endpoint on its own port, server keeps running without it. Nodes of a session directory
+        // each serve their own metrics on admin_port + node_id.
+        std::unique_ptr<AdminServer> adminServer;
+        if (config.admin_port > 0) {
+            int admin_port = config.admin_port + (config.session_directory.empty() ? 0 : config.node_id);
+            adminServer = std::make_unique<AdminServer>(&playerManager, &roomManager, &networkManager,
+                                                        &logger, config.admin_ip, admin_port,
+                                                        networkManager.supportsHotRestart());
+            if (!adminServer->start()) {
+                logger.warning("Metrics endpoint disabled");
+                adminServer.reset();
+            }
+        }
+
         // Run server in a separate thread
         std::thread server_thread([&networkManager]() {
             networkManager.run();
@@ -85,13 +170,29 @@ int main(int argc, char* argv[]) {
 
         logger.info("Gamba server is running. Press Ctrl+C to stop.");
 
-        // Main loop - wait for shutdown signal
-        while (server_running.load()) {
+        // Main loop - wait for shutdown signal (or for a hot restart successor to take over)
+        while (server_running.load() && !networkManager.wasHandedOver()) {
             std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            if (trace_dump_requested.exchange(false)) {
+                std::string error;
+                if (Tracing::writeChromeTrace(config.trace_file, error)) {
+                    logger.info("Trace written to " + config.trace_file);
+                } else {
+                    logger.error("Failed to write trace: " + error);
+                }
+            }
         }
 
-        logger.info("Shutdown signal received. Stopping server...");
-        networkManager.stop();
+        if (adminServer) {
+            adminServer->stop();
+        }
+        if (networkManager.wasHandedOver()) {
+            logger.info("Successor took over, exiting");
+        } else {
+            logger.info("Shutdown signal received. Stopping server...");
+            networkManager.stop();
+        }
+        gameJournal.stop();
 
         if (server_thread.joinable()) {
             // Use timed join to prevent hanging
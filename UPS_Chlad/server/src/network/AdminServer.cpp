@@ -0,0 +1,191 @@
+// AdminServer.cpp - Admin HTTP endpoint for metrics and traces
+// KIV/UPS Network Programming Project
+
+#include "AdminServer.h"
+#include "NetworkManager.h"
+#include "core/PlayerManager.h"
+#include "core/RoomManager.h"
+#include "core/Logger.h"
+#include "core/Metrics.h"
+#include "core/Tracing.h"
+#include <stdexcept>
+#include <cstring>
+#include <errno.h>
+#include <poll.h>
+#include <sys/time.h>
+
+namespace {
+    constexpr int ACCEPT_POLL_MS = 200;          // How often the accept loop checks for stop()
+    constexpr size_t MAX_REQUEST_SIZE = 4096;
+    constexpr int REQUEST_TIMEOUT_SECONDS = 1;
+
+    void appendGauge(std::string& out, const char* name, const char* help, size_t value) {
+        out += std::string("# HELP ") + name + " " + help + "\n";
+        out += std::string("# TYPE ") + name + " gauge\n";
+        out += std::string(name) + " " + std::to_string(value) + "\n";
+    }
+
+    bool sendAll(int socket_fd, const std::string& data) {
+        size_t sent = 0;
+        while (sent < data.size()) {
+            ssize_t result = send(socket_fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+            if (result < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            sent += static_cast<size_t>(result);
+        }
+        return true;
+    }
+}
+
+AdminServer::AdminServer(PlayerManager* pm, RoomManager* rm, NetworkManager* nm, Logger* lg,
+                         const std::string& ip, int port, bool reuse_port)
+    : playerManager(pm), roomManager(rm), networkManager(nm), logger(lg),
+      admin_ip(ip), admin_port(port), share_port(reuse_port), listen_socket(-1), running(false) {
+
+    if (!playerManager || !roomManager || !networkManager || !logger) {
+        throw std::invalid_argument("AdminServer: All manager pointers must be non-null");
+    }
+}
+
+AdminServer::~AdminServer() {
+    stop();
+}
+
+bool AdminServer::start() {
+    listen_socket = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_socket < 0) {
+        logger->error("Failed to create admin socket: " + std::string(strerror(errno)));
+        return false;
+    }
+
+    int opt = 1;
+    setsockopt(listen_socket, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+    // Hot restart successor binds while the old process is still on its way out. Only then - otherwise a second
+    // server on the same port would silently get a share of the scrapes.
+    if (share_port) {
+        setsockopt(listen_socket, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt));
+    }
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<uint16_t>(admin_port));
+    if (inet_pton(AF_INET, admin_ip.c_str(), &address.sin_addr) != 1) {
+        logger->error("Invalid admin IP address: " + admin_ip);
+        close(listen_socket);
+        listen_socket = -1;
+        return false;
+    }
+
+    if (bind(listen_socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 ||
+        listen(listen_socket, 8) < 0) {
+        logger->error("Failed to bind admin endpoint " + admin_ip + ":" + std::to_string(admin_port)
+                      + ": " + std::string(strerror(errno)));
+        close(listen_socket);
+        listen_socket = -1;
+        return false;
+    }
+
+    running.store(true);
+    server_thread = std::thread(&AdminServer::serveLoop, this);
+    logger->info("Metrics endpoint listening on http://" + admin_ip + ":" + std::to_string(admin_port) + "/metrics");
+    return true;
+}
+
+void AdminServer::stop() {
+    if (!running.exchange(false)) {
+        return;
+    }
+    if (server_thread.joinable()) {
+        server_thread.join();
+    }
+    if (listen_socket >= 0) {
+        close(listen_socket);
+        listen_socket = -1;
+    }
+    logger->info("Metrics endpoint stopped");
+}
+
+void AdminServer::serveLoop() {
+    while (running.load()) {
+        struct pollfd pfd;
+        pfd.fd = listen_socket;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+
+        int ready = poll(&pfd, 1, ACCEPT_POLL_MS);
+        if (ready <= 0) {
+            if (ready < 0 && errno != EINTR) {
+                logger->warning("Admin poll() failed: " + std::string(strerror(errno)));
+            }
+            continue;
+        }
+
+        int client_socket = accept4(listen_socket, nullptr, nullptr, SOCK_CLOEXEC);
+        if (client_socket < 0) {
+            continue;
+        }
+        handleRequest(client_socket);
+    }
+}
+
+void AdminServer::handleRequest(int client_socket) {
+    // Blocking reads with a timeout, a stuck scraper can't hold the admin thread for long
+    struct timeval timeout{};
+    timeout.tv_sec = REQUEST_TIMEOUT_SECONDS;
+    setsockopt(client_socket, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    std::string request;
+    char buffer[1024];
+    while (request.find("\r\n\r\n") == std::string::npos && request.size() < MAX_REQUEST_SIZE) {
+        ssize_t bytes_received = recv(client_socket, buffer, sizeof(buffer), 0);
+        if (bytes_received <= 0) {
+            break;
+        }
+        request.append(buffer, static_cast<size_t>(bytes_received));
+    }
+
+    std::string response;
+    if (request.rfind("GET /metrics ", 0) == 0 || request.rfind("GET /metrics?", 0) == 0) {
+        std::string body = renderMetrics();
+        response = "HTTP/1.1 200 OK\r\n"
+                   "Content-Type: text/plain; version=0.0.4\r\n"
+                   "Content-Length: " + std::to_string(body.size()) + "\r\n"
+                   "Connection: close\r\n\r\n" + body;
+    } else if (request.rfind("GET /trace ", 0) == 0 || request.rfind("GET /trace?", 0) == 0) {
+        std::string body;
+        Tracing::renderChromeTrace(body);
+        response = "HTTP/1.1 200 OK\r\n"
+                   "Content-Type: application/json\r\n"
+                   "Content-Length: " + std::to_string(body.size()) + "\r\n"
+                   "Connection: close\r\n\r\n" + body;
+    } else {
+        const std::string body = "Not found, metrics are at /metrics, sampled traces at /trace\n";
+        response = "HTTP/1.1 404 Not Found\r\n"
+                   "Content-Type: text/plain\r\n"
+                   "Content-Length: " + std::to_string(body.size()) + "\r\n"
+                   "Connection: close\r\n\r\n" + body;
+    }
+
+    if (!sendAll(client_socket, response)) {
+        LOG_DEBUG(logger, "Failed to send admin response: " + std::string(strerror(errno)));
+    }
+    close(client_socket);
+}
+
+std::string AdminServer::renderMetrics() {
+    std::string out;
+    OutboundStats outbound = networkManager->getOutboundStats();
+    appendGauge(out, "gamba_players", "Players known to the server, including those inside the reconnect window",
+                playerManager->getPlayerCount());
+    appendGauge(out, "gamba_rooms", "Active rooms", roomManager->getRoomCount());
+    appendGauge(out, "gamba_rooms_capacity", "Rooms preallocated from max_rooms", roomManager->getRoomCapacity());
+    appendGauge(out, "gamba_connections", "Open client connections", outbound.connections);
+    appendGauge(out, "gamba_outbound_queued_bytes", "Unwritten bytes over all outbound queues", outbound.queued_bytes);
+    appendGauge(out, "gamba_outbound_max_queue_bytes", "Deepest single outbound queue", outbound.max_queued_bytes);
+    Metrics::renderPrometheus(out);
+    return out;
+}
@@ -0,0 +1,320 @@
+// HotRestart.cpp - Server handover to a new process
+// KIV/UPS Network Programming Project
+
+#include "HotRestart.h"
+#include "core/Logger.h"
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/time.h>
+
+namespace {
+    constexpr int ACCEPT_POLL_MS = 200;          // How often the listening loop checks for stop()
+    constexpr int REQUEST_TIMEOUT_SECONDS = 1;
+    constexpr int STATE_TIMEOUT_SECONDS = 10;    // Old process drains its work queues before the state comes
+
+    constexpr char TAKEOVER = 'T';
+    constexpr char SOCKETS = 'F';
+    constexpr char SNAPSHOT = 'S';
+    constexpr char END = 'E';
+    constexpr char ACKNOWLEDGE = 'A';
+
+    socklen_t restartAddress(const std::string& name, sockaddr_un& address) {
+        std::string path = "gamba.restart." + name;
+        memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        size_t length = std::min(path.size(), sizeof(address.sun_path) - 1);
+        memcpy(address.sun_path + 1, path.data(), length);
+        return static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + 1 + length);
+    }
+
+    void setTimeout(int socket_fd, int option, int seconds) {
+        struct timeval timeout{};
+        timeout.tv_sec = seconds;
+        setsockopt(socket_fd, SOL_SOCKET, option, &timeout, sizeof(timeout));
+    }
+
+    bool sendDatagram(int channel_socket, const std::string& payload, const int* fds, size_t fd_count) {
+        struct iovec iov;
+        iov.iov_base = const_cast<char*>(payload.data());
+        iov.iov_len = payload.size();
+
+        std::vector<char> control(fd_count > 0 ? CMSG_SPACE(sizeof(int) * fd_count) : 0);
+        struct msghdr message;
+        memset(&message, 0, sizeof(message));
+        message.msg_iov = &iov;
+        message.msg_iovlen = 1;
+        if (fd_count > 0) {
+            message.msg_control = control.data();
+            message.msg_controllen = control.size();
+            struct cmsghdr* header = CMSG_FIRSTHDR(&message);
+            header->cmsg_level = SOL_SOCKET;
+            header->cmsg_type = SCM_RIGHTS;
+            header->cmsg_len = CMSG_LEN(sizeof(int) * fd_count);
+            memcpy(CMSG_DATA(header), fds, sizeof(int) * fd_count);
+        }
+
+        while (true) {
+            ssize_t sent = sendmsg(channel_socket, &message, MSG_NOSIGNAL);
+            if (sent < 0 && errno == EINTR) {
+                continue;
+            }
+            return sent == static_cast<ssize_t>(payload.size());
+        }
+    }
+
+    void appendLittleEndian(std::string& out, uint64_t value, int bytes) {
+        for (int i = 0; i < bytes; ++i) {
+            out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+        }
+    }
+
+    uint64_t readLittleEndian(const char* data, int bytes) {
+        uint64_t value = 0;
+        for (int i = 0; i < bytes; ++i) {
+            value |= static_cast<uint64_t>(static_cast<unsigned char>(data[i])) << (8 * i);
+        }
+        return value;
+    }
+}
+
+HotRestart::HotRestart(Logger* lg) : logger(lg), listen_socket(-1), running(false) {}
+
+HotRestart::~HotRestart() {
+    stop();
+}
+
+bool HotRestart::listen(const std::string& name, TakeoverCallback on_takeover) {
+    stop();     // Listening thread of a failed takeover has already returned
+    socket_name = name;
+    callback = std::move(on_takeover);
+
+    listen_socket = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (listen_socket < 0) {
+        logger->error("Failed to create hot restart socket: " + std::string(strerror(errno)));
+        return false;
+    }
+
+    sockaddr_un address;
+    socklen_t length = restartAddress(socket_name, address);
+    if (bind(listen_socket, reinterpret_cast<sockaddr*>(&address), length) < 0 || ::listen(listen_socket, 4) < 0) {
+        logger->error("Failed to bind hot restart socket " + socket_name + ": " + std::string(strerror(errno)));
+        close(listen_socket);
+        listen_socket = -1;
+        return false;
+    }
+
+    running.store(true);
+    listen_thread = std::thread(&HotRestart::listenLoop, this);
+    logger->info("Hot restart socket listening as " + socket_name);
+    return true;
+}
+
+void HotRestart::stop() {
+    running.store(false);
+    if (listen_thread.joinable()) {
+        listen_thread.join();
+    }
+    if (listen_socket >= 0) {
+        close(listen_socket);
+        listen_socket = -1;
+    }
+}
+
+void HotRestart::listenLoop() {
+    while (running.load()) {
+        struct pollfd pfd;
+        pfd.fd = listen_socket;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+
+        int ready = poll(&pfd, 1, ACCEPT_POLL_MS);
+        if (ready <= 0) {
+            if (ready < 0 && errno != EINTR) {
+                logger->warning("Hot restart poll() failed: " + std::string(strerror(errno)));
+            }
+            continue;
+        }
+
+        int channel_socket = accept4(listen_socket, nullptr, nullptr, SOCK_CLOEXEC);
+        if (channel_socket < 0) {
+            continue;
+        }
+
+        setTimeout(channel_socket, SO_RCVTIMEO, REQUEST_TIMEOUT_SECONDS);
+        char request = 0;
+        if (recv(channel_socket, &request, 1, 0) != 1 || request != TAKEOVER) {
+            logger->warning("Ignoring malformed hot restart request");
+            close(channel_socket);
+            continue;
+        }
+
+        // One successor at a time, it takes the name over once it runs
+        close(listen_socket);
+        listen_socket = -1;
+        running.store(false);
+        logger->info("Successor process asked to take over");
+        callback(channel_socket);
+        return;
+    }
+}
+
+bool HotRestart::sendState(int channel_socket, int listen_socket, const std::vector<int>& client_sockets,
+                           const std::string& snapshot) {
+    std::vector<int> sockets;
+    sockets.reserve(client_sockets.size() + 1);
+    sockets.push_back(listen_socket);
+    sockets.insert(sockets.end(), client_sockets.begin(), client_sockets.end());
+
+    std::string kind(1, SOCKETS);
+    for (size_t sent = 0; sent < sockets.size(); sent += MAX_FDS_PER_MESSAGE) {
+        size_t count = std::min(MAX_FDS_PER_MESSAGE, sockets.size() - sent);
+        if (!sendDatagram(channel_socket, kind, sockets.data() + sent, count)) {
+            return false;
+        }
+    }
+
+    std::string chunk;
+    for (size_t offset = 0; offset < snapshot.size(); offset += SNAPSHOT_CHUNK_SIZE) {
+        chunk.assign(1, SNAPSHOT);
+        chunk.append(snapshot, offset, SNAPSHOT_CHUNK_SIZE);
+        if (!sendDatagram(channel_socket, chunk, nullptr, 0)) {
+            return false;
+        }
+    }
+
+    std::string end(1, END);
+    appendLittleEndian(end, client_sockets.size(), 4);
+    appendLittleEndian(end, snapshot.size(), 8);
+    return sendDatagram(channel_socket, end, nullptr, 0);
+}
+
+bool HotRestart::waitForAcknowledge(int channel_socket, int timeout_ms) {
+    struct pollfd pfd;
+    pfd.fd = channel_socket;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    if (poll(&pfd, 1, timeout_ms) <= 0) {
+        return false;
+    }
+    char reply = 0;
+    return recv(channel_socket, &reply, 1, MSG_DONTWAIT) == 1 && reply == ACKNOWLEDGE;
+}
+
+bool HotRestart::requestTakeover(const std::string& name, State& state, std::string& error) {
+    state.channel_socket = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (state.channel_socket < 0) {
+        error = "cannot create socket: " + std::string(strerror(errno));
+        return false;
+    }
+
+    sockaddr_un address;
+    socklen_t length = restartAddress(name, address);
+    if (connect(state.channel_socket, reinterpret_cast<sockaddr*>(&address), length) < 0) {
+        error = "no server listens on " + name + ": " + std::string(strerror(errno));
+        discard(state);
+        return false;
+    }
+    setTimeout(state.channel_socket, SO_RCVTIMEO, STATE_TIMEOUT_SECONDS);
+
+    char request = TAKEOVER;
+    if (send(state.channel_socket, &request, 1, MSG_NOSIGNAL) != 1) {
+        error = "request failed: " + std::string(strerror(errno));
+        discard(state);
+        return false;
+    }
+
+    std::vector<char> payload(1 + SNAPSHOT_CHUNK_SIZE);
+    alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(int) * MAX_FDS_PER_MESSAGE)];
+    while (true) {
+        struct iovec iov;
+        iov.iov_base = payload.data();
+        iov.iov_len = payload.size();
+        struct msghdr message;
+        memset(&message, 0, sizeof(message));
+        message.msg_iov = &iov;
+        message.msg_iovlen = 1;
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+
+        ssize_t received = recvmsg(state.channel_socket, &message, MSG_CMSG_CLOEXEC);
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+        if (received <= 0) {
+            error = received < 0 ? "receive failed: " + std::string(strerror(errno)) : "server closed the channel";
+            discard(state);
+            return false;
+        }
+
+        for (struct cmsghdr* header = CMSG_FIRSTHDR(&message); header; header = CMSG_NXTHDR(&message, header)) {
+            if (header->cmsg_level != SOL_SOCKET || header->cmsg_type != SCM_RIGHTS) {
+                continue;
+            }
+            size_t count = (header->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+            for (size_t i = 0; i < count; ++i) {
+                int received_socket;
+                memcpy(&received_socket, CMSG_DATA(header) + i * sizeof(int), sizeof(int));
+                if (state.listen_socket < 0) {
+                    state.listen_socket = received_socket;
+                } else {
+                    state.client_sockets.push_back(received_socket);
+                }
+            }
+        }
+        if (message.msg_flags & (MSG_TRUNC | MSG_CTRUNC)) {
+            error = "truncated state message";
+            discard(state);
+            return false;
+        }
+
+        char kind = payload[0];
+        if (kind == SNAPSHOT) {
+            state.snapshot.append(payload.data() + 1, static_cast<size_t>(received) - 1);
+        } else if (kind == END) {
+            bool complete = received == 13 && state.listen_socket >= 0 &&
+                            readLittleEndian(payload.data() + 1, 4) == state.client_sockets.size() &&
+                            readLittleEndian(payload.data() + 5, 8) == state.snapshot.size();
+            if (!complete) {
+                error = "incomplete state";
+                discard(state);
+                return false;
+            }
+            return true;
+        } else if (kind != SOCKETS) {
+            error = "unknown state message";
+            discard(state);
+            return false;
+        }
+    }
+}
+
+bool HotRestart::acknowledge(State& state) {
+    char reply = ACKNOWLEDGE;
+    bool sent = send(state.channel_socket, &reply, 1, MSG_NOSIGNAL) == 1;
+    close(state.channel_socket);
+    state.channel_socket = -1;
+    return sent;
+}
+
+void HotRestart::discard(State& state) {
+    if (state.channel_socket >= 0) {
+        close(state.channel_socket);
+        state.channel_socket = -1;
+    }
+    if (state.listen_socket >= 0) {
+        close(state.listen_socket);
+        state.listen_socket = -1;
+    }
+    for (int client_socket : state.client_sockets) {
+        close(client_socket);
+    }
+    state.client_sockets.clear();
+    state.snapshot.clear();
+}
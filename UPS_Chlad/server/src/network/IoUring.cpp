@@ -0,0 +1,245 @@
+// IoUring.cpp - Minimal io_uring wrapper
+// KIV/UPS Network Programming Project
+
+#include "IoUring.h"
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/socket.h>
+#include <sys/utsname.h>
+#include <unistd.h>
+#include <errno.h>
+#include <cstring>
+#include <cstdio>
+
+IoUring::IoUring()
+    : ring_fd(-1), ring_memory(nullptr), ring_memory_size(0), sqes(nullptr), sqes_size(0),
+      sq_head(nullptr), sq_tail(nullptr), sq_mask(0), sq_entries(0), cq_head(nullptr), cq_tail(nullptr), cq_mask(0),
+      cqes(nullptr), sqe_tail(0), unsubmitted(0), buffer_ring(nullptr), buffer_ring_size(0),
+      buffer_count(0), buffer_size(0), buffer_tail(0) {}
+
+IoUring::~IoUring() {
+    close();
+}
+
+bool IoUring::kernelAtLeast(int major, int minor) {
+    struct utsname name;
+    int kernel_major = 0;
+    int kernel_minor = 0;
+    if (uname(&name) < 0 || sscanf(name.release, "%d.%d", &kernel_major, &kernel_minor) != 2) {
+        return false;
+    }
+    return kernel_major > major || (kernel_major == major && kernel_minor >= minor);
+}
+
+bool IoUring::setup(unsigned entries, uint16_t group, unsigned count, unsigned size, std::string& error) {
+    // Multishot recv is the newest piece in use, older kernels reject the flag only when the request runs
+    if (!kernelAtLeast(6, 0)) {
+        error = "kernel older than 6.0";
+        return false;
+    }
+
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    params.flags = IORING_SETUP_CLAMP;
+    ring_fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+    if (ring_fd < 0) {
+        error = std::string("io_uring_setup: ") + strerror(errno);
+        return false;
+    }
+    if (!(params.features & IORING_FEAT_SINGLE_MMAP) || !(params.features & IORING_FEAT_NODROP)) {
+        error = "io_uring without single mmap / no-drop completions";
+        close();
+        return false;
+    }
+
+    size_t sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    size_t cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    ring_memory_size = sq_size > cq_size ? sq_size : cq_size;
+    ring_memory = mmap(nullptr, ring_memory_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQ_RING);
+    if (ring_memory == MAP_FAILED) {
+        ring_memory = nullptr;
+        error = std::string("mmap of io_uring rings: ") + strerror(errno);
+        close();
+        return false;
+    }
+    sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+    void* sqe_memory = mmap(nullptr, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQES);
+    if (sqe_memory == MAP_FAILED) {
+        error = std::string("mmap of io_uring entries: ") + strerror(errno);
+        close();
+        return false;
+    }
+    sqes = static_cast<io_uring_sqe*>(sqe_memory);
+
+    char* base = static_cast<char*>(ring_memory);
+    sq_head = reinterpret_cast<unsigned*>(base + params.sq_off.head);
+    sq_tail = reinterpret_cast<unsigned*>(base + params.sq_off.tail);
+    sq_mask = *reinterpret_cast<unsigned*>(base + params.sq_off.ring_mask);
+    sq_entries = params.sq_entries;
+    cq_head = reinterpret_cast<unsigned*>(base + params.cq_off.head);
+    cq_tail = reinterpret_cast<unsigned*>(base + params.cq_off.tail);
+    cq_mask = *reinterpret_cast<unsigned*>(base + params.cq_off.ring_mask);
+    cqes = reinterpret_cast<io_uring_cqe*>(base + params.cq_off.cqes);
+    sqe_tail = *sq_tail;
+
+    // Submission entries are always used in ring order, the index array stays the identity
+    unsigned* sq_array = reinterpret_cast<unsigned*>(base + params.sq_off.array);
+    for (unsigned i = 0; i < sq_entries; ++i) {
+        sq_array[i] = i;
+    }
+
+    // Provided buffer ring, page aligned memory the kernel reads buffer addresses from
+    buffer_ring_size = count * sizeof(io_uring_buf);
+    void* buffer_ring_memory = mmap(nullptr, buffer_ring_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (buffer_ring_memory == MAP_FAILED) {
+        error = std::string("mmap of buffer ring: ") + strerror(errno);
+        close();
+        return false;
+    }
+    buffer_ring = static_cast<io_uring_buf_ring*>(buffer_ring_memory);
+
+    struct io_uring_buf_reg registration;
+    memset(&registration, 0, sizeof(registration));
+    registration.ring_addr = reinterpret_cast<uint64_t>(buffer_ring);
+    registration.ring_entries = count;
+    registration.bgid = group;
+    if (syscall(__NR_io_uring_register, ring_fd, IORING_REGISTER_PBUF_RING, &registration, 1) < 0) {
+        error = std::string("registering buffer ring: ") + strerror(errno);
+        close();
+        return false;
+    }
+
+    buffer_count = count;
+    buffer_size = size;
+    buffer_memory.reset(new char[static_cast<size_t>(count) * size]);
+    buffer_tail = 0;
+    for (unsigned i = 0; i < count; ++i) {
+        recycleBuffer(static_cast<uint16_t>(i));
+    }
+    publishBuffers();
+    return true;
+}
+
+void IoUring::close() {
+    // Closing the ring cancels every request still in flight
+    if (ring_fd >= 0) {
+        ::close(ring_fd);
+        ring_fd = -1;
+    }
+    if (buffer_ring) {
+        munmap(buffer_ring, buffer_ring_size);
+        buffer_ring = nullptr;
+    }
+    if (sqes) {
+        munmap(sqes, sqes_size);
+        sqes = nullptr;
+    }
+    if (ring_memory) {
+        munmap(ring_memory, ring_memory_size);
+        ring_memory = nullptr;
+    }
+    buffer_memory.reset();
+}
+
+io_uring_sqe* IoUring::nextSqe() {
+    if (sqe_tail - __atomic_load_n(sq_head, __ATOMIC_ACQUIRE) >= sq_entries) {
+        // Queue full - hand what is prepared to the kernel without waiting for completions
+        submitAndWait(0);
+        if (sqe_tail - __atomic_load_n(sq_head, __ATOMIC_ACQUIRE) >= sq_entries) {
+            return nullptr;
+        }
+    }
+    io_uring_sqe* sqe = &sqes[sqe_tail & sq_mask];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe_tail++;
+    unsubmitted++;
+    return sqe;
+}
+
+bool IoUring::prepareMultishotAccept(int listen_fd, uint64_t user_data) {
+    io_uring_sqe* sqe = nextSqe();
+    if (!sqe) {
+        return false;
+    }
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = listen_fd;
+    sqe->accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+    sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe->user_data = user_data;
+    return true;
+}
+
+bool IoUring::prepareMultishotRecv(int fd, uint16_t group, uint64_t user_data) {
+    io_uring_sqe* sqe = nextSqe();
+    if (!sqe) {
+        return false;
+    }
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = fd;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = group;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->user_data = user_data;
+    return true;
+}
+
+bool IoUring::prepareMultishotPoll(int fd, unsigned events, uint64_t user_data) {
+    io_uring_sqe* sqe = nextSqe();
+    if (!sqe) {
+        return false;
+    }
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = fd;
+    sqe->poll32_events = events;
+    sqe->len = IORING_POLL_ADD_MULTI;
+    sqe->user_data = user_data;
+    return true;
+}
+
+bool IoUring::prepareCancel(uint64_t target_user_data, uint64_t user_data) {
+    io_uring_sqe* sqe = nextSqe();
+    if (!sqe) {
+        return false;
+    }
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->fd = -1;
+    sqe->addr = target_user_data;
+    sqe->user_data = user_data;
+    return true;
+}
+
+int IoUring::submitAndWait(unsigned min_complete) {
+    __atomic_store_n(sq_tail, sqe_tail, __ATOMIC_RELEASE);
+    unsigned flags = min_complete > 0 ? IORING_ENTER_GETEVENTS : 0;
+    long submitted = syscall(__NR_io_uring_enter, ring_fd, unsubmitted, min_complete, flags, nullptr, 0);
+    if (submitted < 0) {
+        return -errno;
+    }
+    unsubmitted -= static_cast<unsigned>(submitted);
+    return static_cast<int>(submitted);
+}
+
+io_uring_cqe* IoUring::peekCompletion() {
+    unsigned head = *cq_head;
+    if (head == __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE)) {
+        return nullptr;
+    }
+    return &cqes[head & cq_mask];
+}
+
+void IoUring::consumeCompletion() {
+    __atomic_store_n(cq_head, *cq_head + 1, __ATOMIC_RELEASE);
+}
+
+void IoUring::recycleBuffer(uint16_t buffer_id) {
+    // Not buffer_ring->bufs - in C++ the empty struct in front of the flexible array moves it 8 bytes up
+    io_uring_buf* slot = reinterpret_cast<io_uring_buf*>(buffer_ring) + (buffer_tail & (buffer_count - 1));
+    slot->addr = reinterpret_cast<uint64_t>(bufferData(buffer_id));
+    slot->len = buffer_size;
+    slot->bid = buffer_id;
+    buffer_tail++;
+}
+
+void IoUring::publishBuffers() {
+    __atomic_store_n(&buffer_ring->tail, buffer_tail, __ATOMIC_RELEASE);
+}
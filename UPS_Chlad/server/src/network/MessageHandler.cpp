@@ -9,75 +9,144 @@
 #include "PlayerManager.h"
 #include "RoomManager.h"
 #include "GameManager.h"
+#include "Matchmaker.h"
 #include "Logger.h"
+#include "Metrics.h"
+#include "Tracing.h"
 #include <sstream>
 #include <vector>
 
 MessageHandler::MessageHandler(PlayerManager* pm, RoomManager* rm, MessageValidator* mv, Logger* lg, GameManager* gm)
     : playerManager(pm), roomManager(rm), gameManager(gm), validator(mv), logger(lg) {}
 
-std::vector<ProtocolMessage> MessageHandler::processMessage(const std::string& raw_message, int client_socket) {
-    if (!validator->isValidFormat(raw_message)) {
-        logger->warning("Invalid message format from socket " + std::to_string(client_socket) + ": '" + raw_message + "'");
+std::vector<ProtocolMessage> MessageHandler::processMessage(std::string_view raw_message, int client_socket) {
+    std::vector<ProtocolMessage> responses;
+    processMessage(raw_message, client_socket, responses);
+    return responses;
+}
+
+void MessageHandler::processMessage(std::string_view raw_message, int client_socket, std::vector<ProtocolMessage>& responses) {
+    Tracing::Span span("MessageHandler::processMessage");
+    auto started = std::chrono::steady_clock::now();
+    responses.clear();
+
+    // Tokenize in place, format and type are validated in the same pass
+    MessageView view;
+    MessageView::ParseStatus status = MessageView::parse(raw_message, view);
+    if (status == MessageView::ParseStatus::INVALID_FORMAT) {
+        logger->warning("Invalid message format from socket " + std::to_string(client_socket) + ": '" + std::string(raw_message) + "'");
         ProtocolMessage disconnect_response(MessageType::ERROR_MSG);
         disconnect_response.setData("disconnect", "true");
-        return {disconnect_response};
+        responses.push_back(std::move(disconnect_response));
+        return;
     }
-
-    ProtocolMessage msg = ProtocolMessage::parse(raw_message);
-    logger->debug("Parsed message type: " + std::to_string(static_cast<int>(msg.getType())));
-    
-    if (!validator->isValidMessageType(static_cast<int>(msg.getType()))) {
-        logger->warning("Invalid message type " + std::to_string(static_cast<int>(msg.getType())) + " from socket " + std::to_string(client_socket));
+    if (status == MessageView::ParseStatus::INVALID_TYPE) {
+        logger->warning("Invalid message type " + std::string(raw_message.substr(0, raw_message.find('|'))) + " from socket " + std::to_string(client_socket));
         ProtocolMessage disconnect_response(MessageType::ERROR_MSG);
         disconnect_response.setData("disconnect", "true");
-        return {disconnect_response};
+        responses.push_back(std::move(disconnect_response));
+        return;
+    }
+
+    span.setDetail(Metrics::messageTypeName(view.type()));
+
+    // Any valid frame is a sign of life, clients PING only when they have nothing else to send
+    PlayerHandle player = markAlive(client_socket);
+
+    // PING fast path - answered straight from the view, no owning message is built
+    if (view.type() == MessageType::PING) {
+        answerPing(player, responses);
+    } else {
+        responses = routeMessage(ProtocolMessage::fromView(view), client_socket);
+    }
+
+    Metrics::add(Metrics::Counter::MESSAGES_IN);
+    Metrics::recordMessage(view.type(), Metrics::elapsedNanoseconds(started));
+}
+
+void MessageHandler::processMessage(const ProtocolMessage& msg, int client_socket, std::vector<ProtocolMessage>& responses) {
+    Tracing::Span span("MessageHandler::processMessage", Metrics::messageTypeName(msg.getType()));
+    auto started = std::chrono::steady_clock::now();
+    responses.clear();
+
+    // Binary decoder already rejected unknown types
+    PlayerHandle player = markAlive(client_socket);
+    if (msg.getType() == MessageType::PING) {
+        answerPing(player, responses);
+    } else {
+        responses = routeMessage(msg, client_socket);
     }
 
+    Metrics::add(Metrics::Counter::MESSAGES_IN);
+    Metrics::recordMessage(msg.getType(), Metrics::elapsedNanoseconds(started));
+}
+
+PlayerHandle MessageHandler::markAlive(int client_socket) {
+    PlayerHandle player = playerManager->getPlayerHandleFromSocket(client_socket);
+    if (player != Handles::INVALID) {
+        playerManager->updateLastPing(player);
+    }
+    return player;
+}
+
+void MessageHandler::answerPing(PlayerHandle player, std::vector<ProtocolMessage>& responses) {
+    if (player == Handles::INVALID) {
+        responses.push_back(ProtocolHelper::createErrorResponse("Must connect first"));
+        return;
+    }
+    responses.push_back(ProtocolHelper::createPongResponse());
+}
+
+std::vector<ProtocolMessage> MessageHandler::routeMessage(const ProtocolMessage& msg, int client_socket) {
+    LOG_DEBUG(logger, "Parsed message type: " + std::to_string(static_cast<int>(msg.getType())));
+
     // Player resolution
     std::string player_name = "";
-    logger->debug("About to check if message requires active player");
+    LOG_DEBUG(logger, "About to check if message requires active player");
 
     if (MessageParser::requiresActivePlayer(msg.getType())) {
-        logger->debug("Message requires active player, getting from socket");
+        LOG_DEBUG(logger, "Message requires active player, getting from socket");
         player_name = playerManager->getPlayerIdFromSocket(client_socket);
-        logger->debug("Got player name from socket: '" + player_name + "'");
+        LOG_DEBUG(logger, "Got player name from socket: '" + player_name + "'");
 
         if (player_name.empty()) {
-            logger->debug("Player name is empty, returning error");
+            LOG_DEBUG(logger, "Player name is empty, returning error");
             return {ProtocolHelper::createErrorResponse("Must connect first")};
         }
     }
     
-    logger->debug("About to enter switch statement with message type: " + std::to_string(static_cast<int>(msg.getType())));
+    LOG_DEBUG(logger, "About to enter switch statement with message type: " + std::to_string(static_cast<int>(msg.getType())));
 
     switch (msg.getType()) {
         case MessageType::CONNECT:
-            logger->debug("Routing to handleConnect");
+            LOG_DEBUG(logger, "Routing to handleConnect");
             return handleConnect(msg, client_socket);
         case MessageType::RECONNECT:
-            logger->debug("Routing to handleReconnect");
+            LOG_DEBUG(logger, "Routing to handleReconnect");
             return handleReconnect(msg, client_socket);
         case MessageType::PING:
-            logger->debug("Routing to handlePing");
+            LOG_DEBUG(logger, "Routing to handlePing");
             return handlePing(player_name);
         case MessageType::JOIN_ROOM:
-            logger->debug("Routing to handleJoinRoom");
+            LOG_DEBUG(logger, "Routing to handleJoinRoom");
             return handleJoinRoom(player_name);
         case MessageType::LEAVE_ROOM:
-            logger->debug("Routing to handleLeaveRoom");
+            LOG_DEBUG(logger, "Routing to handleLeaveRoom");
             return handleLeaveRoom(player_name);
         case MessageType::START_GAME:
-            logger->debug("Routing to handleStartGame");
+            LOG_DEBUG(logger, "Routing to handleStartGame");
             return handleStartGame(player_name);
         case MessageType::PLAY_CARDS:
-            logger->debug("Routing to handlePlayCards");
+            LOG_DEBUG(logger, "Routing to handlePlayCards");
             return handlePlayCards(msg, player_name);
         case MessageType::PICKUP_PILE:
-            logger->debug("Routing to handlePickupPile");
+            LOG_DEBUG(logger, "Routing to handlePickupPile");
             return handlePickupPile(player_name);
+        case MessageType::RESYNC:
+            LOG_DEBUG(logger, "Routing to handleResync");
+            return handleResync(player_name);
         default:
-            logger->debug("Unknown message type");
+            LOG_DEBUG(logger, "Unknown message type");
             return {ProtocolHelper::createErrorResponse("Unknown message type")};
     }
 }
@@ -90,7 +159,7 @@ std::vector<ProtocolMessage> MessageHandler::handlePing(const std::string& playe
 std::vector<ProtocolMessage> MessageHandler::handleConnect(const ProtocolMessage& msg, int client_socket) {
     // 1. Get player name from message
     std::string player_name = MessageParser::getPlayerNameFromMessage(msg);
-    logger->debug("handleConnect: extracted player name '" + player_name + "'");
+    LOG_DEBUG(logger, "handleConnect: extracted player name '" + player_name + "'");
     
     // 2. VALIDATE PLAYER NAME
     if (player_name.empty()) {
@@ -118,39 +187,67 @@ std::vector<ProtocolMessage> MessageHandler::handleConnect(const ProtocolMessage
     }
     
     // 3. Try to connect player
-    logger->debug("handleConnect: calling playerManager->connectPlayer with name='" + player_name + "', socket=" + std::to_string(client_socket));
+    LOG_DEBUG(logger, "handleConnect: calling playerManager->connectPlayer with name='" + player_name + "', socket=" + std::to_string(client_socket));
     std::string result = playerManager->connectPlayer(player_name, client_socket);
-    logger->debug("handleConnect: playerManager->connectPlayer returned '" + result + "'");
+    LOG_DEBUG(logger, "handleConnect: playerManager->connectPlayer returned '" + result + "'");
 
     // 4. Return response
     if (!result.empty()) {
-        logger->debug("handleConnect: creating success response");
-        return {ProtocolHelper::createConnectedResponse(result, player_name)};
+        LOG_DEBUG(logger, "handleConnect: creating success response");
+        ProtocolMessage connected = ProtocolHelper::createConnectedResponse(result, player_name);
+        acknowledgeBinary(msg, connected);
+        advertiseHeartbeat(connected);
+        return {connected};
     } else {
-        logger->debug("handleConnect: creating error response");
+        LOG_DEBUG(logger, "handleConnect: creating error response");
         ProtocolMessage error = ProtocolHelper::createErrorResponse("Connection failed - name already taken");
         error.setData("disconnect", "true");  // Close socket after sending error
         return {error};
     }
 }
 
+void MessageHandler::acknowledgeBinary(const ProtocolMessage& request, ProtocolMessage& connected) {
+    // Network layer switches the connection to binary frames once this CONNECTED is sent
+    if (request.getData("binary") == "true") {
+        connected.setData("binary", "true");
+    }
+}
+
+void MessageHandler::advertiseHeartbeat(ProtocolMessage& connected) {
+    const HeartbeatSchedule& schedule = playerManager->getHeartbeatSchedule();
+    connected.setData("heartbeat_lobby_ms", std::to_string(schedule.lobby_ms));
+    connected.setData("heartbeat_room_ms", std::to_string(schedule.room_ms));
+    connected.setData("heartbeat_turn_ms", std::to_string(schedule.turn_ms));
+}
+
 std::vector<ProtocolMessage> MessageHandler::handleJoinRoom(const std::string& player_name) {
-    logger->debug("handleJoinRoom: called for player '" + player_name + "'");
+    LOG_DEBUG(logger, "handleJoinRoom: called for player '" + player_name + "'");
     
     // DEBUG: Check player state
     auto player_opt = playerManager->getPlayer(player_name);
     if (player_opt.has_value()) {
-        logger->debug("  Player found: connected=" + std::string(player_opt->connected ? "true" : "false") + 
-                     ", room_id='" + player_opt->room_id + "', socket=" + std::to_string(player_opt->socket_fd));
+        logger->debug([&] {
+            return "  Player found: connected=" + std::string(player_opt->connected ? "true" : "false") +
+                   ", room_id='" + player_opt->room_id + "', socket=" + std::to_string(player_opt->socket_fd);
+        });
     } else {
         logger->error("  Player not found in PlayerManager!");
     }
+
+    // ROOM_JOINED comes from the matchmaker once the player is paired
+    if (matchmaker) {
+        if (player_opt.has_value() && !player_opt->room_id.empty()) {
+            return {ProtocolHelper::createErrorResponse("Already in a room")};
+        }
+        matchmaker->enqueue(player_name);
+        return {};
+    }
     
     std::string assigned_room = roomManager->joinAnyAvailableRoom(player_name);
 
     if (!assigned_room.empty()) {
         playerManager->setPlayerRoom(player_name, assigned_room);
-        logger->debug("handleJoinRoom: room assigned successfully: " + assigned_room);
+        LOG_DEBUG(logger, "handleJoinRoom: room assigned successfully: " + assigned_room);
 
         // Get list of all players currently in the room
         std::vector<std::string> room_players = roomManager->getRoomPlayers(assigned_room);
@@ -162,7 +259,7 @@ std::vector<ProtocolMessage> MessageHandler::handleJoinRoom(const std::string& p
             players_list += room_players[i];
         }
         
-        logger->debug("handleJoinRoom: players in room: " + players_list + " (count: " + std::to_string(room_players.size()) + ")");
+        LOG_DEBUG(logger, "handleJoinRoom: players in room: " + players_list + " (count: " + std::to_string(room_players.size()) + ")");
 
         // Create response with player list
         ProtocolMessage response = ProtocolHelper::createRoomJoinedResponse(player_name, assigned_room);
@@ -175,7 +272,10 @@ std::vector<ProtocolMessage> MessageHandler::handleJoinRoom(const std::string& p
         
         return {response};
     } else {
-        logger->debug("handleJoinRoom: room not assigned");
+        LOG_DEBUG(logger, "handleJoinRoom: room not assigned");
+        if (roomManager->getRoomCount() >= roomManager->getRoomCapacity()) {
+            return {ProtocolHelper::createErrorResponse("No free room, server is full")};
+        }
         return {ProtocolHelper::createErrorResponse("Error occurred while joining room")};
     }
 }
@@ -204,6 +304,8 @@ std::vector<ProtocolMessage> MessageHandler::handleReconnect(const ProtocolMessa
         // 1. Send CONNECTED response to reconnecting player
         ProtocolMessage connected = ProtocolHelper::createConnectedResponse(player_name, player_name);
         connected.player_id = player_name;
+        acknowledgeBinary(msg, connected);
+        advertiseHeartbeat(connected);
         responses.push_back(connected);
         
         // 2. Get player's room
@@ -222,7 +324,7 @@ std::vector<ProtocolMessage> MessageHandler::handleReconnect(const ProtocolMessa
                     reconnect_notification.setData("reconnected_player", player_name);
                     reconnect_notification.setData("status", "reconnected");
                     responses.push_back(reconnect_notification);
-                    logger->debug("Added reconnection notification for player '" + other_player + "'");
+                    LOG_DEBUG(logger, "Added reconnection notification for player '" + other_player + "'");
                 }
             }
             
@@ -238,7 +340,7 @@ std::vector<ProtocolMessage> MessageHandler::handleReconnect(const ProtocolMessa
                         ProtocolMessage game_state = ProtocolHelper::createGameStateResponse(player_name, room_id, game_data);
                         game_state.player_id = player_name;
                         responses.push_back(game_state);
-                        logger->debug("Sent game state to reconnected player '" + player_name + "'");
+                        LOG_DEBUG(logger, "Sent game state to reconnected player '" + player_name + "'");
                     }
                 } catch (const std::exception& e) {
                     logger->error("Failed to get game state for reconnected player: " + std::string(e.what()));
@@ -296,26 +398,26 @@ std::vector<ProtocolMessage> MessageHandler::handleStartGame(const std::string&
     game_started.should_broadcast_to_room = true;
     responses.push_back(game_started);
     
-    // 2. GAME_STATE for each player in room
-    std::vector<std::string> room_players = roomManager->getRoomPlayers(room_id);
-    
-    for (const std::string& target_player : room_players) {
-        try {
-            // Get game state data from GameManager
-            GameStateData game_data = gameManager->getGameStateForPlayer(roomManager, room_id, target_player);
-            
-            if (game_data.valid) {
+    // 2. GAME_STATE for each player in room, all read from one snapshot
+    try {
+        RoomSnapshot snapshot = gameManager->getRoomSnapshot(roomManager, room_id, true);
+
+        if (snapshot.valid) {
+            logger->info("Room '" + room_id + "' game seed " + std::to_string(snapshot.game_seed));
+            trackTurn(room_id, snapshot);
+            for (size_t i = 0; i < snapshot.players.size(); ++i) {
+                const std::string& target_player = snapshot.players[i];
                 // Convert to ProtocolMessage
-                ProtocolMessage game_state = ProtocolHelper::createGameStateResponse(target_player, room_id, game_data);
+                ProtocolMessage game_state = ProtocolHelper::createGameStateResponse(target_player, room_id, snapshot.views[i].current);
                 game_state.player_id = target_player;  // Mark who this is for
-                responses.push_back(game_state);
-                logger->debug("Added game state for player '" + target_player + "'");
-            } else {
-                logger->error("Invalid game state for player '" + target_player + "': " + game_data.error_message);
+                responses.push_back(std::move(game_state));
+                LOG_DEBUG(logger, "Added game state for player '" + target_player + "'");
             }
-        } catch (const std::exception& e) {
-            logger->error("Failed to get game state for player '" + target_player + "': " + e.what());
+        } else {
+            logger->error("Invalid game state in room '" + room_id + "': " + snapshot.error_message);
         }
+    } catch (const std::exception& e) {
+        logger->error("Failed to get game state in room '" + room_id + "': " + e.what());
     }
     
     logger->info("Returning " + std::to_string(responses.size()) + " messages for game start");
@@ -346,31 +448,61 @@ std::vector<ProtocolMessage> MessageHandler::handlePickupPile(const std::string&
     responses.push_back(turn_result);
     
     // b. Send TURN_UPDATE (delta) to all players
-    std::vector<std::string> room_players = roomManager->getRoomPlayers(room_id);
-
-    for (const std::string& target_player : room_players) {
-        try {
-            GameStateData game_data = gameManager->getGameStateForPlayer(roomManager, room_id, target_player);
-
-            if (game_data.valid) {
-                // Use TURN_UPDATE for normal gameplay (compact delta)
-                ProtocolMessage turn_update = ProtocolHelper::createTurnUpdateResponse(target_player, room_id, game_data);
-                turn_update.player_id = target_player;
-                responses.push_back(turn_update);
-                logger->debug("Added turn update (delta) for player '" + target_player + "'");
-            } else {
-                logger->error("Invalid game state for player '" + target_player + "': " + game_data.error_message);
-            }
-        } catch (const std::exception& e) {
-            logger->error("Failed to get game state for player '" + target_player + "': " + e.what());
-        }
-    }
+    appendTurnUpdates(room_id, responses);
     
     logger->info("Player '" + player_name + "' picked up pile, returning " + std::to_string(responses.size()) + " messages");
     
     return responses;
 }
 
+void MessageHandler::appendTurnUpdates(const std::string& room_id, std::vector<ProtocolMessage>& responses) {
+    try {
+        // One snapshot under one room lock, only the delta encoding differs per player
+        RoomSnapshot snapshot = gameManager->getRoomSnapshot(roomManager, room_id, false);
+
+        if (!snapshot.valid) {
+            logger->error("Invalid game state in room '" + room_id + "': " + snapshot.error_message);
+            return;
+        }
+        trackTurn(room_id, snapshot);
+
+        for (size_t i = 0; i < snapshot.players.size(); ++i) {
+            const std::string& target_player = snapshot.players[i];
+            const TurnUpdateData& update = snapshot.views[i];
+            // Use TURN_UPDATE for normal gameplay (compact delta)
+            ProtocolMessage turn_update = ProtocolHelper::createTurnUpdateResponse(target_player, room_id, update.current, update.previous);
+            turn_update.player_id = target_player;
+            responses.push_back(std::move(turn_update));
+            LOG_DEBUG(logger, "Added turn update (delta) for player '" + target_player + "'");
+        }
+    } catch (const std::exception& e) {
+        logger->error("Failed to get game state in room '" + room_id + "': " + e.what());
+    }
+}
+
+void MessageHandler::trackTurn(const std::string& room_id, const RoomSnapshot& snapshot) {
+    // Every view shows the same current player
+    playerManager->setTurnPlayer(room_id, snapshot.views.empty() ? "" : snapshot.views[0].current.current_player);
+}
+
+std::vector<ProtocolMessage> MessageHandler::handleResync(const std::string& player_name) {
+    std::string room_id = playerManager->getPlayerRoom(player_name);
+    if (room_id.empty()) {
+        return {ProtocolHelper::createErrorResponse("Not in any room")};
+    }
+
+    // Full state also resets the delta baseline, following TURN_UPDATEs continue from its seq
+    GameStateData game_data = gameManager->getGameStateForPlayer(roomManager, room_id, player_name);
+    if (!game_data.valid) {
+        return {ProtocolHelper::createErrorResponse("Cannot resync: " + game_data.error_message)};
+    }
+
+    logger->info("Player '" + player_name + "' requested resync, sending full game state");
+    ProtocolMessage game_state = ProtocolHelper::createGameStateResponse(player_name, room_id, game_data);
+    game_state.player_id = player_name;
+    return {game_state};
+}
+
 std::vector<ProtocolMessage> MessageHandler::handlePlayCards(const ProtocolMessage& msg, const std::string& player_name) {
     // 1. Extract cards from message
     std::string cards_str = MessageParser::extractDataField(msg, "cards");
@@ -384,7 +516,7 @@ std::vector<ProtocolMessage> MessageHandler::handlePlayCards(const ProtocolMessa
     std::string card;
     while (std::getline(ss, card, ',')) {
         cards.push_back(card);
-        logger->debug("Parsed card from message: '" + card + "'");
+        LOG_DEBUG(logger, "Parsed card from message: '" + card + "'");
     }
     
     logger->info("Player '" + player_name + "' attempting to play " + std::to_string(cards.size()) + " cards: " + cards_str);
@@ -418,20 +550,18 @@ std::vector<ProtocolMessage> MessageHandler::handlePlayCards(const ProtocolMessa
         // Get room players before cleanup
         std::vector<std::string> room_players = roomManager->getRoomPlayers(room_id);
         
-        // Send GAME_OVER to both players
-        for (const std::string& target_player : room_players) {
-            ProtocolMessage game_over = ProtocolHelper::createGameOverResponse(winner);
-            game_over.player_id = target_player;
-            game_over.room_id = room_id;
-            responses.push_back(game_over);
-        }
-        
+        // Send GAME_OVER to both players (built once, only header differs per player)
+        ProtocolMessage game_over = ProtocolHelper::createGameOverResponse(winner);
+        game_over.room_id = room_id;
+        game_over.recipients = room_players;
+        responses.push_back(std::move(game_over));
+
         // Send ROOM_LEFT to both players (they're back in lobby)
+        ProtocolMessage room_left = ProtocolHelper::createRoomLeftResponse("");
+        room_left.recipients = room_players;
+        responses.push_back(std::move(room_left));
+
         for (const std::string& target_player : room_players) {
-            ProtocolMessage room_left = ProtocolHelper::createRoomLeftResponse(target_player);
-            room_left.player_id = target_player;
-            responses.push_back(room_left);
-            
             // Clear player's room assignment
             playerManager->clearPlayerRoom(target_player);
         }
@@ -445,25 +575,7 @@ std::vector<ProtocolMessage> MessageHandler::handlePlayCards(const ProtocolMessa
     }
     
     // c. Send TURN_UPDATE (delta) to all players
-    std::vector<std::string> room_players = roomManager->getRoomPlayers(room_id);
-
-    for (const std::string& target_player : room_players) {
-        try {
-            GameStateData game_data = gameManager->getGameStateForPlayer(roomManager, room_id, target_player);
-
-            if (game_data.valid) {
-                // Use TURN_UPDATE for normal gameplay (compact delta)
-                ProtocolMessage turn_update = ProtocolHelper::createTurnUpdateResponse(target_player, room_id, game_data);
-                turn_update.player_id = target_player;
-                responses.push_back(turn_update);
-                logger->debug("Added turn update (delta) for player '" + target_player + "'");
-            } else {
-                logger->error("Invalid game state for player '" + target_player + "': " + game_data.error_message);
-            }
-        } catch (const std::exception& e) {
-            logger->error("Failed to get game state for player '" + target_player + "': " + e.what());
-        }
-    }
+    appendTurnUpdates(room_id, responses);
     
     logger->info("Player '" + player_name + "' played cards, returning " + std::to_string(responses.size()) + " messages");
     
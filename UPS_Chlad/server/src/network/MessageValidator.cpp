@@ -34,34 +34,7 @@ bool MessageValidator::isValidFormat(const std::string& raw_message) {
 
 bool MessageValidator::isValidMessageType(int type_code) {
     // Check if type_code corresponds to a valid MessageType
-    switch (static_cast<MessageType>(type_code)) {
-        case MessageType::CONNECT:
-        case MessageType::DISCONNECT:
-        case MessageType::JOIN_ROOM:
-        case MessageType::LEAVE_ROOM:
-        case MessageType::PING:
-        case MessageType::START_GAME:
-        case MessageType::RECONNECT:
-        case MessageType::PLAY_CARDS:
-        case MessageType::PICKUP_PILE:
-        case MessageType::CONNECTED:
-        case MessageType::ROOM_JOINED:
-        case MessageType::ROOM_LEFT:
-        case MessageType::ERROR_MSG:
-        case MessageType::PONG:
-        case MessageType::GAME_STARTED:
-        case MessageType::GAME_STATE:
-        case MessageType::TURN_UPDATE:
-        case MessageType::PLAYER_DISCONNECTED:
-        case MessageType::GAME_PAUSED:
-        case MessageType::PLAYER_RECONNECTED:
-        case MessageType::GAME_RESUMED:
-        case MessageType::TURN_RESULT:
-        case MessageType::GAME_OVER:
-            return true;
-        default:
-            return false;
-    }
+    return isKnownMessageType(type_code);
 }
 
 bool MessageValidator::isValidMessage(const ProtocolMessage& msg) {
@@ -84,6 +57,9 @@ bool MessageValidator::isValidMessage(const ProtocolMessage& msg) {
         case MessageType::PICKUP_PILE:
             return true;  // No required fields
 
+        case MessageType::RESYNC:
+            return true;  // No required fields
+
         case MessageType::RECONNECT:
             return !msg.player_id.empty();  // Need player_id for reconnect
 
@@ -9,26 +9,103 @@
 #include "network/MessageValidator.h"
 #include "core/Logger.h"
 #include "core/server_config.h"
+#include "core/RoomShardPool.h"
+#include "core/Metrics.h"
+#include "core/Tracing.h"
+#include "network/IoUring.h"
+#include "core/SessionDirectory.h"
+#include "core/Matchmaker.h"
+#include "core/GameJournal.h"
+#include "core/Snapshot.h"
 #include "protocol/ProtocolMessage.h"
+#include "protocol/ProtocolHelper.h"
+#include "protocol/MessageView.h"
 #include <errno.h>
 #include <cstring>
 #include <vector>
+#include <map>
 #include <algorithm>
 #include <fcntl.h>
 #include <chrono>
 #include <sys/socket.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <poll.h>
+#include <netinet/tcp.h>
+
+namespace {
+    // Copy of a message that has to outlive the receive buffer (queued to a shard)
+    std::string ownedMessage(std::string_view line) {
+        return std::string(line);
+    }
+
+    ProtocolMessage ownedMessage(ProtocolMessage&& message) {
+        return std::move(message);
+    }
+
+    // Connections the current thread queued frames for since its outermost WriteBatch opened
+    struct WriteBatchState {
+        int depth = 0;
+        std::vector<std::shared_ptr<Connection>> connections;
+    };
+
+    thread_local WriteBatchState write_batch;
+
+    // io_uring request kinds, top byte of user_data
+    enum class UringRequest : uint8_t {
+        ACCEPT = 1,
+        RECV,
+        WRITABLE,
+        WAKEUP,
+        CANCEL
+    };
+
+    const unsigned URING_ENTRIES = 1024;
+    const uint16_t URING_BUFFER_GROUP = 0;
+    const unsigned URING_BUFFER_COUNT = 512;        // Power of two, 2 MB of provided receive buffers
+
+    uint64_t uringUserData(UringRequest request, uint32_t generation, int fd) {
+        return (static_cast<uint64_t>(request) << 56) | (static_cast<uint64_t>(generation & 0xFFFFFF) << 32)
+               | static_cast<uint32_t>(fd);
+    }
+
+    // Hot restart snapshot: header, connections, then the PlayerManager and RoomManager sections
+    constexpr std::string_view SNAPSHOT_MAGIC = "GHRS";
+    constexpr uint8_t SNAPSHOT_VERSION = 1;
+    constexpr int TAKEOVER_ACK_TIMEOUT_MS = 10000;
+
+    void writeNames(SnapshotWriter& out, const std::vector<std::string>& names) {
+        out.u32(static_cast<uint32_t>(names.size()));
+        for (const std::string& name : names) {
+            out.text(name);
+        }
+    }
+
+    std::vector<std::string> readNames(SnapshotReader& in) {
+        std::vector<std::string> names;
+        uint32_t count = in.u32();
+        for (uint32_t i = 0; i < count && in.ok(); ++i) {
+            names.push_back(in.text());
+        }
+        return names;
+    }
+}
 
 NetworkManager::NetworkManager(PlayerManager* pm, RoomManager* rm, MessageHandler* mh,
                                MessageValidator* mv, Logger* lg, const ServerConfig* cfg,
                                const std::string& ip, int port)
     : server_socket(-1), running(false), server_ip(ip), server_port(port),
       playerManager(pm), roomManager(rm), messageHandler(mh), validator(mv), logger(lg), config(cfg),
-      heartbeat_running(false) {
+      heartbeat_running(false), use_epoll(false), epoll_fd(-1), wakeup_fd(-1), use_uring(false), next_ring_generation(0),
+      directory(nullptr), matchmaker(nullptr), takeover_channel(-1), handed_over(false) {
 
     if (!playerManager || !roomManager || !messageHandler || !validator || !logger || !config) {
         throw std::invalid_argument("NetworkManager: All manager pointers must be non-null");
     }
 
+    use_uring = (config->io_mode == "io_uring");
+    use_epoll = (config->io_mode == "epoll") || use_uring;
+
     logger->info("NetworkManager initialized with IP: " + ip + ", Port: " + std::to_string(port));
 }
 
@@ -37,393 +114,1990 @@ NetworkManager::~NetworkManager() {
         logger->warning("NetworkManager destructor called while still running - forcing stop");
         stop();
     }
-    stopHeartbeatMonitor();
-    cleanup();
-    logger->info("NetworkManager destroyed");
+    stopHeartbeatMonitor();
+    cleanup();
+    logger->info("NetworkManager destroyed");
+}
+
+bool NetworkManager::start() {
+    if (running.load()) {
+        logger->warning("NetworkManager::start() called but server is already running");
+        return false;
+    }
+
+    logger->info("Starting NetworkManager server...");
+
+    // Successor of a hot restart inherits the listening socket instead of binding a new one
+    HotRestart::State inherited;
+    if (config->takeover) {
+        std::string error = "needs hot_restart_socket, io_mode=epoll and no session_directory";
+        if (!supportsHotRestart() || !HotRestart::requestTakeover(config->hot_restart_socket, inherited, error)) {
+            logger->error("Failed to take over the running server: " + error);
+            return false;
+        }
+        server_socket = inherited.listen_socket;
+        inherited.listen_socket = -1;
+    } else if (!setupSocket()) {
+        logger->error("Failed to setup server socket");
+        return false;
+    }
+
+    if (use_uring && !setupUring()) {
+        logger->warning("io_uring backend unavailable, falling back to epoll");
+        use_uring = false;
+    }
+
+    if (use_epoll && !use_uring && !setupEpoll()) {
+        logger->error("Failed to setup epoll reactor");
+        cleanup();
+        return false;
+    }
+
+    // Game actions run on room shards, the reactor thread only does I/O
+    if (use_epoll && config->worker_threads > 0) {
+        shard_pool = std::make_unique<RoomShardPool>(static_cast<size_t>(config->worker_threads));
+        shard_pool->start();
+        logger->info("Room shard pool started with " + std::to_string(config->worker_threads) + " worker threads");
+    }
+
+    running.store(true);
+
+    if (config->takeover && !restoreInheritedState(inherited)) {
+        logger->error("Failed to restore the state of the running server, it keeps serving");
+        HotRestart::discard(inherited);
+        running.store(false);
+        if (shard_pool) {
+            shard_pool->stop();
+        }
+        cleanup();
+        return false;
+    }
+
+    // Sockets handed over by other nodes arrive on the channel thread
+    if (directory) {
+        node_channel = std::make_unique<NodeChannel>(logger);
+        if (!node_channel->start(directory->getName(), directory->getNodeId(),
+                                 [this](int client_socket, Handoff&& handoff) { receiveHandoff(client_socket, std::move(handoff)); })) {
+            logger->warning("Node channel unavailable, other nodes serve clients they would hand over here themselves");
+            node_channel.reset();
+        }
+    }
+
+    // Start heartbeat monitoring
+    startHeartbeatMonitor();
+    if (matchmaker) {
+        matchmaker->start([this](const std::vector<ProtocolMessage>& messages) { deliverMatches(messages); });
+    }
+
+    if (!config->hot_restart_socket.empty()) {
+        if (supportsHotRestart()) {
+            listenForSuccessor();
+        } else {
+            logger->warning("Hot restart needs io_mode=epoll without session_directory, hot_restart_socket ignored");
+        }
+    }
+
+    logger->info("NetworkManager started successfully on " + server_ip + ":" + std::to_string(server_port));
+    return true;
+}
+
+void NetworkManager::run() {
+    if (!running.load()) {
+        logger->error("NetworkManager::run() called but server is not started");
+        return;
+    }
+
+    if (use_uring) {
+        runUringLoop();
+        return;
+    }
+
+    if (use_epoll) {
+        runEpollLoop();
+        return;
+    }
+
+    logger->info("NetworkManager entering main accept loop (threaded mode)");
+
+    struct sockaddr_in client_addr;
+    socklen_t client_addr_len = sizeof(client_addr);
+
+    while (running.load()) {
+        // Accept new client connection
+        int client_socket = accept(server_socket, (struct sockaddr*)&client_addr, &client_addr_len);
+
+        if (client_socket < 0) {
+            if (running.load()) {
+                logger->error("Accept failed: " + std::string(strerror(errno)));
+            }
+            continue;
+        }
+
+        // Refused before a thread is spent on it
+        if (!admitConnection(client_socket, client_addr)) {
+            continue;
+        }
+
+        // Log client connection
+        char client_ip[INET_ADDRSTRLEN];
+        inet_ntop(AF_INET, &client_addr.sin_addr, client_ip, INET_ADDRSTRLEN);
+        logger->info("New client connected from " + std::string(client_ip) + ":" + std::to_string(ntohs(client_addr.sin_port)) + " (socket: " + std::to_string(client_socket) + ")");
+
+        // Registered here so the next admission check already counts it
+        registerConnection(client_socket);
+
+        // Create and detach thread for handling client
+        try {
+            std::thread client_handler(&NetworkManager::handleClient, this, client_socket);
+            client_handler.detach();
+        } catch (const std::exception& e) {
+            logger->error("Failed to create thread for client " + std::to_string(client_socket) + ": " + e.what());
+            {
+                std::lock_guard<std::mutex> lock(connections_mutex);
+                connections.erase(client_socket);
+            }
+            close(client_socket);
+        }
+    }
+
+    logger->info("NetworkManager exiting main accept loop");
+}
+
+void NetworkManager::stop() {
+    if (!running.load()) {
+        logger->warning("NetworkManager::stop() called but server is not running");
+        return;
+    }
+
+    logger->info("Stopping NetworkManager...");
+    running.store(false);
+
+    // Stop heartbeat monitoring first
+    stopHeartbeatMonitor();
+
+    if (hot_restart) {
+        hot_restart->stop();
+    }
+
+    // No more sockets from other nodes
+    if (node_channel) {
+        node_channel->stop();
+    }
+
+    // Finish messages already handed to room shards
+    if (shard_pool) {
+        shard_pool->stop();
+    }
+    // Players still queued get their rooms while their connections are open
+    if (matchmaker) {
+        matchmaker->stop();
+    }
+
+    // Wake up epoll reactor (it closes the listening socket itself)
+    if (use_epoll && wakeup_fd >= 0) {
+        uint64_t one = 1;
+        if (write(wakeup_fd, &one, sizeof(one)) < 0) {
+            logger->warning("Failed to wake up epoll reactor: " + std::string(strerror(errno)));
+        }
+    }
+
+    // Close server socket to break accept() loop
+    if (!use_epoll && server_socket >= 0) {
+        LOG_DEBUG(logger, "Closing server socket to break accept loop");
+        shutdown(server_socket, SHUT_RDWR);
+        close(server_socket);
+        server_socket = -1;
+    }
+
+    cleanup();
+    logger->info("NetworkManager stopped");
+}
+
+bool NetworkManager::setupSocket() {
+    // Create TCP socket
+    server_socket = socket(AF_INET, SOCK_STREAM, 0);
+    if (server_socket < 0) {
+        logger->error("Failed to create socket: " + std::string(strerror(errno)));
+        return false;
+    }
+
+    // Set socket options for reuse
+    int opt = 1;
+    if (setsockopt(server_socket, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) < 0) {
+        logger->error("Failed to set SO_REUSEADDR: " + std::string(strerror(errno)));
+        close(server_socket);
+        server_socket = -1;
+        return false;
+    }
+
+    // Several nodes listen on the same port, the kernel spreads new connections between them
+    if (config->reuse_port && setsockopt(server_socket, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) < 0) {
+        logger->error("Failed to set SO_REUSEPORT: " + std::string(strerror(errno)));
+        close(server_socket);
+        server_socket = -1;
+        return false;
+    }
+
+    // Setup server address
+    struct sockaddr_in server_addr;
+    memset(&server_addr, 0, sizeof(server_addr));
+    server_addr.sin_family = AF_INET;
+    server_addr.sin_port = htons(server_port);
+
+    if (inet_pton(AF_INET, server_ip.c_str(), &server_addr.sin_addr) <= 0) {
+        logger->error("Invalid IP address: " + server_ip);
+        close(server_socket);
+        server_socket = -1;
+        return false;
+    }
+
+    // Bind socket
+    if (bind(server_socket, (struct sockaddr*)&server_addr, sizeof(server_addr)) < 0) {
+        logger->error("Failed to bind socket to " + server_ip + ":" + std::to_string(server_port) + ": " + std::string(strerror(errno)));
+        close(server_socket);
+        server_socket = -1;
+        return false;
+    }
+
+    // Start listening
+    const int backlog = 128;
+    if (listen(server_socket, backlog) < 0) {
+        logger->error("Failed to listen on socket: " + std::string(strerror(errno)));
+        close(server_socket);
+        server_socket = -1;
+        return false;
+    }
+
+    logger->info("Socket setup complete - listening on " + server_ip + ":" + std::to_string(server_port));
+    return true;
+}
+
+bool NetworkManager::receiveInto(Connection& conn, ssize_t& bytes_received) {
+    ReceiveBuffer& buffer = conn.read_buffer;
+    char* target = buffer.prepareWrite(RECEIVE_CHUNK_SIZE);
+    bytes_received = recv(conn.fd, target, buffer.writableSize(), 0);
+    if (bytes_received <= 0) {
+        return false;
+    }
+    buffer.commit(static_cast<size_t>(bytes_received));
+    Metrics::add(Metrics::Counter::BYTES_IN, static_cast<uint64_t>(bytes_received));
+    return true;
+}
+
+template <typename Dispatch>
+bool NetworkManager::extractMessages(Connection& conn, Dispatch&& dispatch) {
+    ReceiveBuffer& buffer = conn.read_buffer;
+    bool keep_open = true;
+    while (keep_open && !buffer.empty()) {
+        if (conn.binary_input.load()) {
+            size_t consumed = 0;
+            ProtocolMessage message;
+            BinaryDecoder::Status status = conn.decoder.decode(buffer.unread(), consumed, message);
+            if (status == BinaryDecoder::Status::INCOMPLETE) {
+                break;
+            }
+            if (status == BinaryDecoder::Status::INVALID) {
+                logger->warning("Malformed binary frame from client " + std::to_string(conn.fd) + ", disconnecting");
+                return false;
+            }
+            buffer.consume(consumed);
+            keep_open = dispatch(std::move(message));
+        } else {
+            std::string_view complete_message;
+            if (!buffer.nextLine(complete_message)) {
+                break;
+            }
+            if (complete_message.size() > MAX_MESSAGE_SIZE) {
+                logger->warning("Message too large from client " + std::to_string(conn.fd) + ", disconnecting");
+                return false;
+            }
+            keep_open = dispatch(complete_message);
+        }
+    }
+
+    // Limit applies to one frame - any number of complete messages may arrive in a single read
+    if (keep_open && buffer.size() > MAX_MESSAGE_SIZE) {
+        logger->warning("Message too large from client " + std::to_string(conn.fd) + ", disconnecting");
+        return false;
+    }
+    return keep_open;
+}
+
+void NetworkManager::handleClient(int client_socket) {
+    LOG_DEBUG(logger, "Client handler started for socket " + std::to_string(client_socket));
+    std::shared_ptr<Connection> client_conn = findConnection(client_socket);
+    if (!client_conn) {
+        client_conn = registerConnection(client_socket);
+    }
+
+    // Non-blocking socket so senders on other threads never stall on this client
+    int flags = fcntl(client_socket, F_GETFL, 0);
+    if (flags < 0 || fcntl(client_socket, F_SETFL, flags | O_NONBLOCK) < 0) {
+        logger->warning("Failed to set client socket " + std::to_string(client_socket) + " non-blocking: " + std::string(strerror(errno)));
+    }
+
+    // Other threads signal it when they leave bytes queued, so poll() can block until there is work
+    int wakeup = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeup < 0) {
+        logger->warning("Failed to create wakeup eventfd for client " + std::to_string(client_socket) + ": " + std::string(strerror(errno)));
+    } else {
+        std::lock_guard<std::mutex> lock(client_conn->write_mutex);
+        client_conn->wakeup_fd = wakeup;
+    }
+
+    // Process complete messages (text lines or binary frames), their responses leave in one write per socket
+    bool disconnect_handled = false;
+    bool handed_off = false;
+    auto processBuffered = [&]() {
+        WriteBatch batch(*this);
+        return extractMessages(*client_conn, [&](const auto& complete_message) {
+            Admission admission = admitMessage(*client_conn);
+            if (admission != Admission::ACCEPT) {
+                return admission == Admission::REJECT;  // Flooding client gets the regular disconnect cleanup
+            }
+            if (handOffConnection(client_conn, complete_message)) {
+                handed_off = true;  // Socket is closed already, another node serves the client now
+                return false;
+            }
+            disconnect_handled = !processClientMessage(client_socket, complete_message);
+            return !disconnect_handled;
+        });
+    };
+
+    try {
+        // Connections adopted from another node arrive with bytes already read
+        bool keep_open = client_conn->read_buffer.empty() || processBuffered();
+
+        while (keep_open && running.load()) {
+            // Wait for input, for writability while outbound queue holds data and for the wakeup
+            struct pollfd pfds[2];
+            struct pollfd& pfd = pfds[0];
+            pfd.fd = client_socket;
+            pfd.events = POLLIN;
+            pfd.revents = 0;
+            pfds[1].fd = wakeup;
+            pfds[1].events = POLLIN;
+            pfds[1].revents = 0;
+            {
+                std::lock_guard<std::mutex> lock(client_conn->write_mutex);
+                client_conn->polling_writable = !client_conn->outbound.empty();
+                if (client_conn->polling_writable) {
+                    pfd.events |= POLLOUT;
+                }
+            }
+
+            // Without the eventfd a short timeout has to notice data queued by other threads after poll() started
+            const int FALLBACK_POLL_INTERVAL_MS = 50;
+            int ready = wakeup >= 0 ? poll(pfds, 2, -1) : poll(&pfd, 1, FALLBACK_POLL_INTERVAL_MS);
+            if (ready < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                logger->warning("poll() failed for client " + std::to_string(client_socket) + ": " + std::string(strerror(errno)));
+                break;
+            }
+
+            if (wakeup >= 0 && (pfds[1].revents & POLLIN)) {
+                uint64_t value;
+                while (read(wakeup, &value, sizeof(value)) > 0) {}
+            }
+
+            if (pfd.revents & POLLOUT) {
+                std::lock_guard<std::mutex> lock(client_conn->write_mutex);
+                flushConnection(*client_conn);
+            }
+
+            if (!(pfd.revents & (POLLIN | POLLHUP | POLLERR))) {
+                continue;
+            }
+
+            // One trace per read, covers parsing, game logic and the responses it sends
+            Tracing::Trace trace("NetworkManager::handleClient");
+
+            // Receive data from client straight into its receive buffer
+            ssize_t bytes_received = 0;
+            receiveInto(*client_conn, bytes_received);
+
+            LOG_DEBUG(logger, "recv() returned: " + std::to_string(bytes_received) + " bytes for socket " + std::to_string(client_socket));
+
+            if (bytes_received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+                continue;
+            }
+
+            if (bytes_received <= 0) {
+                if (bytes_received == 0) {
+                    logger->info("Client " + std::to_string(client_socket) + " disconnected gracefully");
+                } else {
+                    logger->warning("Receive error from client " + std::to_string(client_socket) + ": " + std::string(strerror(errno)));
+                }
+                break;
+            }
+
+            // Malformed binary frame or oversized message ends the loop too, regular disconnect cleanup
+            keep_open = processBuffered();
+        }
+    } catch (const std::exception& e) {
+        logger->error("Exception in client handler for socket " + std::to_string(client_socket) + ": " + e.what());
+    }
+
+    if (wakeup >= 0) {
+        {
+            std::lock_guard<std::mutex> lock(client_conn->write_mutex);
+            client_conn->wakeup_fd = -1;
+        }
+        close(wakeup);
+    }
+
+    if (handed_off) {
+        LOG_DEBUG(logger, "Client handler finished for socket " + std::to_string(client_socket) + " (handed off)");
+        return;
+    }
+
+    if (disconnect_handled) {
+        // Close socket and exit
+        {
+            std::lock_guard<std::mutex> map_lock(connections_mutex);
+            connections.erase(client_socket);
+        }
+        {
+            std::lock_guard<std::mutex> lock(client_conn->write_mutex);
+            client_conn->closed = true;
+        }
+        shutdown(client_socket, SHUT_RDWR);
+        close(client_socket);
+        return;  // Exit handleClient immediately
+    }
+
+    // Cleanup after client disconnects
+    logger->info("Client " + std::to_string(client_socket) + " disconnected, waiting for 6-second timeout");
+    handleClientDisconnect(client_socket, "socket_closed");
+
+    std::shared_ptr<Connection> conn = findConnection(client_socket);
+    {
+        std::lock_guard<std::mutex> map_lock(connections_mutex);
+        connections.erase(client_socket);
+    }
+    if (conn) {
+        std::lock_guard<std::mutex> lock(conn->write_mutex);
+        conn->closed = true;
+    }
+
+    // Close the socket
+    if (close(client_socket) < 0) {
+        logger->warning("Error closing client socket " + std::to_string(client_socket) + ": " + std::string(strerror(errno)));
+    }
+
+    LOG_DEBUG(logger, "Client handler finished for socket " + std::to_string(client_socket));
+}
+
+bool NetworkManager::processClientMessage(int client_socket, std::string_view complete_message) {
+    // Remove carriage return if present
+    if (!complete_message.empty() && complete_message.back() == '\r') {
+        complete_message.remove_suffix(1);
+    }
+
+    LOG_DEBUG(logger, "Processing complete message: '" + std::string(complete_message) + "'");
+
+    if (complete_message.empty()) {
+        return true;
+    }
+
+    LOG_DEBUG(logger, "Received message from client " + std::to_string(client_socket) + ": " + std::string(complete_message));
+
+    // Process message through MessageHandler - NOW RETURNS VECTOR
+    WriteBatch batch(*this);
+    try {
+        // Reused per thread, keeps its capacity between messages
+        thread_local std::vector<ProtocolMessage> responses;
+        messageHandler->processMessage(complete_message, client_socket, responses);
+        return deliverResponses(client_socket, responses);
+    } catch (const std::exception& e) {
+        logger->error("Error processing message from client " + std::to_string(client_socket) + ": " + e.what());
+
+        // Send error response
+        ProtocolMessage error_response(MessageType::ERROR_MSG);
+        error_response.setData("message", "Internal server error");
+        sendMessage(client_socket, error_response);
+    }
+
+    return true;
+}
+
+bool NetworkManager::processClientMessage(int client_socket, const ProtocolMessage& message) {
+    LOG_DEBUG(logger, "Received binary message type " + std::to_string(static_cast<int>(message.getType())) + " from client " + std::to_string(client_socket));
+
+    WriteBatch batch(*this);
+    try {
+        thread_local std::vector<ProtocolMessage> responses;
+        messageHandler->processMessage(message, client_socket, responses);
+        return deliverResponses(client_socket, responses);
+    } catch (const std::exception& e) {
+        logger->error("Error processing message from client " + std::to_string(client_socket) + ": " + e.what());
+
+        ProtocolMessage error_response(MessageType::ERROR_MSG);
+        error_response.setData("message", "Internal server error");
+        sendMessage(client_socket, error_response);
+    }
+
+    return true;
+}
+
+void NetworkManager::deliverMatches(const std::vector<ProtocolMessage>& messages) {
+    WriteBatch batch(*this);
+    deliverResponses(-1, messages);     // Every message names its player, none goes to a requesting socket
+}
+
+bool NetworkManager::deliverResponses(int client_socket, const std::vector<ProtocolMessage>& responses) {
+    LOG_DEBUG(logger, "MessageHandler returned " + std::to_string(responses.size()) + " response(s)");
+
+    // Process each response
+    for (const ProtocolMessage& response : responses) {
+        LOG_DEBUG(logger, "Processing response type: " + std::to_string(static_cast<int>(response.getType())));
+        
+        if (response.should_broadcast_to_room) {
+            // Handle broadcast messages
+            std::string room_id = response.getRoomId();
+            
+            if (!room_id.empty()) {
+                std::string player_name = playerManager->getPlayerIdFromSocket(client_socket);
+                
+                // STEP 1: Send original response to requesting client
+                if (sendMessage(client_socket, response)) {
+                    LOG_DEBUG(logger, "Sent response to requesting client " + std::to_string(client_socket));
+                } else {
+                    logger->error("Failed to send response to requesting client " + std::to_string(client_socket));
+                }
+                
+                // STEP 2: Broadcast modified version to OTHER players (exclude sender)
+                LOG_DEBUG(logger, "Broadcasting to room " + room_id + " (excluding " + player_name + ")");
+
+                // Notification fields are merged while serializing, the response itself is not copied
+                std::map<std::string, std::string> notification;
+                notification["broadcast_type"] = "room_notification";
+
+                // Add context about who triggered the action
+                if (response.getType() == MessageType::ROOM_JOINED) {
+                    notification["joined_player"] = player_name;
+
+                    // Update broadcast with CURRENT room state (not stale snapshot)
+                    std::vector<std::string> current_players = roomManager->getRoomPlayers(room_id);
+                    std::string players_list;
+                    for (size_t i = 0; i < current_players.size(); ++i) {
+                        if (i > 0) players_list += ",";
+                        players_list += current_players[i];
+                    }
+                    notification["players"] = players_list;
+                    notification["player_count"] = std::to_string(current_players.size());
+                    notification["room_full"] = (current_players.size() >= 2) ? "true" : "false";
+                }
+
+                std::string broadcast_msg;
+                {
+                    Tracing::Span serialize("serialize");
+                    response.serializeTo(broadcast_msg, notification);
+                }
+                broadcastFrame(room_id, response, &notification, makeEncodedFrame(std::move(broadcast_msg)), player_name);
+            } else {
+                logger->warning("Broadcast flagged but no room_id in response");
+            }
+            
+        } else if (!response.recipients.empty()) {
+            // Same message for several players, serialized once
+            sendToRecipients(response);
+
+        } else if (!response.player_id.empty()) {
+            // Message targeted at specific player (not the sender)
+            LOG_DEBUG(logger, "Sending targeted message to player '" + response.player_id + "'");
+            
+            auto player_opt = playerManager->getPlayer(response.player_id);
+            
+            if (player_opt.has_value() && player_opt->connected && player_opt->socket_fd != -1) {
+                int target_socket = player_opt->socket_fd;
+                
+                if (sendMessage(target_socket, response)) {
+                    LOG_DEBUG(logger, "Sent targeted message to player '" + response.player_id + "' on socket " + std::to_string(target_socket));
+                } else {
+                    logger->error("Failed to send targeted message to player '" + response.player_id + "'");
+                }
+            } else {
+                logger->warning("Cannot send to player '" + response.player_id + "' - disconnected or invalid socket");
+            }
+            
+        } else {
+            // Regular response to the requesting client
+            if (!sendMessage(client_socket, response)) {
+                logger->error("Failed to send response to client " + std::to_string(client_socket));
+                break;
+            }
+            LOG_DEBUG(logger, "Sent response type " + std::to_string(static_cast<int>(response.getType())) + " to client " + std::to_string(client_socket));
+        }
+        
+        // Check if client should be disconnected
+        if (response.hasData("disconnect") && response.getData("disconnect") == "true") {
+            logger->info("Disconnecting client " + std::to_string(client_socket) + " due to invalid message");
+
+            // Mark socket as disconnected (6-second timeout will apply before reconnection window)
+            handleClientDisconnect(client_socket, "invalid_message");
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void NetworkManager::handleClientDisconnect(int client_socket, const std::string& status) {
+    // Get player name before removing socket mapping
+    std::string disconnected_player = playerManager->getPlayerIdFromSocket(client_socket);
+    if (!disconnected_player.empty()) {
+        // Get room before marking disconnected
+        std::string room_id = playerManager->getPlayerRoom(disconnected_player);
+
+        // Mark socket as disconnected (6-second timeout will apply before reconnection window)
+        playerManager->markSocketDisconnected(disconnected_player);
+
+        // Broadcast disconnection to room
+        if (!room_id.empty()) {
+            ProtocolMessage disconnect_broadcast(MessageType::PLAYER_DISCONNECTED);
+            disconnect_broadcast.player_id = disconnected_player;
+            disconnect_broadcast.room_id = room_id;
+            disconnect_broadcast.setData("disconnected_player", disconnected_player);
+            disconnect_broadcast.setData("status", status);
+
+            broadcastToRoom(room_id, disconnect_broadcast, disconnected_player);
+        }
+    } else {
+        LOG_DEBUG(logger, "No player found for disconnected socket " + std::to_string(client_socket));
+    }
+
+    // Remove socket mapping
+    playerManager->removeSocketMapping(client_socket);
+}
+
+bool NetworkManager::admitConnection(int client_socket, const sockaddr_in& client_addr) {
+    // Addresses whose bucket refilled are forgotten, past this many the table is reset rather than scanned on every accept
+    const size_t MAX_TRACKED_ADDRESSES = 4096;
+
+    const char* refusal_reason = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(connections_mutex);
+        if (connections.size() >= static_cast<size_t>(config->max_clients)) {
+            refusal_reason = "Server is full, try again later";
+        }
+    }
+
+    if (!refusal_reason && config->accept_rate_per_ip > 0) {
+        auto now = std::chrono::steady_clock::now();
+        if (accept_buckets.size() >= MAX_TRACKED_ADDRESSES) {
+            for (auto it = accept_buckets.begin(); it != accept_buckets.end();) {
+                it = it->second.isFull(now) ? accept_buckets.erase(it) : std::next(it);
+            }
+            if (accept_buckets.size() >= MAX_TRACKED_ADDRESSES) {
+                accept_buckets.clear();
+            }
+        }
+        auto bucket = accept_buckets.try_emplace(client_addr.sin_addr.s_addr,
+                                                 static_cast<double>(config->accept_rate_per_ip),
+                                                 static_cast<double>(config->accept_burst_per_ip)).first;
+        if (!bucket->second.take(now)) {
+            refusal_reason = "Too many connections from your address, try again later";
+        }
+    }
+
+    if (!refusal_reason) {
+        return true;
+    }
+
+    Metrics::add(Metrics::Counter::REJECTED_CONNECTIONS);
+    LOG_DEBUG(logger, "Refused connection on socket " + std::to_string(client_socket) + ": " + refusal_reason);
+
+    // Best effort notice, the socket is new so the line fits into its send buffer
+    std::string frame;
+    ProtocolHelper::createErrorResponse(refusal_reason).serializeTo(frame);
+    send(client_socket, frame.data(), frame.size(), MSG_NOSIGNAL | MSG_DONTWAIT);
+    close(client_socket);
+    return false;
+}
+
+NetworkManager::Admission NetworkManager::admitMessage(Connection& conn) {
+    if (conn.message_bucket.take(std::chrono::steady_clock::now())) {
+        conn.rate_strikes = 0;
+        return Admission::ACCEPT;
+    }
+
+    Metrics::add(Metrics::Counter::RATE_LIMITED_MESSAGES);
+    if (++conn.rate_strikes >= config->rate_limit_strikes) {
+        logger->warning("Client " + std::to_string(conn.fd) + " exceeded message rate limit, disconnecting");
+        return Admission::DISCONNECT;
+    }
+    sendMessage(conn.fd, ProtocolHelper::createErrorResponse("Too many messages, slow down"));
+    return Admission::REJECT;
+}
+
+std::shared_ptr<Connection> NetworkManager::registerConnection(int client_socket) {
+    if (config->tcp_nodelay) {
+        // Responses are already coalesced into one write per socket, Nagle would only hold them back
+        int one = 1;
+        if (setsockopt(client_socket, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one)) < 0) {
+            logger->warning("Failed to set TCP_NODELAY on socket " + std::to_string(client_socket) + ": " + std::string(strerror(errno)));
+        }
+    }
+
+    auto conn = std::make_shared<Connection>(client_socket);
+    conn->message_bucket = TokenBucket(static_cast<double>(config->client_message_rate),
+                                       static_cast<double>(config->client_message_burst));
+    std::lock_guard<std::mutex> lock(connections_mutex);
+    connections[client_socket] = conn;
+    return conn;
+}
+
+std::shared_ptr<Connection> NetworkManager::findConnection(int client_socket) {
+    std::lock_guard<std::mutex> lock(connections_mutex);
+    auto it = connections.find(client_socket);
+    return (it != connections.end()) ? it->second : nullptr;
+}
+
+NetworkManager::WriteBatch::WriteBatch(NetworkManager& owner) : manager(owner) {
+    write_batch.depth++;
+}
+
+NetworkManager::WriteBatch::~WriteBatch() {
+    if (--write_batch.depth == 0) {
+        manager.flushWriteBatch();
+    }
+}
+
+bool NetworkManager::joinWriteBatch(const std::shared_ptr<Connection>& conn) {
+    if (write_batch.depth == 0) {
+        return false;
+    }
+    // A batch touches the requester and its room, a linear search is cheaper than any set
+    if (std::find(write_batch.connections.begin(), write_batch.connections.end(), conn) == write_batch.connections.end()) {
+        write_batch.connections.push_back(conn);
+    }
+    return true;
+}
+
+void NetworkManager::flushWriteBatch() {
+    for (const auto& conn : write_batch.connections) {
+        std::lock_guard<std::mutex> lock(conn->write_mutex);
+        if (!conn->closed && !conn->outbound.empty()) {
+            flushConnection(*conn);
+        }
+    }
+    write_batch.connections.clear();
+}
+
+bool NetworkManager::writeToConnection(const std::shared_ptr<Connection>& conn, std::string_view data) {
+    if (joinWriteBatch(conn)) {
+        conn->outbound.push(std::string(data));
+        return true;
+    }
+
+    // Write what the socket accepts now, rest is queued and flushed once writable (EPOLLOUT / POLLOUT)
+    bool partial_write = false;
+    OutboundQueue::FlushResult result = conn->outbound.write(conn->fd, data, partial_write);
+    return handleFlushResult(*conn, result, partial_write);
+}
+
+bool NetworkManager::sendFrame(int client_socket, std::string_view head, const EncodedFrame& body, const FrameSource& source) {
+    std::shared_ptr<Connection> conn = findConnection(client_socket);
+    if (!conn) {
+        LOG_DEBUG(logger, "sendFrame: socket " + std::to_string(client_socket) + " is not registered");
+        Metrics::add(Metrics::Counter::SEND_FAILURES);
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(conn->write_mutex);
+    if (conn->closed) {
+        Metrics::add(Metrics::Counter::SEND_FAILURES);
+        return false;
+    }
+
+    if (conn->binary_output) {
+        // Intern table is per connection, binary recipients can't share one encoded body
+        thread_local std::string binary_frame;
+        binary_frame.clear();
+        conn->encoder.encode(source.message, source.header_player_id, source.extra_data, binary_frame);
+        return writeToConnection(conn, binary_frame);
+    }
+
+    if (joinWriteBatch(conn)) {
+        if (!head.empty()) {
+            conn->outbound.push(std::string(head));
+        }
+        conn->outbound.push(body);  // Shared body stays one copy for the whole room
+        return true;
+    }
+
+    bool partial_write = false;
+    OutboundQueue::FlushResult result = conn->outbound.write(conn->fd, head, body, partial_write);
+    return handleFlushResult(*conn, result, partial_write);
+}
+
+void NetworkManager::sendToRecipients(const ProtocolMessage& message) {
+    std::string body;
+    message.serializeBodyTo(body);
+    EncodedFrame body_frame = makeEncodedFrame(std::move(body));
+
+    std::vector<int> sockets = playerManager->resolvePlayerSockets(message.recipients);
+    std::string header;
+    for (size_t i = 0; i < message.recipients.size(); ++i) {
+        const std::string& recipient = message.recipients[i];
+        if (sockets[i] == -1) {
+            logger->warning("Cannot send to player '" + recipient + "' - disconnected or invalid socket");
+            continue;
+        }
+
+        header.clear();
+        message.serializeHeaderTo(header, recipient);
+        if (sendFrame(sockets[i], header, body_frame, FrameSource{message, recipient, nullptr})) {
+            LOG_DEBUG(logger, "Sent message type " + std::to_string(static_cast<int>(message.getType())) + " to player '" + recipient + "'");
+        } else {
+            logger->error("Failed to send message to player '" + recipient + "'");
+        }
+    }
+}
+
+bool NetworkManager::sendMessage(int client_socket, const ProtocolMessage& message) {
+    std::shared_ptr<Connection> conn = findConnection(client_socket);
+    if (!conn) {
+        LOG_DEBUG(logger, "sendMessage: socket " + std::to_string(client_socket) + " is not registered");
+        Metrics::add(Metrics::Counter::SEND_FAILURES);
+        return false;
+    }
+
+    // CONNECTED acknowledging binary=true is the last text frame of the connection
+    bool switch_to_binary = message.getType() == MessageType::CONNECTED && message.getData("binary") == "true";
+
+    std::lock_guard<std::mutex> lock(conn->write_mutex);
+    if (conn->closed) {
+        Metrics::add(Metrics::Counter::SEND_FAILURES);
+        return false;
+    }
+
+    thread_local std::string frame;
+    frame.clear();
+    std::string_view data;
+    {
+        Tracing::Span serialize("serialize");
+        if (conn->binary_output) {
+            conn->encoder.encode(message, message.player_id, nullptr, frame);
+            data = frame;
+        } else {
+            data = ProtocolHelper::prerenderedFrame(message);
+            if (data.empty()) {
+                message.serializeTo(frame);
+                data = frame;
+            }
+        }
+    }
+
+    if (switch_to_binary && !conn->binary_output) {
+        // Reader has to expect frames before the client can see CONNECTED and start sending them
+        conn->binary_input.store(true);
+        conn->binary_output = true;
+        logger->info("Client " + std::to_string(client_socket) + " switched to binary protocol");
+    }
+    return writeToConnection(conn, data);
+}
+
+OutboundStats NetworkManager::getOutboundStats() {
+    std::vector<std::shared_ptr<Connection>> snapshot;
+    {
+        std::lock_guard<std::mutex> lock(connections_mutex);
+        snapshot.reserve(connections.size());
+        for (const auto& pair : connections) {
+            snapshot.push_back(pair.second);
+        }
+    }
+
+    OutboundStats stats;
+    stats.connections = snapshot.size();
+    for (const auto& conn : snapshot) {
+        std::lock_guard<std::mutex> lock(conn->write_mutex);
+        size_t depth = conn->outbound.pendingBytes();
+        stats.queued_bytes += depth;
+        stats.max_queued_bytes = std::max(stats.max_queued_bytes, depth);
+    }
+    stats.partial_writes = Metrics::total(Metrics::Counter::PARTIAL_WRITES);
+    stats.slow_disconnects = Metrics::total(Metrics::Counter::SLOW_DISCONNECTS);
+    return stats;
+}
+
+void NetworkManager::checkSlowClients() {
+    std::vector<std::shared_ptr<Connection>> snapshot;
+    {
+        std::lock_guard<std::mutex> lock(connections_mutex);
+        for (const auto& pair : connections) {
+            snapshot.push_back(pair.second);
+        }
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    auto grace = std::chrono::milliseconds(config->slow_client_grace_ms);
+    for (const auto& conn : snapshot) {
+        std::lock_guard<std::mutex> lock(conn->write_mutex);
+        if (!conn->closed && conn->over_high_water && now - conn->over_high_water_since > grace) {
+            dropSlowClient(*conn);
+        }
+    }
+}
+
+void NetworkManager::dropSlowClient(Connection& conn) {
+    logger->warning("Client " + std::to_string(conn.fd) + " stayed above outbound high-water mark ("
+                    + std::to_string(conn.outbound.pendingBytes()) + " bytes queued), disconnecting");
+    Metrics::add(Metrics::Counter::SLOW_DISCONNECTS);
+    conn.outbound.clear();
+    conn.over_high_water = false;
+    conn.dropped.store(true);
+    // Owner thread / reactor sees the shutdown as hangup and runs regular disconnect cleanup
+    shutdown(conn.fd, SHUT_RDWR);
+}
+
+bool NetworkManager::setupEpoll() {
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd < 0) {
+        logger->error("Failed to create epoll instance: " + std::string(strerror(errno)));
+        return false;
+    }
+
+    wakeup_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeup_fd < 0) {
+        logger->error("Failed to create wakeup eventfd: " + std::string(strerror(errno)));
+        close(epoll_fd);
+        epoll_fd = -1;
+        return false;
+    }
+
+    // Listening socket must not block accept() once all pending connections were taken
+    int flags = fcntl(server_socket, F_GETFL, 0);
+    if (flags < 0 || fcntl(server_socket, F_SETFL, flags | O_NONBLOCK) < 0) {
+        logger->error("Failed to set listening socket non-blocking: " + std::string(strerror(errno)));
+        return false;
+    }
+
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN | EPOLLET;
+    ev.data.fd = server_socket;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, server_socket, &ev) < 0) {
+        logger->error("Failed to register listening socket with epoll: " + std::string(strerror(errno)));
+        return false;
+    }
+
+    ev.events = EPOLLIN;
+    ev.data.fd = wakeup_fd;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wakeup_fd, &ev) < 0) {
+        logger->error("Failed to register wakeup eventfd with epoll: " + std::string(strerror(errno)));
+        return false;
+    }
+
+    logger->info("Epoll reactor initialized (edge-triggered)");
+    return true;
+}
+
+void NetworkManager::runEpollLoop() {
+    logger->info("NetworkManager entering epoll reactor loop");
+    Tracing::nameThread("reactor");
+
+    const int MAX_EVENTS = 256;
+    struct epoll_event events[MAX_EVENTS];
+
+    while (running.load()) {
+        int ready = epoll_wait(epoll_fd, events, MAX_EVENTS, -1);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            logger->error("epoll_wait failed: " + std::string(strerror(errno)));
+            break;
+        }
+
+        for (int i = 0; i < ready; ++i) {
+            int fd = events[i].data.fd;
+            uint32_t ev = events[i].events;
+
+            if (fd == wakeup_fd) {
+                uint64_t value;
+                while (read(wakeup_fd, &value, sizeof(value)) > 0) {}
+                closePendingClients();
+                adoptHandoffs();
+                int channel_socket = takeover_channel.exchange(-1);
+                if (channel_socket >= 0) {
+                    handOverServer(channel_socket);
+                    if (handed_over.load()) {
+                        break;  // Remaining events belong to sockets that are not ours any more
+                    }
+                }
+                continue;
+            }
+
+            if (fd == server_socket) {
+                acceptEpollClients();
+                continue;
+            }
+
+            std::shared_ptr<Connection> conn = findConnection(fd);
+            if (!conn || conn->closing) {
+                continue;  // Closed earlier in this batch or close pending on its shard
+            }
+
+            bool keep_open = true;
+
+            if (ev & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+                keep_open = readEpollClient(conn);
+            }
+
+            if (keep_open && (ev & EPOLLOUT)) {
+                std::lock_guard<std::mutex> lock(conn->write_mutex);
+                if (!conn->closed && !conn->outbound.empty()) {
+                    keep_open = flushConnection(*conn);
+                }
+            }
+
+            if (!keep_open) {
+                finishEpollClient(conn);
+            }
+        }
+    }
+
+    // Close every client still attached to the reactor
+    closePendingClients();
+    std::vector<std::shared_ptr<Connection>> remaining;
+    {
+        std::lock_guard<std::mutex> lock(connections_mutex);
+        for (const auto& pair : connections) {
+            remaining.push_back(pair.second);
+        }
+    }
+    for (const auto& conn : remaining) {
+        closeEpollClient(conn);
+    }
+
+    if (server_socket >= 0) {
+        close(server_socket);
+        server_socket = -1;
+    }
+    if (wakeup_fd >= 0) {
+        close(wakeup_fd);
+        wakeup_fd = -1;
+    }
+    if (epoll_fd >= 0) {
+        close(epoll_fd);
+        epoll_fd = -1;
+    }
+
+    logger->info("NetworkManager exiting epoll reactor loop");
+}
+
+void NetworkManager::acceptEpollClients() {
+    while (running.load()) {
+        struct sockaddr_in client_addr;
+        socklen_t client_addr_len = sizeof(client_addr);
+
+        int client_socket = accept4(server_socket, (struct sockaddr*)&client_addr, &client_addr_len,
+                                    SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (client_socket < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return;  // All pending connections accepted
+            }
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            logger->error("Accept failed: " + std::string(strerror(errno)));
+            return;
+        }
+
+        if (!admitConnection(client_socket, client_addr)) {
+            continue;
+        }
+
+        // Log client connection
+        char client_ip[INET_ADDRSTRLEN];
+        inet_ntop(AF_INET, &client_addr.sin_addr, client_ip, INET_ADDRSTRLEN);
+        logger->info("New client connected from " + std::string(client_ip) + ":" + std::to_string(ntohs(client_addr.sin_port)) + " (socket: " + std::to_string(client_socket) + ")");
+
+        registerConnection(client_socket);
+
+        struct epoll_event ev;
+        memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+        ev.data.fd = client_socket;
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, client_socket, &ev) < 0) {
+            logger->error("Failed to register client " + std::to_string(client_socket) + " with epoll: " + std::string(strerror(errno)));
+            std::lock_guard<std::mutex> lock(connections_mutex);
+            connections.erase(client_socket);
+            close(client_socket);
+        }
+    }
+}
+
+bool NetworkManager::readEpollClient(const std::shared_ptr<Connection>& conn) {
+    int client_socket = conn->fd;
+
+    // Edge-triggered: drain the socket completely
+    while (!conn->disconnect_requested.load()) {
+        ssize_t bytes_received = 0;
+        receiveInto(*conn, bytes_received);
+
+        if (bytes_received < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return true;  // Everything read for now
+            }
+            if (errno == EINTR) {
+                continue;
+            }
+            logger->warning("Receive error from client " + std::to_string(client_socket) + ": " + std::string(strerror(errno)));
+            return false;
+        }
+
+        if (bytes_received == 0) {
+            logger->info("Client " + std::to_string(client_socket) + " disconnected gracefully");
+            return false;
+        }
+
+        if (!processReceived(conn)) {
+            return false;  // Disconnect already handled (invalid message), malformed binary frame or oversized message
+        }
+    }
+    return true;  // Rest of input is ignored, shard closes the connection
+}
+
+bool NetworkManager::processReceived(const std::shared_ptr<Connection>& conn) {
+    Tracing::Trace trace("NetworkManager::processReceived");
+
+    // Process complete messages (text lines or binary frames), inline responses leave in one write per socket
+    WriteBatch batch(*this);
+    return extractMessages(*conn, [&](auto&& complete_message) {
+        return dispatchClientMessage(conn, std::move(complete_message));
+    });
+}
+
+template <typename Message>
+bool NetworkManager::dispatchClientMessage(const std::shared_ptr<Connection>& conn, Message complete_message) {
+    if (conn->disconnect_requested.load()) {
+        return true;  // Waiting for shard to close the connection, ignore rest of input
+    }
+
+    // Rate limit runs on the reactor, a flood never reaches parsing or the shard queues
+    Admission admission = admitMessage(*conn);
+    if (admission != Admission::ACCEPT) {
+        return admission == Admission::REJECT;  // DISCONNECT closes like a dropped socket (finishEpollClient)
+    }
+
+    if (handOffConnection(conn, complete_message)) {
+        return false;  // Socket already closed here, finishEpollClient only drops what is left of the connection
+    }
+
+    if (!shard_pool) {
+        if (!processClientMessage(conn->fd, complete_message)) {
+            conn->disconnect_requested.store(true);  // Disconnect handled by processClientMessage
+            return false;
+        }
+        return true;
+    }
+
+    // Text lines are views into the receive buffer, the shard gets its own copy
+    size_t shard = selectShard(conn);
+    conn->in_flight++;
+    uint64_t trace = Tracing::currentTrace();
+    uint64_t queued = Tracing::sampledNow();
+    bool posted = shard_pool->post(shard, [this, conn, trace, queued,
+                                           complete_message = ownedMessage(std::move(complete_message))]() {
+        // Continues the reactor's trace, the time spent in the shard queue shows as its own span
+        Tracing::Trace shard_trace("RoomShardPool task", trace);
+        Tracing::spanSince("shard queue wait", queued);
+        if (!conn->disconnect_requested.load() && !conn->dropped.load()) {
+            bool keep_open = true;
+            try {
+                keep_open = processClientMessage(conn->fd, complete_message);
+            } catch (const std::exception& e) {
+                logger->error("Exception in room shard for socket " + std::to_string(conn->fd) + ": " + e.what());
+            }
+
+            if (!keep_open) {
+                // Disconnect already handled, every earlier message of this connection is done - reactor closes it
+                conn->disconnect_requested.store(true);
+                requestClose(conn);
+            }
+        }
+        conn->in_flight--;
+    });
+
+    if (!posted) {
+        conn->in_flight--;
+    }
+    return true;
+}
+
+size_t NetworkManager::selectShard(const std::shared_ptr<Connection>& conn) {
+    // Pick shard by player's room, but keep in-flight messages of this connection on one shard so they stay ordered
+    if (conn->in_flight.load() == 0) {
+        std::string room_id;
+        std::string player_name = playerManager->getPlayerIdFromSocket(conn->fd);
+        if (!player_name.empty()) {
+            room_id = playerManager->getPlayerRoom(player_name);
+        }
+        conn->pinned_shard = shard_pool->shardFor(room_id);
+    }
+    return conn->pinned_shard;
+}
+
+void NetworkManager::finishEpollClient(const std::shared_ptr<Connection>& conn) {
+    conn->closing = true;
+
+    auto disconnect = [this, conn]() {
+        // Invalid message path already ran the disconnect handling
+        if (!conn->disconnect_requested.exchange(true)) {
+            handleClientDisconnect(conn->fd, "socket_closed");
+        }
+    };
+
+    if (shard_pool) {
+        // Runs after every message of this connection still queued on its shard, the socket is closed back here
+        size_t shard = selectShard(conn);
+        conn->in_flight++;
+        if (shard_pool->post(shard, [this, conn, disconnect]() {
+                disconnect();
+                requestClose(conn);
+                conn->in_flight--;
+            })) {
+            return;
+        }
+        conn->in_flight--;
+    }
+    disconnect();
+    closeEpollClient(conn);
+}
+
+void NetworkManager::requestClose(const std::shared_ptr<Connection>& conn) {
+    {
+        std::lock_guard<std::mutex> lock(pending_close_mutex);
+        pending_closes.push_back(conn);
+    }
+    uint64_t one = 1;
+    if (wakeup_fd >= 0 && write(wakeup_fd, &one, sizeof(one)) < 0) {
+        logger->warning("Failed to wake up reactor for a close: " + std::string(strerror(errno)));
+    }
+}
+
+void NetworkManager::closePendingClients() {
+    std::vector<std::shared_ptr<Connection>> closes;
+    {
+        std::lock_guard<std::mutex> lock(pending_close_mutex);
+        closes.swap(pending_closes);
+    }
+    for (const auto& conn : closes) {
+        closeEpollClient(conn);
+    }
+}
+
+bool NetworkManager::flushConnection(Connection& conn) {
+    bool partial_write = false;
+    OutboundQueue::FlushResult result = conn.outbound.flush(conn.fd, partial_write);
+    return handleFlushResult(conn, result, partial_write);
+}
+
+bool NetworkManager::handleFlushResult(Connection& conn, OutboundQueue::FlushResult result, bool partial_write) {
+    if (partial_write) {
+        Metrics::add(Metrics::Counter::PARTIAL_WRITES);
+    }
+
+    if (result == OutboundQueue::FlushResult::FAILED) {
+        Metrics::add(Metrics::Counter::SEND_FAILURES);
+        logger->warning("Failed to send to socket " + std::to_string(conn.fd) + ": " + std::string(strerror(errno)));
+        conn.over_high_water = false;
+        return false;
+    }
+
+    // Backpressure - track how long the client stays above high-water mark
+    size_t high_water = static_cast<size_t>(config->outbound_high_water_bytes);
+    if (conn.outbound.pendingBytes() > high_water) {
+        auto now = std::chrono::steady_clock::now();
+        if (!conn.over_high_water) {
+            conn.over_high_water = true;
+            conn.over_high_water_since = now;
+            LOG_DEBUG(logger, "Client " + std::to_string(conn.fd) + " above outbound high-water mark");
+        } else if (now - conn.over_high_water_since > std::chrono::milliseconds(config->slow_client_grace_ms)) {
+            dropSlowClient(conn);
+            Metrics::add(Metrics::Counter::SEND_FAILURES);
+            return false;
+        }
+    } else {
+        conn.over_high_water = false;
+    }
+
+    // Threaded mode - client thread blocked in poll() without POLLOUT, it has to pick the rest up
+    if (conn.wakeup_fd >= 0 && !conn.polling_writable && !conn.outbound.empty()) {
+        conn.polling_writable = true;
+        uint64_t one = 1;
+        if (write(conn.wakeup_fd, &one, sizeof(one)) < 0) {
+            logger->warning("Failed to wake up client thread " + std::to_string(conn.fd) + ": " + std::string(strerror(errno)));
+        }
+    }
+
+    return true;
+}
+
+void NetworkManager::closeEpollClient(const std::shared_ptr<Connection>& conn) {
+    // Remove from table first so the fd number can't be reused while still mapped
+    {
+        std::lock_guard<std::mutex> lock(connections_mutex);
+        auto it = connections.find(conn->fd);
+        if (it != connections.end() && it->second == conn) {
+            connections.erase(it);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(conn->write_mutex);
+    if (conn->closed) {
+        return;
+    }
+    conn->closed = true;
+
+    if (use_uring) {
+        // Ring requests hold the socket open past close(), shutdown ends the multishot recv and the reactor
+        // cancels the writable poll once it reports for a connection that is gone
+        shutdown(conn->fd, SHUT_RDWR);
+    } else {
+        epoll_ctl(epoll_fd, EPOLL_CTL_DEL, conn->fd, nullptr);
+    }
+    if (close(conn->fd) < 0) {
+        logger->warning("Error closing client socket " + std::to_string(conn->fd) + ": " + std::string(strerror(errno)));
+    }
+    LOG_DEBUG(logger, "Client connection closed for socket " + std::to_string(conn->fd));
+}
+
+bool NetworkManager::setupUring() {
+    auto ring = std::make_unique<IoUring>();
+    std::string error;
+    if (!ring->setup(URING_ENTRIES, URING_BUFFER_GROUP, URING_BUFFER_COUNT, static_cast<unsigned>(RECEIVE_CHUNK_SIZE), error)) {
+        logger->warning("io_uring setup failed: " + error);
+        return false;
+    }
+
+    wakeup_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeup_fd < 0) {
+        logger->error("Failed to create wakeup eventfd: " + std::string(strerror(errno)));
+        return false;
+    }
+
+    ring->prepareMultishotAccept(server_socket, uringUserData(UringRequest::ACCEPT, 0, server_socket));
+    ring->prepareMultishotPoll(wakeup_fd, POLLIN, uringUserData(UringRequest::WAKEUP, 0, wakeup_fd));
+    int submitted = ring->submitAndWait(0);
+    if (submitted < 0) {
+        logger->warning("Failed to arm io_uring accept: " + std::string(strerror(-submitted)));
+        close(wakeup_fd);
+        wakeup_fd = -1;
+        return false;
+    }
+
+    uring = std::move(ring);
+    logger->info("io_uring reactor initialized (multishot accept / recv, " + std::to_string(URING_BUFFER_COUNT)
+                 + " provided buffers of " + std::to_string(RECEIVE_CHUNK_SIZE) + " bytes)");
+    return true;
+}
+
+void NetworkManager::runUringLoop() {
+    logger->info("NetworkManager entering io_uring reactor loop");
+    Tracing::nameThread("reactor");
+
+    while (running.load()) {
+        int result = uring->submitAndWait(1);
+        if (result < 0 && result != -EINTR && result != -EAGAIN && result != -EBUSY) {
+            logger->error("io_uring_enter failed: " + std::string(strerror(-result)));
+            break;
+        }
+
+        // Everything completed so far is handled before the next enter, re-armed requests go out together
+        io_uring_cqe* cqe;
+        while ((cqe = uring->peekCompletion()) != nullptr) {
+            uint64_t user_data = cqe->user_data;
+            int32_t res = cqe->res;
+            uint32_t flags = cqe->flags;
+            uring->consumeCompletion();
+            handleUringCompletion(user_data, res, flags);
+        }
+        uring->publishBuffers();
+    }
+
+    // Close every client still attached to the reactor
+    closePendingClients();
+    std::vector<std::shared_ptr<Connection>> remaining;
+    {
+        std::lock_guard<std::mutex> lock(connections_mutex);
+        for (const auto& pair : connections) {
+            remaining.push_back(pair.second);
+        }
+    }
+    for (const auto& conn : remaining) {
+        closeEpollClient(conn);
+    }
+
+    // Ring goes first, it still references the listening socket and the eventfd
+    uring->close();
+    if (server_socket >= 0) {
+        close(server_socket);
+        server_socket = -1;
+    }
+    if (wakeup_fd >= 0) {
+        close(wakeup_fd);
+        wakeup_fd = -1;
+    }
+
+    logger->info("NetworkManager exiting io_uring reactor loop");
+}
+
+void NetworkManager::handleUringCompletion(uint64_t user_data, int32_t result, uint32_t flags) {
+    UringRequest request = static_cast<UringRequest>(user_data >> 56);
+    uint32_t generation = static_cast<uint32_t>(user_data >> 32) & 0xFFFFFF;
+    int fd = static_cast<int>(user_data & 0xFFFFFFFF);
+    bool more = (flags & IORING_CQE_F_MORE) != 0;
+
+    switch (request) {
+        case UringRequest::WAKEUP: {
+            uint64_t value;
+            while (read(wakeup_fd, &value, sizeof(value)) > 0) {}
+            closePendingClients();
+            adoptHandoffs();
+            if (!more && running.load()) {
+                uring->prepareMultishotPoll(wakeup_fd, POLLIN, user_data);
+            }
+            return;
+        }
+        case UringRequest::ACCEPT:
+            if (result >= 0) {
+                acceptUringClient(result);
+            } else if (result != -EINTR && result != -ECONNABORTED && result != -EAGAIN) {
+                logger->error("Accept failed: " + std::string(strerror(-result)));
+            }
+            if (!more && running.load() && !uring->prepareMultishotAccept(server_socket, user_data)) {
+                logger->error("Failed to re-arm io_uring accept");
+            }
+            return;
+        case UringRequest::CANCEL:
+            return;
+        default:
+            break;
+    }
+
+    std::shared_ptr<Connection> conn = findConnection(fd);
+    bool live = conn && conn->ring_generation == generation && !conn->closing;
+
+    if (request == UringRequest::RECV && (flags & IORING_CQE_F_BUFFER)) {
+        uint16_t buffer_id = static_cast<uint16_t>(flags >> IORING_CQE_BUFFER_SHIFT);
+        if (live && result > 0 && !conn->disconnect_requested.load()) {
+            size_t length = static_cast<size_t>(result);
+            char* target = conn->read_buffer.prepareWrite(length);
+            memcpy(target, uring->bufferData(buffer_id), length);
+            conn->read_buffer.commit(length);
+            Metrics::add(Metrics::Counter::BYTES_IN, static_cast<uint64_t>(result));
+        }
+        uring->recycleBuffer(buffer_id);
+    }
+
+    if (!live) {
+        // Request of a connection that is closing or gone - the fd may already belong to someone else
+        if (more) {
+            uring->prepareCancel(user_data, uringUserData(UringRequest::CANCEL, 0, fd));
+        }
+        return;
+    }
+
+    if (request == UringRequest::RECV) {
+        if (result > 0 || result == -ENOBUFS) {
+            if (result > 0 && !processReceived(conn)) {
+                finishEpollClient(conn);  // Disconnect already handled (invalid message), malformed or oversized frame
+                return;
+            }
+            // Out of provided buffers ends the multishot recv, buffers are back in the ring before the next enter
+            if (!more && !uring->prepareMultishotRecv(fd, URING_BUFFER_GROUP, user_data)) {
+                logger->error("Failed to re-arm recv for client " + std::to_string(fd));
+                finishEpollClient(conn);
+            }
+            return;
+        }
+        if (result == 0) {
+            logger->info("Client " + std::to_string(fd) + " disconnected gracefully");
+        } else {
+            logger->warning("Receive error from client " + std::to_string(fd) + ": " + std::string(strerror(-result)));
+        }
+        finishEpollClient(conn);
+        return;
+    }
+
+    if (request == UringRequest::WRITABLE) {
+        bool keep_open = true;
+        if (result > 0) {
+            std::lock_guard<std::mutex> lock(conn->write_mutex);
+            if (!conn->closed && !conn->outbound.empty()) {
+                keep_open = flushConnection(*conn);
+            }
+        }
+        if (!keep_open) {
+            finishEpollClient(conn);
+            return;
+        }
+        if (!more) {
+            uring->prepareMultishotPoll(fd, POLLOUT, user_data);
+        }
+    }
+}
+
+void NetworkManager::acceptUringClient(int client_socket) {
+    // Multishot accept shares one address buffer between completions, ask the socket instead
+    struct sockaddr_in client_addr;
+    socklen_t client_addr_len = sizeof(client_addr);
+    memset(&client_addr, 0, sizeof(client_addr));
+    if (getpeername(client_socket, (struct sockaddr*)&client_addr, &client_addr_len) < 0) {
+        close(client_socket);
+        return;
+    }
+
+    if (!admitConnection(client_socket, client_addr)) {
+        return;
+    }
+
+    // Log client connection
+    char client_ip[INET_ADDRSTRLEN];
+    inet_ntop(AF_INET, &client_addr.sin_addr, client_ip, INET_ADDRSTRLEN);
+    logger->info("New client connected from " + std::string(client_ip) + ":" + std::to_string(ntohs(client_addr.sin_port)) + " (socket: " + std::to_string(client_socket) + ")");
+
+    std::shared_ptr<Connection> conn = registerConnection(client_socket);
+    if (!armUringClient(conn)) {
+        logger->error("Failed to register client " + std::to_string(client_socket) + " with io_uring");
+        closeEpollClient(conn);
+    }
 }
 
-bool NetworkManager::start() {
-    if (running.load()) {
-        logger->warning("NetworkManager::start() called but server is already running");
+bool NetworkManager::armUringClient(const std::shared_ptr<Connection>& conn) {
+    conn->ring_generation = next_ring_generation++ & 0xFFFFFF;
+
+    // Writable poll only reports after a send ran into a full socket buffer, like EPOLLOUT | EPOLLET
+    return uring->prepareMultishotRecv(conn->fd, URING_BUFFER_GROUP, uringUserData(UringRequest::RECV, conn->ring_generation, conn->fd))
+           && uring->prepareMultishotPoll(conn->fd, POLLOUT, uringUserData(UringRequest::WRITABLE, conn->ring_generation, conn->fd));
+}
+
+bool NetworkManager::handOffConnection(const std::shared_ptr<Connection>& conn, std::string_view line) {
+    if (!directory || !node_channel || use_uring || conn->binary_input.load() || conn->in_flight.load() > 0) {
         return false;
     }
 
-    logger->info("Starting NetworkManager server...");
+    MessageView view;
+    if (MessageView::parse(line, view) != MessageView::ParseStatus::OK) {
+        return false;
+    }
 
-    if (!setupSocket()) {
-        logger->error("Failed to setup server socket");
+    Handoff handoff;
+    int target = SessionDirectory::NO_NODE;
+    if (view.type() == MessageType::RECONNECT) {
+        // Session this node does not know, for a socket without a player yet
+        handoff.kind = Handoff::Kind::RECONNECT;
+        handoff.player_name = std::string(view.get("name"));
+        if (handoff.player_name.empty() || playerManager->getPlayerHandleFromSocket(conn->fd) != Handles::INVALID
+            || playerManager->playerExists(handoff.player_name)) {
+            return false;
+        }
+        target = directory->findOwner(handoff.player_name);
+    } else if (view.type() == MessageType::JOIN_ROOM) {
+        // Lobby player, goes where somebody already waits instead of opening another room here
+        handoff.kind = Handoff::Kind::JOIN_ROOM;
+        handoff.player_name = playerManager->getPlayerIdFromSocket(conn->fd);
+        if (handoff.player_name.empty() || !playerManager->getPlayerRoom(handoff.player_name).empty()) {
+            return false;
+        }
+        target = directory->findSeatNode();
+    } else {
         return false;
     }
 
-    running.store(true);
+    int self = directory->getNodeId();
+    if (target == SessionDirectory::NO_NODE || target == self) {
+        return false;
+    }
 
-    // Start heartbeat monitoring
-    startHeartbeatMonitor();
+    {
+        // Responses already queued go out first, nothing is written here once the other node has the socket
+        std::lock_guard<std::mutex> lock(conn->write_mutex);
+        if (conn->closed || conn->binary_output) {
+            return false;
+        }
+        if (!conn->outbound.empty() && (!flushConnection(*conn) || !conn->outbound.empty())) {
+            return false;  // Client is not reading, serve it here
+        }
 
-    logger->info("NetworkManager started successfully on " + server_ip + ":" + std::to_string(server_port));
-    return true;
-}
+        handoff.pending.reserve(line.size() + 1 + conn->read_buffer.size());
+        handoff.pending.append(line);
+        handoff.pending.push_back('\n');
+        handoff.pending.append(conn->read_buffer.unread());
 
-void NetworkManager::run() {
-    if (!running.load()) {
-        logger->error("NetworkManager::run() called but server is not started");
-        return;
+        if (handoff.kind == Handoff::Kind::JOIN_ROOM && !directory->transfer(handoff.player_name, self, target)) {
+            return false;
+        }
+        if (!node_channel->send(target, conn->fd, handoff)) {
+            if (handoff.kind == Handoff::Kind::JOIN_ROOM) {
+                directory->transfer(handoff.player_name, target, self);
+            }
+            return false;
+        }
+        conn->closed = true;
+        conn->disconnect_requested.store(true);
     }
 
-    logger->info("NetworkManager entering main accept loop");
-
-    struct sockaddr_in client_addr;
-    socklen_t client_addr_len = sizeof(client_addr);
-
-    while (running.load()) {
-        // Accept new client connection
-        int client_socket = accept(server_socket, (struct sockaddr*)&client_addr, &client_addr_len);
+    Metrics::add(Metrics::Counter::HANDOFFS_SENT);
+    logger->info("Handed client " + std::to_string(conn->fd) + " (" + handoff.player_name + ") to node " + std::to_string(target));
 
-        if (client_socket < 0) {
-            if (running.load()) {
-                logger->error("Accept failed: " + std::string(strerror(errno)));
-            }
-            continue;
+    // The session left with the socket, no disconnect handling for it here
+    if (handoff.kind == Handoff::Kind::JOIN_ROOM) {
+        playerManager->removePlayer(handoff.player_name);
+    }
+    {
+        std::lock_guard<std::mutex> lock(connections_mutex);
+        auto it = connections.find(conn->fd);
+        if (it != connections.end() && it->second == conn) {
+            connections.erase(it);
         }
+    }
+    if (use_epoll) {
+        epoll_ctl(epoll_fd, EPOLL_CTL_DEL, conn->fd, nullptr);
+    }
+    close(conn->fd);
+    return true;
+}
 
-        // Log client connection
-        char client_ip[INET_ADDRSTRLEN];
-        inet_ntop(AF_INET, &client_addr.sin_addr, client_ip, INET_ADDRSTRLEN);
-        logger->info("New client connected from " + std::string(client_ip) + ":" + std::to_string(ntohs(client_addr.sin_port)) + " (socket: " + std::to_string(client_socket) + ")");
+void NetworkManager::receiveHandoff(int client_socket, Handoff&& handoff) {
+    Metrics::add(Metrics::Counter::HANDOFFS_RECEIVED);
 
-        // Create and detach thread for handling client
+    if (!use_epoll) {
+        if (!adoptConnection(client_socket, handoff)) {
+            return;
+        }
         try {
             std::thread client_handler(&NetworkManager::handleClient, this, client_socket);
             client_handler.detach();
         } catch (const std::exception& e) {
             logger->error("Failed to create thread for client " + std::to_string(client_socket) + ": " + e.what());
+            handleClientDisconnect(client_socket, "socket_closed");
+            {
+                std::lock_guard<std::mutex> lock(connections_mutex);
+                connections.erase(client_socket);
+            }
             close(client_socket);
         }
+        return;
     }
 
-    logger->info("NetworkManager exiting main accept loop");
+    // Reactor owns its connections, it picks the socket up on wakeup
+    {
+        std::lock_guard<std::mutex> lock(adopted_mutex);
+        adopted.emplace_back(client_socket, std::move(handoff));
+    }
+    uint64_t one = 1;
+    if (write(wakeup_fd, &one, sizeof(one)) < 0) {
+        logger->warning("Failed to wake up reactor for handoff: " + std::string(strerror(errno)));
+    }
 }
 
-void NetworkManager::stop() {
-    if (!running.load()) {
-        logger->warning("NetworkManager::stop() called but server is not running");
-        return;
-    }
+std::shared_ptr<Connection> NetworkManager::adoptConnection(int client_socket, Handoff& handoff) {
+    std::shared_ptr<Connection> conn = registerConnection(client_socket);
 
-    logger->info("Stopping NetworkManager...");
-    running.store(false);
+    int flags = fcntl(client_socket, F_GETFL, 0);
+    if (flags < 0 || fcntl(client_socket, F_SETFL, flags | O_NONBLOCK) < 0) {
+        logger->warning("Failed to set client socket " + std::to_string(client_socket) + " non-blocking: " + std::string(strerror(errno)));
+    }
 
-    // Stop heartbeat monitoring first
-    stopHeartbeatMonitor();
+    char* target = conn->read_buffer.prepareWrite(handoff.pending.size());
+    memcpy(target, handoff.pending.data(), handoff.pending.size());
+    conn->read_buffer.commit(handoff.pending.size());
 
-    // Close server socket to break accept() loop
-    if (server_socket >= 0) {
-        logger->debug("Closing server socket to break accept loop");
-        shutdown(server_socket, SHUT_RDWR);
-        close(server_socket);
-        server_socket = -1;
+    // Directory already lists this node as owner, the player continues in the lobby here
+    if (handoff.kind == Handoff::Kind::JOIN_ROOM && playerManager->connectPlayer(handoff.player_name, client_socket).empty()) {
+        logger->warning("Could not adopt session of '" + handoff.player_name + "', closing client " + std::to_string(client_socket));
+        sendMessage(client_socket, ProtocolHelper::createErrorResponse("Session could not be moved, connect again"));
+        if (!playerManager->playerExists(handoff.player_name)) {
+            directory->release(handoff.player_name);
+        }
+        {
+            std::lock_guard<std::mutex> lock(connections_mutex);
+            connections.erase(client_socket);
+        }
+        {
+            std::lock_guard<std::mutex> lock(conn->write_mutex);
+            conn->closed = true;
+        }
+        close(client_socket);
+        return nullptr;
     }
 
-    cleanup();
-    logger->info("NetworkManager stopped");
+    logger->info("Adopted client " + std::to_string(client_socket) + " (" + handoff.player_name + ") from another node");
+    return conn;
 }
 
-bool NetworkManager::setupSocket() {
-    // Create TCP socket
-    server_socket = socket(AF_INET, SOCK_STREAM, 0);
-    if (server_socket < 0) {
-        logger->error("Failed to create socket: " + std::string(strerror(errno)));
-        return false;
+void NetworkManager::adoptHandoffs() {
+    std::vector<std::pair<int, Handoff>> pending;
+    {
+        std::lock_guard<std::mutex> lock(adopted_mutex);
+        pending.swap(adopted);
     }
 
-    // Set socket options for reuse
-    int opt = 1;
-    if (setsockopt(server_socket, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) < 0) {
-        logger->error("Failed to set SO_REUSEADDR: " + std::string(strerror(errno)));
-        close(server_socket);
-        server_socket = -1;
-        return false;
-    }
+    for (auto& [client_socket, handoff] : pending) {
+        std::shared_ptr<Connection> conn = adoptConnection(client_socket, handoff);
+        if (!conn) {
+            continue;
+        }
 
-    // Setup server address
-    struct sockaddr_in server_addr;
-    memset(&server_addr, 0, sizeof(server_addr));
-    server_addr.sin_family = AF_INET;
-    server_addr.sin_port = htons(server_port);
+        bool registered = false;
+        if (use_uring) {
+            registered = armUringClient(conn);
+        } else {
+            struct epoll_event ev;
+            memset(&ev, 0, sizeof(ev));
+            ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+            ev.data.fd = client_socket;
+            registered = epoll_ctl(epoll_fd, EPOLL_CTL_ADD, client_socket, &ev) == 0;
+        }
+        if (!registered) {
+            logger->error("Failed to register adopted client " + std::to_string(client_socket) + " with the reactor");
+            finishEpollClient(conn);
+            continue;
+        }
 
-    if (inet_pton(AF_INET, server_ip.c_str(), &server_addr.sin_addr) <= 0) {
-        logger->error("Invalid IP address: " + server_ip);
-        close(server_socket);
-        server_socket = -1;
-        return false;
+        if (!processReceived(conn)) {
+            finishEpollClient(conn);
+        }
     }
+}
 
-    // Bind socket
-    if (bind(server_socket, (struct sockaddr*)&server_addr, sizeof(server_addr)) < 0) {
-        logger->error("Failed to bind socket to " + server_ip + ":" + std::to_string(server_port) + ": " + std::string(strerror(errno)));
-        close(server_socket);
-        server_socket = -1;
-        return false;
-    }
+bool NetworkManager::supportsHotRestart() const {
+    return config->io_mode == "epoll" && !directory && !config->hot_restart_socket.empty();
+}
 
-    // Start listening
-    const int backlog = 128;
-    if (listen(server_socket, backlog) < 0) {
-        logger->error("Failed to listen on socket: " + std::string(strerror(errno)));
-        close(server_socket);
-        server_socket = -1;
-        return false;
+void NetworkManager::listenForSuccessor() {
+    if (!hot_restart) {
+        hot_restart = std::make_unique<HotRestart>(logger);
+    }
+    bool listening = hot_restart->listen(config->hot_restart_socket, [this](int channel_socket) {
+        int previous = takeover_channel.exchange(channel_socket);
+        if (previous >= 0) {
+            close(previous);
+        }
+        uint64_t one = 1;
+        if (write(wakeup_fd, &one, sizeof(one)) < 0) {
+            logger->warning("Failed to wake up reactor for hot restart: " + std::string(strerror(errno)));
+        }
+    });
+    if (!listening) {
+        logger->warning("Hot restart unavailable, a new binary has to be started after this one stops");
     }
-
-    logger->info("Socket setup complete - listening on " + server_ip + ":" + std::to_string(server_port));
-    return true;
 }
 
-void NetworkManager::handleClient(int client_socket) {
-    const size_t BUFFER_SIZE = 4096;
-    const size_t MAX_MESSAGE_SIZE = 8192;
-    char buffer[BUFFER_SIZE];
-    std::string message_buffer;
-
-    logger->debug("Client handler started for socket " + std::to_string(client_socket));
-
-    try {
-        while (running.load()) {
-            // Receive data from client
-            ssize_t bytes_received = recv(client_socket, buffer, BUFFER_SIZE - 1, 0);
+void NetworkManager::handOverServer(int channel_socket) {
+    auto started = std::chrono::steady_clock::now();
+    logger->info("Handing the server over to its successor");
 
-            logger->debug("recv() returned: " + std::to_string(bytes_received) + " bytes for socket " + std::to_string(client_socket));
+    // Pause - no new clients, every accepted message processed, nothing left that could change state
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, server_socket, nullptr);
+    stopHeartbeatMonitor();
+    if (shard_pool) {
+        shard_pool->stop();
+    }
+    closePendingClients();      // Connections the shards were done with are not handed over
+    if (matchmaker) {
+        matchmaker->stop();     // Seats everyone still queued, the snapshot has no matchmaking queue
+    }
+    GameJournal* journal = roomManager->getGameJournal();
+    if (journal) {
+        journal->stop();    // Commits everything, the successor appends to the same journals
+    }
 
-            if (bytes_received <= 0) {
-                if (bytes_received == 0) {
-                    logger->info("Client " + std::to_string(client_socket) + " disconnected gracefully");
-                } else {
-                    logger->warning("Receive error from client " + std::to_string(client_socket) + ": " + std::string(strerror(errno)));
-                }
-                break;
+    std::vector<std::shared_ptr<Connection>> live;
+    {
+        std::lock_guard<std::mutex> lock(connections_mutex);
+        for (const auto& pair : connections) {
+            if (!pair.second->closing) {
+                live.push_back(pair.second);
             }
+        }
+    }
 
-            // Null-terminate and add to buffer
-            buffer[bytes_received] = '\0';
-            message_buffer += buffer;
-
-            // Protect against huge messages
-            if (message_buffer.size() > MAX_MESSAGE_SIZE) {
-                logger->warning("Message too large from client " + std::to_string(client_socket) + ", disconnecting");
-                break;
+    std::string snapshot;
+    SnapshotWriter out(snapshot);
+    out.text(SNAPSHOT_MAGIC);
+    out.u8(SNAPSHOT_VERSION);
+    out.u32(static_cast<uint32_t>(live.size()));
+    std::vector<int> sockets;
+    sockets.reserve(live.size());
+    for (const auto& conn : live) {
+        std::lock_guard<std::mutex> lock(conn->write_mutex);
+        bool partial_write = false;
+        conn->outbound.flush(conn->fd, partial_write);      // The less there is to carry over the better
+        out.i64(conn->fd);
+        out.boolean(conn->binary_input.load());
+        out.boolean(conn->binary_output);
+        out.text(conn->read_buffer.unread());
+        out.text(conn->outbound.pendingData());
+        writeNames(out, conn->encoder.internedNames());
+        writeNames(out, conn->decoder.internedNames());
+        sockets.push_back(conn->fd);
+    }
+    playerManager->saveSnapshot(out);
+    roomManager->saveSnapshot(out);
+
+    bool confirmed = HotRestart::sendState(channel_socket, server_socket, sockets, snapshot) &&
+                     HotRestart::waitForAcknowledge(channel_socket, TAKEOVER_ACK_TIMEOUT_MS);
+    close(channel_socket);
+
+    if (!confirmed) {
+        logger->error("Successor did not take over, resuming");
+        if (journal) {
+            std::string error;
+            if (!journal->start(error)) {
+                logger->error("Failed to restart game journal: " + error);
             }
-            
-            logger->debug("Current message_buffer for socket " + std::to_string(client_socket) + ": '" + message_buffer + "'");
-
-            // Process complete messages (newline-delimited)
-            size_t pos = 0;
-            while ((pos = message_buffer.find('\n')) != std::string::npos) {
-                std::string complete_message = message_buffer.substr(0, pos);
-                message_buffer.erase(0, pos + 1);
-
-                // Remove carriage return if present
-                if (!complete_message.empty() && complete_message.back() == '\r') {
-                    complete_message.pop_back();
-                }
+        }
+        if (shard_pool) {
+            shard_pool->start();
+        }
+        startHeartbeatMonitor();
+        if (matchmaker) {
+            matchmaker->start([this](const std::vector<ProtocolMessage>& messages) { deliverMatches(messages); });
+        }
+        struct epoll_event ev;
+        memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN | EPOLLET;
+        ev.data.fd = server_socket;
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, server_socket, &ev) < 0) {
+            logger->error("Failed to register listening socket with epoll again: " + std::string(strerror(errno)));
+        }
+        acceptEpollClients();   // Edge-triggered, connections that queued meanwhile raise no new event
+        listenForSuccessor();
+        return;
+    }
 
-                logger->debug("Processing complete message: '" + complete_message + "'");
+    // Successor owns the sockets now. Closing our descriptors (no shutdown) leaves the connections up.
+    for (const auto& conn : live) {
+        {
+            std::lock_guard<std::mutex> lock(connections_mutex);
+            connections.erase(conn->fd);
+        }
+        std::lock_guard<std::mutex> lock(conn->write_mutex);
+        conn->closed = true;
+        epoll_ctl(epoll_fd, EPOLL_CTL_DEL, conn->fd, nullptr);
+        close(conn->fd);
+    }
+    close(server_socket);
+    server_socket = -1;
 
-                if (!complete_message.empty()) {
-                    logger->debug("Received message from client " + std::to_string(client_socket) + ": " + complete_message);
+    logger->info("Handed " + std::to_string(live.size()) + " connection(s) and " + std::to_string(snapshot.size())
+                 + " bytes of state over in " + std::to_string(Metrics::elapsedNanoseconds(started) / 1000000) + " ms");
+    handed_over.store(true);
+    running.store(false);
+}
 
-                    // Process message through MessageHandler - NOW RETURNS VECTOR
-                    try {
-                        std::vector<ProtocolMessage> responses = messageHandler->processMessage(complete_message, client_socket);
-                        
-                        logger->debug("MessageHandler returned " + std::to_string(responses.size()) + " response(s)");
-
-                        // Process each response
-                        for (const ProtocolMessage& response : responses) {
-                            logger->debug("Processing response type: " + std::to_string(static_cast<int>(response.getType())));
-                            
-                            if (response.should_broadcast_to_room) {
-                                // Handle broadcast messages
-                                std::string room_id = response.getRoomId();
-                                
-                                if (!room_id.empty()) {
-                                    std::string player_name = playerManager->getPlayerIdFromSocket(client_socket);
-                                    
-                                    // STEP 1: Send original response to requesting client
-                                    std::string response_str = response.serialize() + "\n";
-                                    ssize_t bytes_sent = send(client_socket, response_str.c_str(), response_str.length(), MSG_NOSIGNAL);
-                                    
-                                    if (bytes_sent < 0) {
-                                        logger->error("Failed to send response to requesting client " + std::to_string(client_socket) + ": " + std::string(strerror(errno)));
-                                    } else if (static_cast<size_t>(bytes_sent) != response_str.length()) {
-                                        logger->warning("Partial send to requesting client " + std::to_string(client_socket));
-                                    } else {
-                                        logger->debug("Sent response to requesting client " + std::to_string(client_socket));
-                                    }
-                                    
-                                    // STEP 2: Broadcast modified version to OTHER players (exclude sender)
-                                    logger->debug("Broadcasting to room " + room_id + " (excluding " + player_name + ")");
-
-                                    ProtocolMessage broadcast_msg = response;
-                                    broadcast_msg.setData("broadcast_type", "room_notification");
-
-                                    // Add context about who triggered the action
-                                    if (response.getType() == MessageType::ROOM_JOINED) {
-                                        broadcast_msg.setData("joined_player", player_name);
-
-                                        // Update broadcast with CURRENT room state (not stale snapshot)
-                                        std::vector<std::string> current_players = roomManager->getRoomPlayers(room_id);
-                                        std::string players_list;
-                                        for (size_t i = 0; i < current_players.size(); ++i) {
-                                            if (i > 0) players_list += ",";
-                                            players_list += current_players[i];
-                                        }
-                                        broadcast_msg.setData("players", players_list);
-                                        broadcast_msg.setData("player_count", std::to_string(current_players.size()));
-                                        broadcast_msg.setData("room_full", (current_players.size() >= 2) ? "true" : "false");
-                                    }
-
-                                    broadcastToRoom(room_id, broadcast_msg, player_name);
-                                } else {
-                                    logger->warning("Broadcast flagged but no room_id in response");
-                                }
-                                
-                            } else if (!response.player_id.empty()) {
-                                // Message targeted at specific player (not the sender)
-                                logger->debug("Sending targeted message to player '" + response.player_id + "'");
-                                
-                                auto player_opt = playerManager->getPlayer(response.player_id);
-                                
-                                if (player_opt.has_value() && player_opt->connected && player_opt->socket_fd != -1) {
-                                    std::string response_str = response.serialize() + "\n";
-                                    int target_socket = player_opt->socket_fd;
-                                    
-                                    ssize_t bytes_sent = send(target_socket, response_str.c_str(), response_str.length(), MSG_NOSIGNAL);
-                                    
-                                    if (bytes_sent < 0) {
-                                        logger->error("Failed to send targeted message to player '" + response.player_id + "': " + std::string(strerror(errno)));
-                                    } else if (static_cast<size_t>(bytes_sent) != response_str.length()) {
-                                        logger->warning("Partial send to player '" + response.player_id + "': sent " + std::to_string(bytes_sent) + "/" + std::to_string(response_str.length()) + " bytes");
-                                    } else {
-                                        logger->debug("Sent targeted message to player '" + response.player_id + "' on socket " + std::to_string(target_socket));
-                                    }
-                                } else {
-                                    logger->warning("Cannot send to player '" + response.player_id + "' - disconnected or invalid socket");
-                                }
-                                
-                            } else {
-                                // Regular response to the requesting client
-                                std::string response_str = response.serialize() + "\n";
-                                
-                                logger->debug("Sending response: '" + response_str + "'");
-                                
-                                ssize_t bytes_sent = send(client_socket, response_str.c_str(), response_str.length(), MSG_NOSIGNAL);
-                                
-                                if (bytes_sent < 0) {
-                                    logger->error("Failed to send response to client " + std::to_string(client_socket) + ": " + std::string(strerror(errno)));
-                                    break;
-                                } else if (static_cast<size_t>(bytes_sent) != response_str.length()) {
-                                    logger->warning("Partial send to client " + std::to_string(client_socket) + ": sent " + std::to_string(bytes_sent) + "/" + std::to_string(response_str.length()) + " bytes");
-                                } else {
-                                    logger->debug("Sent response to client " + std::to_string(client_socket) + ": " + response.serialize());
-                                }
-                            }
-                            
-                            // Check if client should be disconnected
-                            if (response.hasData("disconnect") && response.getData("disconnect") == "true") {
-                                logger->info("Disconnecting client " + std::to_string(client_socket) + " due to invalid message");
-
-                                // Mark socket as disconnected (6-second timeout will apply before reconnection window)
-                                std::string disconnected_player = playerManager->getPlayerIdFromSocket(client_socket);
-                                if (!disconnected_player.empty()) {
-                                    std::string room_id = playerManager->getPlayerRoom(disconnected_player);
-                                    playerManager->markSocketDisconnected(disconnected_player);
-
-                                    // Broadcast disconnection to room
-                                    if (!room_id.empty()) {
-                                        ProtocolMessage disconnect_broadcast(MessageType::PLAYER_DISCONNECTED);
-                                        disconnect_broadcast.player_id = disconnected_player;
-                                        disconnect_broadcast.room_id = room_id;
-                                        disconnect_broadcast.setData("disconnected_player", disconnected_player);
-                                        disconnect_broadcast.setData("status", "invalid_message");
-
-                                        broadcastToRoom(room_id, disconnect_broadcast, disconnected_player);
-                                    }
-                                }
+bool NetworkManager::restoreInheritedState(HotRestart::State& state) {
+    auto started = std::chrono::steady_clock::now();
+    SnapshotReader in(state.snapshot);
+    if (in.text() != SNAPSHOT_MAGIC || in.u8() != SNAPSHOT_VERSION || in.u32() != state.client_sockets.size()) {
+        logger->error("Hot restart snapshot has an unknown format");
+        return false;
+    }
 
-                                // Remove socket mapping
-                                playerManager->removeSocketMapping(client_socket);
+    std::unordered_map<int, int> sockets;
+    std::vector<std::shared_ptr<Connection>> restored;
+    restored.reserve(state.client_sockets.size());
+    for (int client_socket : state.client_sockets) {
+        int old_socket = static_cast<int>(in.i64());
+        bool binary_input = in.boolean();
+        bool binary_output = in.boolean();
+        std::string unread = in.text();
+        std::string unsent = in.text();
+        std::vector<std::string> encoder_names = readNames(in);
+        std::vector<std::string> decoder_names = readNames(in);
+        if (!in.ok()) {
+            break;
+        }
 
-                                // Close socket and exit
-                                shutdown(client_socket, SHUT_RDWR);
-                                close(client_socket);
-                                return;  // Exit handleClient immediately
-                            }
-                        }
-                        
-                    } catch (const std::exception& e) {
-                        logger->error("Error processing message from client " + std::to_string(client_socket) + ": " + e.what());
-
-                        // Send error response
-                        ProtocolMessage error_response(MessageType::ERROR_MSG);
-                        error_response.setData("message", "Internal server error");
-                        std::string error_str = error_response.serialize() + "\n";
-                        send(client_socket, error_str.c_str(), error_str.length(), MSG_NOSIGNAL);
-                    }
-                }
-            }
+        std::shared_ptr<Connection> conn = registerConnection(client_socket);
+        conn->binary_input.store(binary_input);
+        conn->binary_output = binary_output;
+        char* target = conn->read_buffer.prepareWrite(unread.size());
+        memcpy(target, unread.data(), unread.size());
+        conn->read_buffer.commit(unread.size());
+        if (!unsent.empty()) {
+            conn->outbound.push(std::move(unsent));
         }
-    } catch (const std::exception& e) {
-        logger->error("Exception in client handler for socket " + std::to_string(client_socket) + ": " + e.what());
+        conn->encoder.restoreInterned(encoder_names);
+        conn->decoder.restoreInterned(decoder_names);
+        sockets[old_socket] = client_socket;
+        restored.push_back(conn);
     }
-    
-    // Cleanup after client disconnects
-    logger->info("Client " + std::to_string(client_socket) + " disconnected, waiting for 6-second timeout");
-
-    // Get player name before removing socket mapping
-    std::string disconnected_player = playerManager->getPlayerIdFromSocket(client_socket);
-    if (!disconnected_player.empty()) {
-        // Get room before marking disconnected
-        std::string room_id = playerManager->getPlayerRoom(disconnected_player);
-
-        // Mark socket as disconnected (6-second timeout will apply before reconnection window)
-        playerManager->markSocketDisconnected(disconnected_player);
 
-        // Broadcast disconnection to room
-        if (!room_id.empty()) {
-            ProtocolMessage disconnect_broadcast(MessageType::PLAYER_DISCONNECTED);
-            disconnect_broadcast.player_id = disconnected_player;
-            disconnect_broadcast.room_id = room_id;
-            disconnect_broadcast.setData("disconnected_player", disconnected_player);
-            disconnect_broadcast.setData("status", "socket_closed");
+    if (!in.ok() || !playerManager->loadSnapshot(in, sockets) || !roomManager->loadSnapshot(in) || !in.atEnd()) {
+        logger->error("Hot restart snapshot is malformed");
+        std::lock_guard<std::mutex> lock(connections_mutex);
+        connections.clear();    // Sockets are closed by HotRestart::discard
+        return false;
+    }
 
-            broadcastToRoom(room_id, disconnect_broadcast, disconnected_player);
+    for (const auto& conn : restored) {
+        struct epoll_event ev;
+        memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+        ev.data.fd = conn->fd;
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, conn->fd, &ev) < 0) {
+            logger->error("Failed to register inherited client " + std::to_string(conn->fd) + " with epoll: " + std::string(strerror(errno)));
+            std::lock_guard<std::mutex> lock(connections_mutex);
+            connections.clear();
+            return false;
         }
-    } else {
-        logger->debug("No player found for disconnected socket " + std::to_string(client_socket));
     }
 
-    // Remove socket mapping
-    playerManager->removeSocketMapping(client_socket);
-
-    // Close the socket
-    if (close(client_socket) < 0) {
-        logger->warning("Error closing client socket " + std::to_string(client_socket) + ": " + std::string(strerror(errno)));
+    // From here the sockets are ours, the old process exits
+    state.client_sockets.clear();
+    if (!HotRestart::acknowledge(state)) {
+        logger->error("Old process did not wait for the takeover confirmation");
+        return false;
     }
 
-    logger->debug("Client handler finished for socket " + std::to_string(client_socket));
+    logger->info("Took over " + std::to_string(restored.size()) + " connection(s), " + std::to_string(playerManager->getPlayerCount())
+                 + " player(s) and " + std::to_string(roomManager->getRoomCount()) + " room(s) from " + std::to_string(state.snapshot.size())
+                 + " bytes of state in " + std::to_string(Metrics::elapsedNanoseconds(started) / 1000000) + " ms");
+
+    // Whatever the old process had not split into messages yet
+    for (const auto& conn : restored) {
+        if (!processReceived(conn)) {
+            finishEpollClient(conn);
+        }
+    }
+    return true;
 }
 
 void NetworkManager::cleanup() {
     // Close server socket if still open
     if (server_socket >= 0) {
-        logger->debug("Closing server socket");
+        LOG_DEBUG(logger, "Closing server socket");
         if (close(server_socket) < 0) {
             logger->warning("Error closing server socket: " + std::string(strerror(errno)));
         }
         server_socket = -1;
     }
 
-    logger->debug("NetworkManager cleanup complete");
+    // Handed over but never picked up by the reactor
+    {
+        std::lock_guard<std::mutex> lock(adopted_mutex);
+        for (const auto& pending : adopted) {
+            close(pending.first);
+        }
+        adopted.clear();
+    }
+
+    // Successor asked to take over but the reactor never got to it
+    int channel_socket = takeover_channel.exchange(-1);
+    if (channel_socket >= 0) {
+        close(channel_socket);
+    }
+
+    LOG_DEBUG(logger, "NetworkManager cleanup complete");
 }
 
 void NetworkManager::startHeartbeatMonitor() {
@@ -460,23 +2134,27 @@ void NetworkManager::stopHeartbeatMonitor() {
 }
 
 void NetworkManager::heartbeatMonitorLoop() {
-    logger->debug("Heartbeat monitor thread started");
+    LOG_DEBUG(logger, "Heartbeat monitor thread started");
+    Tracing::nameThread("heartbeat");
 
     while (heartbeat_running.load()) {
         try {
+            Metrics::ScopedTimer scan_timer(Metrics::Timer::HEARTBEAT_SCAN);
+            Tracing::Trace trace("NetworkManager::heartbeatScan");
+
             // Get timed out players (normal ping timeout)
             std::vector<std::string> timed_out_players = playerManager->getTimedOutPlayers(config->player_timeout_seconds);
 
-            // Get players who need cleanup (2-minute reconnection window expired)
-            std::vector<std::string> cleanup_players = playerManager->getDisconnectedPlayersForCleanup(120);
+            // Get players who need cleanup (reconnection window expired)
+            std::vector<std::string> cleanup_players = playerManager->getDisconnectedPlayersForCleanup(config->reconnect_window_seconds);
 
             // Handle ping/socket timeouts (mark as temporarily disconnected)
-            // This applies the 6-second timeout before starting the 120-second reconnection window
+            // This applies the player timeout before starting the reconnection window
             for (const std::string& player_name : timed_out_players) {
-                logger->info("Player '" + player_name + "' timed out after 6 seconds - starting reconnection window");
+                logger->info("Player '" + player_name + "' timed out (no message within its heartbeat timeout) - starting reconnection window");
                 std::string room_id = playerManager->getPlayerRoom(player_name);
 
-                // Mark as temporarily disconnected (starts the 120-second reconnection window)
+                // Mark as temporarily disconnected (starts the reconnection window)
                 playerManager->markPlayerTemporarilyDisconnected(player_name);
 
                 // Broadcast timeout to room
@@ -530,8 +2208,7 @@ void NetworkManager::heartbeatMonitorLoop() {
                                     game_over.setData("reason", "opponent_disconnect");
                                     game_over.setData("status", "game_over");
                                     
-                                    std::string game_over_msg = game_over.serialize() + "\n";
-                                    send(player_opt->socket_fd, game_over_msg.c_str(), game_over_msg.length(), MSG_NOSIGNAL);
+                                    sendMessage(player_opt->socket_fd, game_over);
                                     
                                     // Send ROOM_LEFT message (back to lobby)
                                     ProtocolMessage room_left(MessageType::ROOM_LEFT);
@@ -539,8 +2216,7 @@ void NetworkManager::heartbeatMonitorLoop() {
                                     room_left.room_id = "";
                                     room_left.setData("status", "left");
                                     
-                                    std::string room_left_msg = room_left.serialize() + "\n";
-                                    send(player_opt->socket_fd, room_left_msg.c_str(), room_left_msg.length(), MSG_NOSIGNAL);
+                                    sendMessage(player_opt->socket_fd, room_left);
                                     
                                     // Clear player's room assignment
                                     playerManager->clearPlayerRoom(remaining_player);
@@ -565,6 +2241,17 @@ void NetworkManager::heartbeatMonitorLoop() {
                 logger->info("Processed " + std::to_string(timed_out_players.size()) + " timeouts and " + std::to_string(cleanup_players.size()) + " cleanups");
             }
 
+            // Outbound backpressure - drop clients that keep not reading
+            checkSlowClients();
+
+            OutboundStats stats = getOutboundStats();
+            if (stats.queued_bytes > 0) {
+                logger->info("Outbound queues: " + std::to_string(stats.queued_bytes) + " bytes queued over "
+                             + std::to_string(stats.connections) + " connections (max " + std::to_string(stats.max_queued_bytes)
+                             + "), " + std::to_string(stats.partial_writes) + " partial writes, "
+                             + std::to_string(stats.slow_disconnects) + " slow client disconnects");
+            }
+
         } catch (const std::exception& e) {
             logger->error("Exception in heartbeat monitor: " + std::string(e.what()));
         }
@@ -575,10 +2262,23 @@ void NetworkManager::heartbeatMonitorLoop() {
                               [this] { return !heartbeat_running.load(); });
     }
 
-    logger->debug("Heartbeat monitor thread stopped");
+    LOG_DEBUG(logger, "Heartbeat monitor thread stopped");
 }
 
 void NetworkManager::broadcastToRoom(const std::string& room_id, const ProtocolMessage& message, const std::string& exclude_player) {
+    // Serialize once, every recipient queues the same frame
+    std::string broadcast_msg;
+    {
+        Tracing::Span serialize("serialize");
+        message.serializeTo(broadcast_msg);
+    }
+    broadcastFrame(room_id, message, nullptr, makeEncodedFrame(std::move(broadcast_msg)), exclude_player);
+}
+
+void NetworkManager::broadcastFrame(const std::string& room_id, const ProtocolMessage& message,
+                                    const std::map<std::string, std::string>* extra_data,
+                                    const EncodedFrame& frame, const std::string& exclude_player) {
+    Tracing::Span span("NetworkManager::broadcastToRoom");
     if (!running.load()) {
         logger->warning("Cannot broadcast - server not running");
         return;
@@ -587,42 +2287,38 @@ void NetworkManager::broadcastToRoom(const std::string& room_id, const ProtocolM
     // Get all players in the room
     std::vector<std::string> room_players = playerManager->getPlayersInRoom(room_id);
     if (room_players.empty()) {
-        logger->debug("No players to broadcast to in room " + room_id);
+        LOG_DEBUG(logger, "No players to broadcast to in room " + room_id);
         return;
     }
 
-    std::string broadcast_msg = message.serialize() + "\n";
     int successful_sends = 0;
     int failed_sends = 0;
 
-    logger->debug("Broadcasting message type " + std::to_string(static_cast<int>(message.getType())) + " to room " + room_id);
+    LOG_DEBUG(logger, "Broadcasting message type " + std::to_string(static_cast<int>(message.getType())) + " to room " + room_id);
+
+    // Resolve all recipient sockets under a single PlayerManager lock
+    std::vector<int> room_sockets = playerManager->resolvePlayerSockets(room_players);
+
+    for (size_t i = 0; i < room_players.size(); ++i) {
+        const std::string& player_name = room_players[i];
 
-    for (const std::string& player_name : room_players) {
         // Skip excluded player
         if (player_name == exclude_player) {
             continue;
         }
 
-        // Get player info
-        auto player_opt = playerManager->getPlayer(player_name);
-        if (!player_opt.has_value() || !player_opt->connected || player_opt->socket_fd == -1) {
-            logger->debug("Skipping broadcast to disconnected player: " + player_name);
+        int socket_fd = room_sockets[i];
+        if (socket_fd == -1) {
+            LOG_DEBUG(logger, "Skipping broadcast to disconnected player: " + player_name);
             continue;
         }
 
-        int socket_fd = player_opt->socket_fd;
-
         // Send message to this player
-        ssize_t bytes_sent = send(socket_fd, broadcast_msg.c_str(), broadcast_msg.length(), MSG_NOSIGNAL);
-
-        if (bytes_sent < 0) {
-            logger->warning("Failed to broadcast to player '" + player_name + "' on socket " + std::to_string(socket_fd) + ": " + std::string(strerror(errno)));
-            failed_sends++;
-        } else if (static_cast<size_t>(bytes_sent) != broadcast_msg.length()) {
-            logger->warning("Partial broadcast to player '" + player_name + "': sent " + std::to_string(bytes_sent) + "/" + std::to_string(broadcast_msg.length()) + " bytes");
+        if (!sendFrame(socket_fd, std::string_view(), frame, FrameSource{message, message.player_id, extra_data})) {
+            logger->warning("Failed to broadcast to player '" + player_name + "' on socket " + std::to_string(socket_fd));
             failed_sends++;
         } else {
-            logger->debug("Broadcast sent to player '" + player_name + "' on socket " + std::to_string(socket_fd));
+            LOG_DEBUG(logger, "Broadcast sent to player '" + player_name + "' on socket " + std::to_string(socket_fd));
             successful_sends++;
         }
     }
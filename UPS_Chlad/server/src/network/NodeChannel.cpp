@@ -0,0 +1,200 @@
+// NodeChannel.cpp - Unix socket passing clients between nodes
+// KIV/UPS Network Programming Project
+
+#include "NodeChannel.h"
+#include "core/Logger.h"
+#include <cstring>
+#include <cstddef>
+#include <algorithm>
+#include <vector>
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/time.h>
+
+namespace {
+    constexpr int ACCEPT_POLL_MS = 200;          // How often the receive loop checks for stop()
+    constexpr int RECEIVE_TIMEOUT_SECONDS = 1;
+
+    // Abstract socket address, nothing to clean up in the filesystem when a node dies
+    socklen_t channelAddress(const std::string& directory_name, int node_id, sockaddr_un& address) {
+        std::string path = "gamba" + directory_name + ".node" + std::to_string(node_id);
+        memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        size_t length = std::min(path.size(), sizeof(address.sun_path) - 1);
+        memcpy(address.sun_path + 1, path.data(), length);
+        return static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + 1 + length);
+    }
+}
+
+NodeChannel::NodeChannel(Logger* lg) : logger(lg), listen_socket(-1), running(false) {}
+
+NodeChannel::~NodeChannel() {
+    stop();
+}
+
+bool NodeChannel::start(const std::string& name, int node_id, HandoffCallback on_handoff) {
+    directory_name = name;
+    callback = std::move(on_handoff);
+
+    listen_socket = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (listen_socket < 0) {
+        logger->error("Failed to create node channel socket: " + std::string(strerror(errno)));
+        return false;
+    }
+
+    sockaddr_un address;
+    socklen_t length = channelAddress(directory_name, node_id, address);
+    if (bind(listen_socket, reinterpret_cast<sockaddr*>(&address), length) < 0 || listen(listen_socket, 64) < 0) {
+        logger->error("Failed to bind node channel of node " + std::to_string(node_id) + ": " + std::string(strerror(errno)));
+        close(listen_socket);
+        listen_socket = -1;
+        return false;
+    }
+
+    running.store(true);
+    receive_thread = std::thread(&NodeChannel::receiveLoop, this);
+    logger->info("Node channel listening as node " + std::to_string(node_id) + " of " + directory_name);
+    return true;
+}
+
+void NodeChannel::stop() {
+    if (!running.exchange(false)) {
+        return;
+    }
+    if (receive_thread.joinable()) {
+        receive_thread.join();
+    }
+    if (listen_socket >= 0) {
+        close(listen_socket);
+        listen_socket = -1;
+    }
+}
+
+void NodeChannel::receiveLoop() {
+    while (running.load()) {
+        struct pollfd pfd;
+        pfd.fd = listen_socket;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+
+        int ready = poll(&pfd, 1, ACCEPT_POLL_MS);
+        if (ready <= 0) {
+            if (ready < 0 && errno != EINTR) {
+                logger->warning("Node channel poll() failed: " + std::string(strerror(errno)));
+            }
+            continue;
+        }
+
+        int channel_socket = accept4(listen_socket, nullptr, nullptr, SOCK_CLOEXEC);
+        if (channel_socket < 0) {
+            continue;
+        }
+        receiveHandoff(channel_socket);
+        close(channel_socket);
+    }
+}
+
+void NodeChannel::receiveHandoff(int channel_socket) {
+    struct timeval timeout{};
+    timeout.tv_sec = RECEIVE_TIMEOUT_SECONDS;
+    setsockopt(channel_socket, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    // kind, name length, name, pending bytes - one datagram
+    std::vector<char> payload(2 + 255 + MAX_PENDING);
+    struct iovec iov;
+    iov.iov_base = payload.data();
+    iov.iov_len = payload.size();
+
+    alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(int))];
+    struct msghdr message;
+    memset(&message, 0, sizeof(message));
+    message.msg_iov = &iov;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+
+    ssize_t received = recvmsg(channel_socket, &message, MSG_CMSG_CLOEXEC);
+    if (received < 0) {
+        logger->warning("Failed to receive handoff: " + std::string(strerror(errno)));
+        return;
+    }
+
+    int client_socket = -1;
+    struct cmsghdr* header = CMSG_FIRSTHDR(&message);
+    if (header && header->cmsg_level == SOL_SOCKET && header->cmsg_type == SCM_RIGHTS) {
+        memcpy(&client_socket, CMSG_DATA(header), sizeof(int));
+    }
+
+    size_t length = static_cast<size_t>(received);
+    size_t name_length = length >= 2 ? static_cast<unsigned char>(payload[1]) : 0;
+    if (client_socket < 0 || (message.msg_flags & (MSG_TRUNC | MSG_CTRUNC)) || length < 2 + name_length) {
+        logger->warning("Malformed handoff received, dropping it");
+        if (client_socket >= 0) {
+            close(client_socket);
+        }
+        return;
+    }
+
+    Handoff handoff;
+    handoff.kind = static_cast<Handoff::Kind>(payload[0]);
+    handoff.player_name.assign(payload.data() + 2, name_length);
+    handoff.pending.assign(payload.data() + 2 + name_length, length - 2 - name_length);
+    callback(client_socket, std::move(handoff));
+}
+
+bool NodeChannel::send(int node_id, int client_socket, const Handoff& handoff) {
+    if (handoff.player_name.size() > 255 || handoff.pending.size() > MAX_PENDING) {
+        return false;
+    }
+
+    int channel_socket = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (channel_socket < 0) {
+        return false;
+    }
+
+    sockaddr_un address;
+    socklen_t address_length = channelAddress(directory_name, node_id, address);
+    if (connect(channel_socket, reinterpret_cast<sockaddr*>(&address), address_length) < 0) {
+        LOG_DEBUG(logger, "Node " + std::to_string(node_id) + " channel unreachable: " + std::string(strerror(errno)));
+        close(channel_socket);
+        return false;
+    }
+
+    std::string payload;
+    payload.reserve(2 + handoff.player_name.size() + handoff.pending.size());
+    payload.push_back(static_cast<char>(handoff.kind));
+    payload.push_back(static_cast<char>(handoff.player_name.size()));
+    payload += handoff.player_name;
+    payload += handoff.pending;
+
+    struct iovec iov;
+    iov.iov_base = payload.data();
+    iov.iov_len = payload.size();
+
+    alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(int))];
+    memset(control, 0, sizeof(control));
+    struct msghdr message;
+    memset(&message, 0, sizeof(message));
+    message.msg_iov = &iov;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+
+    struct cmsghdr* header = CMSG_FIRSTHDR(&message);
+    header->cmsg_level = SOL_SOCKET;
+    header->cmsg_type = SCM_RIGHTS;
+    header->cmsg_len = CMSG_LEN(sizeof(int));
+    memcpy(CMSG_DATA(header), &client_socket, sizeof(int));
+
+    // The kernel holds its own reference to the socket from here, closing ours can't end the connection
+    bool sent = sendmsg(channel_socket, &message, MSG_NOSIGNAL) == static_cast<ssize_t>(payload.size());
+    if (!sent) {
+        logger->warning("Failed to hand socket " + std::to_string(client_socket) + " to node " + std::to_string(node_id)
+                        + ": " + std::string(strerror(errno)));
+    }
+    close(channel_socket);
+    return sent;
+}
@@ -0,0 +1,211 @@
+// OutboundQueue.cpp - Per-client outbound message queue
+// KIV/UPS Network Programming Project
+
+#include "OutboundQueue.h"
+#include "Metrics.h"
+#include "Tracing.h"
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <errno.h>
+#include <cstring>
+
+namespace {
+    // Upper bound of frames handed to one sendmsg() call
+    const size_t MAX_IOV_PER_FLUSH = 64;
+}
+
+OutboundQueue::OutboundQueue() : front_offset(0), pending_bytes(0) {}
+
+void OutboundQueue::push(std::string frame) {
+    if (frame.empty()) {
+        return;
+    }
+    push(makeEncodedFrame(std::move(frame)));
+}
+
+void OutboundQueue::push(EncodedFrame frame) {
+    if (!frame || frame->empty()) {
+        return;
+    }
+    pending_bytes += frame->size();
+    frames.push_back(std::move(frame));
+}
+
+OutboundQueue::FlushResult OutboundQueue::write(int fd, std::string_view frame, bool& partial_write) {
+    partial_write = false;
+    if (frame.empty()) {
+        return frames.empty() ? FlushResult::DRAINED : FlushResult::PENDING;
+    }
+    if (!frames.empty()) {
+        push(std::string(frame));
+        return flush(fd, partial_write);
+    }
+
+    while (true) {
+        ssize_t bytes_sent;
+        {
+            Tracing::Span span("send");
+            bytes_sent = send(fd, frame.data(), frame.size(), MSG_NOSIGNAL);
+        }
+        Metrics::add(Metrics::Counter::WRITE_CALLS);
+        if (bytes_sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                push(std::string(frame));
+                return FlushResult::PENDING;
+            }
+            return FlushResult::FAILED;
+        }
+        Metrics::add(Metrics::Counter::BYTES_OUT, static_cast<uint64_t>(bytes_sent));
+        if (static_cast<size_t>(bytes_sent) < frame.size()) {
+            partial_write = true;
+            push(std::string(frame.substr(static_cast<size_t>(bytes_sent))));
+            return FlushResult::PENDING;  // Kernel buffer full
+        }
+        return FlushResult::DRAINED;
+    }
+}
+
+OutboundQueue::FlushResult OutboundQueue::write(int fd, std::string_view head, const EncodedFrame& body, bool& partial_write) {
+    partial_write = false;
+    if (!frames.empty()) {
+        if (!head.empty()) {
+            push(std::string(head));
+        }
+        push(body);
+        return flush(fd, partial_write);
+    }
+
+    struct iovec iov[2];
+    size_t iov_count = 0;
+    if (!head.empty()) {
+        iov[iov_count].iov_base = const_cast<char*>(head.data());
+        iov[iov_count].iov_len = head.size();
+        iov_count++;
+    }
+    iov[iov_count].iov_base = const_cast<char*>(body->data());
+    iov[iov_count].iov_len = body->size();
+    iov_count++;
+
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = iov;
+    msg.msg_iovlen = iov_count;
+
+    ssize_t bytes_sent;
+    do {
+        Tracing::Span span("send");
+        bytes_sent = sendmsg(fd, &msg, MSG_NOSIGNAL);
+        Metrics::add(Metrics::Counter::WRITE_CALLS);
+    } while (bytes_sent < 0 && errno == EINTR);
+
+    if (bytes_sent < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            bytes_sent = 0;
+        } else {
+            return FlushResult::FAILED;
+        }
+    }
+    if (bytes_sent > 0) {
+        Metrics::add(Metrics::Counter::BYTES_OUT, static_cast<uint64_t>(bytes_sent));
+    }
+
+    size_t sent = static_cast<size_t>(bytes_sent);
+    if (sent == head.size() + body->size()) {
+        return FlushResult::DRAINED;
+    }
+
+    partial_write = sent > 0;
+    if (sent < head.size()) {
+        push(std::string(head.substr(sent)));
+        push(body);
+    } else {
+        // Queue was empty, so body becomes the front frame - remember how much of it is already out
+        push(body);
+        front_offset = sent - head.size();
+        pending_bytes -= front_offset;
+    }
+    return FlushResult::PENDING;
+}
+
+OutboundQueue::FlushResult OutboundQueue::flush(int fd, bool& partial_write) {
+    partial_write = false;
+
+    while (!frames.empty()) {
+        struct iovec iov[MAX_IOV_PER_FLUSH];
+        size_t iov_count = 0;
+        size_t offered = 0;
+
+        for (auto it = frames.begin(); it != frames.end() && iov_count < MAX_IOV_PER_FLUSH; ++it) {
+            size_t skip = (iov_count == 0) ? front_offset : 0;
+            iov[iov_count].iov_base = const_cast<char*>((*it)->data() + skip);
+            iov[iov_count].iov_len = (*it)->size() - skip;
+            offered += iov[iov_count].iov_len;
+            iov_count++;
+        }
+
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = iov;
+        msg.msg_iovlen = iov_count;
+
+        ssize_t bytes_sent;
+        {
+            Tracing::Span span("send");
+            bytes_sent = sendmsg(fd, &msg, MSG_NOSIGNAL);
+        }
+        Metrics::add(Metrics::Counter::WRITE_CALLS);
+        if (bytes_sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return FlushResult::PENDING;
+            }
+            clear();
+            return FlushResult::FAILED;
+        }
+
+        size_t remaining = static_cast<size_t>(bytes_sent);
+        pending_bytes -= remaining;
+        Metrics::add(Metrics::Counter::BYTES_OUT, remaining);
+
+        // Pop fully written frames, remember offset into the first unfinished one
+        while (remaining > 0) {
+            size_t front_left = frames.front()->size() - front_offset;
+            if (remaining >= front_left) {
+                remaining -= front_left;
+                frames.pop_front();
+                front_offset = 0;
+            } else {
+                front_offset += remaining;
+                remaining = 0;
+            }
+        }
+
+        if (static_cast<size_t>(bytes_sent) < offered) {
+            partial_write = true;
+            return FlushResult::PENDING;  // Kernel buffer full
+        }
+    }
+
+    return FlushResult::DRAINED;
+}
+
+std::string OutboundQueue::pendingData() const {
+    std::string data;
+    data.reserve(pending_bytes);
+    for (auto it = frames.begin(); it != frames.end(); ++it) {
+        size_t skip = (it == frames.begin()) ? front_offset : 0;
+        data.append((*it)->data() + skip, (*it)->size() - skip);
+    }
+    return data;
+}
+
+void OutboundQueue::clear() {
+    frames.clear();
+    front_offset = 0;
+    pending_bytes = 0;
+}
@@ -0,0 +1,51 @@
+// ReceiveBuffer.cpp - Per-client receive buffer and line framing
+// KIV/UPS Network Programming Project
+
+#include "ReceiveBuffer.h"
+#include <algorithm>
+#include <cstring>
+
+ReceiveBuffer::ReceiveBuffer(size_t initial_capacity)
+    : storage(new char[initial_capacity]), capacity(initial_capacity), read_pos(0), write_pos(0), scan_pos(0) {}
+
+char* ReceiveBuffer::prepareWrite(size_t min_free) {
+    if (capacity - write_pos < min_free) {
+        size_t pending = write_pos - read_pos;
+        if (capacity - pending >= min_free) {
+            // Tail exhausted but enough room in front - slide the partial frame back
+            std::memmove(storage.get(), storage.get() + read_pos, pending);
+        } else {
+            size_t grown = std::max(capacity * 2, pending + min_free);
+            std::unique_ptr<char[]> larger(new char[grown]);
+            std::memcpy(larger.get(), storage.get() + read_pos, pending);
+            storage = std::move(larger);
+            capacity = grown;
+        }
+        scan_pos -= read_pos;
+        write_pos = pending;
+        read_pos = 0;
+    }
+    return storage.get() + write_pos;
+}
+
+void ReceiveBuffer::consume(size_t count) {
+    read_pos += count;
+    scan_pos = std::max(scan_pos, read_pos);
+    if (read_pos == write_pos) {
+        // Everything parsed, next recv() starts at the front again for free
+        read_pos = write_pos = scan_pos = 0;
+    }
+}
+
+bool ReceiveBuffer::nextLine(std::string_view& line) {
+    const char* begin = storage.get();
+    const char* found = static_cast<const char*>(std::memchr(begin + scan_pos, '\n', write_pos - scan_pos));
+    if (!found) {
+        scan_pos = write_pos;
+        return false;
+    }
+    size_t end = static_cast<size_t>(found - begin);
+    line = std::string_view(begin + read_pos, end - read_pos);
+    consume(end + 1 - read_pos);
+    return true;
+}
@@ -0,0 +1,419 @@
+// BinaryCodec.cpp - Binary wire format encoder and decoder
+// KIV/UPS Network Programming Project
+
+#include "BinaryCodec.h"
+#include "FieldCodes.h"
+#include "CardSet.h"
+
+using BinaryProtocol::Kind;
+
+namespace {
+    // Fields holding player names, their values go through the intern table like the header ids
+    constexpr std::string_view NAME_FIELDS[] = {
+        "name", "current_player", "opponent_name", "joined_player",
+        "winner", "reconnected_player", "disconnected_player"
+    };
+
+    constexpr size_t MAX_NUMBER_DIGITS = 9;     // Always fits into 32-bit varint
+
+    bool isNameField(std::string_view key) {
+        for (std::string_view name : NAME_FIELDS) {
+            if (name == key) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool isFlag(std::string_view value) {
+        return value == "true" || value == "false";
+    }
+
+    bool isNumber(std::string_view value) {
+        if (value.empty() || value.size() > MAX_NUMBER_DIGITS || (value[0] == '0' && value.size() > 1)) {
+            return false;
+        }
+        for (char c : value) {
+            if (c < '0' || c > '9') {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // true if value is a comma separated list of cards that renders back to exactly the same text
+    bool isCardList(std::string_view value) {
+        if (value.empty()) {
+            return false;
+        }
+        size_t start = 0;
+        while (start <= value.size()) {
+            size_t end = value.find(',', start);
+            if (end == std::string_view::npos) {
+                end = value.size();
+            }
+            CardId id;
+            std::string_view token = value.substr(start, end - start);
+            if (!parseCardId(token, id) || cardName(id) != token) {
+                return false;
+            }
+            start = end + 1;
+        }
+        return true;
+    }
+
+    void appendVarint(std::string& out, uint32_t value) {
+        while (value >= 0x80) {
+            out += static_cast<char>((value & 0x7F) | 0x80);
+            value >>= 7;
+        }
+        out += static_cast<char>(value);
+    }
+
+    void appendText(std::string& out, std::string_view text) {
+        appendVarint(out, static_cast<uint32_t>(text.size()));
+        out.append(text.data(), text.size());
+    }
+
+    void appendKey(std::string& out, std::string_view key) {
+        int index = FieldCodes::indexOf(key);
+        if (index >= 0) {
+            appendVarint(out, static_cast<uint32_t>(index) + 1);
+        } else {
+            appendVarint(out, 0);
+            appendText(out, key);
+        }
+    }
+
+    void appendCards(std::string& out, std::string_view value) {
+        size_t count_pos = out.size();
+        uint32_t count = 0;
+        out += '\0';    // Placeholder, a list never exceeds DECK_SIZE cards so the count is one byte
+        size_t start = 0;
+        while (start <= value.size()) {
+            size_t end = value.find(',', start);
+            if (end == std::string_view::npos) {
+                end = value.size();
+            }
+            CardId id = 0;
+            parseCardId(value.substr(start, end - start), id);
+            out += static_cast<char>(id);
+            count++;
+            start = end + 1;
+        }
+        out[count_pos] = static_cast<char>(count);
+    }
+
+    // Calls fn(key, value) in key order for data merged with extra_data (extra wins on equal key)
+    template <typename Fn>
+    void forEachField(const std::map<std::string, std::string>& data,
+                      const std::map<std::string, std::string>* extra_data, Fn&& fn) {
+        if (!extra_data) {
+            for (const auto& pair : data) {
+                fn(pair.first, pair.second);
+            }
+            return;
+        }
+
+        auto it = data.begin();
+        auto extra_it = extra_data->begin();
+        while (it != data.end() || extra_it != extra_data->end()) {
+            if (extra_it == extra_data->end() || (it != data.end() && it->first < extra_it->first)) {
+                fn(it->first, it->second);
+                ++it;
+            } else {
+                if (it != data.end() && it->first == extra_it->first) {
+                    ++it;  // Overridden
+                }
+                fn(extra_it->first, extra_it->second);
+                ++extra_it;
+            }
+        }
+    }
+
+    // Bounds checked reader over one payload, every read fails once the payload is exhausted
+    struct Reader {
+        std::string_view data;
+        size_t pos = 0;
+        bool ok = true;
+
+        uint8_t byte() {
+            if (pos >= data.size()) {
+                ok = false;
+                return 0;
+            }
+            return static_cast<uint8_t>(data[pos++]);
+        }
+
+        uint32_t varint() {
+            uint32_t value = 0;
+            for (int shift = 0; shift < 35 && ok; shift += 7) {
+                uint8_t b = byte();
+                value |= static_cast<uint32_t>(b & 0x7F) << shift;
+                if (!(b & 0x80)) {
+                    return value;
+                }
+            }
+            ok = false;
+            return 0;
+        }
+
+        std::string_view text() {
+            uint32_t length = varint();
+            if (!ok || length > data.size() - pos) {
+                ok = false;
+                return {};
+            }
+            std::string_view result = data.substr(pos, length);
+            pos += length;
+            return result;
+        }
+    };
+
+    // Reads varint frame length from the start of input
+    // @return false if more bytes are needed, length_size is 0 when the prefix itself is malformed
+    bool readFrameLength(std::string_view input, uint32_t& length, size_t& length_size) {
+        length = 0;
+        for (size_t i = 0; i < input.size() && i < 5; ++i) {
+            uint8_t b = static_cast<uint8_t>(input[i]);
+            length |= static_cast<uint32_t>(b & 0x7F) << (7 * i);
+            if (!(b & 0x80)) {
+                length_size = i + 1;
+                return true;
+            }
+        }
+        length_size = 0;
+        return input.size() >= 5;
+    }
+}
+
+void BinaryEncoder::appendName(std::string& out, const std::string& name) {
+    if (name.empty()) {
+        appendVarint(out, 0);
+        return;
+    }
+
+    auto it = interned.find(name);
+    if (it != interned.end()) {
+        appendVarint(out, it->second + 3);
+        return;
+    }
+
+    if (interned.size() < BinaryProtocol::MAX_INTERNED) {
+        uint32_t index = static_cast<uint32_t>(interned.size());
+        interned.emplace(name, index);
+        appendVarint(out, 2);
+    } else {
+        appendVarint(out, 1);
+    }
+    appendText(out, name);
+}
+
+std::vector<std::string> BinaryEncoder::internedNames() const {
+    std::vector<std::string> names(interned.size());
+    for (const auto& [name, index] : interned) {
+        names[index] = name;
+    }
+    return names;
+}
+
+void BinaryEncoder::restoreInterned(const std::vector<std::string>& names) {
+    interned.clear();
+    for (size_t index = 0; index < names.size(); ++index) {
+        interned.emplace(names[index], static_cast<uint32_t>(index));
+    }
+}
+
+void BinaryEncoder::encode(const ProtocolMessage& message, const std::string& header_player_id,
+                           const std::map<std::string, std::string>* extra_data, std::string& out) {
+    // Payload is built in place behind the frame start, its length prefix is inserted once known
+    size_t frame_start = out.size();
+    appendVarint(out, static_cast<uint32_t>(message.type));
+    appendName(out, header_player_id);
+    appendName(out, message.room_id);
+
+    uint32_t field_count = 0;
+    uint32_t flag_count = 0;
+    forEachField(message.data, extra_data, [&](const std::string&, const std::string& value) {
+        if (isFlag(value)) {
+            flag_count++;
+        } else {
+            field_count++;
+        }
+    });
+
+    appendVarint(out, field_count);
+    forEachField(message.data, extra_data, [&](const std::string& key, const std::string& value) {
+        if (isFlag(value)) {
+            return;
+        }
+        appendKey(out, key);
+
+        int code_index = FieldCodes::indexOf(value);
+        if (isNameField(key) && !value.empty()) {
+            out += static_cast<char>(Kind::NAME);
+            appendName(out, value);
+        } else if (isNumber(value)) {
+            out += static_cast<char>(Kind::NUMBER);
+            appendVarint(out, static_cast<uint32_t>(std::stoul(value)));
+        } else if (isCardList(value)) {
+            out += static_cast<char>(Kind::CARDS);
+            appendCards(out, value);
+        } else if (code_index >= 0) {
+            out += static_cast<char>(Kind::CODE);
+            appendVarint(out, static_cast<uint32_t>(code_index));
+        } else {
+            out += static_cast<char>(Kind::TEXT);
+            appendText(out, value);
+        }
+    });
+
+    appendVarint(out, flag_count);
+    uint8_t bits = 0;
+    uint32_t bit = 0;
+    std::string flag_bits;
+    forEachField(message.data, extra_data, [&](const std::string& key, const std::string& value) {
+        if (!isFlag(value)) {
+            return;
+        }
+        appendKey(out, key);
+        if (value == "true") {
+            bits |= static_cast<uint8_t>(1u << bit);
+        }
+        if (++bit == 8) {
+            flag_bits += static_cast<char>(bits);
+            bits = 0;
+            bit = 0;
+        }
+    });
+    if (bit != 0) {
+        flag_bits += static_cast<char>(bits);
+    }
+    out += flag_bits;
+
+    std::string length_prefix;
+    appendVarint(length_prefix, static_cast<uint32_t>(out.size() - frame_start));
+    out.insert(frame_start, length_prefix);
+}
+
+BinaryDecoder::Status BinaryDecoder::decode(std::string_view input, size_t& consumed, ProtocolMessage& out) {
+    uint32_t length = 0;
+    size_t length_size = 0;
+    if (!readFrameLength(input, length, length_size)) {
+        return Status::INCOMPLETE;
+    }
+    if (length_size == 0 || length == 0 || length > BinaryProtocol::MAX_FRAME_SIZE) {
+        return Status::INVALID;
+    }
+    if (input.size() - length_size < length) {
+        return Status::INCOMPLETE;
+    }
+
+    Reader reader{input.substr(length_size, length)};
+    out = ProtocolMessage();
+
+    auto readName = [&](std::string& name) {
+        uint32_t tag = reader.varint();
+        if (!reader.ok || tag == 0) {
+            name.clear();
+        } else if (tag == 1 || tag == 2) {
+            name = std::string(reader.text());
+            if (tag == 2) {
+                if (interned.size() >= BinaryProtocol::MAX_INTERNED) {
+                    reader.ok = false;
+                    return;
+                }
+                interned.push_back(name);
+            }
+        } else if (tag - 3 < interned.size()) {
+            name = interned[tag - 3];
+        } else {
+            reader.ok = false;
+        }
+    };
+
+    auto readKey = [&]() -> std::string {
+        uint32_t key = reader.varint();
+        if (key == 0) {
+            return std::string(reader.text());
+        }
+        if (key - 1 >= FieldCodes::COUNT) {
+            reader.ok = false;
+            return {};
+        }
+        return std::string(FieldCodes::TABLE[key - 1].full);
+    };
+
+    uint32_t type_code = reader.varint();
+    if (!reader.ok || type_code > 200 || !isKnownMessageType(static_cast<int>(type_code))) {
+        return Status::INVALID;
+    }
+    out.type = static_cast<MessageType>(type_code);
+    readName(out.player_id);
+    readName(out.room_id);
+
+    uint32_t field_count = reader.varint();
+    for (uint32_t i = 0; i < field_count && reader.ok; ++i) {
+        std::string key = readKey();
+        std::string value;
+        switch (static_cast<Kind>(reader.byte())) {
+            case Kind::TEXT:
+                value = std::string(reader.text());
+                break;
+            case Kind::NUMBER:
+                value = std::to_string(reader.varint());
+                break;
+            case Kind::CARDS: {
+                uint8_t count = reader.byte();
+                for (uint8_t c = 0; c < count && reader.ok; ++c) {
+                    uint8_t id = reader.byte();
+                    if (id >= DECK_SIZE) {
+                        reader.ok = false;
+                        break;
+                    }
+                    if (c > 0) value += ',';
+                    value += cardName(id);
+                }
+                break;
+            }
+            case Kind::CODE: {
+                uint32_t index = reader.varint();
+                if (index >= FieldCodes::COUNT) {
+                    reader.ok = false;
+                    break;
+                }
+                value = std::string(FieldCodes::TABLE[index].full);
+                break;
+            }
+            case Kind::NAME:
+                readName(value);
+                break;
+            default:
+                reader.ok = false;
+                break;
+        }
+        if (reader.ok) {
+            out.data[std::move(key)] = std::move(value);
+        }
+    }
+
+    uint32_t flag_count = reader.varint();
+    std::vector<std::string> flag_keys;
+    for (uint32_t i = 0; i < flag_count && reader.ok; ++i) {
+        flag_keys.push_back(readKey());
+    }
+    for (size_t i = 0; i < flag_keys.size() && reader.ok; i += 8) {
+        uint8_t bits = reader.byte();
+        for (size_t b = 0; b < 8 && i + b < flag_keys.size(); ++b) {
+            out.data[flag_keys[i + b]] = ((bits >> b) & 1) ? "true" : "false";
+        }
+    }
+
+    // Trailing bytes mean the peer and this decoder disagree on the format
+    if (!reader.ok || reader.pos != reader.data.size()) {
+        return Status::INVALID;
+    }
+
+    consumed = length_size + length;
+    return Status::OK;
+}
@@ -0,0 +1,115 @@
+// MessageView.cpp - In-place protocol message tokenizer
+// KIV/UPS Network Programming Project
+
+#include "MessageView.h"
+#include "FieldCodes.h"
+
+namespace {
+    bool isNumeric(std::string_view value) {
+        size_t start_idx = (value[0] == '-' && value.length() > 1) ? 1 : 0;
+        for (size_t i = start_idx; i < value.length(); ++i) {
+            if (value[i] < '0' || value[i] > '9') {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Returns text up to next '|' (or end) and advances pos behind the separator
+    std::string_view nextToken(std::string_view raw, size_t& pos, bool& found) {
+        if (pos > raw.size()) {
+            found = false;
+            return {};
+        }
+        size_t end = raw.find('|', pos);
+        if (end == std::string_view::npos) {
+            end = raw.size();
+        }
+        std::string_view token = raw.substr(pos, end - pos);
+        pos = end + 1;
+        found = true;
+        return token;
+    }
+}
+
+MessageView::ParseStatus MessageView::parse(std::string_view raw, MessageView& out) {
+    out = MessageView();
+
+    // Type - digits only, terminated by the first '|' and in 0-200 range
+    size_t first_pipe = raw.find('|');
+    if (raw.empty() || first_pipe == std::string_view::npos || first_pipe == 0 || first_pipe > 9) {
+        return ParseStatus::INVALID_FORMAT;
+    }
+    int type_code = 0;
+    for (size_t i = 0; i < first_pipe; ++i) {
+        if (raw[i] < '0' || raw[i] > '9') {
+            return ParseStatus::INVALID_FORMAT;
+        }
+        type_code = type_code * 10 + (raw[i] - '0');
+    }
+    if (type_code > 200) {
+        return ParseStatus::INVALID_FORMAT;
+    }
+    if (!isKnownMessageType(type_code)) {
+        return ParseStatus::INVALID_TYPE;
+    }
+    out.type_code = type_code;
+
+    size_t pos = first_pipe + 1;
+    bool found = false;
+
+    out.player_id = nextToken(raw, pos, found);
+    out.room_id = nextToken(raw, pos, found);
+
+    // Key-value pairs (may be compact codes or full names), tokens without '=' are ignored
+    while (pos <= raw.size()) {
+        std::string_view token = nextToken(raw, pos, found);
+        size_t eq = token.find('=');
+        if (eq == std::string_view::npos) {
+            continue;
+        }
+
+        std::string_view key = FieldCodes::expand(token.substr(0, eq));
+        std::string_view value = token.substr(eq + 1);
+        // Only non-numeric values are translated to avoid converting "1", "2", etc.
+        if (!value.empty() && !isNumeric(value)) {
+            value = FieldCodes::expand(value);
+        }
+
+        // Repeated key keeps the last value
+        bool replaced = false;
+        for (size_t i = 0; i < out.field_count; ++i) {
+            if (out.fields[i].key == key) {
+                out.fields[i].value = value;
+                replaced = true;
+                break;
+            }
+        }
+        if (!replaced) {
+            if (out.field_count == MAX_FIELDS) {
+                return ParseStatus::INVALID_FORMAT;
+            }
+            out.fields[out.field_count++] = Field{key, value};
+        }
+    }
+
+    return ParseStatus::OK;
+}
+
+std::string_view MessageView::get(std::string_view key, std::string_view default_value) const {
+    for (size_t i = 0; i < field_count; ++i) {
+        if (fields[i].key == key) {
+            return fields[i].value;
+        }
+    }
+    return default_value;
+}
+
+bool MessageView::has(std::string_view key) const {
+    for (size_t i = 0; i < field_count; ++i) {
+        if (fields[i].key == key) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -52,6 +52,24 @@ ProtocolMessage ProtocolHelper::createPongResponse() {
     return msg;
 }
 
+namespace {
+    std::string renderFrame(const ProtocolMessage& message) {
+        std::string frame;
+        message.serializeTo(frame);
+        return frame;
+    }
+
+    const std::string PONG_FRAME = renderFrame(ProtocolHelper::createPongResponse());
+}
+
+std::string_view ProtocolHelper::prerenderedFrame(const ProtocolMessage& message) {
+    if (message.getType() == MessageType::PONG && message.player_id.empty() &&
+        message.room_id.empty() && message.data.empty()) {
+        return PONG_FRAME;
+    }
+    return {};
+}
+
 ProtocolMessage ProtocolHelper::createGameStateResponse(
     const std::string& player_name,
     const std::string& room_id,
@@ -63,10 +81,7 @@ ProtocolMessage ProtocolHelper::createGameStateResponse(
     
     // Build comma-separated list of player's hand cards
     std::string hand_str;
-    for (size_t i = 0; i < game_data.hand_cards.size(); ++i) {
-        if (i > 0) hand_str += ",";
-        hand_str += game_data.hand_cards[i];
-    }
+    game_data.hand_cards.appendNames(hand_str);
     
     msg.setData("hand", hand_str);
     msg.setData("reserves", std::to_string(game_data.reserve_count));
@@ -78,6 +93,7 @@ ProtocolMessage ProtocolHelper::createGameStateResponse(
     // NEW: Add deck and discard pile sizes
     msg.setData("deck_size", std::to_string(game_data.deck_size));
     msg.setData("discard_pile_size", std::to_string(game_data.discard_pile_size));
+    msg.setData("seq", std::to_string(game_data.seq));
     
     // Parse other players info (format: "playername:handsize:reservesize")
     for (const std::string& player_info : game_data.other_players_info) {
@@ -108,59 +124,79 @@ ProtocolMessage ProtocolHelper::createGameOverResponse(const std::string& winner
 ProtocolMessage ProtocolHelper::createTurnUpdateResponse(
     const std::string& player_name,
     const std::string& /* room_id */,
-    const GameStateData& game_data)
+    const GameStateData& game_data,
+    const GameStateData& previous)
 {
     ProtocolMessage msg(MessageType::TURN_UPDATE);
     msg.player_id = player_name;
     msg.room_id = "";  // Client already knows room (per design)
 
-    // ALWAYS send: hand, top_card, discard_pile_size, your_turn
-    // Build comma-separated list of player's hand cards
-    std::string hand_str;
-    for (size_t i = 0; i < game_data.hand_cards.size(); ++i) {
-        if (i > 0) hand_str += ",";
-        hand_str += game_data.hand_cards[i];
+    // No baseline (state was never sent to this player) - send everything like a full update
+    bool full = !previous.valid;
+    msg.setData("seq", std::to_string(game_data.seq));
+
+    // Hand as cards added and removed since last update, full list only without baseline
+    if (full) {
+        std::string hand_str;
+        game_data.hand_cards.appendNames(hand_str);
+        msg.setData("hand", hand_str);
+    } else {
+        CardSet added(game_data.hand_cards.mask() & ~previous.hand_cards.mask());
+        CardSet removed(previous.hand_cards.mask() & ~game_data.hand_cards.mask());
+        if (!added.empty()) {
+            std::string added_str;
+            added.appendNames(added_str);
+            msg.setData("hand_add", added_str);
+        }
+        if (!removed.empty()) {
+            std::string removed_str;
+            removed.appendNames(removed_str);
+            msg.setData("hand_remove", removed_str);
+        }
     }
-    msg.setData("hand", hand_str);
 
-    msg.setData("top_card", game_data.top_discard_card);
-    msg.setData("discard_pile_size", std::to_string(game_data.discard_pile_size));
-    msg.setData("your_turn", (player_name == game_data.current_player) ? "1" : "0");
+    if (full || game_data.top_discard_card != previous.top_discard_card) {
+        msg.setData("top_card", game_data.top_discard_card);
+    }
+    if (full || game_data.discard_pile_size != previous.discard_pile_size) {
+        msg.setData("discard_pile_size", std::to_string(game_data.discard_pile_size));
+    }
+
+    bool your_turn = (player_name == game_data.current_player);
+    if (full || your_turn != (player_name == previous.current_player)) {
+        msg.setData("your_turn", your_turn ? "1" : "0");
+    }
 
-    // CONDITIONALLY send: reserves (only if changed from 3)
-    if (game_data.reserve_count != 3) {
+    // Reserves without baseline only if changed from 3
+    if (full ? game_data.reserve_count != 3 : game_data.reserve_count != previous.reserve_count) {
         msg.setData("reserves", std::to_string(game_data.reserve_count));
     }
 
-    // CONDITIONALLY send: deck_size (only if cards were drawn this turn)
-    // For now, always send it since we can't track "previous" state easily
-    // TODO: Optimize by tracking previous deck size
-    if (game_data.deck_size > 0) {
+    // Deck size without baseline only while cards are left
+    if (full ? game_data.deck_size > 0 : game_data.deck_size != previous.deck_size) {
         msg.setData("deck_size", std::to_string(game_data.deck_size));
     }
 
-    // CONDITIONALLY send: must_play_low (only if active)
-    if (game_data.must_play_seven_or_lower) {
-        msg.setData("must_play_low", "1");
-    } else {
-        // Send 0 to explicitly reset (important for clarity)
-        msg.setData("must_play_low", "0");
+    if (full || game_data.must_play_seven_or_lower != previous.must_play_seven_or_lower) {
+        msg.setData("must_play_low", game_data.must_play_seven_or_lower ? "1" : "0");
     }
 
     // Parse opponent info (format: "playername:handsize:reservesize")
-    for (const std::string& player_info : game_data.other_players_info) {
-        size_t first_colon = player_info.find(':');
-        size_t second_colon = player_info.find(':', first_colon + 1);
+    if (full || game_data.other_players_info != previous.other_players_info) {
+        for (const std::string& player_info : game_data.other_players_info) {
+            size_t first_colon = player_info.find(':');
+            size_t second_colon = player_info.find(':', first_colon + 1);
 
-        if (first_colon != std::string::npos && second_colon != std::string::npos) {
-            std::string hand_size = player_info.substr(first_colon + 1, second_colon - first_colon - 1);
-            std::string reserve_size = player_info.substr(second_colon + 1);
+            if (first_colon != std::string::npos && second_colon != std::string::npos) {
+                std::string hand_size = player_info.substr(first_colon + 1, second_colon - first_colon - 1);
+                std::string reserve_size = player_info.substr(second_colon + 1);
 
-            msg.setData("opponent_hand", hand_size);
+                msg.setData("opponent_hand", hand_size);
 
-            // Only send opponent reserves if not 3 (changed)
-            if (reserve_size != "3") {
-                msg.setData("opponent_reserves", reserve_size);
+                // Without baseline only send opponent reserves if not 3 (changed)
+                if (!full || reserve_size != "3") {
+                    msg.setData("opponent_reserves", reserve_size);
+                }
             }
         }
     }
@@ -202,6 +238,7 @@ std::string ProtocolHelper::getMessageTypeName(MessageType type) {
         case MessageType::RECONNECT: return "RECONNECT";
         case MessageType::PLAY_CARDS: return "PLAY_CARDS";
         case MessageType::PICKUP_PILE: return "PICKUP_PILE";
+        case MessageType::RESYNC: return "RESYNC";
         case MessageType::PLAYER_DISCONNECTED: return "PLAYER_DISCONNECTED";
         case MessageType::GAME_PAUSED: return "GAME_PAUSED";
         case MessageType::PLAYER_RECONNECTED: return "PLAYER_RECONNECTED";
@@ -0,0 +1,49 @@
+// Benchmark.cpp - Micro-benchmarks of server hot paths
+// KIV/UPS Network Programming Project
+
+#include "Benchmark.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+    std::atomic<uint64_t> allocations{0};
+
+    void* allocate(std::size_t size) {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        void* memory = std::malloc(size == 0 ? 1 : size);
+        if (!memory) {
+            throw std::bad_alloc();
+        }
+        return memory;
+    }
+}
+
+uint64_t Benchmark::allocationCount() {
+    return allocations.load(std::memory_order_relaxed);
+}
+
+// Every allocation of the benchmark binary goes through here, aligned forms are not used by the server
+void* operator new(std::size_t size) {
+    return allocate(size);
+}
+
+void* operator new[](std::size_t size) {
+    return allocate(size);
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
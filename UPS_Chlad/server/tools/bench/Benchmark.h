@@ -0,0 +1,83 @@
+// Benchmark.h - Micro-benchmarks of server hot paths
+// KIV/UPS Network Programming Project
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <algorithm>
+
+/*
+* Minimal microbenchmark harness. Each case is timed over enough iterations to fill a fixed time slice,
+* repeated a few times and the fastest repetition is reported, heap allocations are counted by the
+* replaced global operator new (see Benchmark.cpp).
+*/
+namespace Benchmark {
+    struct Result {
+        std::string name;
+        double ns_per_op = 0.0;
+        double allocs_per_op = 0.0;
+    };
+
+    // Heap allocations made by this process so far
+    uint64_t allocationCount();
+
+    // Keeps the compiler from discarding a computed value or hoisting work out of the timed loop
+    template<typename T>
+    inline void keep(T&& value) {
+        asm volatile("" : : "g"(&value) : "memory");
+    }
+
+    /*
+    * Times operation() and returns the per call cost.
+    * @param name - case name, also the key in the baseline file (no whitespace)
+    * @param operation - one benchmarked call, must leave state ready for the next call
+    */
+    template<typename Operation>
+    Result run(const std::string& name, Operation operation) {
+        using Clock = std::chrono::steady_clock;
+        constexpr auto SLICE = std::chrono::milliseconds(100);
+        constexpr int REPETITIONS = 5;
+
+        // Warm up and find an iteration count that fills the slice
+        uint64_t iterations = 1;
+        while (true) {
+            auto start = Clock::now();
+            for (uint64_t i = 0; i < iterations; ++i) {
+                operation();
+            }
+            auto elapsed = Clock::now() - start;
+            if (elapsed >= SLICE / 4 || iterations >= (uint64_t(1) << 30)) {
+                double scale = std::chrono::duration<double>(SLICE) / std::max(elapsed, Clock::duration(1));
+                iterations = std::max<uint64_t>(1, static_cast<uint64_t>(static_cast<double>(iterations) * scale));
+                break;
+            }
+            iterations *= 2;
+        }
+
+        Result result;
+        result.name = name;
+        result.ns_per_op = 0.0;
+        for (int repetition = 0; repetition < REPETITIONS; ++repetition) {
+            uint64_t allocations_before = allocationCount();
+            auto start = Clock::now();
+            for (uint64_t i = 0; i < iterations; ++i) {
+                operation();
+            }
+            auto elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+            uint64_t allocations = allocationCount() - allocations_before;
+
+            double ns_per_op = elapsed / static_cast<double>(iterations);
+            if (repetition == 0 || ns_per_op < result.ns_per_op) {
+                result.ns_per_op = ns_per_op;
+            }
+            result.allocs_per_op = static_cast<double>(allocations) / static_cast<double>(iterations);
+        }
+        return result;
+    }
+}
+
+#endif //BENCHMARK_H
@@ -0,0 +1,334 @@
+// main.cpp - Gamba microbenchmarks
+// KIV/UPS Network Programming Project
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <cstdlib>
+#include <cstring>
+#include "Benchmark.h"
+#include "ProtocolMessage.h"
+#include "MessageView.h"
+#include "MessageValidator.h"
+#include "ReceiveBuffer.h"
+#include "GameRules.h"
+#include "GameLogic.h"
+#include "PlayerManager.h"
+#include "RoomManager.h"
+
+namespace {
+    // A typical client request and the kind of state message every move produces
+    const std::string PLAY_REQUEST = "7|alice|ROOM_12|cd=7H,7S";
+
+    ProtocolMessage gameStateMessage() {
+        ProtocolMessage message(MessageType::GAME_STATE);
+        message.setPlayerId("alice");
+        message.setRoomId("ROOM_12");
+        message.setData("hand", "3H,7S,KD");
+        message.setData("reserves", "3");
+        message.setData("opponent_hand", "4");
+        message.setData("opponent_reserves", "3");
+        message.setData("top_card", "9C");
+        message.setData("discard_pile_size", "5");
+        message.setData("deck_size", "28");
+        message.setData("must_play_low", "false");
+        message.setData("your_turn", "true");
+        message.setData("seq", "17");
+        return message;
+    }
+
+    CardSet lowestRank(CardSet cards) {
+        return cards & CardSet::ofRank(cardRank(cards.lowest()));
+    }
+
+    /*
+    * Deals games until bob is on turn holding at least min_hand cards and a legal play.
+    * Bob picks the pile up while his hand is still too small, alice always plays her lowest legal rank.
+    */
+    GameLogic prepareGame(size_t min_hand) {
+        for (uint64_t seed = 1; ; ++seed) {
+            GameLogic game;
+            game.addPlayer("alice");
+            game.addPlayer("bob");
+            game.startGame(seed);   // Fixed seeds, every run measures the same positions
+
+            for (int turn = 0; turn < 500 && game.getGameState() == GameState::GAME_STARTED; ++turn) {
+                std::string current = game.getCurrentPlayer();
+                CardSet legal = game.legalMoves(current);
+                bool growing = current == "bob" && game.getPlayerHandSize("bob") < min_hand;
+                if (current == "bob" && !growing && !legal.empty()) {
+                    return game;
+                }
+
+                if (growing && game.getDiscardPileSize() > 0) {
+                    game.pickupDiscardPile(current);
+                } else if (!legal.empty()) {
+                    game.playCards(current, lowestRank(legal));
+                } else if (game.getPlayerHandSize(current) == 0) {
+                    game.playFromReserve(current);
+                } else {
+                    game.pickupDiscardPile(current);
+                }
+            }
+        }
+    }
+
+    // Copy-assigning the prepared state back reuses every buffer, so the case measures the move itself
+    Benchmark::Result benchmarkPlay(const std::string& name, size_t min_hand) {
+        const GameLogic prepared = prepareGame(min_hand);
+        const CardSet move = lowestRank(prepared.legalMoves("bob"));
+        const std::string bob = "bob";
+        GameLogic game = prepared;
+        return Benchmark::run(name, [&] {
+            game = prepared;
+            Benchmark::keep(game.playCards(bob, move));
+        });
+    }
+
+    std::vector<Benchmark::Result> runAll(const std::string& filter) {
+        std::vector<Benchmark::Result> results;
+        auto add = [&](const std::string& name, auto make) {
+            if (filter.empty() || name.find(filter) != std::string::npos) {
+                results.push_back(make(name));
+                std::cerr << "  " << name << " done" << std::endl;
+            }
+        };
+
+        add("protocol_parse", [](const std::string& name) {
+            return Benchmark::run(name, [] {
+                Benchmark::keep(ProtocolMessage::parse(PLAY_REQUEST));
+            });
+        });
+        add("message_view_parse", [](const std::string& name) {
+            MessageView view;
+            return Benchmark::run(name, [&] {
+                Benchmark::keep(MessageView::parse(PLAY_REQUEST, view));
+            });
+        });
+        add("protocol_serialize", [](const std::string& name) {
+            const ProtocolMessage message = gameStateMessage();
+            return Benchmark::run(name, [&] {
+                Benchmark::keep(message.serialize());
+            });
+        });
+        add("protocol_serialize_to", [](const std::string& name) {
+            const ProtocolMessage message = gameStateMessage();
+            std::string buffer;
+            return Benchmark::run(name, [&] {
+                buffer.clear();
+                message.serializeTo(buffer);
+                Benchmark::keep(buffer);
+            });
+        });
+        add("validator_is_valid_format", [](const std::string& name) {
+            MessageValidator validator;
+            return Benchmark::run(name, [&] {
+                Benchmark::keep(validator.isValidFormat(PLAY_REQUEST));
+            });
+        });
+        add("receive_buffer_frame_64_lines", [](const std::string& name) {
+            // One read carrying 64 pipelined requests, split in place
+            std::string burst;
+            for (int i = 0; i < 64; ++i) {
+                burst += PLAY_REQUEST;
+                burst += '\n';
+            }
+            ReceiveBuffer buffer;
+            return Benchmark::run(name, [&] {
+                char* target = buffer.prepareWrite(burst.size());
+                std::memcpy(target, burst.data(), burst.size());
+                buffer.commit(burst.size());
+                std::string_view line;
+                while (buffer.nextLine(line)) {
+                    Benchmark::keep(line);
+                }
+            });
+        });
+        add("rules_is_valid_play", [](const std::string& name) {
+            CardId top;
+            CardId seven_hearts;
+            CardId seven_spades;
+            parseCardId("9C", top);
+            parseCardId("7H", seven_hearts);
+            parseCardId("7S", seven_spades);
+            CardSet cards = CardSet::of(seven_hearts) | CardSet::of(seven_spades);
+            bool must_play_low = false;
+            return Benchmark::run(name, [&] {
+                Benchmark::keep(cards);
+                Benchmark::keep(GameRules::isValidPlay(cards, top, must_play_low));
+            });
+        });
+        add("game_start", [](const std::string& name) {
+            GameLogic game;
+            game.addPlayer("alice");
+            game.addPlayer("bob");
+            uint64_t seed = 0;
+            return Benchmark::run(name, [&] {
+                game.startGame(++seed);
+                Benchmark::keep(game);
+            });
+        });
+        add("game_play_cards_small_hand", [](const std::string& name) {
+            return benchmarkPlay(name, 3);
+        });
+        add("game_play_cards_huge_hand", [](const std::string& name) {
+            return benchmarkPlay(name, 30);
+        });
+        add("players_in_room_10k", [](const std::string& name) {
+            PlayerManager players;
+            for (int i = 0; i < 10000; ++i) {
+                std::string player = "p" + std::to_string(i);
+                players.connectPlayer(player, 100 + i);
+                players.setPlayerRoom(player, "ROOM_" + std::to_string(i / 2));
+            }
+            const std::string room = "ROOM_2500";
+            return Benchmark::run(name, [&] {
+                Benchmark::keep(players.getPlayersInRoom(room));
+            });
+        });
+        add("create_delete_room", [](const std::string& name) {
+            RoomManager rooms;
+            return Benchmark::run(name, [&] {
+                std::string room = rooms.createRoom();
+                rooms.deleteRoom(room);
+                Benchmark::keep(room);
+            });
+        });
+        add("join_any_room_5k_rooms", [](const std::string& name) {
+            // Every room has one player waiting, each call joins one and leaves it again (requeueing it)
+            RoomManager rooms(5000);
+            std::vector<std::string> filled;
+            for (int i = 0; i < 5000; ++i) {
+                rooms.joinAnyAvailableRoom("w" + std::to_string(i));
+                filled.push_back(rooms.joinAnyAvailableRoom("l" + std::to_string(i)));
+            }
+            for (int i = 0; i < 5000; ++i) {
+                rooms.leaveRoom("l" + std::to_string(i), filled[i]);
+            }
+            const std::string player = "joiner";
+            return Benchmark::run(name, [&] {
+                std::string room = rooms.joinAnyAvailableRoom(player);
+                rooms.leaveRoom(player, room);
+                Benchmark::keep(room);
+            });
+        });
+        return results;
+    }
+
+    // Baseline file: one "name ns_per_op allocs_per_op" line per case, '#' starts a comment
+    std::map<std::string, Benchmark::Result> readBaseline(const std::string& path) {
+        std::map<std::string, Benchmark::Result> baseline;
+        std::ifstream file(path);
+        std::string line;
+        while (std::getline(file, line)) {
+            if (line.empty() || line[0] == '#') {
+                continue;
+            }
+            std::istringstream fields(line);
+            Benchmark::Result result;
+            if (fields >> result.name >> result.ns_per_op >> result.allocs_per_op) {
+                baseline[result.name] = result;
+            }
+        }
+        return baseline;
+    }
+
+    bool writeBaseline(const std::string& path, const std::vector<Benchmark::Result>& results) {
+        std::ofstream file(path);
+        if (!file) {
+            return false;
+        }
+        file << "# name ns_per_op allocs_per_op (regenerate with make bench-baseline)" << std::endl;
+        file << std::fixed;
+        for (const Benchmark::Result& result : results) {
+            file << result.name << " " << std::setprecision(1) << result.ns_per_op
+                 << " " << std::setprecision(2) << result.allocs_per_op << std::endl;
+        }
+        return static_cast<bool>(file);
+    }
+
+    void printResults(const std::vector<Benchmark::Result>& results,
+                      const std::map<std::string, Benchmark::Result>& baseline) {
+        std::cout << std::fixed;
+        std::cout << std::left << std::setw(30) << "benchmark" << std::right
+                  << std::setw(12) << "ns/op" << std::setw(12) << "allocs/op";
+        if (!baseline.empty()) {
+            std::cout << std::setw(14) << "base ns/op" << std::setw(10) << "change" << std::setw(14) << "base allocs";
+        }
+        std::cout << std::endl;
+
+        for (const Benchmark::Result& result : results) {
+            std::cout << std::left << std::setw(30) << result.name << std::right
+                      << std::setw(12) << std::setprecision(1) << result.ns_per_op
+                      << std::setw(12) << std::setprecision(2) << result.allocs_per_op;
+            auto base = baseline.find(result.name);
+            if (base != baseline.end()) {
+                double change = base->second.ns_per_op > 0.0
+                    ? (result.ns_per_op / base->second.ns_per_op - 1.0) * 100.0 : 0.0;
+                std::ostringstream percent;
+                percent << std::fixed << std::setprecision(1) << std::showpos << change << "%";
+                std::cout << std::setw(14) << std::setprecision(1) << base->second.ns_per_op
+                          << std::setw(10) << percent.str()
+                          << std::setw(14) << std::setprecision(2) << base->second.allocs_per_op;
+            }
+            std::cout << std::endl;
+        }
+    }
+
+    void printUsage(const char* program_name) {
+        std::cout << "Usage: " << program_name << " [OPTIONS]" << std::endl;
+        std::cout << std::endl;
+        std::cout << "Options:" << std::endl;
+        std::cout << "  -h, --help              Show this help message" << std::endl;
+        std::cout << "  --baseline FILE         Compare results with a baseline file" << std::endl;
+        std::cout << "  --output FILE           Write results as a new baseline file" << std::endl;
+        std::cout << "  --filter TEXT           Only run benchmarks whose name contains TEXT" << std::endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::string baseline_path;
+    std::string output_path;
+    std::string filter;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage(argv[0]);
+            return 0;
+        } else if (arg == "--baseline" && i + 1 < argc) {
+            baseline_path = argv[++i];
+        } else if (arg == "--output" && i + 1 < argc) {
+            output_path = argv[++i];
+        } else if (arg == "--filter" && i + 1 < argc) {
+            filter = argv[++i];
+        } else {
+            std::cerr << "Error: Unknown argument: " << arg << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    std::map<std::string, Benchmark::Result> baseline;
+    if (!baseline_path.empty()) {
+        baseline = readBaseline(baseline_path);
+        if (baseline.empty()) {
+            std::cerr << "Warning: no baseline entries in " << baseline_path << std::endl;
+        }
+    }
+
+    std::vector<Benchmark::Result> results = runAll(filter);
+    printResults(results, baseline);
+
+    if (!output_path.empty()) {
+        if (!writeBaseline(output_path, results)) {
+            std::cerr << "Error: Cannot write " << output_path << std::endl;
+            return 1;
+        }
+        std::cout << "Baseline written to " << output_path << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,241 @@
+// BotClient.cpp - Scripted bot client for load generation
+// KIV/UPS Network Programming Project
+
+#include "BotClient.h"
+#include "GameRules.h"
+
+namespace {
+    bool isTrue(std::string_view value) {
+        return value == "true" || value == "1";
+    }
+
+    // Parses comma separated card names, unknown tokens are skipped
+    CardSet parseCards(std::string_view list) {
+        CardSet cards;
+        size_t start = 0;
+        while (start < list.size()) {
+            size_t end = list.find(',', start);
+            if (end == std::string_view::npos) {
+                end = list.size();
+            }
+            CardId id;
+            if (parseCardId(list.substr(start, end - start), id)) {
+                cards.insert(id);
+            }
+            start = end + 1;
+        }
+        return cards;
+    }
+}
+
+void BotStats::merge(const BotStats& other) {
+    messages_sent += other.messages_sent;
+    messages_received += other.messages_received;
+    bytes_sent += other.bytes_sent;
+    bytes_received += other.bytes_received;
+    games_completed += other.games_completed;
+    connected += other.connected;
+    server_errors += other.server_errors;
+    disconnects += other.disconnects;
+    connect_failures += other.connect_failures;
+    sequence_gaps += other.sequence_gaps;
+    malformed += other.malformed;
+    for (size_t i = 0; i < static_cast<size_t>(RoundTrip::COUNT); ++i) {
+        latency[i].merge(other.latency[i]);
+    }
+}
+
+BotClient::BotClient(std::string bot_name, std::chrono::milliseconds ping_every, Clock::time_point first_ping)
+    : name(std::move(bot_name)), next_ping(first_ping), ping_interval(ping_every),
+      top_card(0), pile_empty(true), must_play_low(false), your_turn(false), move_pending(false), seq(0),
+      registered(false), fd(-1), connecting(false), write_armed(false), wants_join(false), closed(false) {}
+
+void BotClient::send(BotStats& stats, std::string_view line) {
+    output.append(line.data(), line.size());
+    output += '\n';
+    stats.messages_sent++;
+}
+
+void BotClient::request(BotStats& stats, std::string_view line, RoundTrip kind) {
+    pending[static_cast<size_t>(kind)].push_back(Clock::now());
+    send(stats, line);
+}
+
+void BotClient::finishRoundTrip(BotStats& stats, RoundTrip kind, Clock::time_point now) {
+    std::deque<Clock::time_point>& sent = pending[static_cast<size_t>(kind)];
+    if (sent.empty()) {
+        return;
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(now - sent.front());
+    stats.latency[static_cast<size_t>(kind)].record(static_cast<uint64_t>(elapsed.count()));
+    sent.pop_front();
+}
+
+void BotClient::start(BotStats& stats) {
+    request(stats, "0|||nm=" + name, RoundTrip::CONNECT);
+}
+
+void BotClient::joinRoom(BotStats& stats) {
+    wants_join = false;
+    request(stats, "2||", RoundTrip::JOIN_ROOM);
+}
+
+void BotClient::tick(BotStats& stats, Clock::time_point now) {
+    if (!registered || closed || now < next_ping) {
+        return;
+    }
+    request(stats, "4||", RoundTrip::PING);
+    next_ping += ping_interval;
+    if (next_ping < now) {
+        next_ping = now + ping_interval;  // Fell behind (stalled loop), don't burst
+    }
+}
+
+void BotClient::handleLine(BotStats& stats, std::string_view line) {
+    if (!line.empty() && line.back() == '\r') {
+        line.remove_suffix(1);
+    }
+    if (line.empty()) {
+        return;
+    }
+
+    MessageView view;
+    if (MessageView::parse(line, view) != MessageView::ParseStatus::OK) {
+        stats.malformed++;
+        return;
+    }
+    stats.messages_received++;
+    Clock::time_point now = Clock::now();
+
+    switch (view.type()) {
+        case MessageType::CONNECTED:
+            finishRoundTrip(stats, RoundTrip::CONNECT, now);
+            if (!registered) {
+                registered = true;
+                stats.connected++;
+            }
+            wants_join = true;
+            break;
+
+        case MessageType::ROOM_JOINED:
+            if (view.get("broadcast_type") == "room_notification") {
+                // Someone else joined our room, with matchmaking that is our answer if we still wait for one
+                finishRoundTrip(stats, RoundTrip::JOIN_ROOM, now);
+                break;
+            }
+            finishRoundTrip(stats, RoundTrip::JOIN_ROOM, now);
+            if (isTrue(view.get("room_full"))) {
+                send(stats, "5||");  // Second player starts the game
+            }
+            break;
+
+        case MessageType::PONG:
+            finishRoundTrip(stats, RoundTrip::PING, now);
+            break;
+
+        case MessageType::GAME_STATE:
+            applyState(stats, view, true);
+            break;
+
+        case MessageType::TURN_UPDATE:
+            applyState(stats, view, false);
+            break;
+
+        case MessageType::TURN_RESULT:
+            finishRoundTrip(stats, RoundTrip::MOVE, now);
+            move_pending = false;
+            break;
+
+        case MessageType::GAME_OVER:
+            stats.games_completed++;
+            your_turn = false;
+            move_pending = false;
+            break;
+
+        case MessageType::ROOM_LEFT:
+            if (view.get("broadcast_type") != "room_notification") {
+                your_turn = false;
+                move_pending = false;
+                wants_join = true;
+            }
+            break;
+
+        case MessageType::ERROR_MSG:
+            stats.server_errors++;
+            if (move_pending) {
+                // Move rejected, picking up the pile is always allowed and keeps the game going
+                finishRoundTrip(stats, RoundTrip::MOVE, now);
+                move_pending = false;
+                if (view.get("error").find("play") != std::string_view::npos) {
+                    move_pending = true;
+                    request(stats, "8||", RoundTrip::MOVE);
+                }
+            }
+            break;
+
+        default:
+            break;  // Disconnect / reconnect notifications don't change what the bot does
+    }
+}
+
+void BotClient::applyState(BotStats& stats, const MessageView& view, bool full_state) {
+    uint64_t message_seq = 0;
+    std::string_view seq_text = view.get("seq");
+    for (char c : seq_text) {
+        message_seq = message_seq * 10 + static_cast<uint64_t>(c - '0');
+    }
+
+    if (!full_state && message_seq != seq + 1) {
+        // Missed an update, the view can't be trusted until the full state arrives
+        stats.sequence_gaps++;
+        your_turn = false;
+        send(stats, "9||");
+        return;
+    }
+    seq = message_seq;
+
+    if (view.has("hand")) {
+        hand = parseCards(view.get("hand"));
+    }
+    if (view.has("hand_add")) {
+        hand.insertAll(parseCards(view.get("hand_add")));
+    }
+    if (view.has("hand_remove")) {
+        hand.eraseAll(parseCards(view.get("hand_remove")));
+    }
+    if (view.has("top_card")) {
+        // Empty pile is sent as a placeholder that is not a real card
+        pile_empty = !parseCardId(view.get("top_card"), top_card);
+    }
+    if (view.has("must_play_low")) {
+        must_play_low = isTrue(view.get("must_play_low"));
+    }
+    if (view.has("your_turn")) {
+        your_turn = isTrue(view.get("your_turn"));
+    }
+
+    if (your_turn && !move_pending) {
+        play(stats);
+    }
+}
+
+void BotClient::play(BotStats& stats) {
+    move_pending = true;
+    if (hand.empty()) {
+        request(stats, "7|||cd=RESERVE", RoundTrip::MOVE);
+        return;
+    }
+
+    CardSet allowed = pile_empty ? GameRules::legalCardsOnEmptyPile() : GameRules::legalCards(top_card, must_play_low);
+    CardSet legal = hand & allowed;
+    if (legal.empty()) {
+        request(stats, "8||", RoundTrip::MOVE);
+        return;
+    }
+
+    // Lowest legal rank, every card of it at once
+    CardSet cards = legal & CardSet::ofRank(cardRank(legal.lowest()));
+    std::string line = "7|||cd=";
+    cards.appendNames(line);
+    request(stats, line, RoundTrip::MOVE);
+}
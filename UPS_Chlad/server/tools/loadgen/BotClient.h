@@ -0,0 +1,107 @@
+// BotClient.h - Scripted bot client for load generation
+// KIV/UPS Network Programming Project
+
+#ifndef BOTCLIENT_H
+#define BOTCLIENT_H
+
+#include <string>
+#include <string_view>
+#include <deque>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include "CardSet.h"
+#include "MessageView.h"
+#include "Metrics.h"
+
+using Clock = std::chrono::steady_clock;
+
+// Requests whose round trip is measured, each answered by its own response type
+enum class RoundTrip : size_t {
+    CONNECT,        // CONNECT -> CONNECTED
+    JOIN_ROOM,      // JOIN_ROOM -> ROOM_JOINED
+    PING,           // PING -> PONG
+    MOVE,           // PLAY_CARDS / PICKUP_PILE -> TURN_RESULT (or ERROR)
+    COUNT
+};
+
+// Counters of one load generator thread, merged into the report at the end
+struct BotStats {
+    uint64_t messages_sent = 0;
+    uint64_t messages_received = 0;
+    uint64_t bytes_sent = 0;
+    uint64_t bytes_received = 0;
+    uint64_t games_completed = 0;
+    uint64_t connected = 0;             // Connections that got CONNECTED
+    uint64_t server_errors = 0;         // ERROR responses
+    uint64_t disconnects = 0;           // Connections closed by the server or failed while running
+    uint64_t connect_failures = 0;      // TCP connect failed
+    uint64_t sequence_gaps = 0;         // TURN_UPDATE seq jumps answered with RESYNC
+    uint64_t malformed = 0;             // Lines the bot could not parse
+    Metrics::LatencyHistogram latency[static_cast<size_t>(RoundTrip::COUNT)];
+
+    void merge(const BotStats& other);
+};
+
+/*
+* One simulated player speaking the text protocol. Connects, joins a room, starts the game once the room
+* is full and plays legal moves from the GAME_STATE / TURN_UPDATE it receives (using the server's own legality
+* table), then rejoins for the next game.
+* Outgoing lines are collected in an output buffer, the owning LoadGenerator thread does all socket I/O.
+*/
+class BotClient {
+private:
+    std::string name;
+    Clock::time_point next_ping;
+    std::chrono::milliseconds ping_interval;
+
+    // Game view rebuilt from full states and deltas
+    CardSet hand;
+    CardId top_card;
+    bool pile_empty;
+    bool must_play_low;
+    bool your_turn;
+    bool move_pending;          // Move sent and TURN_RESULT not seen yet, don't send another one
+    uint64_t seq;
+    bool registered;            // CONNECTED received, pings may start
+
+    // Send times of requests still waiting for their response, per round trip kind
+    std::deque<Clock::time_point> pending[static_cast<size_t>(RoundTrip::COUNT)];
+
+    void send(BotStats& stats, std::string_view line);
+    // Sends line and starts measuring its round trip
+    void request(BotStats& stats, std::string_view line, RoundTrip kind);
+    void finishRoundTrip(BotStats& stats, RoundTrip kind, Clock::time_point now);
+    void applyState(BotStats& stats, const MessageView& view, bool full_state);
+    void play(BotStats& stats);
+
+public:
+    int fd;
+    std::string input;          // Received bytes not yet split into lines
+    std::string output;         // Lines waiting to be written
+    bool connecting;            // Non-blocking connect() still in progress
+    bool write_armed;           // EPOLLOUT registered because output did not fit into the socket
+    bool wants_join;            // In lobby, waiting for a game rate token to join a room
+    bool closed;
+
+    BotClient(std::string bot_name, std::chrono::milliseconds ping_every, Clock::time_point first_ping);
+
+    /*
+    * Queues CONNECT, called once the TCP connection is established.
+    */
+    void start(BotStats& stats);
+    /*
+    * Handles one received line (without newline) and queues whatever the bot answers.
+    */
+    void handleLine(BotStats& stats, std::string_view line);
+    /*
+    * Queues JOIN_ROOM once the load generator granted a join (see wants_join).
+    */
+    void joinRoom(BotStats& stats);
+    /*
+    * Queues PING when it is due.
+    */
+    void tick(BotStats& stats, Clock::time_point now);
+};
+
+#endif //BOTCLIENT_H
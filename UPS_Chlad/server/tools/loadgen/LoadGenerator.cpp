@@ -0,0 +1,282 @@
+// LoadGenerator.cpp - Load generator driving many bot clients
+// KIV/UPS Network Programming Project
+
+#include "LoadGenerator.h"
+#include <thread>
+#include <algorithm>
+#include <iostream>
+#include <cstring>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+namespace {
+    constexpr int MAX_EVENTS = 256;
+    constexpr int LOOP_TIMEOUT_MS = 5;          // Upper bound on ping / join scheduling delay
+    constexpr size_t READ_BUFFER_SIZE = 65536;
+
+    // Token bucket refilled at rate per second, rate 0 means unlimited
+    class RateLimiter {
+    private:
+        double rate;
+        double burst;
+        double tokens;
+        Clock::time_point last;
+
+    public:
+        RateLimiter(double per_second, double max_burst)
+            : rate(per_second), burst(max_burst), tokens(max_burst), last(Clock::now()) {}
+
+        bool take(Clock::time_point now) {
+            if (rate <= 0.0) {
+                return true;
+            }
+            tokens = std::min(burst, tokens + std::chrono::duration<double>(now - last).count() * rate);
+            last = now;
+            if (tokens < 1.0) {
+                return false;
+            }
+            tokens -= 1.0;
+            return true;
+        }
+    };
+}
+
+LoadGenerator::LoadGenerator(const LoadConfig& cfg) : config(cfg), running(false) {}
+
+void LoadGenerator::stop() {
+    running.store(false);
+}
+
+std::unique_ptr<BotStats> LoadGenerator::run() {
+    running.store(true);
+    std::vector<std::unique_ptr<BotStats>> thread_stats;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < config.threads; ++i) {
+        thread_stats.push_back(std::make_unique<BotStats>());
+    }
+    for (int i = 0; i < config.threads; ++i) {
+        threads.emplace_back(&LoadGenerator::runThread, this, i, std::ref(*thread_stats[i]));
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    auto total = std::make_unique<BotStats>();
+    for (const auto& stats : thread_stats) {
+        total->merge(*stats);
+    }
+    return total;
+}
+
+void LoadGenerator::runThread(int thread_index, BotStats& stats) {
+    int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd < 0) {
+        std::cerr << "epoll_create1 failed: " << strerror(errno) << std::endl;
+        return;
+    }
+
+    Clock::time_point start = Clock::now();
+    Clock::time_point end = start + std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(config.duration_seconds));
+    std::chrono::milliseconds ping_interval(config.ping_interval_ms);
+
+    // This thread's share of bots, first pings spread over one interval so they don't arrive in bursts
+    std::vector<std::unique_ptr<BotClient>> bots;
+    for (int i = thread_index; i < config.connections; i += config.threads) {
+        auto offset = ping_interval * i / std::max(1, config.connections);
+        bots.push_back(std::make_unique<BotClient>(config.name_prefix + std::to_string(i), ping_interval, start + offset));
+    }
+
+    // Bot joins (two per game) and connects are paced per thread
+    double threads = static_cast<double>(config.threads);
+    RateLimiter join_limiter(2.0 * config.game_rate / threads, std::max(2.0, 2.0 * config.game_rate / threads));
+    RateLimiter connect_limiter(config.connect_rate / threads, std::max(1.0, config.connect_rate / threads / 10.0));
+    size_t next_to_connect = 0;
+
+    epoll_event events[MAX_EVENTS];
+    while (running.load()) {
+        Clock::time_point now = Clock::now();
+        if (now >= end) {
+            break;
+        }
+
+        while (next_to_connect < bots.size() && connect_limiter.take(now)) {
+            startConnect(epoll_fd, *bots[next_to_connect++], stats);
+        }
+
+        int ready = epoll_wait(epoll_fd, events, MAX_EVENTS, LOOP_TIMEOUT_MS);
+        if (ready < 0 && errno != EINTR) {
+            std::cerr << "epoll_wait failed: " << strerror(errno) << std::endl;
+            break;
+        }
+
+        for (int i = 0; i < ready; ++i) {
+            BotClient& bot = *static_cast<BotClient*>(events[i].data.ptr);
+            if (bot.closed) {
+                continue;
+            }
+
+            if (bot.connecting) {
+                int error = 0;
+                socklen_t length = sizeof(error);
+                getsockopt(bot.fd, SOL_SOCKET, SO_ERROR, &error, &length);
+                if (error != 0) {
+                    stats.connect_failures++;
+                    closeBot(epoll_fd, bot);
+                    continue;
+                }
+                bot.connecting = false;
+                bot.write_armed = false;
+                epoll_event ev{};
+                ev.events = EPOLLIN;
+                ev.data.ptr = &bot;
+                epoll_ctl(epoll_fd, EPOLL_CTL_MOD, bot.fd, &ev);
+                bot.start(stats);
+                continue;
+            }
+
+            if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+                if (!readBot(bot, stats)) {
+                    stats.disconnects++;
+                    closeBot(epoll_fd, bot);
+                    continue;
+                }
+            }
+            if ((events[i].events & EPOLLOUT) && !writeBot(epoll_fd, bot, stats)) {
+                stats.disconnects++;
+                closeBot(epoll_fd, bot);
+            }
+        }
+
+        // Pings, join tokens and whatever the bots queued while handling input
+        now = Clock::now();
+        for (const auto& bot : bots) {
+            if (bot->closed || bot->connecting || bot->fd < 0) {
+                continue;
+            }
+            bot->tick(stats, now);
+            if (bot->wants_join && join_limiter.take(now)) {
+                bot->joinRoom(stats);
+            }
+            if (!bot->output.empty() && !bot->write_armed && !writeBot(epoll_fd, *bot, stats)) {
+                stats.disconnects++;
+                closeBot(epoll_fd, *bot);
+            }
+        }
+    }
+
+    for (const auto& bot : bots) {
+        if (!bot->closed && bot->fd >= 0) {
+            closeBot(epoll_fd, *bot);
+        }
+    }
+    close(epoll_fd);
+}
+
+bool LoadGenerator::startConnect(int epoll_fd, BotClient& bot, BotStats& stats) {
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<uint16_t>(config.port));
+    if (inet_pton(AF_INET, config.host.c_str(), &address.sin_addr) != 1) {
+        stats.connect_failures++;
+        bot.closed = true;
+        return false;
+    }
+
+    bot.fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (bot.fd < 0) {
+        stats.connect_failures++;
+        bot.closed = true;
+        return false;
+    }
+
+    // Requests are single small lines, don't let Nagle hold them back
+    int one = 1;
+    setsockopt(bot.fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    if (connect(bot.fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 && errno != EINPROGRESS) {
+        stats.connect_failures++;
+        close(bot.fd);
+        bot.fd = -1;
+        bot.closed = true;
+        return false;
+    }
+
+    // Writability reports the connect result
+    bot.connecting = true;
+    epoll_event ev{};
+    ev.events = EPOLLOUT;
+    ev.data.ptr = &bot;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, bot.fd, &ev);
+    return true;
+}
+
+bool LoadGenerator::readBot(BotClient& bot, BotStats& stats) {
+    thread_local char buffer[READ_BUFFER_SIZE];
+    while (true) {
+        ssize_t received = recv(bot.fd, buffer, sizeof(buffer), 0);
+        if (received < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        if (received == 0) {
+            return false;
+        }
+        stats.bytes_received += static_cast<uint64_t>(received);
+        bot.input.append(buffer, static_cast<size_t>(received));
+
+        size_t line_start = 0;
+        size_t newline;
+        while ((newline = bot.input.find('\n', line_start)) != std::string::npos) {
+            bot.handleLine(stats, std::string_view(bot.input).substr(line_start, newline - line_start));
+            line_start = newline + 1;
+        }
+        bot.input.erase(0, line_start);
+
+        if (static_cast<size_t>(received) < sizeof(buffer)) {
+            return true;  // Drained, level-triggered epoll reports the rest
+        }
+    }
+}
+
+bool LoadGenerator::writeBot(int epoll_fd, BotClient& bot, BotStats& stats) {
+    while (!bot.output.empty()) {
+        ssize_t sent = send(bot.fd, bot.output.data(), bot.output.size(), MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;
+            }
+            return false;
+        }
+        stats.bytes_sent += static_cast<uint64_t>(sent);
+        bot.output.erase(0, static_cast<size_t>(sent));
+    }
+
+    bool want_write = !bot.output.empty();
+    if (want_write != bot.write_armed) {
+        epoll_event ev{};
+        ev.events = want_write ? (EPOLLIN | EPOLLOUT) : EPOLLIN;
+        ev.data.ptr = &bot;
+        epoll_ctl(epoll_fd, EPOLL_CTL_MOD, bot.fd, &ev);
+        bot.write_armed = want_write;
+    }
+    return true;
+}
+
+void LoadGenerator::closeBot(int epoll_fd, BotClient& bot) {
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, bot.fd, nullptr);
+    close(bot.fd);
+    bot.fd = -1;
+    bot.closed = true;
+}
@@ -0,0 +1,70 @@
+// LoadGenerator.h - Load generator driving many bot clients
+// KIV/UPS Network Programming Project
+
+#ifndef LOADGENERATOR_H
+#define LOADGENERATOR_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include "BotClient.h"
+
+struct LoadConfig {
+    std::string host = "127.0.0.1";
+    int port = 8080;
+    int connections = 100;
+    int threads = 1;                    // Event loop threads, bots are split evenly between them
+    double duration_seconds = 10.0;
+    int ping_interval_ms = 2000;        // Per bot, must stay below the server's player_timeout_seconds
+    double game_rate = 0.0;             // Games started per second over all bots (0 = as fast as possible)
+    double connect_rate = 1000.0;       // New connections per second over all threads (0 = all at once)
+    std::string name_prefix = "lg";     // Bot names are prefix + index, must be unique on the server
+};
+
+/*
+* Runs config.connections bots against the server on config.threads epoll loops for the configured duration
+* and collects their statistics. Every thread owns its bots, nothing is shared while the test runs.
+*/
+class LoadGenerator {
+private:
+    LoadConfig config;
+    std::atomic<bool> running;
+
+    /*
+    * Event loop of one thread: connects its share of bots at the connect rate, reads and writes their sockets,
+    * hands out join tokens at the game rate and sends pings.
+    */
+    void runThread(int thread_index, BotStats& stats);
+    /*
+    * Starts a non-blocking connect for bot and registers it with epoll.
+    * @return false if the socket could not be created or connected
+    */
+    bool startConnect(int epoll_fd, BotClient& bot, BotStats& stats);
+    /*
+    * Reads everything available and feeds complete lines to the bot.
+    * @return false if the connection was closed or failed
+    */
+    bool readBot(BotClient& bot, BotStats& stats);
+    /*
+    * Writes as much of bot's output as the socket accepts, EPOLLOUT stays armed while output is left.
+    * @return false if the connection failed
+    */
+    bool writeBot(int epoll_fd, BotClient& bot, BotStats& stats);
+    void closeBot(int epoll_fd, BotClient& bot);
+
+public:
+    explicit LoadGenerator(const LoadConfig& cfg);
+
+    /*
+    * Runs the test, blocks for its whole duration.
+    * @return statistics of all threads merged
+    */
+    std::unique_ptr<BotStats> run();
+    /*
+    * Ends the test early (signal handler safe)
+    */
+    void stop();
+};
+
+#endif //LOADGENERATOR_H
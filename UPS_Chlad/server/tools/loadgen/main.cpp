@@ -0,0 +1,168 @@
+// main.cpp - Gamba load generator entry point
+// KIV/UPS Network Programming Project
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <csignal>
+#include <cstdlib>
+#include <algorithm>
+#include <sys/resource.h>
+#include "LoadGenerator.h"
+
+namespace {
+    LoadGenerator* active_generator = nullptr;
+
+    void signalHandler(int /* signal */) {
+        if (active_generator) {
+            active_generator->stop();
+        }
+    }
+
+    void printUsage(const char* program_name) {
+        std::cout << "Usage: " << program_name << " [OPTIONS]" << std::endl;
+        std::cout << std::endl;
+        std::cout << "Options:" << std::endl;
+        std::cout << "  -h, --help              Show this help message" << std::endl;
+        std::cout << "  --ip IP                 Server IP (default: 127.0.0.1)" << std::endl;
+        std::cout << "  -p, --port PORT         Server port (default: 8080)" << std::endl;
+        std::cout << "  -c, --connections N     Simulated players (default: 100)" << std::endl;
+        std::cout << "  -t, --threads N         Event loop threads (default: 1)" << std::endl;
+        std::cout << "  -d, --duration SEC      Test length in seconds (default: 10)" << std::endl;
+        std::cout << "  --ping-ms MS            Ping interval per player (default: 2000)" << std::endl;
+        std::cout << "  --game-rate N           Games started per second, 0 = unlimited (default: 0)" << std::endl;
+        std::cout << "  --connect-rate N        New connections per second, 0 = all at once (default: 1000)" << std::endl;
+        std::cout << "  --prefix NAME           Player name prefix, must be unique per server (default: lg)" << std::endl;
+        std::cout << std::endl;
+        std::cout << "Every bot connects from the same address. A server with accept_rate_per_ip or client_message_rate" << std::endl;
+        std::cout << "set refuses bots beyond accept_burst_per_ip plus the rate and rate-limits fast games, so run it" << std::endl;
+        std::cout << "with both at 0 (the shipped server.conf) or lower --connect-rate and --game-rate to match." << std::endl;
+        std::cout << "Bots beyond 2 * max_rooms get no room and count as server errors." << std::endl;
+    }
+
+    // Parses numeric option value, exits with usage on a bad or missing value
+    double numberArgument(int argc, char* argv[], int& i, double minimum) {
+        if (i + 1 >= argc) {
+            std::cerr << "Error: " << argv[i] << " requires a value" << std::endl;
+            printUsage(argv[0]);
+            exit(1);
+        }
+        try {
+            double value = std::stod(argv[++i]);
+            if (value < minimum) {
+                throw std::out_of_range("below minimum");
+            }
+            return value;
+        } catch (const std::exception&) {
+            std::cerr << "Error: Invalid value '" << argv[i] << "' for " << argv[i - 1] << std::endl;
+            exit(1);
+        }
+    }
+
+    void parseCommandLine(int argc, char* argv[], LoadConfig& config) {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            if (arg == "--help" || arg == "-h") {
+                printUsage(argv[0]);
+                exit(0);
+            } else if (arg == "--ip" && i + 1 < argc) {
+                config.host = argv[++i];
+            } else if (arg == "--port" || arg == "-p") {
+                config.port = static_cast<int>(numberArgument(argc, argv, i, 1));
+            } else if (arg == "--connections" || arg == "-c") {
+                config.connections = static_cast<int>(numberArgument(argc, argv, i, 1));
+            } else if (arg == "--threads" || arg == "-t") {
+                config.threads = static_cast<int>(numberArgument(argc, argv, i, 1));
+            } else if (arg == "--duration" || arg == "-d") {
+                config.duration_seconds = numberArgument(argc, argv, i, 0.1);
+            } else if (arg == "--ping-ms") {
+                config.ping_interval_ms = static_cast<int>(numberArgument(argc, argv, i, 10));
+            } else if (arg == "--game-rate") {
+                config.game_rate = numberArgument(argc, argv, i, 0);
+            } else if (arg == "--connect-rate") {
+                config.connect_rate = numberArgument(argc, argv, i, 0);
+            } else if (arg == "--prefix" && i + 1 < argc) {
+                config.name_prefix = argv[++i];
+            } else {
+                std::cerr << "Error: Unknown argument: " << arg << std::endl;
+                printUsage(argv[0]);
+                exit(1);
+            }
+        }
+        if (config.threads > config.connections) {
+            config.threads = config.connections;
+        }
+    }
+
+    // Thousands of sockets need more than the usual 1024 descriptors
+    void raiseFileLimit(int connections) {
+        struct rlimit limit;
+        if (getrlimit(RLIMIT_NOFILE, &limit) != 0) {
+            return;
+        }
+        rlim_t wanted = static_cast<rlim_t>(connections) + 64;
+        if (limit.rlim_cur < wanted) {
+            limit.rlim_cur = std::min(wanted, limit.rlim_max);
+            setrlimit(RLIMIT_NOFILE, &limit);
+            if (limit.rlim_cur < wanted) {
+                std::cerr << "Warning: file descriptor limit " << limit.rlim_cur
+                          << " is below the requested connection count" << std::endl;
+            }
+        }
+    }
+
+    double milliseconds(uint64_t nanoseconds) {
+        return static_cast<double>(nanoseconds) / 1e6;
+    }
+
+    void printReport(const LoadConfig& config, const BotStats& stats, double elapsed) {
+        static const char* ROUND_TRIP_NAMES[] = {"CONNECT", "JOIN_ROOM", "PING", "MOVE"};
+
+        std::cout << std::fixed << std::setprecision(1);
+        std::cout << "=== Load Generator Report ===" << std::endl;
+        std::cout << "  Duration: " << elapsed << " s, " << config.threads << " thread(s)" << std::endl;
+        std::cout << "  Connections: " << stats.connected << " of " << config.connections << " connected" << std::endl;
+        std::cout << "  Sent: " << stats.messages_sent << " messages (" << stats.messages_sent / elapsed << "/s), "
+                  << stats.bytes_sent << " bytes" << std::endl;
+        std::cout << "  Received: " << stats.messages_received << " messages (" << stats.messages_received / elapsed
+                  << "/s), " << stats.bytes_received << " bytes" << std::endl;
+        std::cout << "  Games completed: " << stats.games_completed << " (" << stats.games_completed / elapsed << "/s)" << std::endl;
+
+        std::cout << "  Round trip (ms)      count       p50       p99      p999" << std::endl;
+        std::cout << std::setprecision(3);
+        for (size_t i = 0; i < static_cast<size_t>(RoundTrip::COUNT); ++i) {
+            const Metrics::LatencyHistogram& histogram = stats.latency[i];
+            std::cout << "    " << std::left << std::setw(12) << ROUND_TRIP_NAMES[i] << std::right
+                      << std::setw(11) << histogram.count()
+                      << std::setw(10) << milliseconds(histogram.quantile(0.5))
+                      << std::setw(10) << milliseconds(histogram.quantile(0.99))
+                      << std::setw(10) << milliseconds(histogram.quantile(0.999)) << std::endl;
+        }
+
+        std::cout << "  Errors: " << stats.server_errors << " server errors, " << stats.disconnects << " disconnects, "
+                  << stats.connect_failures << " connect failures, " << stats.sequence_gaps << " sequence gaps, "
+                  << stats.malformed << " malformed messages" << std::endl;
+        std::cout << "=============================" << std::endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    LoadConfig config;
+    parseCommandLine(argc, argv, config);
+    raiseFileLimit(config.connections);
+
+    LoadGenerator generator(config);
+    active_generator = &generator;
+    std::signal(SIGINT, signalHandler);
+    std::signal(SIGTERM, signalHandler);
+
+    std::cout << "Running " << config.connections << " players against " << config.host << ":" << config.port
+              << " for " << config.duration_seconds << " s" << std::endl;
+
+    auto started = Clock::now();
+    std::unique_ptr<BotStats> stats = generator.run();
+    double elapsed = std::chrono::duration<double>(Clock::now() - started).count();
+
+    printReport(config, *stats, elapsed);
+    return (stats->disconnects == 0 && stats->connect_failures == 0 && stats->malformed == 0) ? 0 : 1;
+}
@@ -0,0 +1,159 @@
+// main.cpp - Gamba headless game simulator
+// KIV/UPS Network Programming Project
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include "Simulation.h"
+
+namespace {
+    void printUsage(const char* program_name) {
+        std::cout << "Usage: " << program_name << " [OPTIONS]" << std::endl;
+        std::cout << std::endl;
+        std::cout << "Options:" << std::endl;
+        std::cout << "  -h, --help              Show this help message" << std::endl;
+        std::cout << "  -g, --games N           Games to play (default: 1000000)" << std::endl;
+        std::cout << "  -t, --threads N         Worker threads, 0 = every core (default: 0)" << std::endl;
+        std::cout << "  -s, --seed N            Base seed, the same seed replays the same games (default: 1)" << std::endl;
+        std::cout << "  --players N             Seats per game, 2 to " << MAX_SEATS << " (default: 2)" << std::endl;
+        std::cout << "  --policy LIST           Policy per seat, comma separated, the last one fills the remaining"
+                  << std::endl;
+        std::cout << "                          seats (default: lowest)" << std::endl;
+        std::cout << "  --max-turns N           Turns before a game counts as stalled (default: 2000)" << std::endl;
+        std::cout << std::endl;
+        std::cout << "Policies:";
+        for (const std::string& name : BotPolicies::names()) {
+            std::cout << " " << name;
+        }
+        std::cout << std::endl;
+    }
+
+    // Parses numeric option value, exits with usage on a bad or missing value
+    uint64_t numberArgument(int argc, char* argv[], int& i, uint64_t minimum) {
+        if (i + 1 >= argc) {
+            std::cerr << "Error: " << argv[i] << " requires a value" << std::endl;
+            printUsage(argv[0]);
+            exit(1);
+        }
+        try {
+            uint64_t value = std::stoull(argv[++i]);
+            if (value < minimum) {
+                throw std::out_of_range("below minimum");
+            }
+            return value;
+        } catch (const std::exception&) {
+            std::cerr << "Error: Invalid value '" << argv[i] << "' for " << argv[i - 1] << std::endl;
+            exit(1);
+        }
+    }
+
+    std::vector<std::string> splitList(const std::string& list) {
+        std::vector<std::string> items;
+        std::stringstream stream(list);
+        std::string item;
+        while (std::getline(stream, item, ',')) {
+            items.push_back(item);
+        }
+        return items;
+    }
+
+    void parseCommandLine(int argc, char* argv[], SimulationConfig& config, std::vector<std::string>& policies) {
+        size_t players = 2;
+        policies = {"lowest"};
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            if (arg == "--help" || arg == "-h") {
+                printUsage(argv[0]);
+                exit(0);
+            } else if (arg == "--games" || arg == "-g") {
+                config.games = numberArgument(argc, argv, i, 1);
+            } else if (arg == "--threads" || arg == "-t") {
+                config.threads = static_cast<size_t>(numberArgument(argc, argv, i, 0));
+            } else if (arg == "--seed" || arg == "-s") {
+                config.seed = numberArgument(argc, argv, i, 0);
+            } else if (arg == "--players") {
+                players = static_cast<size_t>(numberArgument(argc, argv, i, 2));
+            } else if (arg == "--policy" && i + 1 < argc) {
+                policies = splitList(argv[++i]);
+            } else if (arg == "--max-turns") {
+                config.max_turns = static_cast<size_t>(numberArgument(argc, argv, i, 1));
+            } else {
+                std::cerr << "Error: Unknown argument: " << arg << std::endl;
+                printUsage(argv[0]);
+                exit(1);
+            }
+        }
+
+        if (players > MAX_SEATS || policies.empty() || policies.size() > players) {
+            std::cerr << "Error: Need 2 to " << MAX_SEATS << " players and at most one policy per seat" << std::endl;
+            exit(1);
+        }
+        policies.resize(players, policies.back());
+        for (const std::string& name : policies) {
+            PolicyFactory factory = BotPolicies::byName(name);
+            if (!factory) {
+                std::cerr << "Error: Unknown policy: " << name << std::endl;
+                printUsage(argv[0]);
+                exit(1);
+            }
+            config.seats.push_back(factory);
+        }
+    }
+
+    double percent(uint64_t part, uint64_t whole) {
+        return whole == 0 ? 0.0 : 100.0 * static_cast<double>(part) / static_cast<double>(whole);
+    }
+
+    double perGame(uint64_t total, uint64_t games) {
+        return games == 0 ? 0.0 : static_cast<double>(total) / static_cast<double>(games);
+    }
+
+    void printReport(const SimulationConfig& config, const std::vector<std::string>& policies,
+                     const SimulationStats& stats) {
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "=== Simulation Report ===" << std::endl;
+        std::cout << "  Games: " << stats.games << " in " << stats.seconds << " s ("
+                  << static_cast<uint64_t>(static_cast<double>(stats.games) / stats.seconds) << " games/s), seed "
+                  << config.seed << std::endl;
+        std::cout << "  Finished: " << stats.finished << ", stalled after " << config.max_turns << " turns: "
+                  << stats.stalled << " (" << percent(stats.stalled, stats.games) << "%)" << std::endl;
+
+        std::cout << "  Game length (turns): mean " << perGame(stats.turns, stats.finished)
+                  << ", p50 " << stats.lengthPercentile(0.5)
+                  << ", p90 " << stats.lengthPercentile(0.9)
+                  << ", p99 " << stats.lengthPercentile(0.99)
+                  << ", min " << (stats.finished > 0 ? stats.shortest_game : 0)
+                  << ", max " << stats.longest_game << std::endl;
+
+        std::cout << "  Pickups: " << perGame(stats.pickups, stats.games) << " per game" << std::endl;
+        std::cout << "  Reserve plays: " << perGame(stats.reserve_plays, stats.games) << " per game, "
+                  << percent(stats.failed_reserve_plays, stats.reserve_plays) << "% did not fit" << std::endl;
+        std::cout << "  Deck ran dry: " << stats.deck_ran_dry << " games (" << percent(stats.deck_ran_dry, stats.games)
+                  << "%), " << perGame(stats.turns_after_dry, stats.deck_ran_dry) << " turns after it on average"
+                  << std::endl;
+
+        std::cout << "  Wins by seat:" << std::endl;
+        for (size_t seat = 0; seat < policies.size(); ++seat) {
+            std::cout << "    " << seat << " " << std::left << std::setw(8) << policies[seat] << std::right
+                      << std::setw(12) << stats.wins_by_seat[seat]
+                      << std::setw(8) << percent(stats.wins_by_seat[seat], stats.finished) << "%" << std::endl;
+        }
+        if (stats.rejected_moves > 0) {
+            std::cout << "  Rejected policy moves: " << stats.rejected_moves << std::endl;
+        }
+        std::cout << "=========================" << std::endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    SimulationConfig config;
+    std::vector<std::string> policies;
+    parseCommandLine(argc, argv, config, policies);
+
+    SimulationStats stats = Simulation::run(config);
+    printReport(config, policies, stats);
+    return 0;
+}